@@ -1,12 +1,12 @@
 #version 460 core
 
+// must match PackedVertex
 struct VertexData
 {
     float position[3];
-    float normal[3];
-    float tangent[3];
-    float bitangent[3];
-    float uv[2];
+    uint normal;
+    uint tangent;
+    uint uv;
 };
 
 layout(binding = 0, std430) readonly buffer vertices {
@@ -23,9 +23,7 @@ vec3 get_position(uint index)
 
 vec2 get_uv(uint index)
 {
-    return vec2(
-        data[index].uv[0],
-        data[index].uv[1]);
+    return unpackHalf2x16(data[index].uv);
 }
 
 layout(location = 0) out vec2 out_uv;
@@ -1,12 +1,12 @@
 #version 460 core
 
+// must match PackedVertex
 struct VertexData
 {
     float position[3];
-    float normal[3];
-    float tangent[3];
-    float bitangent[3];
-    float uv[2];
+    uint normal;
+    uint tangent;
+    uint uv;
 };
 
 layout(binding = 0, std430) readonly buffer vertices {
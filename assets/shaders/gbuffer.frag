@@ -1,11 +1,21 @@
 #version 460 core
 #extension GL_ARB_bindless_texture : require
 
-layout(location = 0) in flat uvec2 in_albedo_tex_bindless_handle;
-layout(location = 1) in flat uvec2 in_normal_tex_bindless_handle;
-layout(location = 2) in flat uvec2 in_specular_tex_bindless_handle;
-layout(location = 3) in flat uvec2 in_glossiness_tex_bindless_handle;
-layout(location = 4) in flat uvec2 in_emissive_tex_bindless_handle;
+struct MaterialData
+{
+    uvec2 albedo_bindless_handle;
+    uvec2 normal_bindless_handle;
+    uvec2 specular_bindless_handle;
+    uvec2 ao_bindless_handle;
+    uvec2 glossiness_bindless_handle;
+    uvec2 emissive_bindless_handle;
+};
+
+layout(binding = 3, std430) readonly buffer materials {
+    MaterialData material_data[];
+};
+
+layout(location = 0) in flat uint in_material_index;
 layout(location = 5) in vec2 in_uv;
 layout(location = 6) in vec4 in_frag_position;
 layout(location = 7) in mat3 in_tbn;
@@ -19,19 +29,21 @@ layout(location = 4) out vec4 out_emissive;
 
 void main()
 {
+    MaterialData material = material_data[in_material_index];
+
     vec3 n;
-    n.xy = texture(sampler2D(in_normal_tex_bindless_handle), in_uv).rg * 2.0 - 1.0;
+    n.xy = texture(sampler2D(material.normal_bindless_handle), in_uv).rg * 2.0 - 1.0;
     n.z = sqrt(max(1.0 - dot(n.xy, n.xy), 0.0));
     n = normalize(in_tbn * n);
 
-    out_colour = vec4(texture(sampler2D(in_albedo_tex_bindless_handle), in_uv).rgb, 1.0);
+    out_colour = vec4(texture(sampler2D(material.albedo_bindless_handle), in_uv).rgb, 1.0);
     out_normal = vec4(n, 1.0);
     out_pos = in_frag_position;
 
-    float specular = texture(sampler2D(in_specular_tex_bindless_handle), in_uv).r;
-    float glossiness = texture(sampler2D(in_glossiness_tex_bindless_handle), in_uv).r;
+    float specular = texture(sampler2D(material.specular_bindless_handle), in_uv).r;
+    float glossiness = texture(sampler2D(material.glossiness_bindless_handle), in_uv).r;
 
     out_specular = vec4(specular, glossiness, 0.0, 1.0);
 
-    out_emissive = vec4(texture(sampler2D(in_emissive_tex_bindless_handle), in_uv).rgb * in_emissive_strength, 1.0);
+    out_emissive = vec4(texture(sampler2D(material.emissive_bindless_handle), in_uv).rgb * in_emissive_strength, 1.0);
 }
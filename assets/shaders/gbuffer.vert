@@ -1,22 +1,18 @@
 #version 460 core
 
+// must match PackedVertex
 struct VertexData
 {
     float position[3];
-    float normal[3];
-    float tangent[3];
-    float bitangent[3];
-    float uv[2];
+    uint normal;
+    uint tangent;
+    uint uv;
 };
 
 struct ObjectData
 {
     mat4 model;
-    uvec2 albedo_bindless_handle;
-    uvec2 normal_bindless_handle;
-    uvec2 specular_bindless_handle;
-    uvec2 glossiness_bindless_handle;
-    uvec2 emissive_bindless_handle;
+    uint material_index;
     float emissive_strength;
 };
 
@@ -43,42 +39,43 @@ vec3 get_position(uint index)
         data[index].position[2]);
 }
 
+// mirror of octahedral_decode in packed_vertex.cpp
+vec3 octahedral_decode(uint encoded)
+{
+    vec2 f = unpackSnorm2x16(encoded);
+    vec3 v = vec3(f, 1.0 - abs(f.x) - abs(f.y));
+
+    // unfold the lower hemisphere
+    float t = max(-v.z, 0.0);
+    v.x += v.x >= 0.0 ? -t : t;
+    v.y += v.y >= 0.0 ? -t : t;
+
+    return normalize(v);
+}
+
 vec3 get_normal(uint index)
 {
-    return vec3(
-        data[index].normal[0],
-        data[index].normal[1],
-        data[index].normal[2]);
+    return octahedral_decode(data[index].normal);
 }
 
 vec3 get_tangent(uint index)
 {
-    return vec3(
-        data[index].tangent[0],
-        data[index].tangent[1],
-        data[index].tangent[2]);
+    return octahedral_decode(data[index].tangent);
 }
 
 vec3 get_bitangent(uint index)
 {
-    return vec3(
-        data[index].bitangent[0],
-        data[index].bitangent[1],
-        data[index].bitangent[2]);
+    // the lowest bit of the tangent's y component holds the bitangent sign
+    float handedness = (data[index].tangent & 0x10000u) != 0u ? -1.0 : 1.0;
+    return handedness * cross(get_normal(index), get_tangent(index));
 }
 
 vec2 get_uv(uint index)
 {
-    return vec2(
-        data[index].uv[0],
-        data[index].uv[1]);
+    return unpackHalf2x16(data[index].uv);
 }
 
-layout(location = 0) out flat uvec2 out_albedo_bindless_handle;
-layout(location = 1) out flat uvec2 out_normal_bindless_handle;
-layout(location = 2) out flat uvec2 out_specular_bindless_handle;
-layout(location = 3) out flat uvec2 out_glossiness_bindless_handle;
-layout(location = 4) out flat uvec2 out_emissive_bindless_handle;
+layout(location = 0) out flat uint out_material_index;
 layout(location = 5) out vec2 out_uv;
 layout(location = 6) out vec4 out_frag_position;
 layout(location = 7) out mat3 out_tbn;
@@ -86,16 +83,15 @@ layout(location = 10) out flat float out_emissive_strength;
 
 void main()
 {
-    mat3 normal_mat = transpose(inverse(mat3(object_data[gl_DrawID].model)));
+    // identical draws are merged into one instanced command, base instance points at the first instance's data
+    uint object_index = uint(gl_BaseInstance + gl_InstanceID);
+
+    mat3 normal_mat = transpose(inverse(mat3(object_data[object_index].model)));
 
-    out_frag_position = object_data[gl_DrawID].model * vec4(get_position(gl_VertexID), 1.0);
+    out_frag_position = object_data[object_index].model * vec4(get_position(gl_VertexID), 1.0);
     gl_Position = projection * view * out_frag_position;
 
-    out_albedo_bindless_handle = object_data[gl_DrawID].albedo_bindless_handle;
-    out_normal_bindless_handle = object_data[gl_DrawID].normal_bindless_handle;
-    out_specular_bindless_handle = object_data[gl_DrawID].specular_bindless_handle;
-    out_glossiness_bindless_handle = object_data[gl_DrawID].glossiness_bindless_handle;
-    out_emissive_bindless_handle = object_data[gl_DrawID].emissive_bindless_handle;
+    out_material_index = object_data[object_index].material_index;
     out_uv = get_uv(gl_VertexID);
 
     vec3 t = normalize(normal_mat * get_tangent(gl_VertexID));
@@ -103,5 +99,5 @@ void main()
     vec3 n = normalize(normal_mat * get_normal(gl_VertexID));
     out_tbn = mat3(t, b, n);
 
-    out_emissive_strength = object_data[gl_DrawID].emissive_strength;
+    out_emissive_strength = object_data[object_index].emissive_strength;
 }
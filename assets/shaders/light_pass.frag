@@ -23,6 +23,23 @@ layout(binding = 2, std430) readonly buffer camera {
     float pad;
 };
 
+// must match LightClusterGrid
+const uint cluster_grid_width = 16u;
+const uint cluster_grid_height = 9u;
+const uint cluster_grid_depth = 24u;
+
+layout(binding = 3, std430) readonly buffer clusters {
+    float cluster_near_plane;
+    float cluster_far_plane;
+    uint light_index_count;
+    uint cluster_pad;
+    uvec2 light_clusters[];
+};
+
+layout(binding = 4, std430) readonly buffer indices {
+    uint light_indices[];
+};
+
 layout(bindless_sampler, location = 0) uniform sampler2D albedo_texture;
 layout(bindless_sampler, location = 1) uniform sampler2D normal_texture;
 layout(bindless_sampler, location = 2) uniform sampler2D position_texture;
@@ -81,9 +98,19 @@ void main()
 
     vec3 result = ambient * albedo;
 
-    for (uint i = 0; i < num_point_lights; i++)
+    // find the cluster this fragment is in and only shade the lights assigned to it
+    float depth = max(-(view * vec4(frag_pos, 1.0)).z, cluster_near_plane);
+    float slice_scale = float(cluster_grid_depth) / log(cluster_far_plane / cluster_near_plane);
+    uint slice = min(uint(log(depth / cluster_near_plane) * slice_scale), cluster_grid_depth - 1u);
+    uvec2 tile = min(
+        uvec2(in_uv * vec2(cluster_grid_width, cluster_grid_height)),
+        uvec2(cluster_grid_width - 1u, cluster_grid_height - 1u));
+    uvec2 cluster = light_clusters[(slice * cluster_grid_height + tile.y) * cluster_grid_width + tile.x];
+
+    for (uint i = 0; i < cluster.y; i++)
     {
-        result += calculate_point_light(point_lights[i], normal, frag_pos, albedo, specular, glossiness);
+        uint light_index = light_indices[cluster.x + i];
+        result += calculate_point_light(point_lights[light_index], normal, frag_pos, albedo, specular, glossiness);
     }
 
     result += texture(emissive_texture, in_uv).rgb;
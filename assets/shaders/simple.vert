@@ -1,12 +1,12 @@
 #version 460 core
     
+// must match PackedVertex
 struct VertexData
 {
     float position[3];
-    float normal[3];
-    float tangent[3];
-    float bitangent[3];
-    float uv[2];
+    uint normal;
+    uint tangent;
+    uint uv;
 };
 
 struct ObjectData
@@ -57,35 +57,40 @@ vec3 get_position(uint index)
         data[index].position[2]);
 }
 
+// mirror of octahedral_decode in packed_vertex.cpp
+vec3 octahedral_decode(uint encoded)
+{
+    vec2 f = unpackSnorm2x16(encoded);
+    vec3 v = vec3(f, 1.0 - abs(f.x) - abs(f.y));
+
+    // unfold the lower hemisphere
+    float t = max(-v.z, 0.0);
+    v.x += v.x >= 0.0 ? -t : t;
+    v.y += v.y >= 0.0 ? -t : t;
+
+    return normalize(v);
+}
+
 vec3 get_normal(uint index)
 {
-    return vec3(
-        data[index].normal[0],
-        data[index].normal[1],
-        data[index].normal[2]);
+    return octahedral_decode(data[index].normal);
 }
 
 vec3 get_tangent(uint index)
 {
-    return vec3(
-        data[index].tangent[0],
-        data[index].tangent[1],
-        data[index].tangent[2]);
+    return octahedral_decode(data[index].tangent);
 }
 
 vec3 get_bitangent(uint index)
 {
-    return vec3(
-        data[index].bitangent[0],
-        data[index].bitangent[1],
-        data[index].bitangent[2]);
+    // the lowest bit of the tangent's y component holds the bitangent sign
+    float handedness = (data[index].tangent & 0x10000u) != 0u ? -1.0 : 1.0;
+    return handedness * cross(get_normal(index), get_tangent(index));
 }
 
 vec2 get_uv(uint index)
 {
-    return vec2(
-        data[index].uv[0],
-        data[index].uv[1]);
+    return unpackHalf2x16(data[index].uv);
 }
 
 layout (location = 0) out flat uint out_material_index;
@@ -0,0 +1,85 @@
+#include <chrono>
+#include <cstdint>
+#include <numbers>
+#include <print>
+#include <random>
+#include <vector>
+
+#include "concurrency/thread_pool.h"
+#include "core/camera.h"
+#include "graphics/light_clusters.h"
+#include "graphics/point_light.h"
+
+namespace
+{
+
+constexpr auto iterations = 50u;
+
+auto random_lights(std::uint32_t count) -> std::vector<ufps::PointLight>
+{
+    auto generator = std::mt19937{42u};
+    auto position = std::uniform_real_distribution<float>{-100.0f, 100.0f};
+    auto unit = std::uniform_real_distribution<float>{0.0f, 1.0f};
+
+    auto lights = std::vector<ufps::PointLight>{};
+
+    for (auto i = 0u; i < count; ++i)
+    {
+        lights.push_back({
+            .position = {position(generator), position(generator) * 0.1f, position(generator)},
+            .colour = {.r = unit(generator), .g = unit(generator), .b = unit(generator)},
+            .constant_attenuation = 1.0f,
+            .linear_attenuation = 0.35f,
+            .quadratic_attenuation = 0.44f,
+            .intensity = unit(generator) * 5.0f,
+        });
+    }
+
+    return lights;
+}
+
+template <class F>
+auto time_ms(F &&func) -> float
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    for (auto i = 0u; i < iterations; ++i)
+    {
+        func();
+    }
+
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<float, std::milli>(end - start).count() / static_cast<float>(iterations);
+}
+
+}
+
+auto main() -> int
+{
+    const auto camera = ufps::Camera{
+        {0.0f, 2.0f, 0.0f},
+        {0.0f, 0.0f, -1.0f},
+        {0.0f, 1.0f, 0.0f},
+        std::numbers::pi_v<float> / 4.0f,
+        1920.0f,
+        1080.0f,
+        0.1f,
+        1000.0f};
+
+    auto pool = ufps::ThreadPool{};
+
+    std::println("{:>8} {:>12} {:>12} {:>14}", "lights", "serial ms", "parallel ms", "light indices");
+
+    for (const auto count : {1000u, 2500u, 5000u, 10000u})
+    {
+        const auto lights = random_lights(count);
+
+        auto index_count = 0zu;
+        const auto serial = time_ms([&] { index_count = ufps::cluster_lights(camera, lights).light_indices.size(); });
+        const auto parallel = time_ms([&] { ufps::cluster_lights(camera, lights, pool); });
+
+        std::println("{:>8} {:>12.3f} {:>12.3f} {:>14}", count, serial, parallel, index_count);
+    }
+
+    return 0;
+}
@@ -0,0 +1,96 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <memory>
+#include <print>
+#include <vector>
+
+#include "core/service_locator.h"
+#include "graphics/deferred_release.h"
+#include "graphics/mesh_data.h"
+#include "graphics/mesh_manager.h"
+#include "graphics/packed_vertex.h"
+#include "graphics/vertex_data.h"
+#include "graphics/window.h"
+
+namespace
+{
+
+constexpr auto mesh_count = 1000u;
+constexpr auto vertices_per_mesh = 512u;
+constexpr auto indices_per_mesh = 1536u;
+
+auto make_mesh(std::uint32_t seed) -> ufps::MeshData
+{
+    auto mesh = ufps::MeshData{};
+
+    for (auto i = 0u; i < vertices_per_mesh; ++i)
+    {
+        const auto value = static_cast<float>(seed + i);
+        mesh.vertices.push_back({
+            .position = {value, value, value},
+            .normal = {0.0f, 1.0f, 0.0f},
+            .tangent = {1.0f, 0.0f, 0.0f},
+            .bitangent = {0.0f, 0.0f, 1.0f},
+            .uv = {0.0f, 0.0f},
+        });
+    }
+
+    for (auto i = 0u; i < indices_per_mesh; ++i)
+    {
+        mesh.indices.push_back(i % vertices_per_mesh);
+    }
+
+    return mesh;
+}
+
+}
+
+auto main() -> int
+{
+    // a gl context is required for the arena buffers
+    auto window = ufps::Window{ufps::WindowMode::WINDOWED, 320u, 240u, 0u, 0u};
+
+    auto services = std::make_unique<ufps::Services>();
+    std::get<std::unique_ptr<ufps::DeferredRelease<>>>(*services) = std::make_unique<ufps::DeferredRelease<>>();
+    ufps::set_service(services.get());
+
+    const auto mesh = std::vector<ufps::MeshData>{make_mesh(0u)};
+    const auto mesh_bytes =
+        (mesh.front().vertices.size() * sizeof(ufps::PackedVertex)) +
+        (mesh.front().indices.size() * sizeof(std::uint32_t));
+
+    auto mesh_manager = ufps::MeshManager{};
+
+    const auto start = std::chrono::steady_clock::now();
+
+    for (auto i = 0u; i < mesh_count; ++i)
+    {
+        mesh_manager.load(std::format("mesh_{}", i), mesh);
+    }
+
+    const auto end = std::chrono::steady_clock::now();
+
+    // previously every load re-uploaded all geometry loaded so far
+    auto whole_buffer_bytes = 0zu;
+    for (auto i = 1zu; i <= mesh_count; ++i)
+    {
+        whole_buffer_bytes += i * mesh_bytes;
+    }
+
+    std::println("{:>8} {:>12} {:>18} {:>18}", "meshes", "total ms", "arena bytes", "whole buffer bytes");
+    std::println(
+        "{:>8} {:>12.3f} {:>18} {:>18}",
+        mesh_count,
+        std::chrono::duration<float, std::milli>(end - start).count(),
+        mesh_manager.uploaded_bytes(),
+        whole_buffer_bytes);
+
+    std::println(
+        "vertex bytes: {} unpacked, {} packed",
+        mesh_count * vertices_per_mesh * sizeof(ufps::VertexData),
+        mesh_count * vertices_per_mesh * sizeof(ufps::PackedVertex));
+
+    return 0;
+}
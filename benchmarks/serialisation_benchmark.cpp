@@ -0,0 +1,166 @@
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <print>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "core/entity.h"
+#include "core/scene.h"
+#include "graphics/point_light.h"
+#include "maths/aabb.h"
+#include "maths/matrix4.h"
+#include "maths/transform.h"
+#include "maths/vector3.h"
+#include "memory/metrics.h"
+#include "physics/rigid_body.h"
+#include "serialisation/binary_serialiser.h"
+#include "serialisation/yaml_serialiser.h"
+#include "utils/data_buffer.h"
+#include "utils/error.h"
+
+namespace
+{
+
+constexpr auto entity_count = 100'000u;
+constexpr auto light_count = 256u;
+
+auto random_scene() -> ufps::Scene::Description
+{
+    auto generator = std::mt19937{42u};
+    auto position = std::uniform_real_distribution<float>{-100.0f, 100.0f};
+    auto unit = std::uniform_real_distribution<float>{0.0f, 1.0f};
+
+    auto description = ufps::Scene::Description{};
+
+    for (auto i = 0u; i < light_count; ++i)
+    {
+        description.lights.lights.emplace(
+            ufps::PointLight{
+                .position = {position(generator), position(generator), position(generator)},
+                .colour = {.r = unit(generator), .g = unit(generator), .b = unit(generator)},
+                .constant_attenuation = 1.0f,
+                .linear_attenuation = 0.35f,
+                .quadratic_attenuation = 0.44f,
+                .intensity = unit(generator) * 5.0f,
+            });
+    }
+
+    for (auto i = 0u; i < entity_count; ++i)
+    {
+        const auto translation = ufps::Vector3{position(generator), position(generator), position(generator)};
+
+        description.entities.push_back({
+            .name = i % 2u == 0u ? "crate" : "barrel",
+            .emissive_strength = unit(generator),
+            .transform = {translation, {1.0f, 1.0f, 1.0f}, {}},
+            .aabb = {.min = translation - ufps::Vector3{1.0f}, .max = translation + ufps::Vector3{1.0f}},
+            .rigid_bodies = {{.local_transform = ufps::Matrix4{}, .applied_scale = {1.0f, 1.0f, 1.0f}}},
+        });
+    }
+
+    return description;
+}
+
+template <class F>
+auto time_ms(F &&func) -> float
+{
+    const auto start = std::chrono::steady_clock::now();
+    func();
+    const auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<float, std::milli>(end - start).count();
+}
+
+struct ReadStats
+{
+    float ms;
+    std::size_t peak_bytes;
+};
+
+/**
+ * Time func and track the most memory it had allocated at once, on top of whatever was live beforehand.
+ */
+template <class F>
+auto time_read(F &&func) -> ReadStats
+{
+    const auto live_bytes = ufps::metrics().live_allocated_bytes;
+    ufps::g_metrics.peak_live_allocated_bytes.store(live_bytes, std::memory_order_relaxed);
+
+    const auto ms = time_ms(std::forward<F>(func));
+
+    return {.ms = ms, .peak_bytes = ufps::metrics().peak_live_allocated_bytes - live_bytes};
+}
+
+}
+
+auto main() -> int
+{
+    const auto description = random_scene();
+
+    auto yaml = std::string{};
+    auto binary = ufps::DataBuffer{};
+
+    const auto yaml_write = time_ms(
+        [&]
+        {
+            auto result = ufps::yaml::serialise(description);
+            ufps::ensure(result);
+            yaml = std::move(*result);
+        });
+    const auto yaml_tree_read = time_read(
+        [&]
+        {
+            const auto result = ufps::yaml::deserialise_tree<ufps::Scene::Description>(yaml);
+            ufps::ensure(result);
+        });
+    const auto yaml_read = time_read(
+        [&]
+        {
+            const auto result = ufps::yaml::deserialise<ufps::Scene::Description>(yaml);
+            ufps::ensure(result);
+        });
+
+    const auto binary_write = time_ms(
+        [&]
+        {
+            auto result = ufps::binary::serialise(description);
+            ufps::ensure(result);
+            binary = std::move(*result);
+        });
+    const auto binary_read = time_read(
+        [&]
+        {
+            const auto result = ufps::binary::deserialise<ufps::Scene::Description>(binary);
+            ufps::ensure(result);
+        });
+
+    std::println("{} entities, {} lights", entity_count, light_count);
+    std::println("{:>10} {:>12} {:>12} {:>14} {:>12}", "format", "write ms", "read ms", "read peak", "bytes");
+    std::println(
+        "{:>10} {:>12.3f} {:>12.3f} {:>14} {:>12}",
+        "yaml tree",
+        yaml_write,
+        yaml_tree_read.ms,
+        yaml_tree_read.peak_bytes,
+        yaml.size());
+    std::println(
+        "{:>10} {:>12.3f} {:>12.3f} {:>14} {:>12}",
+        "yaml",
+        yaml_write,
+        yaml_read.ms,
+        yaml_read.peak_bytes,
+        yaml.size());
+    std::println(
+        "{:>10} {:>12.3f} {:>12.3f} {:>14} {:>12}",
+        "binary",
+        binary_write,
+        binary_read.ms,
+        binary_read.peak_bytes,
+        binary.size());
+
+    return 0;
+}
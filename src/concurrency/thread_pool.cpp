@@ -2,10 +2,16 @@
 
 #include <algorithm>
 #include <chrono>
+#include <cstddef>
+#include <exception>
 #include <format>
+#include <latch>
 #include <processthreadsapi.h>
+#include <ranges>
 #include <stop_token>
 #include <thread>
+#include <utility>
+#include <vector>
 
 #include "utils/error.h"
 #include "utils/formatter.h"
@@ -155,5 +161,39 @@ auto ThreadPool::drain() const -> void
     }
 }
 
+auto run_parallel(ThreadPool &pool, std::vector<Job> jobs) -> void
+{
+    auto done = std::latch{static_cast<std::ptrdiff_t>(jobs.size())};
+    auto errors = std::vector<std::exception_ptr>(jobs.size());
+
+    for (auto [index, job] : std::views::enumerate(jobs))
+    {
+        pool.add(
+            [&, index, job = std::move(job)] mutable
+            {
+                try
+                {
+                    job();
+                }
+                catch (...)
+                {
+                    errors[index] = std::current_exception();
+                }
+
+                done.count_down();
+            });
+    }
+
+    done.wait();
+
+    for (const auto &error : errors)
+    {
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
 }
 // 
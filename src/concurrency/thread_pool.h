@@ -58,4 +58,10 @@ inline auto ThreadPool::profile_data()
     return data_copy;
 }
 
+/**
+ * Run jobs on the pool and wait for all of them, the first exception thrown by a job is rethrown on the caller. Must
+ * not be called from a job on the same pool.
+ */
+auto run_parallel(ThreadPool &pool, std::vector<Job> jobs) -> void;
+
 }
@@ -9,6 +9,7 @@
 #include "core/render_entity.h"
 #include "core/service_locator.h"
 #include "core/utils.h"
+#include "graphics/mesh_view.h"
 #include "maths/aabb.h"
 #include "maths/transform.h"
 #include "physics/physics_system.h"
@@ -40,6 +41,7 @@ class Entity
     constexpr auto set_emissive_strength(float strength) -> void;
     constexpr auto add_rigid_body(RigidBodyHandle handle);
     constexpr auto rigid_bodies() const -> std::span<const RigidBodyHandle>;
+    constexpr auto relocate_meshes(std::span<const MeshRelocation> relocations) -> void;
 
   private:
     std::string name_;
@@ -135,4 +137,12 @@ constexpr auto Entity::rigid_bodies() const -> std::span<const RigidBodyHandle>
     return rigid_bodies_;
 }
 
+constexpr auto Entity::relocate_meshes(std::span<const MeshRelocation> relocations) -> void
+{
+    for (auto &render_entity : render_entities_)
+    {
+        render_entity.relocate(relocations);
+    }
+}
+
 }
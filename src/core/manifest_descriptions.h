@@ -2,7 +2,9 @@
 
 #include <vector>
 
+#include "graphics/mesh_lod.h"
 #include "graphics/mesh_view.h"
+#include "graphics/meshlet.h"
 #include "utils/string_map.h"
 
 namespace ufps
@@ -11,6 +13,8 @@ namespace ufps
 struct ModelManifest
 {
     MeshView mesh_view;
+    std::vector<MeshLod> lods;
+    MeshletRange meshlets;
     std::string albedo_texture;
     std::string normal_texture;
     std::string specular_texture;
@@ -24,10 +28,11 @@ struct ModelManifestDescription
     StringMap<std::vector<ModelManifest>> models;
 };
 
+/**
+ * Texture data lives in the asset archive under the same name as the texture.
+ */
 struct TextureManifest
 {
-    std::uint32_t offset;
-    std::uint32_t size;
     bool is_srgb;
 };
 
@@ -2,10 +2,15 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
 
 #include "core/service_locator.h"
+#include "graphics/mesh_lod.h"
 #include "graphics/mesh_manager.h"
 #include "graphics/mesh_view.h"
+#include "graphics/meshlet.h"
 #include "maths/aabb.h"
 
 namespace ufps
@@ -15,7 +20,7 @@ namespace impl
 {
 constexpr auto calculate_aabb(ufps::MeshView mesh_view) -> ufps::AABB
 {
-    const auto vertices = ufps::service<ufps::MeshManager>().vertex_data(mesh_view);
+    const auto positions = ufps::service<ufps::MeshManager>().vertex_positions(mesh_view);
 
     auto initial_aabb = ufps::AABB{
         .min = {std::numeric_limits<float>::max()},
@@ -23,22 +28,22 @@ constexpr auto calculate_aabb(ufps::MeshView mesh_view) -> ufps::AABB
     };
 
     return std::ranges::fold_left(
-        vertices,
+        positions,
         initial_aabb,
         [](const auto &a, const auto &b)
         {
             return ufps::AABB{
                 .min =
                     {
-                        std::min(a.min.x, b.position.x),
-                        std::min(a.min.y, b.position.y),
-                        std::min(a.min.z, b.position.z),
+                        std::min(a.min.x, b.x),
+                        std::min(a.min.y, b.y),
+                        std::min(a.min.z, b.z),
                     },
                 .max =
                     {
-                        std::max(a.max.x, b.position.x),
-                        std::max(a.max.y, b.position.y),
-                        std::max(a.max.z, b.position.z),
+                        std::max(a.max.x, b.x),
+                        std::max(a.max.y, b.y),
+                        std::max(a.max.z, b.z),
                     },
             };
         });
@@ -48,92 +53,82 @@ constexpr auto calculate_aabb(ufps::MeshView mesh_view) -> ufps::AABB
 class RenderEntity
 {
   public:
-    constexpr RenderEntity(
-        MeshView mesh_view,
-        std::uint64_t albedo_texture_bindless_handle,
-        std::uint64_t normal_texture_bindless_handle,
-        std::uint64_t specular_texture_bindless_handle,
-        std::uint64_t ao_texture_bindless_handle,
-        std::uint64_t glossiness_texture_bindless_handle,
-        std::uint64_t emissive_texture_bindless_handle);
+    constexpr RenderEntity(MeshView mesh_view, std::uint32_t material_index);
+
+    /**
+     * Lods must be ordered finest first, the first is the full detail mesh and is used for bounds and picking.
+     * Meshlets, if any, are for the full detail mesh.
+     */
+    constexpr RenderEntity(std::vector<MeshLod> lods, std::vector<Meshlet> meshlets, std::uint32_t material_index);
 
     constexpr auto mesh_view() const -> MeshView;
-    constexpr auto albedo_texture_bindless_handle() const -> std::uint64_t;
-    constexpr auto normal_texture_bindless_handle() const -> std::uint64_t;
-    constexpr auto specular_texture_bindless_handle() const -> std::uint64_t;
-    constexpr auto ao_texture_bindless_handle() const -> std::uint64_t;
-    constexpr auto glossiness_texture_bindless_handle() const -> std::uint64_t;
-    constexpr auto emissive_texture_bindless_handle() const -> std::uint64_t;
+    constexpr auto lods() const -> std::span<const MeshLod>;
+    constexpr auto meshlets() const -> std::span<const Meshlet>;
+    constexpr auto material_index() const -> std::uint32_t;
     constexpr auto aabb() const -> const AABB &;
+    constexpr auto relocate(std::span<const MeshRelocation> relocations) -> void;
 
   private:
-    MeshView mesh_view_;
-    std::uint64_t albedo_texture_bindless_handle_;
-    std::uint64_t normal_texture_bindless_handle_;
-    std::uint64_t specular_texture_bindless_handle_;
-    std::uint64_t ao_texture_bindless_handle_;
-    std::uint64_t glossiness_texture_bindless_handle_;
-    std::uint64_t emissive_texture_bindless_handle_;
+    std::vector<MeshLod> lods_;
+    std::vector<Meshlet> meshlets_;
+    std::uint32_t material_index_;
     AABB aabb_;
 };
 
-constexpr RenderEntity::RenderEntity(
-    MeshView mesh_view,
-    std::uint64_t albedo_texture_bindless_handle,
-    std::uint64_t normal_texture_bindless_handle,
-    std::uint64_t specular_texture_bindless_handle,
-    std::uint64_t ao_texture_bindless_handle,
-    std::uint64_t glossiness_texture_bindless_handle,
-    std::uint64_t emissive_texture_bindless_handle)
-    : mesh_view_{mesh_view}
-    , albedo_texture_bindless_handle_{albedo_texture_bindless_handle}
-    , normal_texture_bindless_handle_{normal_texture_bindless_handle}
-    , specular_texture_bindless_handle_{specular_texture_bindless_handle}
-    , ao_texture_bindless_handle_{ao_texture_bindless_handle}
-    , glossiness_texture_bindless_handle_{glossiness_texture_bindless_handle}
-    , emissive_texture_bindless_handle_{emissive_texture_bindless_handle}
-    , aabb_{impl::calculate_aabb(mesh_view_)}
+constexpr RenderEntity::RenderEntity(MeshView mesh_view, std::uint32_t material_index)
+    : RenderEntity{std::vector<MeshLod>{{.mesh_view = mesh_view, .error = 0.0f}}, {}, material_index}
 {
 }
 
-constexpr auto RenderEntity::mesh_view() const -> MeshView
-{
-    return mesh_view_;
-}
-
-constexpr auto RenderEntity::albedo_texture_bindless_handle() const -> std::uint64_t
+constexpr RenderEntity::RenderEntity(
+    std::vector<MeshLod> lods,
+    std::vector<Meshlet> meshlets,
+    std::uint32_t material_index)
+    : lods_{std::move(lods)}
+    , meshlets_{std::move(meshlets)}
+    , material_index_{material_index}
+    , aabb_{impl::calculate_aabb(lods_.front().mesh_view)}
 {
-    return albedo_texture_bindless_handle_;
 }
 
-constexpr auto RenderEntity::normal_texture_bindless_handle() const -> std::uint64_t
+constexpr auto RenderEntity::mesh_view() const -> MeshView
 {
-    return normal_texture_bindless_handle_;
+    return lods_.front().mesh_view;
 }
 
-constexpr auto RenderEntity::specular_texture_bindless_handle() const -> std::uint64_t
+constexpr auto RenderEntity::lods() const -> std::span<const MeshLod>
 {
-    return specular_texture_bindless_handle_;
+    return lods_;
 }
 
-constexpr auto RenderEntity::ao_texture_bindless_handle() const -> std::uint64_t
+constexpr auto RenderEntity::meshlets() const -> std::span<const Meshlet>
 {
-    return ao_texture_bindless_handle_;
+    return meshlets_;
 }
 
-constexpr auto RenderEntity::glossiness_texture_bindless_handle() const -> std::uint64_t
+constexpr auto RenderEntity::material_index() const -> std::uint32_t
 {
-    return glossiness_texture_bindless_handle_;
+    return material_index_;
 }
 
-constexpr auto RenderEntity::emissive_texture_bindless_handle() const -> std::uint64_t
+constexpr auto RenderEntity::aabb() const -> const AABB &
 {
-    return emissive_texture_bindless_handle_;
+    return aabb_;
 }
 
-constexpr auto RenderEntity::aabb() const -> const AABB &
+constexpr auto RenderEntity::relocate(std::span<const MeshRelocation> relocations) -> void
 {
-    return aabb_;
+    // applied in order as a view can be moved more than once
+    for (const auto &[from, to] : relocations)
+    {
+        for (auto &lod : lods_)
+        {
+            if (lod.mesh_view == from)
+            {
+                lod.mesh_view = to;
+            }
+        }
+    }
 }
 
 }
@@ -2,6 +2,7 @@
 
 #include <optional>
 #include <ranges>
+#include <span>
 #include <type_traits>
 #include <vector>
 
@@ -10,6 +11,7 @@
 #include "core/sparse_set.h"
 #include "graphics/colour.h"
 #include "graphics/mesh_manager.h"
+#include "graphics/mesh_view.h"
 #include "graphics/point_light.h"
 #include "maths/bounded_number.h"
 #include "maths/ray.h"
@@ -129,6 +131,11 @@ class Scene
 
     constexpr auto create_entity(std::string_view name) -> Entity *;
 
+    /**
+     * Move already constructed entities into the scene, e.g. a whole level from a SceneSnapshot.
+     */
+    constexpr auto add_entities(std::vector<Entity> entities) -> void;
+
     template <class Self>
     auto entities(this Self &&self);
 
@@ -158,6 +165,11 @@ class Scene
 
     constexpr auto remove(PointLightHandle light) -> void;
 
+    /**
+     * Update every entity, including cached ones, after meshes have been moved by MeshManager::compact.
+     */
+    constexpr auto relocate_meshes(std::span<const MeshRelocation> relocations) -> void;
+
   private:
     std::vector<Entity> entities_;
     std::vector<Entity> entity_cache_;
@@ -220,13 +232,14 @@ constexpr Scene::Scene(const Description &description, const StringMap<Entity> &
         cache_entity(name, entity);
     }
 
+    entities_.reserve(description.entities.size());
+
     for (const auto &entity_description : description.entities)
     {
-        const auto cached = std::ranges::find_if(
-            entity_cache_, [&entity_description](const auto &e) { return e.name() == entity_description.name; });
-        expect(cached != std::ranges::cend(entity_cache_), "unknown entity: {}", entity_description.name);
+        const auto cached = entity_cache.find(entity_description.name);
+        expect(cached != std::ranges::cend(entity_cache), "unknown entity: {}", entity_description.name);
 
-        auto &new_entity = entities_.emplace_back(*cached);
+        auto &new_entity = entities_.emplace_back(cached->second);
         new_entity.set_transform(entity_description.transform);
         new_entity.set_emissive_strength(entity_description.emissive_strength);
 
@@ -262,13 +275,13 @@ constexpr auto Scene::intersect_ray(const Ray &ray) -> std::optional<Intersectio
 
                 const auto mesh_view = render_entity.mesh_view();
                 const auto indices = mesh_manager.index_data(mesh_view);
-                const auto vertices = mesh_manager.vertex_data(mesh_view);
+                const auto positions = mesh_manager.vertex_positions(mesh_view);
 
                 for (const auto &indices : std::views::chunk(indices, 3))
                 {
-                    const auto v0 = vertices[indices[0]].position;
-                    const auto v1 = vertices[indices[1]].position;
-                    const auto v2 = vertices[indices[2]].position;
+                    const auto v0 = positions[indices[0]];
+                    const auto v1 = positions[indices[1]];
+                    const auto v2 = positions[indices[2]];
 
                     if (const auto distance = intersect(transformed_ray, v0, v1, v2); distance)
                     {
@@ -301,6 +314,18 @@ constexpr auto Scene::create_entity(std::string_view name) -> Entity *
     return &new_entity;
 }
 
+constexpr auto Scene::add_entities(std::vector<Entity> entities) -> void
+{
+    if (entities_.empty())
+    {
+        entities_ = std::move(entities);
+    }
+    else
+    {
+        entities_.append_range(std::views::as_rvalue(entities));
+    }
+}
+
 template <class Self>
 auto Scene::entities(this Self &&self)
 {
@@ -389,4 +414,17 @@ constexpr auto Scene::remove(PointLightHandle light) -> void
 {
     lights_.lights.remove(light);
 }
+
+constexpr auto Scene::relocate_meshes(std::span<const MeshRelocation> relocations) -> void
+{
+    for (auto &entity : entities_)
+    {
+        entity.relocate_meshes(relocations);
+    }
+
+    for (auto &entity : entity_cache_)
+    {
+        entity.relocate_meshes(relocations);
+    }
+}
 }
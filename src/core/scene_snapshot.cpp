@@ -0,0 +1,244 @@
+#include "core/scene_snapshot.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "core/entity.h"
+#include "core/scene.h"
+#include "core/service_locator.h"
+#include "graphics/point_light.h"
+#include "maths/matrix4.h"
+#include "maths/vector3.h"
+#include "physics/physics_system.h"
+#include "physics/rigid_body.h"
+#include "serialisation/binary_serialiser.h"
+#include "utils/data_buffer.h"
+#include "utils/error.h"
+#include "utils/flat_records.h"
+#include "utils/string_map.h"
+
+namespace
+{
+
+constexpr auto format_name = std::string_view{"scene snapshot"};
+
+}
+
+namespace ufps
+{
+
+auto encode_scene_snapshot(const Scene::Description &description) -> DataBuffer
+{
+    const auto settings = binary::serialise(
+        Scene::Description{
+            .tone_map_options = description.tone_map_options,
+            .ssao_options = description.ssao_options,
+            .exposure_options = description.exposure_options,
+            .fog_options = description.fog_options,
+            .chromatic_aberration_options = description.chromatic_aberration_options,
+            .vignette_options = description.vignette_options,
+            .film_grain_options = description.film_grain_options,
+            .bloom_options = description.bloom_options,
+            .lights = {.ambient = description.lights.ambient, .lights = {}},
+            .entities = {},
+        });
+    ensure(settings);
+
+    auto names = std::string{};
+    auto prefabs = std::vector<SceneSnapshotPrefab>{};
+    auto prefab_indices = StringMap<std::uint32_t>{};
+    auto entities = std::vector<SceneSnapshotEntity>{};
+    auto rigid_bodies = std::vector<SceneSnapshotRigidBody>{};
+
+    entities.reserve(description.entities.size());
+
+    for (const auto &entity : description.entities)
+    {
+        const auto [prefab, inserted] =
+            prefab_indices.try_emplace(entity.name, static_cast<std::uint32_t>(prefabs.size()));
+        if (inserted)
+        {
+            prefabs.push_back({
+                .offset = static_cast<std::uint32_t>(names.size()),
+                .size = static_cast<std::uint32_t>(entity.name.size()),
+            });
+            names.append(entity.name);
+        }
+
+        entities.push_back({
+            .transform = entity.transform,
+            .emissive_strength = entity.emissive_strength,
+            .prefab = prefab->second,
+            .first_rigid_body = static_cast<std::uint32_t>(rigid_bodies.size()),
+            .rigid_body_count = static_cast<std::uint32_t>(entity.rigid_bodies.size()),
+        });
+
+        for (const auto &rigid_body : entity.rigid_bodies)
+        {
+            auto &record = rigid_bodies.emplace_back();
+            std::ranges::copy(rigid_body.local_transform.data(), std::ranges::begin(record.local_transform));
+        }
+    }
+
+    const auto lights = description.lights.lights.data();
+
+    const auto header = SceneSnapshotHeader{
+        .magic = scene_snapshot_magic,
+        .version = scene_snapshot_version,
+        .light_count = static_cast<std::uint32_t>(lights.size()),
+        .entity_count = static_cast<std::uint32_t>(entities.size()),
+        .rigid_body_count = static_cast<std::uint32_t>(rigid_bodies.size()),
+        .prefab_count = static_cast<std::uint32_t>(prefabs.size()),
+        .names_size = static_cast<std::uint32_t>(names.size()),
+        .settings_size = static_cast<std::uint32_t>(settings->size()),
+    };
+
+    auto snapshot = DataBuffer{};
+    flat_records::append(snapshot, std::span{&header, 1zu});
+    flat_records::append(snapshot, lights);
+    flat_records::append(snapshot, std::span<const SceneSnapshotEntity>{entities});
+    flat_records::append(snapshot, std::span<const SceneSnapshotRigidBody>{rigid_bodies});
+    flat_records::append(snapshot, std::span<const SceneSnapshotPrefab>{prefabs});
+    flat_records::append(snapshot, std::span<const char>{names});
+    snapshot.append_range(*settings);
+
+    return snapshot;
+}
+
+SceneSnapshot::SceneSnapshot(DataBufferView data)
+    : lights_{}
+    , entities_{}
+    , rigid_bodies_{}
+    , prefabs_{}
+    , names_{}
+    , settings_{}
+{
+    // lights are the most strictly aligned records, mapped files and heap allocations are aligned for them
+    ensure(
+        reinterpret_cast<std::uintptr_t>(data.data()) % alignof(PointLight) == 0zu,
+        "scene snapshot data is not aligned");
+
+    auto offset = 0zu;
+    const auto header = flat_records::section<SceneSnapshotHeader>(format_name, data, offset, 1zu).front();
+    ensure(header.magic == scene_snapshot_magic, "not a scene snapshot");
+    ensure(header.version == scene_snapshot_version, "unsupported scene snapshot version: {}", header.version);
+
+    lights_ = flat_records::section<PointLight>(format_name, data, offset, header.light_count);
+    entities_ = flat_records::section<SceneSnapshotEntity>(format_name, data, offset, header.entity_count);
+    rigid_bodies_ = flat_records::section<SceneSnapshotRigidBody>(format_name, data, offset, header.rigid_body_count);
+    prefabs_ = flat_records::section<SceneSnapshotPrefab>(format_name, data, offset, header.prefab_count);
+
+    const auto names = flat_records::section<char>(format_name, data, offset, header.names_size);
+    names_ = std::string_view{names.data(), names.size()};
+
+    settings_ = flat_records::section<std::byte>(format_name, data, offset, header.settings_size);
+    ensure(offset == data.size(), "scene snapshot has {} trailing bytes", data.size() - offset);
+
+    for (const auto &entity : entities_)
+    {
+        flat_records::check_range(format_name, entity.prefab, 1u, prefabs_.size(), "prefab");
+        flat_records::check_range(
+            format_name, entity.first_rigid_body, entity.rigid_body_count, rigid_bodies_.size(), "rigid body");
+    }
+
+    for (const auto &prefab : prefabs_)
+    {
+        flat_records::check_range(format_name, prefab.offset, prefab.size, names_.size(), "name");
+    }
+}
+
+auto SceneSnapshot::lights() const -> std::span<const PointLight>
+{
+    return lights_;
+}
+
+auto SceneSnapshot::entities() const -> std::span<const SceneSnapshotEntity>
+{
+    return entities_;
+}
+
+auto SceneSnapshot::rigid_bodies() const -> std::span<const SceneSnapshotRigidBody>
+{
+    return rigid_bodies_;
+}
+
+auto SceneSnapshot::prefabs() const -> std::span<const SceneSnapshotPrefab>
+{
+    return prefabs_;
+}
+
+auto SceneSnapshot::prefab_name(const SceneSnapshotPrefab &prefab) const -> std::string_view
+{
+    return names_.substr(prefab.offset, prefab.size);
+}
+
+auto SceneSnapshot::settings() const -> Scene::Description
+{
+    auto settings = binary::deserialise<Scene::Description>(settings_);
+    ensure(settings);
+
+    return std::move(*settings);
+}
+
+auto load_scene(const SceneSnapshot &snapshot, const StringMap<Entity> &entity_cache) -> Scene
+{
+    auto settings = snapshot.settings();
+    for (const auto &light : snapshot.lights())
+    {
+        settings.lights.lights.emplace(light);
+    }
+
+    auto scene = Scene{settings, entity_cache};
+
+    const auto prefabs = snapshot.prefabs() |
+                         std::views::transform(
+                             [&](const auto &prefab)
+                             {
+                                 const auto name = snapshot.prefab_name(prefab);
+                                 const auto cached = entity_cache.find(name);
+                                 ensure(cached != std::ranges::cend(entity_cache), "unknown entity: {}", name);
+
+                                 return std::addressof(cached->second);
+                             }) |
+                         std::ranges::to<std::vector>();
+
+    const auto rigid_body_descriptions =
+        snapshot.rigid_bodies() |
+        std::views::transform(
+            [](const auto &e)
+            {
+                return RigidBody::Description{
+                    .local_transform = Matrix4{e.local_transform}, .applied_scale = Vector3{1.0f}};
+            }) |
+        std::ranges::to<std::vector>();
+    const auto rigid_bodies = service<PhysicsSystem>().create_rigid_bodies(rigid_body_descriptions);
+
+    auto entities = std::vector<Entity>{};
+    entities.reserve(snapshot.entities().size());
+
+    for (const auto &entity : snapshot.entities())
+    {
+        auto &new_entity = entities.emplace_back(*prefabs[entity.prefab]);
+        new_entity.set_transform(entity.transform);
+        new_entity.set_emissive_strength(entity.emissive_strength);
+
+        for (const auto handle : std::span{rigid_bodies}.subspan(entity.first_rigid_body, entity.rigid_body_count))
+        {
+            new_entity.add_rigid_body(handle);
+        }
+    }
+
+    scene.add_entities(std::move(entities));
+
+    return scene;
+}
+
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <type_traits>
+
+#include "core/entity.h"
+#include "core/scene.h"
+#include "graphics/point_light.h"
+#include "maths/transform.h"
+#include "serialisation/binary_serialiser.h"
+#include "utils/data_buffer.h"
+#include "utils/string_map.h"
+
+namespace ufps
+{
+
+inline constexpr auto scene_snapshot_magic = 0x53504655u; // "UFPS"
+inline constexpr auto scene_snapshot_version = 1u;
+
+/**
+ * A snapshot is a header, arrays of fixed size light, entity, rigid body and prefab records, a table of names and then
+ * the scene settings written with the binary serialiser. Lights come first so they stay 16 byte aligned.
+ */
+struct SceneSnapshotHeader
+{
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint32_t light_count;
+    std::uint32_t entity_count;
+    std::uint32_t rigid_body_count;
+    std::uint32_t prefab_count;
+    std::uint32_t names_size;
+    std::uint32_t settings_size;
+};
+
+/**
+ * Prefab is an index into the prefab records, whose names are keys into the entity cache.
+ */
+struct SceneSnapshotEntity
+{
+    Transform transform;
+    float emissive_strength;
+    std::uint32_t prefab;
+    std::uint32_t first_rigid_body;
+    std::uint32_t rigid_body_count;
+};
+
+struct SceneSnapshotRigidBody
+{
+    std::array<float, 16zu> local_transform;
+};
+
+struct SceneSnapshotPrefab
+{
+    std::uint32_t offset;
+    std::uint32_t size;
+};
+
+static_assert(binary::FixedLayout<SceneSnapshotHeader>, "snapshot headers are written to disk as is");
+static_assert(binary::FixedLayout<SceneSnapshotEntity>, "snapshot records are written to disk as is");
+static_assert(binary::FixedLayout<SceneSnapshotRigidBody>, "snapshot records are written to disk as is");
+static_assert(binary::FixedLayout<SceneSnapshotPrefab>, "snapshot records are written to disk as is");
+static_assert(std::is_trivially_copyable_v<PointLight>, "snapshot lights are written to disk as is");
+static_assert(sizeof(SceneSnapshotHeader) == 32zu);
+static_assert(sizeof(SceneSnapshotEntity) == 56zu);
+static_assert(sizeof(SceneSnapshotRigidBody) == 64zu);
+static_assert(sizeof(SceneSnapshotPrefab) == 8zu);
+static_assert(sizeof(SceneSnapshotHeader) % alignof(PointLight) == 0zu);
+
+/**
+ * Bake a scene description into a snapshot. Entities refer to their prefab by index so each name is stored once.
+ */
+auto encode_scene_snapshot(const Scene::Description &description) -> DataBuffer;
+
+/**
+ * Read only view of a scene snapshot, the data must outlive the snapshot. Every record is bounds checked on
+ * construction so accessing them afterwards is just pointer arithmetic.
+ */
+class SceneSnapshot
+{
+  public:
+    SceneSnapshot(DataBufferView data);
+
+    auto lights() const -> std::span<const PointLight>;
+    auto entities() const -> std::span<const SceneSnapshotEntity>;
+    auto rigid_bodies() const -> std::span<const SceneSnapshotRigidBody>;
+    auto prefabs() const -> std::span<const SceneSnapshotPrefab>;
+
+    auto prefab_name(const SceneSnapshotPrefab &prefab) const -> std::string_view;
+
+    /**
+     * Scene settings and ambient light, without any lights or entities.
+     */
+    auto settings() const -> Scene::Description;
+
+  private:
+    std::span<const PointLight> lights_;
+    std::span<const SceneSnapshotEntity> entities_;
+    std::span<const SceneSnapshotRigidBody> rigid_bodies_;
+    std::span<const SceneSnapshotPrefab> prefabs_;
+    std::string_view names_;
+    DataBufferView settings_;
+};
+
+/**
+ * Build a scene from a snapshot. Prefabs are looked up once rather than per entity and all the rigid bodies are added
+ * to the physics system in one batch.
+ */
+auto load_scene(const SceneSnapshot &snapshot, const StringMap<Entity> &entity_cache) -> Scene;
+
+}
@@ -9,16 +9,25 @@ namespace ufps
 {
 
 class AwaitableManager;
+class GpuFence;
+class MaterialManager;
 class MeshManager;
 class PhysicsSystem;
 class TextureManager;
+class TextureStreamer;
 class ThreadPool;
 
+template <class Fence>
+class DeferredRelease;
+
 using Services = std::tuple<
     std::unique_ptr<AwaitableManager>,
+    std::unique_ptr<DeferredRelease<GpuFence>>,
+    std::unique_ptr<MaterialManager>,
     std::unique_ptr<MeshManager>,
     std::unique_ptr<PhysicsSystem>,
     std::unique_ptr<TextureManager>,
+    std::unique_ptr<TextureStreamer>,
     std::unique_ptr<ThreadPool>>;
 
 namespace impl
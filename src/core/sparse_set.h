@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <limits>
@@ -76,6 +77,7 @@ class SparseSet
         }
 
         dense_.push_back(sparse_index);
+        dirty_.push_back(true);
 
         return handle_type{sparse_index, version};
     }
@@ -108,6 +110,12 @@ class SparseSet
             return std::optional<RetType>{};
         }
 
+        if constexpr (!std::is_const_v<std::remove_reference_t<S>>)
+        {
+            // we hand out a mutable reference so have to assume the caller modifies it
+            self.dirty_[dense_index] = true;
+        }
+
         return std::optional<RetType>(self.data_[dense_index]);
     }
 
@@ -121,6 +129,13 @@ class SparseSet
 
     constexpr auto data() const -> std::span<const T>;
 
+    /**
+     * Indices into data() of elements which have been added, moved or accessed mutably since the last clear_dirty().
+     */
+    constexpr auto dirty_indices() const -> std::vector<std::size_t>;
+
+    constexpr auto clear_dirty() -> void;
+
   private:
     template <class U>
     using VectorRebind = std::vector<U, typename std::allocator_traits<Allocator>::template rebind_alloc<U>>;
@@ -128,6 +143,7 @@ class SparseSet
     VectorRebind<std::uint32_t> dense_;
     std::vector<T, Allocator> data_;
     VectorRebind<std::size_t> free_;
+    VectorRebind<bool> dirty_;
 };
 
 template <class T, class Allocator>
@@ -135,6 +151,8 @@ constexpr SparseSet<T, Allocator>::SparseSet()
     : sparse_{}
     , dense_{}
     , data_{}
+    , free_{}
+    , dirty_{}
 {
 }
 
@@ -165,6 +183,7 @@ constexpr auto SparseSet<T, Allocator>::remove(handle_type handle)
     {
         data_.pop_back();
         dense_.pop_back();
+        dirty_.pop_back();
         sparse_[sparse_index].index_ = handle_type::Invalid;
         free_.push_back(sparse_index);
 
@@ -176,6 +195,10 @@ constexpr auto SparseSet<T, Allocator>::remove(handle_type handle)
     std::ranges::swap(dense_[sparse_[sparse_index].index_], *(std::ranges::end(dense_) - 1u));
     dense_.pop_back();
 
+    // the last element now lives in the removed slot
+    dirty_[dense_index] = true;
+    dirty_.pop_back();
+
     sparse_[sparse_index].index_ = handle_type::Invalid;
     free_.push_back(sparse_index);
 
@@ -210,4 +233,17 @@ constexpr auto SparseSet<T, Allocator>::data() const -> std::span<const T>
     return data_;
 }
 
+template <class T, class Allocator>
+constexpr auto SparseSet<T, Allocator>::dirty_indices() const -> std::vector<std::size_t>
+{
+    return std::views::iota(0zu, std::ranges::size(dirty_)) |
+           std::views::filter([this](auto index) { return dirty_[index]; }) | std::ranges::to<std::vector>();
+}
+
+template <class T, class Allocator>
+constexpr auto SparseSet<T, Allocator>::clear_dirty() -> void
+{
+    std::ranges::fill(dirty_, false);
+}
+
 }
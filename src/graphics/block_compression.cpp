@@ -0,0 +1,723 @@
+#include "graphics/block_compression.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "graphics/mip_chain.h"
+#include "graphics/texture_data.h"
+#include "utils/data_buffer.h"
+#include "utils/error.h"
+#include "utils/exception.h"
+#include "utils/formatter.h"
+
+namespace
+{
+
+using Texel = std::array<std::uint8_t, 4u>;
+using Block = std::array<Texel, 16u>;
+using EncodedBlock = std::array<std::byte, 16u>;
+using Vector = std::array<float, 4u>;
+
+constexpr auto block_size = 4u;
+constexpr auto block_bytes = 16zu;
+constexpr auto bc7_mode = 6u;
+constexpr auto bc7_weights = std::array{0u, 4u, 9u, 13u, 17u, 21u, 26u, 30u, 34u, 38u, 43u, 47u, 51u, 55u, 60u, 64u};
+constexpr auto power_iterations = 8u;
+constexpr auto refine_iterations = 2u;
+
+/**
+ * Single subset block with 7 bit rgba endpoints, a unique p bit per endpoint and 4 bit indices. Endpoints are stored
+ * expanded to 8 bits so every channel of an endpoint shares its lowest bit.
+ */
+struct Bc7Mode6
+{
+    std::array<Texel, 2u> endpoints;
+    std::array<std::uint8_t, 16u> indices;
+    std::uint32_t error;
+};
+
+/**
+ * Range of blocks belonging to one level, blocks are numbered across the whole chain in the order they are stored.
+ */
+struct LevelBlocks
+{
+    std::span<const std::byte> data;
+    std::uint32_t width;
+    std::uint32_t height;
+    std::uint32_t blocks_x;
+    std::size_t first_block;
+};
+
+/**
+ * Blocks are little endian bit streams with fields written from the least significant bit up.
+ */
+class BitWriter
+{
+  public:
+    BitWriter()
+        : block_{}
+        , position_{}
+    {
+    }
+
+    auto write(std::uint32_t value, std::uint32_t bits) -> void
+    {
+        for (auto bit = 0u; bit < bits; ++bit, ++position_)
+        {
+            if (((value >> bit) & 1u) != 0u)
+            {
+                block_[position_ / 8u] |= static_cast<std::byte>(1u << (position_ % 8u));
+            }
+        }
+    }
+
+    auto block() const -> const EncodedBlock &
+    {
+        return block_;
+    }
+
+  private:
+    EncodedBlock block_;
+    std::uint32_t position_;
+};
+
+class BitReader
+{
+  public:
+    BitReader(std::span<const std::byte> block)
+        : block_{block}
+        , position_{}
+    {
+    }
+
+    auto read(std::uint32_t bits) -> std::uint32_t
+    {
+        auto value = 0u;
+
+        for (auto bit = 0u; bit < bits; ++bit, ++position_)
+        {
+            value |= ((std::to_integer<std::uint32_t>(block_[position_ / 8u]) >> (position_ % 8u)) & 1u) << bit;
+        }
+
+        return value;
+    }
+
+  private:
+    std::span<const std::byte> block_;
+    std::uint32_t position_;
+};
+
+auto channel_count(ufps::TextureFormat format) -> std::size_t
+{
+    switch (format)
+    {
+        using enum ufps::TextureFormat;
+
+        case RED: return 1zu;
+        case RGB:
+        case SRGB: return 3zu;
+        case RGBA:
+        case SRGBA: return 4zu;
+        default: throw ufps::Exception("texture format does not have 8 bit channels: {}", format);
+    }
+}
+
+/**
+ * Texels past the edge of the level clamp to it, channels the source lacks read as zero with an opaque alpha.
+ */
+auto load_block(const LevelBlocks &level, std::size_t channels, std::uint32_t block_x, std::uint32_t block_y) -> Block
+{
+    auto block = Block{};
+
+    for (auto y = 0u; y < block_size; ++y)
+    {
+        for (auto x = 0u; x < block_size; ++x)
+        {
+            const auto source_x = std::min((block_x * block_size) + x, level.width - 1u);
+            const auto source_y = std::min((block_y * block_size) + y, level.height - 1u);
+            const auto offset = ((static_cast<std::size_t>(source_y) * level.width) + source_x) * channels;
+
+            auto &texel = block[(y * block_size) + x];
+            texel = {0u, 0u, 0u, 255u};
+
+            for (auto channel = 0zu; channel < channels; ++channel)
+            {
+                texel[channel] = std::to_integer<std::uint8_t>(level.data[offset + channel]);
+            }
+        }
+    }
+
+    return block;
+}
+
+auto interpolate(const std::array<Texel, 2u> &endpoints, std::uint32_t index) -> Texel
+{
+    const auto weight = bc7_weights[index];
+    auto texel = Texel{};
+
+    for (auto channel = 0zu; channel < texel.size(); ++channel)
+    {
+        texel[channel] = static_cast<std::uint8_t>(
+            (((64u - weight) * endpoints[0][channel]) + (weight * endpoints[1][channel]) + 32u) >> 6u);
+    }
+
+    return texel;
+}
+
+auto length(const Vector &v) -> float
+{
+    return std::sqrt(std::ranges::fold_left(v, 0.0f, [](auto sum, auto e) { return sum + (e * e); }));
+}
+
+auto squared_error(const Texel &a, const Texel &b) -> std::uint32_t
+{
+    auto error = 0u;
+
+    for (auto channel = 0zu; channel < a.size(); ++channel)
+    {
+        const auto diff = static_cast<std::int32_t>(a[channel]) - static_cast<std::int32_t>(b[channel]);
+        error += static_cast<std::uint32_t>(diff * diff);
+    }
+
+    return error;
+}
+
+/**
+ * Pick the closest palette entry for every texel.
+ */
+auto fit_indices(const Block &block, const std::array<Texel, 2u> &endpoints) -> Bc7Mode6
+{
+    auto palette = std::array<Texel, 16u>{};
+    for (auto index = 0u; index < palette.size(); ++index)
+    {
+        palette[index] = interpolate(endpoints, index);
+    }
+
+    auto fit = Bc7Mode6{.endpoints = endpoints, .indices = {}, .error = 0u};
+
+    for (const auto &[texel_index, texel] : std::views::enumerate(block))
+    {
+        auto best = std::numeric_limits<std::uint32_t>::max();
+
+        for (const auto &[index, entry] : std::views::enumerate(palette))
+        {
+            if (const auto error = squared_error(texel, entry); error < best)
+            {
+                best = error;
+                fit.indices[texel_index] = static_cast<std::uint8_t>(index);
+            }
+        }
+
+        fit.error += best;
+    }
+
+    return fit;
+}
+
+/**
+ * Round ideal endpoints to 7 bits plus a p bit, trying every combination of p bits.
+ */
+auto quantise(const Block &block, const Vector &start, const Vector &end) -> Bc7Mode6
+{
+    auto best = Bc7Mode6{.endpoints = {}, .indices = {}, .error = std::numeric_limits<std::uint32_t>::max()};
+
+    for (auto p_bits = 0u; p_bits < 4u; ++p_bits)
+    {
+        auto endpoints = std::array<Texel, 2u>{};
+
+        for (const auto &[endpoint, ideal] : std::views::enumerate(std::array{start, end}))
+        {
+            const auto p_bit = (p_bits >> endpoint) & 1u;
+
+            for (auto channel = 0zu; channel < ideal.size(); ++channel)
+            {
+                const auto value = std::clamp(std::round((ideal[channel] - p_bit) / 2.0f), 0.0f, 127.0f);
+                endpoints[endpoint][channel] =
+                    static_cast<std::uint8_t>((static_cast<std::uint32_t>(value) << 1u) | p_bit);
+            }
+        }
+
+        if (auto fit = fit_indices(block, endpoints); fit.error < best.error)
+        {
+            best = fit;
+        }
+    }
+
+    return best;
+}
+
+/**
+ * Endpoints minimising the squared error for fixed indices, nullopt if every texel uses the same weight.
+ */
+auto least_squares_endpoints(const Block &block, const Bc7Mode6 &fit) -> std::optional<std::pair<Vector, Vector>>
+{
+    auto a = 0.0f;
+    auto b = 0.0f;
+    auto c = 0.0f;
+    auto start_sum = Vector{};
+    auto end_sum = Vector{};
+
+    for (const auto &[texel, index] : std::views::zip(block, fit.indices))
+    {
+        const auto alpha = static_cast<float>(bc7_weights[index]) / 64.0f;
+        a += (1.0f - alpha) * (1.0f - alpha);
+        b += alpha * (1.0f - alpha);
+        c += alpha * alpha;
+
+        for (auto channel = 0zu; channel < texel.size(); ++channel)
+        {
+            start_sum[channel] += (1.0f - alpha) * texel[channel];
+            end_sum[channel] += alpha * texel[channel];
+        }
+    }
+
+    const auto determinant = (a * c) - (b * b);
+    if (std::abs(determinant) < 1e-6f)
+    {
+        return std::nullopt;
+    }
+
+    auto start = Vector{};
+    auto end = Vector{};
+
+    for (auto channel = 0zu; channel < start.size(); ++channel)
+    {
+        start[channel] = ((c * start_sum[channel]) - (b * end_sum[channel])) / determinant;
+        end[channel] = ((a * end_sum[channel]) - (b * start_sum[channel])) / determinant;
+    }
+
+    return std::pair{start, end};
+}
+
+/**
+ * Endpoints at the extremes of the block along its principal axis.
+ */
+auto principal_endpoints(const Block &block) -> std::pair<Vector, Vector>
+{
+    auto mean = Vector{};
+    for (const auto &texel : block)
+    {
+        for (auto channel = 0zu; channel < mean.size(); ++channel)
+        {
+            mean[channel] += texel[channel] / 16.0f;
+        }
+    }
+
+    auto covariance = std::array<Vector, 4u>{};
+    for (const auto &texel : block)
+    {
+        for (auto row = 0zu; row < 4zu; ++row)
+        {
+            for (auto column = 0zu; column < 4zu; ++column)
+            {
+                covariance[row][column] += (texel[row] - mean[row]) * (texel[column] - mean[column]);
+            }
+        }
+    }
+
+    // the channel varying the most can't be orthogonal to the principal axis so is a safe place to start
+    const auto largest = std::ranges::max(std::views::iota(0zu, 4zu), {}, [&](auto i) { return covariance[i][i]; });
+    if (covariance[largest][largest] < 1e-6f)
+    {
+        // every texel is the same colour
+        return {mean, mean};
+    }
+
+    auto axis = covariance[largest];
+    for (auto iteration = 0u; iteration < power_iterations; ++iteration)
+    {
+        const auto axis_length = length(axis);
+        if (axis_length < 1e-6f)
+        {
+            return {mean, mean};
+        }
+
+        auto next = Vector{};
+        for (auto row = 0zu; row < 4zu; ++row)
+        {
+            for (auto column = 0zu; column < 4zu; ++column)
+            {
+                next[row] += covariance[row][column] * axis[column] / axis_length;
+            }
+        }
+
+        axis = next;
+    }
+
+    const auto axis_length = length(axis);
+    std::ranges::transform(axis, std::ranges::begin(axis), [axis_length](auto v) { return v / axis_length; });
+
+    auto min_t = std::numeric_limits<float>::max();
+    auto max_t = std::numeric_limits<float>::lowest();
+
+    for (const auto &texel : block)
+    {
+        auto t = 0.0f;
+        for (auto channel = 0zu; channel < axis.size(); ++channel)
+        {
+            t += (texel[channel] - mean[channel]) * axis[channel];
+        }
+
+        min_t = std::min(min_t, t);
+        max_t = std::max(max_t, t);
+    }
+
+    auto start = Vector{};
+    auto end = Vector{};
+
+    for (auto channel = 0zu; channel < axis.size(); ++channel)
+    {
+        start[channel] = mean[channel] + (axis[channel] * min_t);
+        end[channel] = mean[channel] + (axis[channel] * max_t);
+    }
+
+    return {start, end};
+}
+
+auto encode_bc7_block(const Block &block) -> EncodedBlock
+{
+    const auto [start, end] = principal_endpoints(block);
+    auto best = quantise(block, start, end);
+
+    for (auto iteration = 0u; iteration < refine_iterations && best.error != 0u; ++iteration)
+    {
+        const auto refined = least_squares_endpoints(block, best);
+        if (!refined)
+        {
+            break;
+        }
+
+        const auto fit = quantise(block, refined->first, refined->second);
+        if (fit.error >= best.error)
+        {
+            break;
+        }
+
+        best = fit;
+    }
+
+    // the first index has an implicit zero high bit so the endpoints are swapped if it would need one
+    if (best.indices[0] >= 8u)
+    {
+        std::ranges::swap(best.endpoints[0], best.endpoints[1]);
+        std::ranges::transform(
+            best.indices, std::ranges::begin(best.indices), [](auto i) { return static_cast<std::uint8_t>(15u - i); });
+    }
+
+    auto writer = BitWriter{};
+    writer.write(1u << bc7_mode, bc7_mode + 1u);
+
+    for (auto channel = 0zu; channel < 4zu; ++channel)
+    {
+        for (const auto &endpoint : best.endpoints)
+        {
+            writer.write(endpoint[channel] >> 1u, 7u);
+        }
+    }
+
+    for (const auto &endpoint : best.endpoints)
+    {
+        writer.write(endpoint[0] & 1u, 1u);
+    }
+
+    for (const auto &[texel, index] : std::views::enumerate(best.indices))
+    {
+        writer.write(index, texel == 0 ? 3u : 4u);
+    }
+
+    return writer.block();
+}
+
+auto decode_bc7_block(std::span<const std::byte> data) -> Block
+{
+    const auto mode = std::countr_zero(std::to_integer<std::uint8_t>(data[0]));
+    ufps::ensure(mode == bc7_mode, "only bc7 mode {} blocks can be decoded, found mode {}", bc7_mode, mode);
+
+    auto reader = BitReader{data};
+    reader.read(bc7_mode + 1u);
+
+    auto endpoints = std::array<Texel, 2u>{};
+
+    for (auto channel = 0zu; channel < 4zu; ++channel)
+    {
+        for (auto &endpoint : endpoints)
+        {
+            endpoint[channel] = static_cast<std::uint8_t>(reader.read(7u) << 1u);
+        }
+    }
+
+    for (auto &endpoint : endpoints)
+    {
+        const auto p_bit = static_cast<std::uint8_t>(reader.read(1u));
+        std::ranges::transform(endpoint, std::ranges::begin(endpoint), [p_bit](auto v) { return v | p_bit; });
+    }
+
+    auto block = Block{};
+
+    for (auto texel = 0zu; texel < block.size(); ++texel)
+    {
+        block[texel] = interpolate(endpoints, reader.read(texel == 0zu ? 3u : 4u));
+    }
+
+    return block;
+}
+
+auto bc4_palette(std::uint32_t red_0, std::uint32_t red_1) -> std::array<std::uint8_t, 8u>
+{
+    auto palette = std::array<std::uint8_t, 8u>{static_cast<std::uint8_t>(red_0), static_cast<std::uint8_t>(red_1)};
+
+    if (red_0 > red_1)
+    {
+        for (auto index = 2u; index < 8u; ++index)
+        {
+            palette[index] = static_cast<std::uint8_t>((((8u - index) * red_0) + ((index - 1u) * red_1) + 3u) / 7u);
+        }
+    }
+    else
+    {
+        for (auto index = 2u; index < 6u; ++index)
+        {
+            palette[index] = static_cast<std::uint8_t>((((6u - index) * red_0) + ((index - 1u) * red_1) + 2u) / 5u);
+        }
+
+        palette[6] = 0u;
+        palette[7] = 255u;
+    }
+
+    return palette;
+}
+
+/**
+ * A single channel of the block as bc4, endpoints are the channel extremes so every palette entry is in range.
+ */
+auto write_bc4(BitWriter &writer, const Block &block, std::size_t channel) -> void
+{
+    const auto [min, max] =
+        std::ranges::minmax(block | std::views::transform([channel](const auto &texel) { return texel[channel]; }));
+    const auto palette = bc4_palette(max, min);
+
+    writer.write(max, 8u);
+    writer.write(min, 8u);
+
+    for (const auto &texel : block)
+    {
+        const auto closest = std::ranges::min_element(
+            palette,
+            {},
+            [value = texel[channel]](auto entry) { return std::abs(static_cast<std::int32_t>(entry) - value); });
+
+        writer.write(static_cast<std::uint32_t>(std::ranges::distance(std::ranges::begin(palette), closest)), 3u);
+    }
+}
+
+auto read_bc4(BitReader &reader, Block &block, std::size_t channel) -> void
+{
+    const auto red_0 = reader.read(8u);
+    const auto red_1 = reader.read(8u);
+    const auto palette = bc4_palette(red_0, red_1);
+
+    for (auto &texel : block)
+    {
+        texel[channel] = palette[reader.read(3u)];
+    }
+}
+
+auto encode_bc5_block(const Block &block) -> EncodedBlock
+{
+    auto writer = BitWriter{};
+    write_bc4(writer, block, 0zu);
+    write_bc4(writer, block, 1zu);
+
+    return writer.block();
+}
+
+auto decode_bc5_block(std::span<const std::byte> data) -> Block
+{
+    auto block = Block{};
+    auto reader = BitReader{data};
+    read_bc4(reader, block, 0zu);
+    read_bc4(reader, block, 1zu);
+
+    return block;
+}
+
+auto level_blocks(const ufps::TextureData &texture) -> std::vector<LevelBlocks>
+{
+    ufps::ensure(texture.data.has_value(), "texture has no data");
+
+    auto levels = std::vector<LevelBlocks>{};
+    auto offset = 0zu;
+    auto first_block = 0zu;
+
+    for (auto level = 0u; level < texture.mip_levels; ++level)
+    {
+        const auto width = ufps::mip_extent(texture.width, level);
+        const auto height = ufps::mip_extent(texture.height, level);
+        const auto size = ufps::mip_level_size(texture.format, width, height);
+        const auto blocks_x = (width + block_size - 1u) / block_size;
+        const auto blocks_y = (height + block_size - 1u) / block_size;
+
+        ufps::ensure(texture.data->size() >= offset + size, "texture data is smaller than its mip chain");
+
+        levels.push_back({
+            .data = std::span{*texture.data}.subspan(offset, size),
+            .width = width,
+            .height = height,
+            .blocks_x = blocks_x,
+            .first_block = first_block,
+        });
+
+        offset += size;
+        first_block += static_cast<std::size_t>(blocks_x) * blocks_y;
+    }
+
+    // sentinel so the block count is the first block of the level after the last
+    levels.push_back({.data = {}, .width = 0u, .height = 0u, .blocks_x = 0u, .first_block = first_block});
+
+    return levels;
+}
+
+auto encode_blocks(
+    std::span<const LevelBlocks> levels,
+    std::size_t channels,
+    ufps::TextureFormat format,
+    std::size_t first,
+    std::size_t last,
+    ufps::DataBuffer &compressed) -> void
+{
+    for (auto index = first; index < last; ++index)
+    {
+        // the level holding a block is the last one starting at or before it
+        const auto level = std::ranges::prev(std::ranges::upper_bound(levels, index, {}, &LevelBlocks::first_block));
+        const auto local = index - level->first_block;
+        const auto block = load_block(
+            *level,
+            channels,
+            static_cast<std::uint32_t>(local % level->blocks_x),
+            static_cast<std::uint32_t>(local / level->blocks_x));
+
+        const auto encoded = format == ufps::TextureFormat::BC5U ? encode_bc5_block(block) : encode_bc7_block(block);
+        std::ranges::copy(encoded, std::ranges::begin(compressed) + (index * block_bytes));
+    }
+}
+
+/**
+ * Output texture taking ownership of the encoded blocks.
+ */
+auto compressed_texture(const ufps::TextureData &texture, ufps::TextureFormat format, ufps::DataBuffer &&blocks)
+    -> ufps::TextureData
+{
+    return {
+        .width = texture.width,
+        .height = texture.height,
+        .mip_levels = texture.mip_levels,
+        .format = format,
+        .data = std::move(blocks),
+        .is_compressed = true,
+    };
+}
+
+auto validate(const ufps::TextureData &texture, ufps::TextureFormat format) -> void
+{
+    ufps::ensure(!texture.is_compressed, "texture is already compressed");
+    ufps::ensure(texture.mip_levels != 0u, "texture has no levels");
+    ufps::ensure(
+        (format == ufps::TextureFormat::BC5U) || (format == ufps::TextureFormat::BC7) ||
+            (format == ufps::TextureFormat::BC7_SRGB),
+        "cannot compress to {}",
+        format);
+}
+
+}
+
+namespace ufps
+{
+
+auto compress_texture(const TextureData &texture, TextureFormat format) -> TextureData
+{
+    validate(texture, format);
+
+    const auto channels = channel_count(texture.format);
+    const auto levels = level_blocks(texture);
+    const auto block_count = levels.back().first_block;
+
+    auto blocks = DataBuffer(block_count * block_bytes);
+    encode_blocks(levels, channels, format, 0zu, block_count, blocks);
+
+    return compressed_texture(texture, format, std::move(blocks));
+}
+
+auto compression_psnr(const TextureData &source, const TextureData &compressed) -> float
+{
+    ensure(
+        (source.width == compressed.width) && (source.height == compressed.height) &&
+            (source.mip_levels == compressed.mip_levels),
+        "compressed texture is not the same shape as its source");
+    ensure(compressed.data.has_value(), "compressed texture has no data");
+
+    const auto is_bc5 = compressed.format == TextureFormat::BC5U;
+    const auto channels = channel_count(source.format);
+    const auto compared_channels = is_bc5 ? 2zu : 4zu;
+    const auto levels = level_blocks(source);
+    ensure(compressed.data->size() >= levels.back().first_block * block_bytes, "compressed texture is truncated");
+
+    auto squared_error = 0.0;
+    auto samples = 0zu;
+
+    for (const auto &level : levels | std::views::take(levels.size() - 1zu))
+    {
+        const auto blocks_y = (level.height + block_size - 1u) / block_size;
+
+        for (auto block_y = 0u; block_y < blocks_y; ++block_y)
+        {
+            for (auto block_x = 0u; block_x < level.blocks_x; ++block_x)
+            {
+                const auto index = level.first_block + (static_cast<std::size_t>(block_y) * level.blocks_x) + block_x;
+                const auto data = std::span{*compressed.data}.subspan(index * block_bytes, block_bytes);
+                const auto expected = load_block(level, channels, block_x, block_y);
+                const auto actual = is_bc5 ? decode_bc5_block(data) : decode_bc7_block(data);
+
+                for (auto y = 0u; y < block_size; ++y)
+                {
+                    for (auto x = 0u; x < block_size; ++x)
+                    {
+                        // clamped texels past the edge aren't part of the image
+                        if (((block_x * block_size) + x >= level.width) || ((block_y * block_size) + y >= level.height))
+                        {
+                            continue;
+                        }
+
+                        const auto texel = (y * block_size) + x;
+
+                        for (auto channel = 0zu; channel < compared_channels; ++channel)
+                        {
+                            const auto diff = static_cast<double>(expected[texel][channel]) - actual[texel][channel];
+                            squared_error += diff * diff;
+                        }
+
+                        samples += compared_channels;
+                    }
+                }
+            }
+        }
+    }
+
+    if (squared_error == 0.0)
+    {
+        return std::numeric_limits<float>::infinity();
+    }
+
+    return static_cast<float>(10.0 * std::log10((255.0 * 255.0 * static_cast<double>(samples)) / squared_error));
+}
+
+}
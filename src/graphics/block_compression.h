@@ -0,0 +1,21 @@
+#pragma once
+
+#include "graphics/texture_data.h"
+
+namespace ufps
+{
+
+/**
+ * Encode every level of an uncompressed 8 bit texture to BC7 or BC5. BC7 keeps all four channels, ones the source
+ * lacks are filled in as a gl upload would, BC5 keeps the first two which is all a tangent space normal needs.
+ */
+auto compress_texture(const TextureData &texture, TextureFormat format) -> TextureData;
+
+/**
+ * Peak signal to noise ratio, in dB, of a compressed texture against the texture it was encoded from over every level
+ * and every channel the compressed format keeps. Infinite if they are identical. Only decodes the BC7 mode written by
+ * compress_texture.
+ */
+auto compression_psnr(const TextureData &source, const TextureData &compressed) -> float;
+
+}
@@ -7,26 +7,14 @@
 #include <span>
 #include <string>
 
-#include "core/scene.h"
+#include "core/entity.h"
+#include "graphics/indirect_command.h"
 #include "graphics/multi_buffer.h"
 #include "graphics/opengl.h"
 #include "graphics/persistent_buffer.h"
 #include "graphics/utils.h"
 #include "utils/log.h"
 
-namespace
-{
-struct IndirectCommand
-{
-    std::uint32_t count;
-    std::uint32_t instance_count;
-    std::uint32_t first;
-    std::int32_t base_vertex;
-    std::uint32_t base_instance;
-};
-
-}
-
 namespace ufps
 {
 
@@ -35,34 +23,6 @@ CommandBuffer::CommandBuffer(std::string_view name)
 {
 }
 
-auto CommandBuffer::build(const Scene &scene) -> std::uint32_t
-{
-    const auto command = scene.entities() | std::views::transform([](const auto &e) { return e.render_entities(); }) |
-                         std::views::join |
-                         std::views::transform(
-                             [](const auto &e)
-                             {
-                                 const auto cmd = IndirectCommand{
-                                     .count = e.mesh_view().index_count,
-                                     .instance_count = 1u,
-                                     .first = e.mesh_view().index_offset,
-                                     .base_vertex = static_cast<std::int32_t>(e.mesh_view().vertex_offset),
-                                     .base_instance = 0u,
-                                 };
-                                 return cmd;
-                             }) |
-                         std::ranges::to<std::vector>();
-
-    const auto command_view =
-        DataBufferView{reinterpret_cast<const std::byte *>(command.data()), command.size() * sizeof(IndirectCommand)};
-
-    resize_gpu_buffer(command, command_buffer_);
-
-    command_buffer_.write(command_view, 0u);
-
-    return command.size();
-}
-
 auto CommandBuffer::build(const Entity &entity) -> std::uint32_t
 {
     const auto command = entity.render_entities() |
@@ -3,7 +3,7 @@
 #include <cstdint>
 #include <string>
 
-#include "core/scene.h"
+#include "core/entity.h"
 #include "graphics/multi_buffer.h"
 #include "graphics/opengl.h"
 #include "graphics/persistent_buffer.h"
@@ -15,7 +15,6 @@ class CommandBuffer
 {
   public:
     CommandBuffer(std::string_view name);
-    auto build(const Scene &scene) -> std::uint32_t;
     auto build(const Entity &entity) -> std::uint32_t;
     auto native_handle() const -> ::GLuint;
     auto advance() -> void;
@@ -2,6 +2,20 @@
 
 #include <windows.h>
 
+inline constexpr DWORD DDSD_CAPS = 0x1;
+inline constexpr DWORD DDSD_HEIGHT = 0x2;
+inline constexpr DWORD DDSD_WIDTH = 0x4;
+inline constexpr DWORD DDSD_PITCH = 0x8;
+inline constexpr DWORD DDSD_PIXELFORMAT = 0x1000;
+inline constexpr DWORD DDSD_MIPMAPCOUNT = 0x20000;
+inline constexpr DWORD DDSD_LINEARSIZE = 0x80000;
+
+inline constexpr DWORD DDPF_FOURCC = 0x4;
+
+inline constexpr DWORD DDSCAPS_COMPLEX = 0x8;
+inline constexpr DWORD DDSCAPS_TEXTURE = 0x1000;
+inline constexpr DWORD DDSCAPS_MIPMAP = 0x400000;
+
 struct DDS_PIXELFORMAT
 {
     DWORD dwSize;
@@ -0,0 +1,20 @@
+#include "graphics/debug_group.h"
+
+#include <string_view>
+
+#include "graphics/opengl.h"
+
+namespace ufps
+{
+
+DebugGroup::DebugGroup(std::string_view name)
+{
+    ::glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 0u, static_cast<::GLsizei>(name.size()), name.data());
+}
+
+DebugGroup::~DebugGroup()
+{
+    ::glPopDebugGroup();
+}
+
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <string_view>
+
+namespace ufps
+{
+
+/**
+ * Names the gl commands issued during its lifetime, graphics debuggers show these as passes and recorded gl calls are
+ * counted against the innermost one.
+ */
+class DebugGroup
+{
+  public:
+    DebugGroup(std::string_view name);
+    ~DebugGroup();
+
+    DebugGroup(const DebugGroup &) = delete;
+    auto operator=(const DebugGroup &) -> DebugGroup & = delete;
+};
+
+}
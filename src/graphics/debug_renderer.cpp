@@ -1,6 +1,7 @@
 #include "graphics/debug_renderer.h"
 
 #include <algorithm>
+#include <array>
 #include <cstring>
 #include <format>
 #include <fstream>
@@ -8,6 +9,8 @@
 #include <optional>
 #include <ranges>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include <imgui.h>
 
@@ -17,10 +20,13 @@
 #include <variant>
 
 #include "core/scene.h"
+#include "core/scene_snapshot.h"
 #include "core/service_locator.h"
 #include "events/mouse_button_event.h"
 #include "graphics/colour.h"
+#include "graphics/gl_recorder.h"
 #include "graphics/line_data.h"
+#include "graphics/material_manager.h"
 #include "graphics/mesh_manager.h"
 #include "graphics/opengl.h"
 #include "graphics/point_light.h"
@@ -256,11 +262,19 @@ auto create_debug_controller(const std::string &, SaveSceneButton &value) -> voi
 {
     if (::ImGui::Button("save"))
     {
-        const auto scene_yaml = ufps::yaml::serialise(value.scene.description());
+        const auto description = value.scene.description();
+
+        const auto scene_yaml = ufps::yaml::serialise(description);
         ufps::ensure(scene_yaml);
         auto out = std::ofstream("scene.yaml");
 
         out << *scene_yaml;
+
+        // written after the yaml so it is the newer of the two and is preferred on the next load
+        const auto snapshot = ufps::encode_scene_snapshot(description);
+        auto snapshot_out = std::ofstream("scene.bin", std::ios::binary);
+        snapshot_out.write(
+            reinterpret_cast<const char *>(snapshot.data()), static_cast<std::streamsize>(snapshot.size()));
     }
 }
 
@@ -445,6 +459,47 @@ auto create_debug_controller(const std::string &, Plot &value) -> void
         ::ImVec2(0.0f, 80.0f));
 }
 
+auto create_debug_controller(const std::string &, std::vector<ufps::GlPassCounts> &value) -> void
+{
+    if (value.empty())
+    {
+        ::ImGui::Text("start with --record-gl to count gl calls per pass");
+        return;
+    }
+
+    ::ImGui::BeginTable(
+        "gl_counts", 8, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit);
+
+    for (const auto *column :
+         {"pass", "calls", "draws", "dispatches", "state changes", "buffer binds", "sub data KiB", "mapped KiB"})
+    {
+        ::ImGui::TableSetupColumn(column);
+    }
+    ::ImGui::TableHeadersRow();
+
+    for (const auto &[name, counts] : value)
+    {
+        ::ImGui::TableNextRow();
+        ::ImGui::TableSetColumnIndex(0);
+        ::ImGui::Text("%s", name.c_str());
+
+        const auto columns = std::array{
+            counts.calls, counts.draw_calls, counts.dispatches, counts.state_changes, counts.buffer_binds};
+        for (const auto &[index, count] : std::views::enumerate(columns))
+        {
+            ::ImGui::TableSetColumnIndex(static_cast<int>(index) + 1);
+            ::ImGui::Text("%zu", count);
+        }
+
+        ::ImGui::TableSetColumnIndex(6);
+        ::ImGui::Text("%0.1f", static_cast<float>(counts.sub_data_bytes) / 1024.0f);
+        ::ImGui::TableSetColumnIndex(7);
+        ::ImGui::Text("%0.1f", static_cast<float>(counts.mapped_write_bytes) / 1024.0f);
+    }
+
+    ::ImGui::EndTable();
+}
+
 auto create_debug_controller(const std::string &, SameLine &) -> void
 {
     ::ImGui::SameLine();
@@ -496,7 +551,6 @@ DebugRenderer::DebugRenderer(const Window &window, ResourceLoader &resource_load
     , click_{}
     , selected_{std::monostate{}}
     , debug_lines_{}
-    , debug_line_buffer_{sizeof(LineData) * 2u, "line_data_buffer"}
     , debug_line_program_{create_program(
           resource_loader,
           "shaders\\line.vert",
@@ -511,6 +565,7 @@ DebugRenderer::DebugRenderer(const Window &window, ResourceLoader &resource_load
           "shaders\\debug_light.frag",
           "debug_light_fragment_shader",
           "debug_light_program")}
+    , gl_counts_{}
 {
     IMGUI_CHECKVERSION();
     ::ImGui::CreateContext();
@@ -583,9 +638,9 @@ auto DebugRenderer::post_render(Scene &scene, const Camera &camera) -> void
     ::glBindBufferRange(
         GL_SHADER_STORAGE_BUFFER,
         1,
-        camera_buffer_.native_handle(),
-        camera_buffer_.frame_offset_bytes(),
-        sizeof(CameraData));
+        camera_allocation_.buffer,
+        camera_allocation_.offset,
+        camera_allocation_.size);
     ::glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffer_handle);
 
     const auto cube_parts = service<MeshManager>().mesh("cube");
@@ -629,20 +684,18 @@ auto DebugRenderer::post_render(Scene &scene, const Camera &camera) -> void
         debug_line_program_.bind();
         debug_line_count = debug_lines_.size();
 
-        resize_gpu_buffer(debug_lines_, debug_line_buffer_);
-        debug_line_buffer_.write(std::as_bytes(std::span{debug_lines_.data(), debug_lines_.size()}), 0zu);
-        ::glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, debug_line_buffer_.native_handle());
+        const auto lines = transient_buffer_.upload(std::as_bytes(std::span{debug_lines_}));
+        ::glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 0, lines.buffer, lines.offset, lines.size);
         ::glBindBufferRange(
             GL_SHADER_STORAGE_BUFFER,
             1,
-            camera_buffer_.native_handle(),
-            camera_buffer_.frame_offset_bytes(),
-            sizeof(CameraData));
+            camera_allocation_.buffer,
+            camera_allocation_.offset,
+            camera_allocation_.size);
         ::glDrawArrays(GL_LINES, 0, debug_lines_.size());
 
         debug_lines_.clear();
 
-        debug_line_buffer_.advance();
         debug_line_program_.unbind();
     }
 
@@ -666,6 +719,7 @@ auto DebugRenderer::post_render(Scene &scene, const Camera &camera) -> void
         SaveSceneButton save_scene;
         AddLightButton add_light;
         bool &enable_post_processing;
+        bool &gpu_light_clustering;
     };
 
     auto average_luminance = 0.0f;
@@ -706,7 +760,8 @@ auto DebugRenderer::post_render(Scene &scene, const Camera &camera) -> void
             .debug_lines = static_cast<float>(debug_line_count),
             .save_scene = {.scene = scene},
             .add_light = {.scene = scene, .selected = &selected_},
-            .enable_post_processing = enable_post_processing_},
+            .enable_post_processing = enable_post_processing_,
+            .gpu_light_clustering = gpu_light_clustering_},
         scene.tone_map_options(),
         scene.ssao_options(),
         scene.bloom_options(),
@@ -751,7 +806,12 @@ auto DebugRenderer::post_render(Scene &scene, const Camera &camera) -> void
     frame_allocations.values.erase(std::ranges::begin(frame_allocations.values));
     frame_allocations.values.push_back(static_cast<float>(metrics().frame_allocated_bytes / 1024.0f));
 
-    create_debug_window("metrics", metrics(), Wrapper<Plot>{.controller = frame_allocations});
+    create_debug_window(
+        "metrics",
+        metrics(),
+        render_metrics_,
+        Wrapper<Plot>{.controller = frame_allocations},
+        Wrapper<std::vector<GlPassCounts>>{.controller = gl_counts_});
 
     struct RenderTargets
     {
@@ -886,14 +946,16 @@ auto DebugRenderer::post_render(Scene &scene, const Camera &camera) -> void
 
             for (const auto &render_entity : entity->render_entities())
             {
-                const auto *albedo_texture = texture_manager.texture(render_entity.albedo_texture_bindless_handle());
+                const auto &material = service<MaterialManager>().material(render_entity.material_index());
+
+                const auto *albedo_texture = texture_manager.texture(material.albedo_texture_bindless_handle);
                 ::ImGui::Image(
                     albedo_texture->native_handle(),
                     ::ImVec2(64.0f, 64.0f),
                     ::ImVec2(0.0f, 1.0f),
                     ::ImVec2(1.0f, 0.0f));
 
-                const auto *normal_texture = texture_manager.texture(render_entity.normal_texture_bindless_handle());
+                const auto *normal_texture = texture_manager.texture(material.normal_texture_bindless_handle);
                 ::ImGui::SameLine();
                 ::ImGui::Image(
                     normal_texture->native_handle(),
@@ -901,8 +963,7 @@ auto DebugRenderer::post_render(Scene &scene, const Camera &camera) -> void
                     ::ImVec2(0.0f, 1.0f),
                     ::ImVec2(1.0f, 0.0f));
 
-                const auto *specular_texture =
-                    texture_manager.texture(render_entity.specular_texture_bindless_handle());
+                const auto *specular_texture = texture_manager.texture(material.specular_texture_bindless_handle);
                 ::ImGui::SameLine();
                 ::ImGui::Image(
                     specular_texture->native_handle(),
@@ -910,12 +971,11 @@ auto DebugRenderer::post_render(Scene &scene, const Camera &camera) -> void
                     ::ImVec2(0.0f, 1.0f),
                     ::ImVec2(1.0f, 0.0f));
 
-                const auto *ao_texture = texture_manager.texture(render_entity.ao_texture_bindless_handle());
+                const auto *ao_texture = texture_manager.texture(material.ao_texture_bindless_handle);
                 ::ImGui::Image(
                     ao_texture->native_handle(), ::ImVec2(64.0f, 64.0f), ::ImVec2(0.0f, 1.0f), ::ImVec2(1.0f, 0.0f));
 
-                const auto *glossiness_texture =
-                    texture_manager.texture(render_entity.glossiness_texture_bindless_handle());
+                const auto *glossiness_texture = texture_manager.texture(material.glossiness_texture_bindless_handle);
                 ::ImGui::SameLine();
                 ::ImGui::Image(
                     glossiness_texture->native_handle(),
@@ -923,8 +983,7 @@ auto DebugRenderer::post_render(Scene &scene, const Camera &camera) -> void
                     ::ImVec2(0.0f, 1.0f),
                     ::ImVec2(1.0f, 0.0f));
 
-                const auto *emissive_texture =
-                    texture_manager.texture(render_entity.emissive_texture_bindless_handle());
+                const auto *emissive_texture = texture_manager.texture(material.emissive_texture_bindless_handle);
                 ::ImGui::SameLine();
                 ::ImGui::Image(
                     emissive_texture->native_handle(),
@@ -1098,4 +1157,9 @@ auto DebugRenderer::set_enabled(bool enabled) -> void
     enabled_ = enabled;
     enable_post_processing_ = !enabled_;
 }
+
+auto DebugRenderer::set_gl_counts(std::vector<GlPassCounts> gl_counts) -> void
+{
+    gl_counts_ = std::move(gl_counts);
+}
 }
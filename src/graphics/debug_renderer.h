@@ -7,6 +7,7 @@
 #include "core/entity.h"
 #include "core/scene.h"
 #include "events/mouse_button_event.h"
+#include "graphics/gl_recorder.h"
 #include "graphics/line_data.h"
 #include "graphics/point_light.h"
 #include "graphics/renderer.h"
@@ -26,6 +27,11 @@ class DebugRenderer : public Renderer
 
     auto set_enabled(bool enabled) -> void;
 
+    /**
+     * Gl counts per pass of the last recorded frame, shown in the metrics window. Only set when recording gl.
+     */
+    auto set_gl_counts(std::vector<GlPassCounts> gl_counts) -> void;
+
   protected:
     auto post_render(Scene &scene, const Camera &camera) -> void override;
 
@@ -34,9 +40,9 @@ class DebugRenderer : public Renderer
     std::optional<MouseButtonEvent> click_;
     std::variant<std::monostate, Entity *, PointLightHandle, RigidBodyHandle> selected_;
     std::vector<LineData> debug_lines_;
-    MultiBuffer<PersistentBuffer> debug_line_buffer_;
     Program debug_line_program_;
     Program debug_light_program_;
+    std::vector<GlPassCounts> gl_counts_;
 };
 
 }
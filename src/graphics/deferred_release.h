@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "graphics/fence.h"
+
+namespace ufps
+{
+
+/**
+ * Keeps gpu objects alive until the gpu has finished with them. Objects are retired with a fence inserted after
+ * everything that could still reference them and are destroyed by a later collect() once that fence has signalled.
+ */
+template <class Fence = GpuFence>
+class DeferredRelease
+{
+    static_assert(IsFence<Fence>);
+
+  public:
+    template <class T>
+    auto retire(T &&obj) -> void
+        requires(!std::is_lvalue_reference_v<T>)
+    {
+        auto fence = Fence{};
+        fence.insert();
+
+        retired_.emplace_back(std::move(fence), std::make_shared<T>(std::move(obj)));
+    }
+
+    /**
+     * Destroy all retired objects the gpu is done with.
+     */
+    auto collect() -> void
+    {
+        std::erase_if(retired_, [](const auto &retired) { return std::get<0>(retired).signalled(); });
+    }
+
+    auto size() const -> std::size_t
+    {
+        return retired_.size();
+    }
+
+  private:
+    /** shared_ptr<void> type erases the object but keeps the correct deleter. */
+    std::vector<std::tuple<Fence, std::shared_ptr<void>>> retired_;
+};
+
+}
@@ -0,0 +1,209 @@
+#include "graphics/draw_batch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <ranges>
+#include <span>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "core/camera.h"
+#include "core/render_entity.h"
+#include "core/scene.h"
+#include "graphics/indirect_command.h"
+#include "graphics/mesh_lod.h"
+#include "graphics/mesh_view.h"
+#include "graphics/meshlet.h"
+#include "graphics/object_data.h"
+#include "maths/aabb.h"
+#include "maths/matrix4.h"
+#include "maths/transform.h"
+#include "maths/vector3.h"
+#include "maths/vector4.h"
+
+namespace
+{
+
+// culling below this leaves most of a mesh to draw, instancing every copy of it whole is cheaper than extra commands
+constexpr auto min_culled_fraction = 0.5f;
+
+auto batch_key(const ufps::DrawInstance &draw)
+{
+    return std::make_tuple(draw.mesh_view, draw.object_data.material_index);
+}
+
+/**
+ * Distance from the camera to the bounding sphere of a mesh, negative if the camera is inside it.
+ */
+auto lod_distance(const ufps::Camera &camera, const ufps::Transform &transform, float scale, const ufps::AABB &aabb)
+    -> float
+{
+    const auto centre = ufps::Matrix4{transform} * ufps::Vector4{(aabb.min + aabb.max) / 2.0f, 1.0f};
+    const auto radius = ufps::Vector3::distance(aabb.min, aabb.max) / 2.0f * scale;
+
+    return ufps::Vector3::distance(camera.position(), {centre.x, centre.y, centre.z}) - radius;
+}
+
+/**
+ * Size of the bounding sphere of a mesh on screen, infinite if the camera is inside it.
+ */
+auto projected_size(float distance, float scale, const ufps::AABB &aabb, float projection_scale) -> float
+{
+    if (distance <= 0.0f)
+    {
+        return std::numeric_limits<float>::infinity();
+    }
+
+    return ufps::Vector3::distance(aabb.min, aabb.max) * scale * projection_scale / distance;
+}
+
+}
+
+namespace ufps
+{
+
+auto batch_draws(std::span<const DrawInstance> draws) -> DrawBatch
+{
+    // sort indices rather than the draws themselves so each ObjectData is only copied once
+    auto order = std::vector<std::uint32_t>(draws.size());
+    std::iota(std::ranges::begin(order), std::ranges::end(order), 0u);
+    std::ranges::stable_sort(order, {}, [&draws](auto i) { return batch_key(draws[i]); });
+
+    auto batch = DrawBatch{};
+    batch.instances.reserve(draws.size());
+
+    const DrawInstance *group_head = nullptr;
+
+    for (const auto index : order)
+    {
+        const auto &draw = draws[index];
+        const auto instance_index = static_cast<std::uint32_t>(batch.instances.size());
+
+        if (group_head != nullptr && batch_key(*group_head) == batch_key(draw))
+        {
+            ++batch.commands.back().instance_count;
+        }
+        else
+        {
+            batch.commands.push_back({
+                .count = draw.mesh_view.index_count,
+                .instance_count = 1u,
+                .first = draw.mesh_view.index_offset,
+                .base_vertex = static_cast<std::int32_t>(draw.mesh_view.vertex_offset),
+                .base_instance = instance_index,
+            });
+            group_head = &draw;
+        }
+
+        batch.instances.push_back(draw.object_data);
+    }
+
+    return batch;
+}
+
+auto cull_mesh(
+    const MeshView &mesh_view,
+    std::span<const Meshlet> meshlets,
+    const AABB &aabb,
+    const Transform &transform,
+    const Camera &camera) -> std::vector<MeshView>
+{
+    if (inside_frustum((aabb.min + aabb.max) / 2.0f, Vector3::distance(aabb.min, aabb.max) / 2.0f, transform, camera))
+    {
+        return {mesh_view};
+    }
+
+    const auto ranges = cull_meshlets(meshlets, transform, camera);
+    const auto visible_count =
+        std::ranges::fold_left(ranges | std::views::transform(&IndexRange::count), 0u, std::plus{});
+
+    if (visible_count == 0u)
+    {
+        return {};
+    }
+
+    if (static_cast<float>(mesh_view.index_count - visible_count) <
+        static_cast<float>(mesh_view.index_count) * min_culled_fraction)
+    {
+        return {mesh_view};
+    }
+
+    return ranges | std::views::transform(
+                        [&](const auto &range)
+                        {
+                            return MeshView{
+                                .index_offset = mesh_view.index_offset + range.offset,
+                                .index_count = range.count,
+                                .vertex_offset = mesh_view.vertex_offset,
+                                .vertex_count = mesh_view.vertex_count,
+                            };
+                        }) |
+           std::ranges::to<std::vector>();
+}
+
+auto batch_draws(const Scene &scene, const Camera &camera) -> DrawBatch
+{
+    const auto projection_scale = lod_projection_scale(camera);
+
+    auto draws = std::vector<DrawInstance>{};
+    auto material_coverage = std::vector<float>{};
+
+    for (const auto &entity : scene.entities())
+    {
+        const auto &transform = entity.transform();
+        const auto scale =
+            std::max({std::abs(transform.scale.x), std::abs(transform.scale.y), std::abs(transform.scale.z)});
+        const auto object_data = [&](const RenderEntity &render_entity)
+        {
+            return ObjectData{
+                .model = transform,
+                .material_index = render_entity.material_index(),
+                .emissive_strength = entity.emissive_strength(),
+            };
+        };
+
+        for (const auto &render_entity : entity.render_entities())
+        {
+            const auto distance = lod_distance(camera, transform, scale, render_entity.aabb());
+            const auto lod = select_lod(render_entity.lods(), distance, scale, projection_scale);
+            const auto mesh_view = render_entity.lods()[lod].mesh_view;
+
+            const auto material_index = render_entity.material_index();
+            if (material_index >= material_coverage.size())
+            {
+                material_coverage.resize(material_index + 1zu, 0.0f);
+            }
+
+            material_coverage[material_index] = std::max(
+                material_coverage[material_index],
+                projected_size(distance, scale, render_entity.aabb(), projection_scale));
+
+            // coarser lods are small on screen so aren't worth culling any finer than the whole mesh
+            if ((lod != 0zu) || render_entity.meshlets().empty())
+            {
+                draws.push_back({.mesh_view = mesh_view, .object_data = object_data(render_entity)});
+                continue;
+            }
+
+            draws.append_range(
+                cull_mesh(mesh_view, render_entity.meshlets(), render_entity.aabb(), transform, camera) |
+                std::views::transform(
+                    [&](const auto &view)
+                    {
+                        return DrawInstance{.mesh_view = view, .object_data = object_data(render_entity)};
+                    }));
+        }
+    }
+
+    auto batch = batch_draws(draws);
+    batch.material_coverage = std::move(material_coverage);
+
+    return batch;
+}
+
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include "graphics/indirect_command.h"
+#include "graphics/mesh_view.h"
+#include "graphics/meshlet.h"
+#include "graphics/object_data.h"
+#include "maths/aabb.h"
+
+namespace ufps
+{
+
+class Camera;
+class Scene;
+class Transform;
+
+/**
+ * A single requested draw of a mesh with its per-instance data.
+ */
+struct DrawInstance
+{
+    MeshView mesh_view;
+    ObjectData object_data;
+};
+
+/**
+ * Result of merging draws, every command references a contiguous range of instances via base_instance. Coverage is
+ * indexed by material and is the largest size on screen, in pixels, of anything drawn with that material.
+ */
+struct DrawBatch
+{
+    std::vector<IndirectCommand> commands;
+    std::vector<ObjectData> instances;
+    std::vector<float> material_coverage;
+};
+
+/**
+ * Sort draws by mesh and material and merge identical ones into a single instanced command.
+ *
+ * Relative order of instances within a command is preserved.
+ */
+auto batch_draws(std::span<const DrawInstance> draws) -> DrawBatch;
+
+/**
+ * The parts of a full detail mesh worth drawing from the camera, aabb bounds the mesh in model space. Culled ranges
+ * are unique to each copy of a mesh and stop it being instanced, so the whole mesh is drawn instead if it is entirely
+ * inside the frustum or if culling doesn't remove at least half its indices. Empty if nothing is visible.
+ */
+auto cull_mesh(
+    const MeshView &mesh_view,
+    std::span<const Meshlet> meshlets,
+    const AABB &aabb,
+    const Transform &transform,
+    const Camera &camera) -> std::vector<MeshView>;
+
+/**
+ * Collect all render entities in the scene and batch them, each is drawn with the coarsest lod which is visually
+ * indistinguishable from the full detail mesh at its distance from the camera. Full detail meshes with meshlets are
+ * culled with cull_mesh. Material coverage is filled in for texture streaming.
+ */
+auto batch_draws(const Scene &scene, const Camera &camera) -> DrawBatch;
+
+}
@@ -0,0 +1,64 @@
+#include "graphics/fence.h"
+
+#include <cstdint>
+
+#include "graphics/opengl.h"
+#include "utils/auto_release.h"
+#include "utils/error.h"
+
+namespace
+{
+
+// how long to block in the driver before checking again, 100ms
+constexpr auto wait_timeout_ns = std::uint64_t{100'000'000};
+
+}
+
+namespace ufps
+{
+
+GpuFence::GpuFence()
+    : sync_{nullptr, [](auto sync) { ::glDeleteSync(sync); }}
+{
+}
+
+auto GpuFence::insert() -> void
+{
+    sync_.reset(::glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+    ensure(sync_, "failed to create fence");
+}
+
+auto GpuFence::wait() const -> void
+{
+    if (!sync_)
+    {
+        return;
+    }
+
+    for (;;)
+    {
+        // flush so the fence is guaranteed to reach the gpu, otherwise we could wait forever
+        const auto result = ::glClientWaitSync(sync_, GL_SYNC_FLUSH_COMMANDS_BIT, wait_timeout_ns);
+        ensure(result != GL_WAIT_FAILED, "failed to wait on fence");
+
+        if ((result == GL_ALREADY_SIGNALED) || (result == GL_CONDITION_SATISFIED))
+        {
+            return;
+        }
+    }
+}
+
+auto GpuFence::signalled() const -> bool
+{
+    if (!sync_)
+    {
+        return true;
+    }
+
+    const auto result = ::glClientWaitSync(sync_, 0, 0);
+    ensure(result != GL_WAIT_FAILED, "failed to query fence");
+
+    return (result == GL_ALREADY_SIGNALED) || (result == GL_CONDITION_SATISFIED);
+}
+
+}
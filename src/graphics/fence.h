@@ -0,0 +1,48 @@
+#pragma once
+
+#include <concepts>
+
+#include "graphics/opengl.h"
+#include "utils/auto_release.h"
+
+namespace ufps
+{
+
+/**
+ * A point in the gpu command stream the cpu can wait on. Fakes satisfying this are used to test fence logic without
+ * an opengl context.
+ */
+template <class T>
+concept IsFence = std::movable<T> && std::default_initializable<T> && requires(T t, const T ct) {
+    { t.insert() };
+    { ct.wait() };
+    { ct.signalled() } -> std::convertible_to<bool>;
+};
+
+/**
+ * Wrapper around an opengl sync object. A default constructed fence has nothing to wait on and is always signalled.
+ */
+class GpuFence
+{
+  public:
+    GpuFence();
+
+    /**
+     * Insert a new fence after all currently submitted commands, replacing any previous one.
+     */
+    auto insert() -> void;
+
+    /**
+     * Block until the gpu has passed the fence.
+     */
+    auto wait() const -> void;
+
+    auto signalled() const -> bool;
+
+  private:
+    AutoRelease<::GLsync, nullptr> sync_;
+};
+
+static_assert(IsFence<GpuFence>);
+
+}
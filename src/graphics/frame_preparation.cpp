@@ -0,0 +1,80 @@
+#include "graphics/frame_preparation.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <ranges>
+#include <span>
+#include <utility>
+
+#include "concurrency/thread_pool.h"
+#include "core/camera.h"
+#include "core/entity.h"
+#include "core/scene.h"
+#include "core/service_locator.h"
+#include "graphics/draw_batch.h"
+#include "graphics/light_clusters.h"
+#include "graphics/point_light.h"
+#include "graphics/render_metrics.h"
+#include "graphics/texture_streamer.h"
+#include "graphics/transient_buffer.h"
+
+namespace ufps
+{
+
+auto prepare_draws(const Scene &scene, const Camera &camera, TransientBuffer<> &transient, RenderMetrics &metrics)
+    -> PreparedDraws
+{
+    const auto build_start = std::chrono::steady_clock::now();
+    auto batch = batch_draws(scene, camera);
+    const auto commands = transient.upload(std::as_bytes(std::span{batch.commands}));
+    const auto object_data = transient.upload(std::as_bytes(std::span{batch.instances}));
+    const auto build_end = std::chrono::steady_clock::now();
+
+    // what was drawn this frame decides which texture levels are streamed in
+    service<TextureStreamer>().request(batch.material_coverage);
+
+    metrics.command_count = batch.commands.size();
+    metrics.instance_count = batch.instances.size();
+    metrics.triangle_count = std::ranges::fold_left(
+        batch.commands | std::views::transform([](const auto &c) { return c.count / 3zu * c.instance_count; }),
+        0zu,
+        std::plus{});
+    metrics.lod0_triangle_count = std::ranges::fold_left(
+        scene.entities() | std::views::transform(&Entity::render_entities) | std::views::join |
+            std::views::transform([](const auto &e) { return e.mesh_view().index_count / 3zu; }),
+        0zu,
+        std::plus{});
+    metrics.command_build_ms = std::chrono::duration<float, std::milli>(build_end - build_start).count();
+
+    return {.batch = std::move(batch), .commands = commands, .object_data = object_data};
+}
+
+auto pack_light_clusters(
+    const Camera &camera,
+    std::span<const PointLight> lights,
+    TransientBuffer<> &transient,
+    RenderMetrics &metrics) -> PackedLightClusters
+{
+    const auto clusters = cluster_lights(camera, lights, service<ThreadPool>());
+
+    const auto header = LightClusterHeader{
+        .near_plane = camera.near_plane(),
+        .far_plane = camera.far_plane(),
+        .light_index_count = static_cast<std::uint32_t>(clusters.light_indices.size()),
+        .pad = 0u};
+    const auto cluster_bytes = std::as_bytes(std::span{clusters.clusters});
+
+    const auto cluster_allocation = transient.allocate(sizeof(header) + cluster_bytes.size());
+    transient.write(cluster_allocation, std::as_bytes(std::span{&header, 1zu}));
+    transient.write(cluster_allocation, cluster_bytes, sizeof(header));
+
+    const auto light_index_allocation = transient.upload(std::as_bytes(std::span{clusters.light_indices}));
+
+    metrics.light_index_count = clusters.light_indices.size();
+
+    return {.clusters = cluster_allocation, .light_indices = light_index_allocation};
+}
+
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <span>
+
+#include "graphics/draw_batch.h"
+#include "graphics/point_light.h"
+#include "graphics/render_metrics.h"
+#include "graphics/transient_buffer.h"
+
+namespace ufps
+{
+
+class Camera;
+class Scene;
+
+/**
+ * Batched draws for the gbuffer pass, the commands and object data have already been written to the transient buffer.
+ */
+struct PreparedDraws
+{
+    DrawBatch batch;
+    TransientAllocation commands;
+    TransientAllocation object_data;
+};
+
+/**
+ * Cpu side clustering results in the transient buffer. Clusters are a LightClusterHeader followed by every cluster.
+ */
+struct PackedLightClusters
+{
+    TransientAllocation clusters;
+    TransientAllocation light_indices;
+};
+
+/**
+ * Cpu side work of the gbuffer pass, shared by Renderer and NullRenderer so headless timings match a real frame.
+ * Batches and uploads the scene's draws, requests the texture levels they need and fills in the draw metrics.
+ */
+auto prepare_draws(const Scene &scene, const Camera &camera, TransientBuffer<> &transient, RenderMetrics &metrics)
+    -> PreparedDraws;
+
+/**
+ * Cluster lights on the cpu and write the results to the transient buffer in the layout the lighting pass reads. Fills
+ * in the light index count, timing is left to the caller.
+ */
+auto pack_light_clusters(
+    const Camera &camera,
+    std::span<const PointLight> lights,
+    TransientBuffer<> &transient,
+    RenderMetrics &metrics) -> PackedLightClusters;
+
+}
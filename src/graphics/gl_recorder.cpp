@@ -0,0 +1,207 @@
+#include "graphics/gl_recorder.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "graphics/opengl.h"
+#include "utils/error.h"
+
+namespace
+{
+
+enum class Category
+{
+    OTHER,
+    DRAW,
+    DISPATCH,
+    STATE,
+    BUFFER_BIND,
+};
+
+/**
+ * The frame being recorded, gl and mapped writes only happen on the main thread so this needs no synchronisation.
+ */
+struct RecorderState
+{
+    bool recording = false;
+    std::vector<ufps::GlPassCounts> passes;
+    std::vector<std::size_t> open_passes;
+};
+
+auto state() -> RecorderState &
+{
+    static auto recorder_state = RecorderState{};
+    return recorder_state;
+}
+
+auto pass_index(std::string_view name) -> std::size_t
+{
+    auto &passes = state().passes;
+
+    const auto pass = std::ranges::find(passes, name, &ufps::GlPassCounts::name);
+    if (pass != std::ranges::end(passes))
+    {
+        return static_cast<std::size_t>(std::ranges::distance(std::ranges::begin(passes), pass));
+    }
+
+    passes.push_back({.name = std::string{name}, .counts = {}});
+    return passes.size() - 1zu;
+}
+
+auto current_pass() -> ufps::GlCounts &
+{
+    auto &recorder_state = state();
+    const auto index = recorder_state.open_passes.empty() ? pass_index("frame") : recorder_state.open_passes.back();
+
+    return recorder_state.passes[index].counts;
+}
+
+constexpr auto category(std::string_view name) -> Category
+{
+    using enum Category;
+
+    if ((name == "glDrawElementsBaseVertex") || (name == "glMultiDrawArraysIndirect") ||
+        (name == "glMultiDrawElementsIndirect"))
+    {
+        return DRAW;
+    }
+
+    if (name == "glDispatchCompute")
+    {
+        return DISPATCH;
+    }
+
+    if ((name == "glBindBuffer") || (name == "glBindBufferBase") || (name == "glBindBufferRange"))
+    {
+        return BUFFER_BIND;
+    }
+
+    if ((name == "glUseProgram") || (name == "glBindVertexArray") || (name == "glBindFramebuffer") ||
+        (name == "glBindTextureUnit") || (name == "glBindSampler") || name.starts_with("glUniform") ||
+        name.starts_with("glProgramUniform"))
+    {
+        return STATE;
+    }
+
+    return OTHER;
+}
+
+auto record(Category call_category) -> void
+{
+    auto &counts = current_pass();
+    ++counts.calls;
+
+    switch (call_category)
+    {
+        using enum Category;
+
+        case DRAW: ++counts.draw_calls; break;
+        case DISPATCH: ++counts.dispatches; break;
+        case STATE: ++counts.state_changes; break;
+        case BUFFER_BIND: ++counts.buffer_binds; break;
+        case OTHER: break;
+    }
+}
+
+/**
+ * What a recorded function forwards to and how its calls are counted, one per function in FOR_OPENGL_FUNCTIONS.
+ */
+template <auto &Function>
+struct Recorded
+{
+    static inline auto forward = std::remove_cvref_t<decltype(Function)>{};
+    static inline auto call_category = Category::OTHER;
+};
+
+template <auto &Function, class R, class... Args>
+auto APIENTRY recorded_call(Args... args) -> R
+{
+    record(Recorded<Function>::call_category);
+    return Recorded<Function>::forward(args...);
+}
+
+/**
+ * The function pointer is only passed to deduce its signature.
+ */
+template <auto &Function, class R, class... Args>
+auto install(R(APIENTRY *)(Args...), std::string_view name) -> void
+{
+    Recorded<Function>::forward = Function;
+    Recorded<Function>::call_category = category(name);
+    Function = &recorded_call<Function, R, Args...>;
+}
+
+auto APIENTRY recorded_named_buffer_sub_data(::GLuint buffer, ::GLintptr offset, ::GLsizeiptr size, const void *data)
+    -> void
+{
+    auto &counts = current_pass();
+    ++counts.calls;
+    counts.sub_data_bytes += static_cast<std::size_t>(size);
+
+    Recorded<::glNamedBufferSubData>::forward(buffer, offset, size, data);
+}
+
+auto APIENTRY recorded_push_debug_group(::GLenum source, ::GLuint id, ::GLsizei length, const ::GLchar *message)
+    -> void
+{
+    // a negative length means the message is null terminated
+    const auto name =
+        length < 0 ? std::string_view{message} : std::string_view{message, static_cast<std::size_t>(length)};
+    state().open_passes.push_back(pass_index(name));
+
+    Recorded<::glPushDebugGroup>::forward(source, id, length, message);
+}
+
+auto APIENTRY recorded_pop_debug_group() -> void
+{
+    auto &open_passes = state().open_passes;
+    ufps::expect(!open_passes.empty(), "unbalanced debug groups");
+    open_passes.pop_back();
+
+    Recorded<::glPopDebugGroup>::forward();
+}
+
+}
+
+namespace ufps
+{
+
+auto record_opengl() -> void
+{
+    expect(!state().recording, "gl is already being recorded");
+
+#define RECORD_FUNCTION(TYPE, NAME) install<::NAME>(::NAME, #NAME);
+
+    FOR_OPENGL_FUNCTIONS(RECORD_FUNCTION)
+
+    // these need their arguments so replace the generic wrappers, which have already stored what to forward to
+    ::glNamedBufferSubData = recorded_named_buffer_sub_data;
+    ::glPushDebugGroup = recorded_push_debug_group;
+    ::glPopDebugGroup = recorded_pop_debug_group;
+
+    state().recording = true;
+}
+
+auto record_mapped_write(std::size_t bytes) -> void
+{
+    if (state().recording)
+    {
+        current_pass().mapped_write_bytes += bytes;
+    }
+}
+
+auto end_recorded_frame() -> std::vector<GlPassCounts>
+{
+    auto &recorder_state = state();
+    expect(recorder_state.open_passes.empty(), "frame ended inside a debug group");
+
+    return std::exchange(recorder_state.passes, {});
+}
+
+}
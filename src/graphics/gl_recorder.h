@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace ufps
+{
+
+/**
+ * Gl work done in a single pass. State changes are program, vertex array, frame buffer, texture and sampler binds and
+ * uniform updates, core 1.1 functions such as glEnable are not loaded through FOR_OPENGL_FUNCTIONS so aren't seen.
+ */
+struct GlCounts
+{
+    std::size_t calls;
+    std::size_t draw_calls;
+    std::size_t dispatches;
+    std::size_t state_changes;
+    std::size_t buffer_binds;
+    std::size_t sub_data_bytes;
+    std::size_t mapped_write_bytes;
+
+    constexpr auto operator==(const GlCounts &) const -> bool = default;
+
+    constexpr auto operator+=(const GlCounts &other) -> GlCounts &
+    {
+        calls += other.calls;
+        draw_calls += other.draw_calls;
+        dispatches += other.dispatches;
+        state_changes += other.state_changes;
+        buffer_binds += other.buffer_binds;
+        sub_data_bytes += other.sub_data_bytes;
+        mapped_write_bytes += other.mapped_write_bytes;
+
+        return *this;
+    }
+};
+
+struct GlPassCounts
+{
+    std::string name;
+    GlCounts counts;
+};
+
+/**
+ * Wrap every function in FOR_OPENGL_FUNCTIONS with one which counts the call and then forwards it to whatever was
+ * loaded before, so this must be called after the functions are resolved or after use_null_opengl(). Calls are
+ * counted against the innermost debug group, which is how passes are named, anything outside of one is counted
+ * against a pass called "frame".
+ */
+auto record_opengl() -> void;
+
+/**
+ * Count bytes written through a persistent mapping, gl never sees these. Does nothing unless recording.
+ */
+auto record_mapped_write(std::size_t bytes) -> void;
+
+/**
+ * Counts for every pass since the last call, in the order they were first entered. A pass entered more than once in a
+ * frame is only reported once with the sum of its counts.
+ */
+auto end_recorded_frame() -> std::vector<GlPassCounts>;
+
+}
@@ -0,0 +1,103 @@
+#include "graphics/index_encoding.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <span>
+#include <vector>
+
+#include "graphics/mesh_view.h"
+#include "utils/data_buffer.h"
+#include "utils/error.h"
+
+namespace
+{
+
+template <class T>
+auto append(ufps::DataBuffer &blob, std::span<const std::uint32_t> indices) -> void
+{
+    for (const auto index : indices)
+    {
+        const auto narrowed = static_cast<T>(index);
+        blob.append_range(std::as_bytes(std::span{&narrowed, 1zu}));
+    }
+}
+
+template <class T>
+auto widen(ufps::DataBufferView blob, std::span<std::uint32_t> indices) -> void
+{
+    for (auto &index : indices)
+    {
+        auto narrowed = T{};
+        std::memcpy(&narrowed, blob.data(), sizeof(T));
+        blob = blob.subspan(sizeof(T));
+
+        index = narrowed;
+    }
+}
+
+}
+
+namespace ufps
+{
+
+auto packed_index_size(std::uint32_t vertex_count) -> std::size_t
+{
+    return vertex_count <= std::numeric_limits<std::uint16_t>::max() + 1u ? sizeof(std::uint16_t)
+                                                                           : sizeof(std::uint32_t);
+}
+
+auto encode_indices(DataBuffer &blob, std::span<const std::uint32_t> indices, std::uint32_t vertex_count) -> void
+{
+    expect(std::ranges::all_of(indices, [&](auto index) { return index < vertex_count; }), "index out of range");
+
+    if (packed_index_size(vertex_count) == sizeof(std::uint16_t))
+    {
+        append<std::uint16_t>(blob, indices);
+    }
+    else
+    {
+        append<std::uint32_t>(blob, indices);
+    }
+}
+
+auto decode_indices(DataBufferView blob, std::span<const MeshView> views) -> std::vector<std::uint32_t>
+{
+    auto sorted_views = std::vector<MeshView>(std::ranges::begin(views), std::ranges::end(views));
+    std::ranges::sort(sorted_views, {}, &MeshView::index_offset);
+
+    // models may share a view, each mesh is only stored once
+    const auto [first, last] = std::ranges::unique(sorted_views);
+    sorted_views.erase(first, last);
+
+    auto indices = std::vector<std::uint32_t>{};
+
+    for (const auto &view : sorted_views)
+    {
+        expect(view.index_offset == indices.size(), "index blob views are not contiguous");
+
+        const auto size = packed_index_size(view.vertex_count);
+        expect(blob.size() >= view.index_count * size, "index blob too small");
+
+        indices.resize(indices.size() + view.index_count);
+        const auto mesh_indices = std::span{indices}.last(view.index_count);
+
+        if (size == sizeof(std::uint16_t))
+        {
+            widen<std::uint16_t>(blob, mesh_indices);
+        }
+        else
+        {
+            widen<std::uint32_t>(blob, mesh_indices);
+        }
+
+        blob = blob.subspan(view.index_count * size);
+    }
+
+    expect(blob.empty(), "index blob has trailing data");
+
+    return indices;
+}
+
+}
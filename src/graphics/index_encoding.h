@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "graphics/mesh_view.h"
+#include "utils/data_buffer.h"
+
+namespace ufps
+{
+
+/**
+ * Size in bytes each index of a mesh is stored with in the packed index blob. Indices are relative to the mesh's first
+ * vertex so any mesh with at most 2^16 vertices can use 16 bit indices.
+ */
+auto packed_index_size(std::uint32_t vertex_count) -> std::size_t;
+
+/**
+ * Append the indices of a single mesh to the packed index blob.
+ */
+auto encode_indices(DataBuffer &blob, std::span<const std::uint32_t> indices, std::uint32_t vertex_count) -> void;
+
+/**
+ * Widen a packed index blob back to 32 bit indices. Meshes are stored back to back in index_offset order so the views
+ * are all that is needed to find each one's index size.
+ */
+auto decode_indices(DataBufferView blob, std::span<const MeshView> views) -> std::vector<std::uint32_t>;
+
+}
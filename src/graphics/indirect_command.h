@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+
+namespace ufps
+{
+
+/**
+ * Layout of a single command consumed by glMultiDrawElementsIndirect.
+ */
+struct IndirectCommand
+{
+    std::uint32_t count;
+    std::uint32_t instance_count;
+    std::uint32_t first;
+    std::int32_t base_vertex;
+    std::uint32_t base_instance;
+
+    constexpr auto operator==(const IndirectCommand &) const -> bool = default;
+};
+
+static_assert(sizeof(IndirectCommand) == sizeof(std::uint32_t) * 5);
+
+}
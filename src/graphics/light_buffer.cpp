@@ -0,0 +1,120 @@
+#include "graphics/light_buffer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "core/scene.h"
+#include "core/service_locator.h"
+#include "graphics/buffer_writer.h"
+#include "graphics/deferred_release.h"
+#include "graphics/opengl.h"
+#include "graphics/point_light.h"
+
+namespace ufps
+{
+
+LightBuffer::LightBuffer(std::string_view name)
+    : buffer_{sizeof(LightData), name}
+    , pending_{}
+{
+}
+
+auto LightBuffer::upload(LightData &lights) -> std::size_t
+{
+    const auto header_size_bytes = sizeof(lights.ambient) + sizeof(std::uint32_t);
+    const auto buffer_size_bytes = header_size_bytes + sizeof(PointLight) * lights.lights.size();
+
+    if (buffer_.size() < buffer_size_bytes)
+    {
+        // grow geometrically so adding lights one at a time doesn't reallocate every frame, the old buffer is kept
+        // alive until the gpu is done with it so there's no need to stall
+        const auto new_size = std::max(buffer_size_bytes, buffer_.size() * 2zu);
+        const auto name = std::string{buffer_.name()};
+
+        service<DeferredRelease<>>().retire(std::move(buffer_));
+        buffer_ = {new_size, name};
+
+        for (auto &pending : pending_)
+        {
+            pending.assign(lights.lights.size(), true);
+        }
+    }
+
+    // every frame has its own copy of the lights so a change has to be written to each of them in turn
+    const auto dirty = lights.lights.dirty_indices();
+    for (auto &pending : pending_)
+    {
+        pending.resize(lights.lights.size(), false);
+
+        for (const auto index : dirty)
+        {
+            pending[index] = true;
+        }
+    }
+    lights.lights.clear_dirty();
+
+    auto writer = BufferWriter{buffer_};
+    writer.write(lights.ambient);
+    writer.write(static_cast<std::uint32_t>(lights.lights.size()));
+
+    auto &pending = pending_[buffer_.frame_index()];
+    const auto data = lights.lights.data();
+    auto upload_bytes = header_size_bytes;
+
+    // coalesce runs of changed lights into a single write
+    for (auto begin = 0zu; begin < pending.size();)
+    {
+        if (!pending[begin])
+        {
+            ++begin;
+            continue;
+        }
+
+        auto end = begin;
+        for (; (end < pending.size()) && pending[end]; ++end)
+        {
+            pending[end] = false;
+        }
+
+        const auto bytes = std::as_bytes(data.subspan(begin, end - begin));
+        buffer_.write(bytes, header_size_bytes + (begin * sizeof(PointLight)));
+        upload_bytes += bytes.size();
+
+        begin = end;
+    }
+
+    return upload_bytes;
+}
+
+auto LightBuffer::advance() -> void
+{
+    buffer_.advance();
+}
+
+auto LightBuffer::native_handle() const -> ::GLuint
+{
+    return buffer_.native_handle();
+}
+
+auto LightBuffer::frame_offset_bytes() const -> std::size_t
+{
+    return buffer_.frame_offset_bytes();
+}
+
+auto LightBuffer::size() const -> std::size_t
+{
+    return buffer_.size();
+}
+
+auto LightBuffer::wait_time() const -> std::chrono::nanoseconds
+{
+    return buffer_.wait_time();
+}
+
+}
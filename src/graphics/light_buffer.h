@@ -0,0 +1,47 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+#include "core/scene.h"
+#include "graphics/multi_buffer.h"
+#include "graphics/opengl.h"
+#include "graphics/persistent_buffer.h"
+
+namespace ufps
+{
+
+/**
+ * Per frame copies of the scene lights, packed as the ambient colour, the light count and then the lights. Each frame
+ * tracks which of its lights are stale so only changed lights are rewritten. The buffer grows to fit the lights, the
+ * old one is kept alive until the gpu is done with it.
+ */
+class LightBuffer
+{
+  public:
+    LightBuffer(std::string_view name);
+
+    /**
+     * Pack the lights into the current frame and clear their dirty flags, returns how many bytes were written.
+     */
+    auto upload(LightData &lights) -> std::size_t;
+
+    auto advance() -> void;
+
+    auto native_handle() const -> ::GLuint;
+
+    auto frame_offset_bytes() const -> std::size_t;
+
+    auto size() const -> std::size_t;
+
+    auto wait_time() const -> std::chrono::nanoseconds;
+
+  private:
+    MultiBuffer<PersistentBuffer> buffer_;
+    std::array<std::vector<bool>, MultiBuffer<PersistentBuffer>::frame_count> pending_;
+};
+
+}
@@ -0,0 +1,361 @@
+#include "graphics/light_clusters.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <ranges>
+#include <span>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <immintrin.h>
+
+#include "concurrency/thread_pool.h"
+#include "core/camera.h"
+#include "graphics/point_light.h"
+#include "maths/aabb.h"
+#include "maths/vector4.h"
+
+namespace
+{
+
+constexpr auto tile_count = ufps::LightClusterGrid::width * ufps::LightClusterGrid::height;
+static_assert(tile_count % 4u == 0u, "tiles are tested four at a time");
+
+// contribution below which a light is considered out of range, must match light_cluster.comp
+constexpr auto light_cutoff = 0.01f;
+
+// fragments find their slice with log but slices are bounded with pow, the two can round differently so slices are
+// padded by this fraction of their depth to overlap their neighbours, must match light_cluster.comp
+constexpr auto slice_padding = 1e-4f;
+
+/**
+ * Light sphere of influence in view space.
+ */
+struct ViewSphere
+{
+    float x;
+    float y;
+    float z;
+    float radius;
+};
+
+/**
+ * Bounds of every tile in a depth slice stored as structure of arrays so they can be tested against a light four at a
+ * time. All tiles in a slice share the same z range.
+ */
+struct SliceBounds
+{
+    alignas(16) std::array<float, tile_count> min_x;
+    alignas(16) std::array<float, tile_count> max_x;
+    alignas(16) std::array<float, tile_count> min_y;
+    alignas(16) std::array<float, tile_count> max_y;
+    float min_z;
+    float max_z;
+};
+
+/**
+ * Clusters for a single depth slice, offsets are relative to the start of the slice's light indices.
+ */
+struct SliceResult
+{
+    std::vector<ufps::LightCluster> clusters;
+    std::vector<std::uint32_t> light_indices;
+};
+
+using TileMask = std::array<std::uint64_t, (tile_count + 63u) / 64u>;
+
+auto slice_depth(const ufps::Camera &camera, std::uint32_t z) -> float
+{
+    return camera.near_plane() * std::pow(
+                                     camera.far_plane() / camera.near_plane(),
+                                     static_cast<float>(z) / static_cast<float>(ufps::LightClusterGrid::depth));
+}
+
+auto depth_to_slice(const ufps::Camera &camera, float depth) -> std::uint32_t
+{
+    if (depth <= camera.near_plane())
+    {
+        return 0u;
+    }
+
+    const auto slice = std::floor(
+        std::log(depth / camera.near_plane()) / std::log(camera.far_plane() / camera.near_plane()) *
+        static_cast<float>(ufps::LightClusterGrid::depth));
+
+    // clamp as a float, infinite radius lights would otherwise overflow the conversion
+    return static_cast<std::uint32_t>(
+        std::clamp(slice, 0.0f, static_cast<float>(ufps::LightClusterGrid::depth - 1u)));
+}
+
+auto slice_bounds(const ufps::Camera &camera, std::uint32_t z) -> SliceBounds
+{
+    auto bounds = SliceBounds{};
+
+    for (auto y = 0u; y < ufps::LightClusterGrid::height; ++y)
+    {
+        for (auto x = 0u; x < ufps::LightClusterGrid::width; ++x)
+        {
+            const auto aabb = ufps::cluster_bounds(camera, x, y, z);
+            const auto tile = y * ufps::LightClusterGrid::width + x;
+
+            bounds.min_x[tile] = aabb.min.x;
+            bounds.max_x[tile] = aabb.max.x;
+            bounds.min_y[tile] = aabb.min.y;
+            bounds.max_y[tile] = aabb.max.y;
+            bounds.min_z = aabb.min.z;
+            bounds.max_z = aabb.max.z;
+        }
+    }
+
+    return bounds;
+}
+
+/**
+ * Test a sphere against every tile in a slice, returns a bit per tile.
+ */
+auto intersect_tiles(const SliceBounds &bounds, const ViewSphere &sphere) -> TileMask
+{
+    auto mask = TileMask{};
+
+    const auto dz = std::max({bounds.min_z - sphere.z, sphere.z - bounds.max_z, 0.0f});
+
+    const auto zero = ::_mm_setzero_ps();
+    const auto centre_x = ::_mm_set1_ps(sphere.x);
+    const auto centre_y = ::_mm_set1_ps(sphere.y);
+    const auto dz_squared = ::_mm_set1_ps(dz * dz);
+    const auto radius_squared = ::_mm_set1_ps(sphere.radius * sphere.radius);
+
+    for (auto i = 0u; i < tile_count; i += 4u)
+    {
+        // distance from the centre to the box along each axis, zero if the centre is inside
+        const auto dx = ::_mm_max_ps(
+            ::_mm_max_ps(
+                ::_mm_sub_ps(::_mm_load_ps(bounds.min_x.data() + i), centre_x),
+                ::_mm_sub_ps(centre_x, ::_mm_load_ps(bounds.max_x.data() + i))),
+            zero);
+        const auto dy = ::_mm_max_ps(
+            ::_mm_max_ps(
+                ::_mm_sub_ps(::_mm_load_ps(bounds.min_y.data() + i), centre_y),
+                ::_mm_sub_ps(centre_y, ::_mm_load_ps(bounds.max_y.data() + i))),
+            zero);
+
+        const auto distance_squared =
+            ::_mm_add_ps(::_mm_add_ps(::_mm_mul_ps(dx, dx), ::_mm_mul_ps(dy, dy)), dz_squared);
+        const auto hits =
+            static_cast<std::uint64_t>(::_mm_movemask_ps(::_mm_cmple_ps(distance_squared, radius_squared)));
+
+        mask[i / 64u] |= hits << (i % 64u);
+    }
+
+    return mask;
+}
+
+auto assign_slice(
+    const ufps::Camera &camera,
+    std::uint32_t z,
+    std::span<const ViewSphere> spheres,
+    std::span<const std::uint32_t> slice_lights) -> SliceResult
+{
+    const auto bounds = slice_bounds(camera, z);
+
+    auto masks = std::vector<TileMask>{};
+    masks.reserve(slice_lights.size());
+
+    auto result = SliceResult{.clusters = std::vector<ufps::LightCluster>(tile_count), .light_indices = {}};
+
+    for (const auto light_index : slice_lights)
+    {
+        const auto &mask = masks.emplace_back(intersect_tiles(bounds, spheres[light_index]));
+
+        for (const auto [word_index, word] : std::views::enumerate(mask))
+        {
+            for (auto bits = word; bits != 0u; bits &= bits - 1u)
+            {
+                ++result.clusters[word_index * 64u + std::countr_zero(bits)].count;
+            }
+        }
+    }
+
+    auto offset = 0u;
+    for (auto &cluster : result.clusters)
+    {
+        cluster.offset = offset;
+        offset += cluster.count;
+        cluster.count = 0u;
+    }
+
+    // scatter in light order so each cluster's indices are ascending
+    result.light_indices.resize(offset);
+    for (const auto [light_index, mask] : std::views::zip(slice_lights, masks))
+    {
+        for (const auto [word_index, word] : std::views::enumerate(mask))
+        {
+            for (auto bits = word; bits != 0u; bits &= bits - 1u)
+            {
+                auto &cluster = result.clusters[word_index * 64u + std::countr_zero(bits)];
+                result.light_indices[cluster.offset + cluster.count++] = light_index;
+            }
+        }
+    }
+
+    return result;
+}
+
+/**
+ * Transform lights into view space and bin them by the depth slices they overlap.
+ */
+auto bin_lights(const ufps::Camera &camera, std::span<const ufps::PointLight> lights)
+    -> std::tuple<std::vector<ViewSphere>, std::vector<std::vector<std::uint32_t>>>
+{
+    auto spheres = std::vector<ViewSphere>{};
+    spheres.reserve(lights.size());
+
+    auto slices = std::vector<std::vector<std::uint32_t>>(ufps::LightClusterGrid::depth);
+
+    for (const auto &[index, light] : std::views::enumerate(lights))
+    {
+        const auto position = camera.data().view * ufps::Vector4{light.position, 1.0f};
+        const auto radius = ufps::light_radius(light);
+        spheres.push_back({.x = position.x, .y = position.y, .z = position.z, .radius = radius});
+
+        const auto depth = -position.z;
+        if ((radius <= 0.0f) || (depth + radius < camera.near_plane()) || (depth - radius > camera.far_plane()))
+        {
+            continue;
+        }
+
+        // widened so the light is also tested against any slice it only reaches through the padding
+        const auto first = depth_to_slice(camera, (depth - radius) / (1.0f + slice_padding));
+        const auto last = depth_to_slice(camera, (depth + radius) / (1.0f - slice_padding));
+
+        for (auto z = first; z <= last; ++z)
+        {
+            slices[z].push_back(static_cast<std::uint32_t>(index));
+        }
+    }
+
+    return {std::move(spheres), std::move(slices)};
+}
+
+auto merge_slices(std::span<const SliceResult> slices) -> ufps::LightClusters
+{
+    auto result = ufps::LightClusters{};
+    result.clusters.reserve(ufps::LightClusterGrid::count);
+
+    for (const auto &slice : slices)
+    {
+        const auto base = static_cast<std::uint32_t>(result.light_indices.size());
+
+        result.clusters.append_range(
+            slice.clusters | std::views::transform(
+                                 [base](const auto &c)
+                                 { return ufps::LightCluster{.offset = base + c.offset, .count = c.count}; }));
+        result.light_indices.append_range(slice.light_indices);
+    }
+
+    return result;
+}
+
+}
+
+namespace ufps
+{
+
+auto light_radius(const PointLight &light) -> float
+{
+    const auto brightness = light.intensity * std::max({light.colour.r, light.colour.g, light.colour.b});
+
+    // solve brightness / (c + l * d + q * d^2) = cutoff for d
+    const auto c = light.constant_attenuation - (brightness / light_cutoff);
+    const auto l = light.linear_attenuation;
+    const auto q = light.quadratic_attenuation;
+
+    if (c >= 0.0f)
+    {
+        return 0.0f;
+    }
+
+    if (q > 0.0f)
+    {
+        return (-l + std::sqrt((l * l) - (4.0f * q * c))) / (2.0f * q);
+    }
+
+    if (l > 0.0f)
+    {
+        return -c / l;
+    }
+
+    return std::numeric_limits<float>::infinity();
+}
+
+auto cluster_bounds(const Camera &camera, std::uint32_t x, std::uint32_t y, std::uint32_t z) -> AABB
+{
+    const auto tan_half_fov = std::tan(camera.fov() / 2.0f);
+    const auto aspect_ratio = camera.width() / camera.height();
+
+    // tile edges as view space slopes, i.e. x / depth
+    const auto to_slope = [](std::uint32_t tile, std::uint32_t tiles, float scale)
+    { return (-1.0f + (2.0f * static_cast<float>(tile) / static_cast<float>(tiles))) * scale; };
+
+    const auto left = to_slope(x, LightClusterGrid::width, tan_half_fov * aspect_ratio);
+    const auto right = to_slope(x + 1u, LightClusterGrid::width, tan_half_fov * aspect_ratio);
+    const auto bottom = to_slope(y, LightClusterGrid::height, tan_half_fov);
+    const auto top = to_slope(y + 1u, LightClusterGrid::height, tan_half_fov);
+
+    // the near and far plane of the frustum are exact so only faces shared with another slice are padded
+    const auto near_depth = slice_depth(camera, z) * (z == 0u ? 1.0f : 1.0f - slice_padding);
+    const auto far_depth =
+        slice_depth(camera, z + 1u) * (z + 1u == LightClusterGrid::depth ? 1.0f : 1.0f + slice_padding);
+
+    // the frustum widens with depth so the bounds must include both the near and far face of the cluster
+    return {
+        .min = {std::min(left * near_depth, left * far_depth),
+                std::min(bottom * near_depth, bottom * far_depth),
+                -far_depth},
+        .max = {std::max(right * near_depth, right * far_depth),
+                std::max(top * near_depth, top * far_depth),
+                -near_depth},
+    };
+}
+
+auto cluster_lights(const Camera &camera, std::span<const PointLight> lights) -> LightClusters
+{
+    const auto [spheres, slice_lights] = bin_lights(camera, lights);
+
+    auto slices = std::vector<SliceResult>{};
+    slices.reserve(LightClusterGrid::depth);
+
+    for (auto z = 0u; z < LightClusterGrid::depth; ++z)
+    {
+        slices.push_back(assign_slice(camera, z, spheres, slice_lights[z]));
+    }
+
+    return merge_slices(slices);
+}
+
+auto cluster_lights(const Camera &camera, std::span<const PointLight> lights, ThreadPool &pool) -> LightClusters
+{
+    const auto [spheres, slice_lights] = bin_lights(camera, lights);
+
+    auto slices = std::vector<SliceResult>(LightClusterGrid::depth);
+
+    // every job writes its own slice, a throwing one is rethrown here rather than leaving the wait hanging
+    auto jobs = std::vector<Job>{};
+    jobs.reserve(LightClusterGrid::depth);
+
+    for (auto z = 0u; z < LightClusterGrid::depth; ++z)
+    {
+        jobs.push_back([&, z] { slices[z] = assign_slice(camera, z, spheres, slice_lights[z]); });
+    }
+
+    run_parallel(pool, std::move(jobs));
+
+    return merge_slices(slices);
+}
+
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "core/camera.h"
+#include "graphics/point_light.h"
+#include "maths/aabb.h"
+
+namespace ufps
+{
+
+class ThreadPool;
+
+/**
+ * Dimensions of the cluster grid, x and y evenly tile the screen and z slices view depth exponentially. These must
+ * match the constants in light_pass.frag and light_cluster.comp.
+ */
+struct LightClusterGrid
+{
+    static constexpr auto width = 16u;
+    static constexpr auto height = 9u;
+    static constexpr auto depth = 24u;
+    static constexpr auto count = width * height * depth;
+};
+
+/**
+ * Range of the light index list that affects a single cluster.
+ */
+struct LightCluster
+{
+    std::uint32_t offset;
+    std::uint32_t count;
+
+    constexpr auto operator==(const LightCluster &) const -> bool = default;
+};
+
+/**
+ * Header of the cluster SSBO, followed by LightClusterGrid::count LightCluster entries.
+ */
+struct LightClusterHeader
+{
+    float near_plane;
+    float far_plane;
+    std::uint32_t light_index_count;
+    std::uint32_t pad;
+};
+
+/**
+ * Result of assigning lights to clusters. Clusters are stored x fastest then y then z and light indices for each
+ * cluster are in ascending order.
+ */
+struct LightClusters
+{
+    std::vector<LightCluster> clusters;
+    std::vector<std::uint32_t> light_indices;
+};
+
+/**
+ * Distance at which the contribution of a light becomes negligible, may be infinite if the light has no attenuation.
+ */
+auto light_radius(const PointLight &light) -> float;
+
+/**
+ * View space bounds of a single cluster.
+ */
+auto cluster_bounds(const Camera &camera, std::uint32_t x, std::uint32_t y, std::uint32_t z) -> AABB;
+
+/**
+ * Assign lights to every cluster overlapping their sphere of influence.
+ */
+auto cluster_lights(const Camera &camera, std::span<const PointLight> lights) -> LightClusters;
+
+/**
+ * As above but depth slices are processed in parallel on the supplied pool, result is identical.
+ */
+auto cluster_lights(const Camera &camera, std::span<const PointLight> lights, ThreadPool &pool) -> LightClusters;
+
+}
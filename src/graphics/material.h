@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+
+namespace ufps
+{
+
+/**
+ * Set of bindless texture handles describing a surface, layout matches the material SSBO in gbuffer.frag.
+ */
+struct Material
+{
+    std::uint64_t albedo_texture_bindless_handle;
+    std::uint64_t normal_texture_bindless_handle;
+    std::uint64_t specular_texture_bindless_handle;
+    std::uint64_t ao_texture_bindless_handle;
+    std::uint64_t glossiness_texture_bindless_handle;
+    std::uint64_t emissive_texture_bindless_handle;
+
+    constexpr auto operator==(const Material &) const -> bool = default;
+};
+
+static_assert(sizeof(Material) == sizeof(std::uint64_t) * 6);
+
+}
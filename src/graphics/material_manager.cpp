@@ -0,0 +1,106 @@
+#include "graphics/material_manager.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <ranges>
+#include <span>
+#include <vector>
+
+#include "graphics/buffer.h"
+#include "graphics/material.h"
+#include "graphics/opengl.h"
+#include "graphics/utils.h"
+#include "utils/error.h"
+
+namespace ufps
+{
+
+MaterialManager::MaterialManager()
+    : gpu_buffer_{sizeof(Material), "material_buffer"}
+    , cpu_buffer_{}
+    , indices_{}
+{
+}
+
+auto MaterialManager::add(const Material &material) -> std::uint32_t
+{
+    const auto [iter, inserted] = indices_.try_emplace(material, static_cast<std::uint32_t>(cpu_buffer_.size()));
+    if (!inserted)
+    {
+        return iter->second;
+    }
+
+    const auto new_index = iter->second;
+    cpu_buffer_.push_back(material);
+
+    const auto old_size = gpu_buffer_.size();
+    resize_gpu_buffer(cpu_buffer_, gpu_buffer_);
+
+    if (gpu_buffer_.size() != old_size)
+    {
+        // buffer was recreated so upload everything
+        gpu_buffer_.write(std::as_bytes(std::span{cpu_buffer_.data(), cpu_buffer_.size()}), 0zu);
+    }
+    else
+    {
+        gpu_buffer_.write(std::as_bytes(std::span{&cpu_buffer_.back(), 1zu}), new_index * sizeof(Material));
+    }
+
+    return new_index;
+}
+
+auto MaterialManager::replace_texture(std::uint64_t old_bindless_handle, std::uint64_t new_bindless_handle) -> void
+{
+    for (auto &&[index, material] : std::views::enumerate(cpu_buffer_))
+    {
+        const auto old_material = material;
+        auto changed = false;
+
+        for (auto *handle :
+             {&material.albedo_texture_bindless_handle,
+              &material.normal_texture_bindless_handle,
+              &material.specular_texture_bindless_handle,
+              &material.ao_texture_bindless_handle,
+              &material.glossiness_texture_bindless_handle,
+              &material.emissive_texture_bindless_handle})
+        {
+            if (*handle == old_bindless_handle)
+            {
+                *handle = new_bindless_handle;
+                changed = true;
+            }
+        }
+
+        if (changed)
+        {
+            // if this now matches another material add() keeps returning the other's index
+            if (const auto key = indices_.find(old_material);
+                (key != std::ranges::end(indices_)) && (key->second == static_cast<std::uint32_t>(index)))
+            {
+                indices_.erase(key);
+            }
+            indices_.try_emplace(material, static_cast<std::uint32_t>(index));
+
+            gpu_buffer_.write(
+                std::as_bytes(std::span{&material, 1zu}), static_cast<std::size_t>(index) * sizeof(Material));
+        }
+    }
+}
+
+auto MaterialManager::material(std::uint32_t index) const -> const Material &
+{
+    expect(index < cpu_buffer_.size(), "material index {} out of range", index);
+    return cpu_buffer_[index];
+}
+
+auto MaterialManager::native_handle() const -> ::GLuint
+{
+    return gpu_buffer_.native_handle();
+}
+
+auto MaterialManager::size() const -> std::size_t
+{
+    return cpu_buffer_.size();
+}
+
+}
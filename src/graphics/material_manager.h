@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#include "graphics/buffer.h"
+#include "graphics/material.h"
+#include "graphics/opengl.h"
+
+namespace ufps
+{
+
+namespace impl
+{
+
+struct MaterialHasher
+{
+    auto operator()(const Material &material) const -> std::size_t
+    {
+        auto seed = 0zu;
+
+        for (const auto handle :
+             {material.albedo_texture_bindless_handle,
+              material.normal_texture_bindless_handle,
+              material.specular_texture_bindless_handle,
+              material.ao_texture_bindless_handle,
+              material.glossiness_texture_bindless_handle,
+              material.emissive_texture_bindless_handle})
+        {
+            seed ^= std::hash<std::uint64_t>{}(handle) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+        }
+
+        return seed;
+    }
+};
+
+}
+
+/**
+ * Registry of unique materials. Identical materials share an index and all materials live in a single GPU buffer
+ * which shaders index with the material index stored in ObjectData.
+ */
+class MaterialManager
+{
+  public:
+    MaterialManager();
+
+    auto add(const Material &material) -> std::uint32_t;
+
+    /**
+     * Point every material using a texture at its replacement.
+     */
+    auto replace_texture(std::uint64_t old_bindless_handle, std::uint64_t new_bindless_handle) -> void;
+
+    auto material(std::uint32_t index) const -> const Material &;
+
+    auto native_handle() const -> ::GLuint;
+
+    auto size() const -> std::size_t;
+
+  private:
+    Buffer gpu_buffer_;
+    std::vector<Material> cpu_buffer_;
+    std::unordered_map<Material, std::uint32_t, impl::MaterialHasher> indices_;
+};
+
+}
@@ -0,0 +1,47 @@
+#include "graphics/mesh_lod.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <span>
+
+#include "core/camera.h"
+#include "utils/error.h"
+
+namespace ufps
+{
+
+auto lod_projection_scale(const Camera &camera) -> float
+{
+    return camera.height() / (2.0f * std::tan(camera.fov() / 2.0f));
+}
+
+auto select_lod(
+    std::span<const MeshLod> lods,
+    float distance,
+    float scale,
+    float projection_scale,
+    float threshold_pixels) -> std::size_t
+{
+    expect(!lods.empty(), "mesh has no lods");
+
+    // inside or touching the mesh, anything but full detail would be visible
+    if (distance <= 0.0f)
+    {
+        return 0zu;
+    }
+
+    const auto pixels_per_unit = scale * projection_scale / distance;
+
+    for (auto index = lods.size() - 1zu; index > 0zu; --index)
+    {
+        if (lods[index].error * pixels_per_unit <= threshold_pixels)
+        {
+            return index;
+        }
+    }
+
+    return 0zu;
+}
+
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+
+#include "graphics/mesh_view.h"
+
+namespace ufps
+{
+
+class Camera;
+
+/**
+ * A single level of detail of a mesh. The error is the maximum distance, in model units, the simplified surface may
+ * deviate from the full detail one.
+ */
+struct MeshLod
+{
+    MeshView mesh_view;
+    float error;
+
+    constexpr auto operator==(const MeshLod &) const -> bool = default;
+};
+
+/**
+ * Largest projected error, in pixels, a selected lod is allowed to have.
+ */
+inline constexpr auto lod_error_threshold_pixels = 1.0f;
+
+/**
+ * Pixels covered by one unit at a distance of one unit from the camera.
+ */
+auto lod_projection_scale(const Camera &camera) -> float;
+
+/**
+ * Pick the coarsest lod whose error projected to the screen is within the threshold. Lods must be ordered from finest
+ * to coarsest with the first having no error. The distance is to the closest point of the mesh and scale is the
+ * largest scale the mesh is drawn with.
+ */
+auto select_lod(
+    std::span<const MeshLod> lods,
+    float distance,
+    float scale,
+    float projection_scale,
+    float threshold_pixels = lod_error_threshold_pixels) -> std::size_t;
+
+}
@@ -1,24 +1,195 @@
 #include "graphics/mesh_manager.h"
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <ranges>
+#include <span>
 #include <string_view>
+#include <tuple>
+#include <utility>
 #include <vector>
 
+#include "core/service_locator.h"
 #include "graphics/buffer.h"
+#include "graphics/deferred_release.h"
+#include "graphics/fence.h"
+#include "graphics/index_encoding.h"
 #include "graphics/mesh_data.h"
-#include "graphics/utils.h"
+#include "graphics/opengl.h"
+#include "graphics/packed_vertex.h"
 #include "graphics/vertex_data.h"
+#include "maths/vector3.h"
 #include "utils/data_buffer.h"
 #include "utils/error.h"
+#include "utils/log.h"
+#include "utils/range_allocator.h"
 #include "utils/string_map.h"
 
+namespace
+{
+
+template <class T>
+auto arena_capacity(std::span<const T> data) -> std::uint32_t
+{
+    // gl buffers cannot be empty
+    return static_cast<std::uint32_t>(std::max(data.size(), 1zu));
+}
+
+/**
+ * Allocate count elements of T from an arena, growing it if there is no large enough gap. Growing copies the old buffer
+ * on the gpu so nothing is re-uploaded. The cpu buffer mirrors the arena layout but may hold a reduced element type.
+ */
+template <class T, class C>
+auto arena_allocate(
+    ufps::RangeAllocator &allocator,
+    ufps::Buffer &gpu_buffer,
+    std::vector<C> &cpu_buffer,
+    std::uint32_t count) -> std::uint32_t
+{
+    if (count == 0u)
+    {
+        return 0u;
+    }
+
+    for (;;)
+    {
+        if (const auto offset = allocator.allocate(count); offset)
+        {
+            return *offset;
+        }
+
+        const auto new_capacity = std::max(allocator.capacity() * 2u, count);
+
+        ufps::log::info("growing {} arena {} -> {}", gpu_buffer.name(), allocator.capacity(), new_capacity);
+
+        auto new_buffer = ufps::Buffer{new_capacity * sizeof(T), gpu_buffer.name()};
+        ::glCopyNamedBufferSubData(
+            gpu_buffer.native_handle(), new_buffer.native_handle(), 0, 0, allocator.capacity() * sizeof(T));
+
+        // the gpu may still be reading the old buffer so keep it alive until it's done rather than stalling
+        ufps::service<ufps::DeferredRelease<>>().retire(std::move(gpu_buffer));
+        gpu_buffer = std::move(new_buffer);
+
+        cpu_buffer.resize(new_capacity);
+        allocator.grow(new_capacity);
+    }
+}
+
+template <class T>
+auto arena_write(ufps::Buffer &gpu_buffer, std::uint32_t offset, std::span<const T> data) -> std::size_t
+{
+    if (data.empty())
+    {
+        return 0zu;
+    }
+
+    gpu_buffer.write(std::as_bytes(data), offset * sizeof(T));
+
+    return data.size_bytes();
+}
+
+/**
+ * Every view in a mesh lookup and a lod lookup, as references so they can be updated in place.
+ */
+template <class L>
+auto all_views(L &mesh_lookup, L &lod_lookup)
+{
+    return std::array{std::views::all(mesh_lookup), std::views::all(lod_lookup)} | std::views::join |
+           std::views::values | std::views::join;
+}
+
+auto pack_vertices(std::span<const ufps::VertexData> vertices) -> std::vector<ufps::PackedVertex>
+{
+    return vertices | std::views::transform(ufps::pack_vertex) | std::ranges::to<std::vector>();
+}
+
+/**
+ * Write vertices to the arena, only their positions are kept on the cpu.
+ */
+auto write_vertices(
+    ufps::Buffer &gpu_buffer,
+    std::vector<ufps::Vector3> &positions,
+    std::uint32_t offset,
+    std::span<const ufps::PackedVertex> vertices) -> std::size_t
+{
+    std::ranges::transform(
+        vertices, std::ranges::begin(positions) + offset, [](const auto &vertex) { return vertex.position; });
+
+    return arena_write(gpu_buffer, offset, vertices);
+}
+
+auto write_indices(
+    ufps::Buffer &gpu_buffer,
+    std::vector<std::uint32_t> &cpu_indices,
+    std::uint32_t offset,
+    std::span<const std::uint32_t> indices) -> std::size_t
+{
+    std::ranges::copy(indices, std::ranges::begin(cpu_indices) + offset);
+
+    return arena_write(gpu_buffer, offset, indices);
+}
+
+/**
+ * Move the mesh view whose range (selected by the offset and count members) ends furthest into an arena down into the
+ * lowest gap which fits it. The view is updated in place and the relocation returned if anything moved.
+ */
+template <class T, class C, class R>
+auto arena_compact_step(
+    ufps::RangeAllocator &allocator,
+    ufps::Buffer &gpu_buffer,
+    std::vector<C> &cpu_buffer,
+    R &&views,
+    std::uint32_t ufps::MeshView::*offset,
+    std::uint32_t ufps::MeshView::*count) -> std::optional<ufps::MeshRelocation>
+{
+    const auto last = std::ranges::max_element(
+        views, {}, [offset, count](const ufps::MeshView &view) { return view.*offset + view.*count; });
+
+    if ((last == std::ranges::end(views)) || ((*last).*count == 0u))
+    {
+        return std::nullopt;
+    }
+
+    auto &view = *last;
+
+    const auto new_offset = allocator.allocate(view.*count);
+    ufps::expect(!!new_offset, "arena has no room for an existing range");
+
+    if (*new_offset >= view.*offset)
+    {
+        allocator.free(*new_offset, view.*count);
+        return std::nullopt;
+    }
+
+    // the destination is a gap and the source is live so they cannot overlap
+    ::glCopyNamedBufferSubData(
+        gpu_buffer.native_handle(),
+        gpu_buffer.native_handle(),
+        view.*offset * sizeof(T),
+        *new_offset * sizeof(T),
+        view.*count * sizeof(T));
+    std::ranges::copy_n(
+        std::ranges::begin(cpu_buffer) + view.*offset, view.*count, std::ranges::begin(cpu_buffer) + *new_offset);
+
+    const auto from = view;
+    view.*offset = *new_offset;
+
+    return ufps::MeshRelocation{.from = from, .to = view};
+}
+
+}
+
 namespace ufps
 {
 MeshManager::MeshManager()
-    : vertex_data_cpu_{}
-    , index_data_cpu_{}
-    , vertex_data_gpu_{sizeof(VertexData), "vertex_mesh_data"}
-    , index_data_gpu_{sizeof(std::uint32_t), "index_mesh_data"}
-    , mesh_lookup_{}
+    : MeshManager(
+          std::span<const PackedVertex>{},
+          std::vector<std::uint32_t>{},
+          StringMap<std::vector<MeshView>>{},
+          StringMap<std::vector<MeshView>>{})
 {
 }
 
@@ -26,71 +197,91 @@ MeshManager::MeshManager(
     std::vector<VertexData> vertex_data,
     std::vector<std::uint32_t> index_data,
     StringMap<std::vector<MeshView>> mesh_lookup)
-    : vertex_data_cpu_{std::move(vertex_data)}
-    , index_data_cpu_{std::move(index_data)}
-    , vertex_data_gpu_{sizeof(VertexData), "vertex_mesh_data"}
-    , index_data_gpu_{sizeof(std::uint32_t), "index_mesh_data"}
-    , mesh_lookup_{std::move(mesh_lookup)}
+    : MeshManager(
+          std::span<const PackedVertex>{pack_vertices(vertex_data)},
+          std::move(index_data),
+          std::move(mesh_lookup),
+          StringMap<std::vector<MeshView>>{})
 {
-    resize_gpu_buffer(vertex_data_cpu_, vertex_data_gpu_);
-    const auto vertex_data_view = DataBufferView{
-        reinterpret_cast<const std::byte *>(vertex_data_cpu_.data()), vertex_data_cpu_.size() * sizeof(VertexData)};
-    vertex_data_gpu_.write(vertex_data_view, 0u);
+}
 
-    resize_gpu_buffer(index_data_cpu_, index_data_gpu_);
-    const auto index_data_view = DataBufferView{
-        reinterpret_cast<const std::byte *>(index_data_cpu_.data()), index_data_cpu_.size() * sizeof(std::uint32_t)};
-    index_data_gpu_.write(index_data_view, 0u);
+MeshManager::MeshManager(
+    DataBufferView raw_vertex_data,
+    DataBufferView raw_index_data,
+    StringMap<std::vector<MeshView>> mesh_lookup,
+    StringMap<std::vector<MeshView>> lod_lookup)
+    : MeshManager(
+          std::span<const PackedVertex>{
+              reinterpret_cast<const PackedVertex *>(raw_vertex_data.data()),
+              raw_vertex_data.size() / sizeof(PackedVertex)},
+          // the arena is 32 bit so every mesh can be drawn by the same multi draw, 16 bit indices only save disk space
+          decode_indices(
+              raw_index_data,
+              all_views(std::as_const(mesh_lookup), std::as_const(lod_lookup)) | std::ranges::to<std::vector>()),
+          // copied rather than moved as the argument above reads them and evaluation order is unspecified
+          StringMap<std::vector<MeshView>>{mesh_lookup},
+          StringMap<std::vector<MeshView>>{lod_lookup})
+{
 }
 
 MeshManager::MeshManager(
-        DataBufferView raw_vertex_data,
-        DataBufferView raw_index_data,
-        StringMap<std::vector<MeshView>> mesh_lookup)
-    : vertex_data_cpu_{reinterpret_cast<const VertexData *>(raw_vertex_data.data()),
-                       reinterpret_cast<const VertexData *>(raw_vertex_data.data() + raw_vertex_data.size())}
-    , index_data_cpu_{reinterpret_cast<const std::uint32_t *>(raw_index_data.data()),
-                      reinterpret_cast<const std::uint32_t *>(raw_index_data.data() + raw_index_data.size())}
-    , vertex_data_gpu_{sizeof(VertexData), "vertex_mesh_data"}
-    , index_data_gpu_{sizeof(std::uint32_t), "index_mesh_data"}
+    std::span<const PackedVertex> vertex_data,
+    std::vector<std::uint32_t> index_data,
+    StringMap<std::vector<MeshView>> mesh_lookup,
+    StringMap<std::vector<MeshView>> lod_lookup)
+    : vertex_positions_(arena_capacity(vertex_data))
+    , index_data_cpu_{std::move(index_data)}
+    , vertex_data_gpu_{arena_capacity(vertex_data) * sizeof(PackedVertex), "vertex_mesh_data"}
+    , index_data_gpu_{
+          arena_capacity(std::span<const std::uint32_t>{index_data_cpu_}) * sizeof(std::uint32_t), "index_mesh_data"}
+    , vertex_allocator_{arena_capacity(vertex_data)}
+    , index_allocator_{arena_capacity(std::span<const std::uint32_t>{index_data_cpu_})}
+    , retired_{}
     , mesh_lookup_{std::move(mesh_lookup)}
+    , lod_lookup_{std::move(lod_lookup)}
+    , uploaded_bytes_{}
 {
-    resize_gpu_buffer(vertex_data_cpu_, vertex_data_gpu_);
-    vertex_data_gpu_.write(raw_vertex_data, 0u);
+    // the indices become the cpu copy of the arena as they are, so are only padded rather than copied
+    const auto index_count = static_cast<std::uint32_t>(index_data_cpu_.size());
+    index_data_cpu_.resize(index_allocator_.capacity());
+
+    // initial geometry is one contiguous range at the start of each arena, uploaded straight from the source
+    arena_allocate<PackedVertex>(
+        vertex_allocator_, vertex_data_gpu_, vertex_positions_, static_cast<std::uint32_t>(vertex_data.size()));
+    arena_allocate<std::uint32_t>(index_allocator_, index_data_gpu_, index_data_cpu_, index_count);
 
-    resize_gpu_buffer(index_data_cpu_, index_data_gpu_);
-    index_data_gpu_.write(raw_index_data, 0u);
+    uploaded_bytes_ += write_vertices(vertex_data_gpu_, vertex_positions_, 0u, vertex_data);
+    uploaded_bytes_ +=
+        arena_write(index_data_gpu_, 0u, std::span<const std::uint32_t>{index_data_cpu_}.first(index_count));
 }
 
 auto MeshManager::load(std::string_view name, std::span<const MeshData> meshes) -> std::span<const MeshView>
 {
     expect(!mesh_lookup_.contains(name), "{} mesh exists", name);
 
+    collect();
+
     auto mesh_views = std::vector<MeshView>{};
 
     for (const auto &mesh_data : meshes)
     {
-        const auto vertex_offset = vertex_data_cpu_.size();
-        const auto index_offset = index_data_cpu_.size();
-
-        vertex_data_cpu_.append_range(mesh_data.vertices);
-        resize_gpu_buffer(vertex_data_cpu_, vertex_data_gpu_);
-        const auto vertex_data_view = DataBufferView{
-            reinterpret_cast<const std::byte *>(vertex_data_cpu_.data()), vertex_data_cpu_.size() * sizeof(VertexData)};
-        vertex_data_gpu_.write(vertex_data_view, 0u);
-
-        index_data_cpu_.append_range(mesh_data.indices);
-        resize_gpu_buffer(index_data_cpu_, index_data_gpu_);
-        const auto index_data_view = DataBufferView{
-            reinterpret_cast<const std::byte *>(index_data_cpu_.data()),
-            index_data_cpu_.size() * sizeof(std::uint32_t)};
-        index_data_gpu_.write(index_data_view, 0u);
+        const auto vertex_count = static_cast<std::uint32_t>(mesh_data.vertices.size());
+        const auto index_count = static_cast<std::uint32_t>(mesh_data.indices.size());
+
+        const auto vertex_offset =
+            arena_allocate<PackedVertex>(vertex_allocator_, vertex_data_gpu_, vertex_positions_, vertex_count);
+        const auto index_offset =
+            arena_allocate<std::uint32_t>(index_allocator_, index_data_gpu_, index_data_cpu_, index_count);
+
+        uploaded_bytes_ +=
+            write_vertices(vertex_data_gpu_, vertex_positions_, vertex_offset, pack_vertices(mesh_data.vertices));
+        uploaded_bytes_ += write_indices(index_data_gpu_, index_data_cpu_, index_offset, mesh_data.indices);
 
         mesh_views.push_back({
-            .index_offset = static_cast<std::uint32_t>(index_offset),
-            .index_count = static_cast<std::uint32_t>(mesh_data.indices.size()),
-            .vertex_offset = static_cast<std::uint32_t>(vertex_offset),
-            .vertex_count = static_cast<std::uint32_t>(mesh_data.vertices.size()),
+            .index_offset = index_offset,
+            .index_count = index_count,
+            .vertex_offset = vertex_offset,
+            .vertex_count = vertex_count,
         });
     }
 
@@ -99,6 +290,95 @@ auto MeshManager::load(std::string_view name, std::span<const MeshData> meshes)
     return iter->second;
 }
 
+auto MeshManager::unload(std::string_view name) -> void
+{
+    const auto mesh_views = mesh_lookup_.find(name);
+    expect(mesh_views != std::ranges::end(mesh_lookup_), "{} mesh does not exist", name);
+
+    for (const auto &view : mesh_views->second)
+    {
+        retire(view);
+    }
+
+    mesh_lookup_.erase(mesh_views);
+
+    if (const auto lod_views = lod_lookup_.find(name); lod_views != std::ranges::end(lod_lookup_))
+    {
+        for (const auto &view : lod_views->second)
+        {
+            retire(view);
+        }
+
+        lod_lookup_.erase(lod_views);
+    }
+}
+
+auto MeshManager::compact(std::size_t max_moves) -> std::vector<MeshRelocation>
+{
+    collect();
+
+    auto relocations = std::vector<MeshRelocation>{};
+    auto views = all_views(mesh_lookup_, lod_lookup_);
+
+    // vertices and indices are compacted independently, each stops once its last range can't move any lower. An arena
+    // with no gaps below its live ranges is skipped without looking at any views, which is most frames
+    auto vertices_done = vertex_allocator_.is_packed();
+    auto indices_done = index_allocator_.is_packed();
+
+    while ((relocations.size() < max_moves) && (!vertices_done || !indices_done))
+    {
+        if (!vertices_done)
+        {
+            const auto relocation = arena_compact_step<PackedVertex>(
+                vertex_allocator_,
+                vertex_data_gpu_,
+                vertex_positions_,
+                views,
+                &MeshView::vertex_offset,
+                &MeshView::vertex_count);
+
+            if (relocation)
+            {
+                relocations.push_back(*relocation);
+                retire({
+                    .index_offset = 0u,
+                    .index_count = 0u,
+                    .vertex_offset = relocation->from.vertex_offset,
+                    .vertex_count = relocation->from.vertex_count,
+                });
+            }
+
+            vertices_done = !relocation;
+        }
+
+        if (!indices_done && (relocations.size() < max_moves))
+        {
+            const auto relocation = arena_compact_step<std::uint32_t>(
+                index_allocator_,
+                index_data_gpu_,
+                index_data_cpu_,
+                views,
+                &MeshView::index_offset,
+                &MeshView::index_count);
+
+            if (relocation)
+            {
+                relocations.push_back(*relocation);
+                retire({
+                    .index_offset = relocation->from.index_offset,
+                    .index_count = relocation->from.index_count,
+                    .vertex_offset = 0u,
+                    .vertex_count = 0u,
+                });
+            }
+
+            indices_done = !relocation;
+        }
+    }
+
+    return relocations;
+}
+
 auto MeshManager::mesh(std::string_view name) -> std::span<const MeshView>
 {
     auto mesh_view = mesh_lookup_.find(name);
@@ -122,15 +402,59 @@ auto MeshManager::index_data(MeshView view) const -> std::span<const std::uint32
     return {index_data_cpu_.data() + view.index_offset, view.index_count};
 }
 
-auto MeshManager::vertex_data(MeshView view) const -> std::span<const VertexData>
+auto MeshManager::vertex_positions(MeshView view) const -> std::span<const Vector3>
+{
+    return {vertex_positions_.data() + view.vertex_offset, view.vertex_count};
+}
+
+auto MeshManager::uploaded_bytes() const -> std::size_t
 {
-    return {vertex_data_cpu_.data() + view.vertex_offset, view.vertex_count};
+    return uploaded_bytes_;
 }
 
 auto MeshManager::to_string() const -> std::string
 {
     return std::format(
-        "mesh manager: vertex count: {} index count: {}", vertex_data_cpu_.size(), index_data_cpu_.size());
+        "mesh manager: vertex count: {}/{} index count: {}/{}",
+        vertex_allocator_.used(),
+        vertex_allocator_.capacity(),
+        index_allocator_.used(),
+        index_allocator_.capacity());
+}
+
+auto MeshManager::retire(MeshView view) -> void
+{
+    // in flight frames may still be drawing from these ranges
+    auto fence = GpuFence{};
+    fence.insert();
+
+    retired_.emplace_back(std::move(fence), view);
+}
+
+auto MeshManager::collect() -> void
+{
+    std::erase_if(
+        retired_,
+        [this](const auto &retired)
+        {
+            const auto &[fence, view] = retired;
+            if (!fence.signalled())
+            {
+                return false;
+            }
+
+            if (view.vertex_count != 0u)
+            {
+                vertex_allocator_.free(view.vertex_offset, view.vertex_count);
+            }
+
+            if (view.index_count != 0u)
+            {
+                index_allocator_.free(view.index_offset, view.index_count);
+            }
+
+            return true;
+        });
 }
 
 }
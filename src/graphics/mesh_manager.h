@@ -1,20 +1,38 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <span>
 #include <string>
 #include <string_view>
+#include <tuple>
+#include <vector>
 
 #include "graphics/buffer.h"
+#include "graphics/fence.h"
 #include "graphics/mesh_data.h"
 #include "graphics/mesh_view.h"
+#include "graphics/packed_vertex.h"
 #include "graphics/vertex_data.h"
+#include "maths/vector3.h"
 #include "utils/data_buffer.h"
+#include "utils/range_allocator.h"
 #include "utils/string_map.h"
 
 namespace ufps
 {
 
+/**
+ * Owns all mesh geometry. Vertices and indices live in two gpu arenas, loading a mesh uploads only its own range and
+ * unloading frees it for reuse. Freed ranges are only reused once the gpu has finished any in flight frames which could
+ * still be drawing them.
+ *
+ * Vertices are stored on the gpu as PackedVertex, the cpu only keeps what picking and bounds need, i.e. vertex
+ * positions and indices. The blob constructor expects vertex and index data already packed by the resource packer.
+ *
+ * A mesh is a view per sub model. Blob meshes may also own reduced detail views in the lod lookup, these are unloaded
+ * and compacted with their mesh but aren't returned by mesh().
+ */
 class MeshManager
 {
   public:
@@ -28,10 +46,19 @@ class MeshManager
     MeshManager(
         DataBufferView raw_vertex_data,
         DataBufferView raw_index_data,
-        StringMap<std::vector<MeshView>> mesh_lookup);
+        StringMap<std::vector<MeshView>> mesh_lookup,
+        StringMap<std::vector<MeshView>> lod_lookup);
 
     auto load(std::string_view name, std::span<const MeshData> mesh_data) -> std::span<const MeshView>;
 
+    auto unload(std::string_view name) -> void;
+
+    /**
+     * Move up to max_moves meshes into gaps left by unloaded meshes, returns how every moved view was changed. Anything
+     * holding a copy of a moved view must apply the relocations before its next draw.
+     */
+    auto compact(std::size_t max_moves) -> std::vector<MeshRelocation>;
+
     auto mesh(std::string_view name) -> std::span<const MeshView>;
 
     auto mesh_names() const -> std::vector<std::string>;
@@ -40,16 +67,36 @@ class MeshManager
 
     auto index_data(MeshView view) const -> std::span<const std::uint32_t>;
 
-    auto vertex_data(MeshView view) const -> std::span<const VertexData>;
+    auto vertex_positions(MeshView view) const -> std::span<const Vector3>;
+
+    /**
+     * Total bytes of geometry written to the gpu, excluding gpu side copies when growing or compacting.
+     */
+    auto uploaded_bytes() const -> std::size_t;
 
     auto to_string() const -> std::string;
 
   private:
-    std::vector<VertexData> vertex_data_cpu_;
+    MeshManager(
+        std::span<const PackedVertex> vertex_data,
+        std::vector<std::uint32_t> index_data,
+        StringMap<std::vector<MeshView>> mesh_lookup,
+        StringMap<std::vector<MeshView>> lod_lookup);
+
+    auto retire(MeshView view) -> void;
+
+    auto collect() -> void;
+
+    std::vector<Vector3> vertex_positions_;
     std::vector<std::uint32_t> index_data_cpu_;
     Buffer vertex_data_gpu_;
     Buffer index_data_gpu_;
+    RangeAllocator vertex_allocator_;
+    RangeAllocator index_allocator_;
+    std::vector<std::tuple<GpuFence, MeshView>> retired_;
     StringMap<std::vector<MeshView>> mesh_lookup_;
+    StringMap<std::vector<MeshView>> lod_lookup_;
+    std::size_t uploaded_bytes_;
 };
 
 }
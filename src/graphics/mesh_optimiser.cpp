@@ -0,0 +1,786 @@
+#include "graphics/mesh_optimiser.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <ranges>
+#include <span>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "graphics/mesh_data.h"
+#include "graphics/vertex_data.h"
+#include "maths/vector3.h"
+#include "utils/error.h"
+
+namespace
+{
+
+// cache size assumed when scoring, forsyth recommends 32
+constexpr auto scoring_cache_size = 32u;
+constexpr auto last_triangle_score = 0.75f;
+constexpr auto cache_decay_power = 1.5f;
+constexpr auto valence_boost_scale = 2.0f;
+constexpr auto valence_boost_power = 0.5f;
+
+constexpr auto no_cache_position = -1;
+
+// each lod targets this fraction of the previous one's triangles
+constexpr auto lod_reduction = 0.5f;
+
+// stop generating lods once a level keeps more than this fraction of the previous one's triangles
+constexpr auto lod_min_reduction = 0.8f;
+
+constexpr auto max_lod_count = 4zu;
+
+// don't bother simplifying tiny meshes any further
+constexpr auto lod_min_index_count = 96zu;
+
+// largest error any lod may have, relative to the size of the mesh
+constexpr auto lod_max_relative_error = 0.01f;
+
+struct VertexBytesHash
+{
+    auto operator()(const ufps::VertexData &vertex) const -> std::size_t
+    {
+        return std::hash<std::string_view>{}({reinterpret_cast<const char *>(&vertex), sizeof(vertex)});
+    }
+};
+
+struct VertexBytesEqual
+{
+    auto operator()(const ufps::VertexData &a, const ufps::VertexData &b) const -> bool
+    {
+        return std::memcmp(&a, &b, sizeof(a)) == 0;
+    }
+};
+
+auto vertex_score(std::int32_t cache_position, std::uint32_t remaining_triangles) -> float
+{
+    if (remaining_triangles == 0u)
+    {
+        return -1.0f;
+    }
+
+    auto score = 0.0f;
+
+    if (cache_position >= 0)
+    {
+        if (cache_position < 3)
+        {
+            // the last triangle's vertices are penalised slightly to avoid strip like orderings
+            score = last_triangle_score;
+        }
+        else
+        {
+            const auto scaler = 1.0f / static_cast<float>(scoring_cache_size - 3u);
+            score = std::pow(1.0f - (static_cast<float>(cache_position - 3) * scaler), cache_decay_power);
+        }
+    }
+
+    // favour vertices with few triangles left so they can leave the cache for good
+    return score + (valence_boost_scale *
+                    std::pow(static_cast<float>(remaining_triangles), -valence_boost_power));
+}
+
+/**
+ * Triangles adjacent to each vertex, in compressed sparse row form.
+ */
+struct Adjacency
+{
+    std::vector<std::uint32_t> offsets;
+    std::vector<std::uint32_t> triangles;
+};
+
+auto build_adjacency(std::span<const std::uint32_t> indices, std::uint32_t vertex_count) -> Adjacency
+{
+    auto adjacency = Adjacency{.offsets = std::vector<std::uint32_t>(vertex_count + 1u), .triangles = {}};
+
+    for (const auto index : indices)
+    {
+        ++adjacency.offsets[index + 1u];
+    }
+
+    std::partial_sum(
+        std::ranges::begin(adjacency.offsets),
+        std::ranges::end(adjacency.offsets),
+        std::ranges::begin(adjacency.offsets));
+
+    auto fill = std::vector<std::uint32_t>(std::ranges::begin(adjacency.offsets), std::ranges::end(adjacency.offsets));
+    adjacency.triangles.resize(indices.size());
+
+    for (const auto [position, index] : std::views::enumerate(indices))
+    {
+        adjacency.triangles[fill[index]++] = static_cast<std::uint32_t>(position / 3);
+    }
+
+    return adjacency;
+}
+
+/**
+ * Symmetric 4x4 matrix which measures the sum of squared distances of a point to a set of planes.
+ */
+struct Quadric
+{
+    double a00, a01, a02, a03;
+    double a11, a12, a13;
+    double a22, a23;
+    double a33;
+
+    auto operator+=(const Quadric &other) -> Quadric &
+    {
+        a00 += other.a00;
+        a01 += other.a01;
+        a02 += other.a02;
+        a03 += other.a03;
+        a11 += other.a11;
+        a12 += other.a12;
+        a13 += other.a13;
+        a22 += other.a22;
+        a23 += other.a23;
+        a33 += other.a33;
+
+        return *this;
+    }
+
+    auto error(const ufps::Vector3 &p) const -> double
+    {
+        const auto x = static_cast<double>(p.x);
+        const auto y = static_cast<double>(p.y);
+        const auto z = static_cast<double>(p.z);
+
+        return (a00 * x * x) + (2.0 * a01 * x * y) + (2.0 * a02 * x * z) + (2.0 * a03 * x) + (a11 * y * y) +
+               (2.0 * a12 * y * z) + (2.0 * a13 * y) + (a22 * z * z) + (2.0 * a23 * z) + a33;
+    }
+};
+
+auto plane_quadric(const ufps::Vector3 &v0, const ufps::Vector3 &v1, const ufps::Vector3 &v2) -> Quadric
+{
+    const auto cross = ufps::Vector3::cross(v1 - v0, v2 - v0);
+    if (cross.length() == 0.0f)
+    {
+        return {};
+    }
+
+    const auto n = ufps::Vector3::normalise(cross);
+    const auto a = static_cast<double>(n.x);
+    const auto b = static_cast<double>(n.y);
+    const auto c = static_cast<double>(n.z);
+    const auto d = -static_cast<double>(ufps::Vector3::dot(n, v0));
+
+    return {
+        .a00 = a * a,
+        .a01 = a * b,
+        .a02 = a * c,
+        .a03 = a * d,
+        .a11 = b * b,
+        .a12 = b * c,
+        .a13 = b * d,
+        .a22 = c * c,
+        .a23 = c * d,
+        .a33 = d * d,
+    };
+}
+
+struct PositionBytesHash
+{
+    auto operator()(const ufps::Vector3 &position) const -> std::size_t
+    {
+        return std::hash<std::string_view>{}({reinterpret_cast<const char *>(&position), sizeof(position)});
+    }
+};
+
+struct PositionBytesEqual
+{
+    auto operator()(const ufps::Vector3 &a, const ufps::Vector3 &b) const -> bool
+    {
+        return std::memcmp(&a, &b, sizeof(a)) == 0;
+    }
+};
+
+/**
+ * Map each vertex to the first vertex sharing its position, vertices only differing in attributes form a seam.
+ */
+auto weld_positions(std::span<const ufps::VertexData> vertices) -> std::vector<std::uint32_t>
+{
+    auto first = std::unordered_map<ufps::Vector3, std::uint32_t, PositionBytesHash, PositionBytesEqual>{};
+    first.reserve(vertices.size());
+
+    return vertices | std::views::enumerate |
+           std::views::transform(
+               [&](const auto &e)
+               {
+                   const auto &[index, vertex] = e;
+                   return first.try_emplace(vertex.position, static_cast<std::uint32_t>(index)).first->second;
+               }) |
+           std::ranges::to<std::vector>();
+}
+
+/**
+ * Positions which must not move: seams, borders and anything touching a non manifold edge.
+ */
+auto locked_positions(std::span<const std::uint32_t> indices, std::span<const std::uint32_t> weld)
+    -> std::vector<bool>
+{
+    auto locked = std::vector<bool>(weld.size(), false);
+
+    auto vertex_count = std::vector<std::uint32_t>(weld.size(), 0u);
+    for (const auto position : weld)
+    {
+        ++vertex_count[position];
+    }
+
+    for (const auto [position, count] : std::views::enumerate(vertex_count))
+    {
+        locked[position] = count > 1u;
+    }
+
+    // an edge used by anything other than exactly two triangles is a border or non manifold
+    auto edges = std::unordered_map<std::uint64_t, std::uint32_t>{};
+    const auto edge_key = [](std::uint32_t a, std::uint32_t b)
+    { return (static_cast<std::uint64_t>(std::min(a, b)) << 32u) | std::max(a, b); };
+
+    for (auto triangle = 0zu; triangle < indices.size(); triangle += 3zu)
+    {
+        for (auto corner = 0zu; corner < 3zu; ++corner)
+        {
+            ++edges[edge_key(weld[indices[triangle + corner]], weld[indices[triangle + ((corner + 1zu) % 3zu)]])];
+        }
+    }
+
+    for (const auto &[key, count] : edges)
+    {
+        if (count != 2u)
+        {
+            locked[static_cast<std::uint32_t>(key >> 32u)] = true;
+            locked[static_cast<std::uint32_t>(key & 0xffffffffu)] = true;
+        }
+    }
+
+    return locked;
+}
+
+auto triangle_centre_and_normal(std::span<const ufps::VertexData> vertices, std::span<const std::uint32_t> triangle)
+    -> std::tuple<ufps::Vector3, ufps::Vector3, float>
+{
+    const auto &v0 = vertices[triangle[0]].position;
+    const auto &v1 = vertices[triangle[1]].position;
+    const auto &v2 = vertices[triangle[2]].position;
+
+    // unnormalised so larger triangles carry more weight
+    const auto normal = ufps::Vector3::cross(v1 - v0, v2 - v0);
+
+    return {v0 + v1 + v2, normal, normal.length()};
+}
+
+}
+
+namespace ufps
+{
+
+auto analyse_vertex_cache(std::span<const std::uint32_t> indices, std::uint32_t vertex_count, std::uint32_t cache_size)
+    -> VertexCacheStatistics
+{
+    expect(indices.size() % 3u == 0u, "index count must be a multiple of three");
+
+    if (indices.empty())
+    {
+        return {.acmr = 0.0f, .atvr = 0.0f};
+    }
+
+    // a vertex is in the fifo if it was added within the last cache_size misses
+    auto timestamps = std::vector<std::uint64_t>(vertex_count, 0u);
+    auto referenced = std::vector<bool>(vertex_count, false);
+    auto time = std::uint64_t{cache_size} + 1u;
+    auto misses = 0u;
+
+    for (const auto index : indices)
+    {
+        referenced[index] = true;
+
+        if (time - timestamps[index] > cache_size)
+        {
+            timestamps[index] = time++;
+            ++misses;
+        }
+    }
+
+    const auto triangle_count = indices.size() / 3u;
+    const auto referenced_count = std::ranges::count(referenced, true);
+
+    return {
+        .acmr = static_cast<float>(misses) / static_cast<float>(triangle_count),
+        .atvr = static_cast<float>(misses) / static_cast<float>(referenced_count),
+    };
+}
+
+auto deduplicate_vertices(const MeshData &mesh) -> MeshData
+{
+    auto remap = std::unordered_map<VertexData, std::uint32_t, VertexBytesHash, VertexBytesEqual>{};
+    remap.reserve(mesh.vertices.size());
+
+    auto result = MeshData{};
+    auto new_index = std::vector<std::uint32_t>{};
+    new_index.reserve(mesh.vertices.size());
+
+    for (const auto &vertex : mesh.vertices)
+    {
+        const auto [iter, inserted] = remap.try_emplace(vertex, static_cast<std::uint32_t>(result.vertices.size()));
+        if (inserted)
+        {
+            result.vertices.push_back(vertex);
+        }
+
+        new_index.push_back(iter->second);
+    }
+
+    result.indices =
+        mesh.indices | std::views::transform([&](auto index) { return new_index[index]; }) |
+        std::ranges::to<std::vector>();
+
+    return result;
+}
+
+auto optimise_vertex_cache(std::span<const std::uint32_t> indices, std::uint32_t vertex_count)
+    -> std::vector<std::uint32_t>
+{
+    expect(indices.size() % 3u == 0u, "index count must be a multiple of three");
+
+    const auto triangle_count = static_cast<std::uint32_t>(indices.size() / 3u);
+    const auto adjacency = build_adjacency(indices, vertex_count);
+
+    auto remaining = std::vector<std::uint32_t>(vertex_count);
+    for (auto vertex = 0u; vertex < vertex_count; ++vertex)
+    {
+        remaining[vertex] = adjacency.offsets[vertex + 1u] - adjacency.offsets[vertex];
+    }
+
+    auto cache_position = std::vector<std::int32_t>(vertex_count, no_cache_position);
+    auto scores = std::vector<float>(vertex_count);
+    for (auto vertex = 0u; vertex < vertex_count; ++vertex)
+    {
+        scores[vertex] = vertex_score(no_cache_position, remaining[vertex]);
+    }
+
+    const auto triangle_score = [&](std::uint32_t triangle)
+    {
+        const auto vertices = indices.subspan(triangle * 3u, 3u);
+        return scores[vertices[0]] + scores[vertices[1]] + scores[vertices[2]];
+    };
+
+    auto emitted = std::vector<bool>(triangle_count, false);
+
+    // lru cache, three extra slots hold vertices pushed out by the triangle just added
+    auto cache = std::vector<std::uint32_t>{};
+    cache.reserve(scoring_cache_size + 3u);
+
+    auto result = std::vector<std::uint32_t>{};
+    result.reserve(indices.size());
+
+    auto next_unemitted = 0u;
+
+    for (auto emitted_count = 0u; emitted_count < triangle_count; ++emitted_count)
+    {
+        // best triangle touching the cache, if none fall back to the first unemitted triangle
+        auto best_triangle = std::numeric_limits<std::uint32_t>::max();
+        auto best_score = -1.0f;
+
+        for (const auto vertex : cache)
+        {
+            for (auto i = adjacency.offsets[vertex]; i < adjacency.offsets[vertex + 1u]; ++i)
+            {
+                const auto triangle = adjacency.triangles[i];
+                if (emitted[triangle])
+                {
+                    continue;
+                }
+
+                if (const auto score = triangle_score(triangle); score > best_score)
+                {
+                    best_score = score;
+                    best_triangle = triangle;
+                }
+            }
+        }
+
+        if (best_triangle == std::numeric_limits<std::uint32_t>::max())
+        {
+            while (emitted[next_unemitted])
+            {
+                ++next_unemitted;
+            }
+            best_triangle = next_unemitted;
+        }
+
+        emitted[best_triangle] = true;
+
+        const auto triangle = indices.subspan(best_triangle * 3u, 3u);
+        result.append_range(triangle);
+
+        // move the triangle's vertices to the front of the cache
+        for (const auto vertex : triangle | std::views::reverse)
+        {
+            std::erase(cache, vertex);
+            cache.insert(std::ranges::begin(cache), vertex);
+            --remaining[vertex];
+        }
+
+        for (const auto [position, vertex] : std::views::enumerate(cache))
+        {
+            cache_position[vertex] =
+                position < scoring_cache_size ? static_cast<std::int32_t>(position) : no_cache_position;
+            scores[vertex] = vertex_score(cache_position[vertex], remaining[vertex]);
+        }
+
+        if (cache.size() > scoring_cache_size)
+        {
+            cache.resize(scoring_cache_size);
+        }
+    }
+
+    return result;
+}
+
+auto optimise_overdraw(std::span<const std::uint32_t> indices, std::span<const VertexData> vertices)
+    -> std::vector<std::uint32_t>
+{
+    expect(indices.size() % 3u == 0u, "index count must be a multiple of three");
+
+    if (indices.empty())
+    {
+        return {};
+    }
+
+    // split into clusters wherever the fifo cache misses on every vertex of a triangle, i.e. the cache restarted
+    auto cluster_starts = std::vector<std::size_t>{0zu};
+    auto timestamps = std::vector<std::uint64_t>(vertices.size(), 0u);
+    auto time = std::uint64_t{vertex_cache_size} + 1u;
+
+    for (auto triangle = 0zu; triangle < indices.size() / 3u; ++triangle)
+    {
+        auto misses = 0u;
+
+        for (const auto index : indices.subspan(triangle * 3u, 3u))
+        {
+            if (time - timestamps[index] > vertex_cache_size)
+            {
+                timestamps[index] = time++;
+                ++misses;
+            }
+        }
+
+        if ((misses == 3u) && (triangle != 0zu))
+        {
+            cluster_starts.push_back(triangle);
+        }
+    }
+
+    cluster_starts.push_back(indices.size() / 3u);
+
+    auto mesh_centre = Vector3{};
+    for (auto triangle = 0zu; triangle < indices.size() / 3u; ++triangle)
+    {
+        const auto [centre, normal, area] = triangle_centre_and_normal(vertices, indices.subspan(triangle * 3u, 3u));
+        mesh_centre += centre;
+    }
+    mesh_centre /= Vector3{static_cast<float>(indices.size())};
+
+    // clusters facing away from the centre of the mesh are likely to occlude the rest so draw them first
+    auto clusters = std::vector<std::tuple<float, std::size_t, std::size_t>>{};
+
+    for (const auto [first, last] : cluster_starts | std::views::pairwise)
+    {
+        auto cluster_centre = Vector3{};
+        auto cluster_normal = Vector3{};
+        auto cluster_area = 0.0f;
+
+        for (auto triangle = first; triangle < last; ++triangle)
+        {
+            const auto [centre, normal, area] =
+                triangle_centre_and_normal(vertices, indices.subspan(triangle * 3u, 3u));
+            cluster_centre += centre * Vector3{area};
+            cluster_normal += normal;
+            cluster_area += area;
+        }
+
+        const auto sort_key = cluster_area > 0.0f
+                                  ? Vector3::dot(
+                                        (cluster_centre / Vector3{cluster_area * 3.0f}) - mesh_centre,
+                                        Vector3::normalise(cluster_normal))
+                                  : 0.0f;
+
+        clusters.emplace_back(sort_key, first, last);
+    }
+
+    std::ranges::stable_sort(clusters, std::ranges::greater{}, [](const auto &c) { return std::get<0>(c); });
+
+    auto result = std::vector<std::uint32_t>{};
+    result.reserve(indices.size());
+
+    for (const auto &[sort_key, first, last] : clusters)
+    {
+        result.append_range(indices.subspan(first * 3u, (last - first) * 3u));
+    }
+
+    return result;
+}
+
+auto optimise_vertex_fetch(const MeshData &mesh) -> MeshData
+{
+    constexpr auto unassigned = std::numeric_limits<std::uint32_t>::max();
+
+    auto remap = std::vector<std::uint32_t>(mesh.vertices.size(), unassigned);
+    auto result = MeshData{};
+    result.indices.reserve(mesh.indices.size());
+
+    for (const auto index : mesh.indices)
+    {
+        if (remap[index] == unassigned)
+        {
+            remap[index] = static_cast<std::uint32_t>(result.vertices.size());
+            result.vertices.push_back(mesh.vertices[index]);
+        }
+
+        result.indices.push_back(remap[index]);
+    }
+
+    return result;
+}
+
+auto optimise_mesh(const MeshData &mesh) -> OptimisedMesh
+{
+    auto result = OptimisedMesh{.mesh = deduplicate_vertices(mesh), .stages = {}};
+
+    const auto record_stage = [&result](std::string_view name)
+    {
+        const auto vertex_count = static_cast<std::uint32_t>(result.mesh.vertices.size());
+        result.stages.push_back({
+            .name = name,
+            .vertex_count = vertex_count,
+            .statistics = analyse_vertex_cache(result.mesh.indices, vertex_count),
+        });
+    };
+
+    record_stage("deduplicate");
+
+    result.mesh.indices =
+        optimise_vertex_cache(result.mesh.indices, static_cast<std::uint32_t>(result.mesh.vertices.size()));
+    record_stage("vertex cache");
+
+    result.mesh.indices = optimise_overdraw(result.mesh.indices, result.mesh.vertices);
+    record_stage("overdraw");
+
+    result.mesh = optimise_vertex_fetch(result.mesh);
+    record_stage("vertex fetch");
+
+    return result;
+}
+
+auto simplify_mesh(const MeshData &mesh, std::size_t target_index_count, float max_error) -> SimplifiedMesh
+{
+    expect(mesh.indices.size() % 3u == 0u, "index count must be a multiple of three");
+
+    // all bookkeeping is done on welded positions, a vertex id is only needed when rewriting indices
+    const auto weld = weld_positions(mesh.vertices);
+    const auto locked = locked_positions(mesh.indices, weld);
+
+    auto quadrics = std::vector<Quadric>(mesh.vertices.size());
+    for (const auto &triangle : mesh.indices | std::views::chunk(3))
+    {
+        const auto quadric = plane_quadric(
+            mesh.vertices[triangle[0]].position,
+            mesh.vertices[triangle[1]].position,
+            mesh.vertices[triangle[2]].position);
+
+        for (const auto index : triangle)
+        {
+            quadrics[weld[index]] += quadric;
+        }
+    }
+
+    const auto position = [&](std::uint32_t vertex) -> const Vector3 & { return mesh.vertices[vertex].position; };
+    const auto max_cost = static_cast<double>(max_error) * static_cast<double>(max_error);
+
+    auto indices = mesh.indices;
+    auto worst_cost = 0.0;
+
+    while (indices.size() > target_index_count)
+    {
+        // triangles around each welded position
+        auto adjacency = std::vector<std::vector<std::uint32_t>>(mesh.vertices.size());
+        for (auto triangle = 0u; triangle < indices.size() / 3u; ++triangle)
+        {
+            for (const auto index : std::span{indices}.subspan(triangle * 3u, 3u))
+            {
+                adjacency[weld[index]].push_back(triangle);
+            }
+        }
+
+        // every half edge from a free vertex is a candidate to collapse it onto the other end
+        auto candidates = std::vector<std::tuple<double, std::uint32_t, std::uint32_t>>{};
+        for (auto triangle = 0zu; triangle < indices.size(); triangle += 3zu)
+        {
+            for (auto corner = 0zu; corner < 3zu; ++corner)
+            {
+                const auto from = indices[triangle + corner];
+                const auto to = indices[triangle + ((corner + 1zu) % 3zu)];
+
+                for (const auto [a, b] : {std::pair{from, to}, std::pair{to, from}})
+                {
+                    if (!locked[weld[a]] && (weld[a] != weld[b]))
+                    {
+                        candidates.emplace_back(quadrics[weld[a]].error(position(b)), a, b);
+                    }
+                }
+            }
+        }
+
+        std::ranges::sort(candidates);
+
+        auto touched = std::vector<bool>(mesh.vertices.size(), false);
+        auto removed = std::vector<bool>(indices.size() / 3u, false);
+        auto index_count = indices.size();
+        auto collapsed = false;
+
+        for (const auto &[cost, from, to] : candidates)
+        {
+            if ((index_count <= target_index_count) || (cost > max_cost))
+            {
+                break;
+            }
+
+            const auto from_position = weld[from];
+            const auto to_position = weld[to];
+
+            if (touched[from_position] || touched[to_position])
+            {
+                continue;
+            }
+
+            // reject collapses which would flip a remaining triangle
+            const auto flips = std::ranges::any_of(
+                adjacency[from_position],
+                [&](auto triangle)
+                {
+                    const auto corners = std::span{indices}.subspan(triangle * 3u, 3u);
+                    if (std::ranges::any_of(corners, [&](auto index) { return weld[index] == to_position; }))
+                    {
+                        return false;
+                    }
+
+                    const auto moved = [&](std::uint32_t index)
+                    { return weld[index] == from_position ? position(to) : position(index); };
+
+                    const auto before = Vector3::cross(
+                        position(corners[1]) - position(corners[0]), position(corners[2]) - position(corners[0]));
+                    const auto after = Vector3::cross(
+                        moved(corners[1]) - moved(corners[0]), moved(corners[2]) - moved(corners[0]));
+
+                    return Vector3::dot(before, after) <= 0.0f;
+                });
+
+            if (flips)
+            {
+                continue;
+            }
+
+            for (const auto triangle : adjacency[from_position])
+            {
+                auto corners = std::span{indices}.subspan(triangle * 3u, 3u);
+
+                for (auto &index : corners)
+                {
+                    touched[weld[index]] = true;
+
+                    if (weld[index] == from_position)
+                    {
+                        index = to;
+                    }
+                }
+
+                if ((weld[corners[0]] == weld[corners[1]]) || (weld[corners[1]] == weld[corners[2]]) ||
+                    (weld[corners[0]] == weld[corners[2]]))
+                {
+                    removed[triangle] = true;
+                    index_count -= 3zu;
+                }
+            }
+
+            quadrics[to_position] += quadrics[from_position];
+            worst_cost = std::max(worst_cost, cost);
+            collapsed = true;
+        }
+
+        auto remaining = std::vector<std::uint32_t>{};
+        remaining.reserve(index_count);
+
+        for (auto triangle = 0zu; triangle < removed.size(); ++triangle)
+        {
+            if (!removed[triangle])
+            {
+                remaining.append_range(std::span{indices}.subspan(triangle * 3u, 3u));
+            }
+        }
+
+        indices = std::move(remaining);
+
+        if (!collapsed)
+        {
+            break;
+        }
+    }
+
+    return {
+        .mesh = optimise_vertex_fetch({.vertices = mesh.vertices, .indices = std::move(indices)}),
+        .error = static_cast<float>(std::sqrt(worst_cost)),
+    };
+}
+
+auto generate_lods(const MeshData &mesh) -> std::vector<SimplifiedMesh>
+{
+    auto lods = std::vector<SimplifiedMesh>{};
+
+    if (mesh.vertices.empty())
+    {
+        return lods;
+    }
+
+    auto min = mesh.vertices.front().position;
+    auto max = mesh.vertices.front().position;
+    for (const auto &[x, y, z] : mesh.vertices | std::views::transform(&VertexData::position))
+    {
+        min = {std::min(min.x, x), std::min(min.y, y), std::min(min.z, z)};
+        max = {std::max(max.x, x), std::max(max.y, y), std::max(max.z, z)};
+    }
+
+    const auto max_error = (max - min).length() * lod_max_relative_error;
+
+    auto previous = SimplifiedMesh{.mesh = mesh, .error = 0.0f};
+
+    while ((lods.size() < max_lod_count) && (previous.mesh.indices.size() >= lod_min_index_count))
+    {
+        const auto target_index_count =
+            static_cast<std::size_t>(static_cast<float>(previous.mesh.indices.size() / 3zu) * lod_reduction) * 3zu;
+
+        auto lod = simplify_mesh(previous.mesh, target_index_count, max_error - previous.error);
+
+        if (static_cast<float>(lod.mesh.indices.size()) >
+            static_cast<float>(previous.mesh.indices.size()) * lod_min_reduction)
+        {
+            break;
+        }
+
+        // each level is simplified from the last so errors accumulate
+        lod.error += previous.error;
+        previous = lods.emplace_back(std::move(lod));
+    }
+
+    return lods;
+}
+
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "graphics/mesh_data.h"
+#include "graphics/vertex_data.h"
+
+namespace ufps
+{
+
+/**
+ * Post transform cache efficiency of an index buffer, simulated with a fifo cache.
+ *
+ * - acmr: average cache miss ratio, vertex shader invocations per triangle (0.5 is ideal, 3.0 is worst)
+ * - atvr: average transformed vertex ratio, vertex shader invocations per referenced vertex (1.0 is ideal)
+ */
+struct VertexCacheStatistics
+{
+    float acmr;
+    float atvr;
+};
+
+/**
+ * Size of the fifo cache used when analysing, a conservative estimate for modern gpus.
+ */
+inline constexpr auto vertex_cache_size = 16u;
+
+auto analyse_vertex_cache(
+    std::span<const std::uint32_t> indices,
+    std::uint32_t vertex_count,
+    std::uint32_t cache_size = vertex_cache_size) -> VertexCacheStatistics;
+
+/**
+ * Merge bitwise identical vertices and remap the indices.
+ */
+auto deduplicate_vertices(const MeshData &mesh) -> MeshData;
+
+/**
+ * Reorder triangles to maximise post transform cache hits, uses Tom Forsyth's linear speed vertex cache optimisation.
+ */
+auto optimise_vertex_cache(std::span<const std::uint32_t> indices, std::uint32_t vertex_count)
+    -> std::vector<std::uint32_t>;
+
+/**
+ * Reorder clusters of cache optimised triangles so that outward facing clusters are drawn first, reducing overdraw.
+ * Clusters are split where the cache restarts so the cache efficiency of the input is preserved.
+ */
+auto optimise_overdraw(std::span<const std::uint32_t> indices, std::span<const VertexData> vertices)
+    -> std::vector<std::uint32_t>;
+
+/**
+ * Reorder vertices into the order they are first referenced by the indices, unreferenced vertices are dropped.
+ */
+auto optimise_vertex_fetch(const MeshData &mesh) -> MeshData;
+
+/**
+ * Vertex count and cache efficiency of a mesh after one of the stages of optimise_mesh.
+ */
+struct OptimisationStage
+{
+    std::string_view name;
+    std::size_t vertex_count;
+    VertexCacheStatistics statistics;
+};
+
+/**
+ * An optimised mesh and how each stage changed it, in the order they ran.
+ */
+struct OptimisedMesh
+{
+    MeshData mesh;
+    std::vector<OptimisationStage> stages;
+};
+
+/**
+ * Run every stage above in order.
+ */
+auto optimise_mesh(const MeshData &mesh) -> OptimisedMesh;
+
+/**
+ * A simplified mesh and the largest distance, in model units, its surface may deviate from the input.
+ */
+struct SimplifiedMesh
+{
+    MeshData mesh;
+    float error;
+};
+
+/**
+ * Reduce a mesh towards target_index_count with quadric error edge collapses, stopping early rather than exceeding
+ * max_error. Vertices are only ever collapsed onto existing vertices and those on borders or attribute seams are never
+ * moved, so uvs and silhouettes are preserved.
+ */
+auto simplify_mesh(const MeshData &mesh, std::size_t target_index_count, float max_error) -> SimplifiedMesh;
+
+/**
+ * Build a chain of successively simplified lods, finest first and excluding the input. Errors are relative to the
+ * input, generation stops once a level no longer meaningfully reduces the triangle count.
+ */
+auto generate_lods(const MeshData &mesh) -> std::vector<SimplifiedMesh>;
+
+}
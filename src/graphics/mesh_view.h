@@ -11,6 +11,17 @@ struct MeshView
     std::uint32_t index_count;
     std::uint32_t vertex_offset;
     std::uint32_t vertex_count;
+
+    constexpr auto operator<=>(const MeshView &) const = default;
+};
+
+/**
+ * A mesh which has been moved within the geometry arena, anything holding the old view should replace it.
+ */
+struct MeshRelocation
+{
+    MeshView from;
+    MeshView to;
 };
 
 }
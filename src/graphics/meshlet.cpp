@@ -0,0 +1,246 @@
+#include "graphics/meshlet.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <map>
+#include <ranges>
+#include <span>
+#include <tuple>
+#include <unordered_set>
+#include <vector>
+
+#include "core/camera.h"
+#include "graphics/mesh_data.h"
+#include "maths/matrix4.h"
+#include "maths/transform.h"
+#include "maths/vector3.h"
+#include "maths/vector4.h"
+#include "utils/error.h"
+
+namespace
+{
+
+// cones wider than this (the cosine of the half angle between the axis and a triangle normal) can never be culled
+constexpr auto min_cone_spread = 0.1f;
+
+using EdgeKey = std::tuple<float, float, float, float, float, float>;
+
+auto edge_key(const ufps::Vector3 &a, const ufps::Vector3 &b) -> EdgeKey
+{
+    const auto as_tuple = [](const ufps::Vector3 &v) { return std::tuple{v.x, v.y, v.z}; };
+    return std::tuple_cat(std::min(as_tuple(a), as_tuple(b)), std::max(as_tuple(a), as_tuple(b)));
+}
+
+/**
+ * A mesh is closed if every edge, by position so uv seams don't count, is shared by exactly two triangles. Only then is
+ * a back facing meshlet guaranteed to be hidden, the gbuffer pass does not cull back faces.
+ */
+auto is_closed(const ufps::MeshData &mesh) -> bool
+{
+    auto edges = std::map<EdgeKey, std::uint32_t>{};
+
+    for (const auto &triangle : mesh.indices | std::views::chunk(3))
+    {
+        for (auto corner = 0zu; corner < 3zu; ++corner)
+        {
+            ++edges[edge_key(
+                mesh.vertices[triangle[corner]].position, mesh.vertices[triangle[(corner + 1zu) % 3zu]].position)];
+        }
+    }
+
+    return std::ranges::all_of(edges | std::views::values, [](auto count) { return count == 2u; });
+}
+
+/**
+ * Inward facing side planes of the frustum in view space, all pass through the origin.
+ */
+auto frustum_side_planes(const ufps::Camera &camera) -> std::array<ufps::Vector3, 4zu>
+{
+    const auto tan_half_fov = std::tan(camera.fov() / 2.0f);
+    const auto tan_half_fov_x = tan_half_fov * (camera.width() / camera.height());
+
+    return {
+        ufps::Vector3::normalise({1.0f, 0.0f, -tan_half_fov_x}),
+        ufps::Vector3::normalise({-1.0f, 0.0f, -tan_half_fov_x}),
+        ufps::Vector3::normalise({0.0f, 1.0f, -tan_half_fov}),
+        ufps::Vector3::normalise({0.0f, -1.0f, -tan_half_fov}),
+    };
+}
+
+auto meshlet_bounds(const ufps::MeshData &mesh, std::span<const std::uint32_t> indices, bool closed)
+    -> ufps::Meshlet
+{
+    auto min = ufps::Vector3{std::numeric_limits<float>::max()};
+    auto max = ufps::Vector3{std::numeric_limits<float>::lowest()};
+
+    for (const auto index : indices)
+    {
+        const auto &position = mesh.vertices[index].position;
+        min = {std::min(min.x, position.x), std::min(min.y, position.y), std::min(min.z, position.z)};
+        max = {std::max(max.x, position.x), std::max(max.y, position.y), std::max(max.z, position.z)};
+    }
+
+    const auto centre = (min + max) / 2.0f;
+    const auto radius = std::ranges::max(
+        indices | std::views::transform([&](auto index)
+                                        { return ufps::Vector3::distance(centre, mesh.vertices[index].position); }));
+
+    auto meshlet = ufps::Meshlet{
+        .index_offset = 0u,
+        .index_count = static_cast<std::uint32_t>(indices.size()),
+        .centre = centre,
+        .radius = radius,
+        .cone_axis = {},
+        .cone_cutoff = 1.0f,
+    };
+
+    if (!closed)
+    {
+        return meshlet;
+    }
+
+    const auto normals = indices | std::views::chunk(3) |
+                         std::views::transform(
+                             [&](const auto &triangle)
+                             {
+                                 const auto &v0 = mesh.vertices[triangle[0]].position;
+                                 const auto &v1 = mesh.vertices[triangle[1]].position;
+                                 const auto &v2 = mesh.vertices[triangle[2]].position;
+                                 return ufps::Vector3::normalise(ufps::Vector3::cross(v1 - v0, v2 - v0));
+                             }) |
+                         std::ranges::to<std::vector>();
+
+    const auto axis = ufps::Vector3::normalise(std::ranges::fold_left(normals, ufps::Vector3{}, std::plus{}));
+    const auto spread = std::ranges::min(
+        normals | std::views::transform([&](const auto &normal) { return ufps::Vector3::dot(axis, normal); }));
+
+    if (spread > min_cone_spread)
+    {
+        meshlet.cone_axis = axis;
+        meshlet.cone_cutoff = std::sqrt(1.0f - (spread * spread));
+    }
+
+    return meshlet;
+}
+
+}
+
+namespace ufps
+{
+
+auto build_meshlets(const MeshData &mesh) -> std::vector<Meshlet>
+{
+    expect(mesh.indices.size() % 3u == 0u, "index count must be a multiple of three");
+
+    const auto closed = is_closed(mesh);
+
+    auto meshlets = std::vector<Meshlet>{};
+    auto meshlet_vertices = std::unordered_set<std::uint32_t>{};
+    auto first = 0zu;
+
+    const auto emit = [&](std::size_t last)
+    {
+        auto &meshlet =
+            meshlets.emplace_back(meshlet_bounds(mesh, std::span{mesh.indices}.subspan(first, last - first), closed));
+        meshlet.index_offset = static_cast<std::uint32_t>(first);
+
+        meshlet_vertices.clear();
+        first = last;
+    };
+
+    for (auto triangle = 0zu; triangle < mesh.indices.size(); triangle += 3zu)
+    {
+        const auto corners = std::span{mesh.indices}.subspan(triangle, 3zu);
+        const auto new_vertices = std::ranges::count_if(
+            corners, [&](auto index) { return !meshlet_vertices.contains(index); });
+
+        if ((meshlet_vertices.size() + new_vertices > meshlet_max_vertices) ||
+            ((triangle - first) / 3zu == meshlet_max_triangles))
+        {
+            emit(triangle);
+        }
+
+        for (const auto index : corners)
+        {
+            meshlet_vertices.insert(index);
+        }
+    }
+
+    if (first != mesh.indices.size())
+    {
+        emit(mesh.indices.size());
+    }
+
+    return meshlets;
+}
+
+auto inside_frustum(const Vector3 &centre, float radius, const Transform &transform, const Camera &camera) -> bool
+{
+    const auto &[scale_x, scale_y, scale_z] = transform.scale;
+    const auto scaled_radius = radius * std::max({std::abs(scale_x), std::abs(scale_y), std::abs(scale_z)});
+    const Vector3 view_centre = camera.data().view * Matrix4{transform} * Vector4{centre, 1.0f};
+    const auto depth = -view_centre.z;
+
+    return (depth - scaled_radius >= camera.near_plane()) && (depth + scaled_radius <= camera.far_plane()) &&
+           std::ranges::all_of(
+               frustum_side_planes(camera),
+               [&](const auto &plane) { return Vector3::dot(plane, view_centre) >= scaled_radius; });
+}
+
+auto cull_meshlets(std::span<const Meshlet> meshlets, const Transform &transform, const Camera &camera)
+    -> std::vector<IndexRange>
+{
+    const auto model = Matrix4{transform};
+    const auto model_view = camera.data().view * model;
+    const auto &[scale_x, scale_y, scale_z] = transform.scale;
+    const auto scale = std::max({std::abs(scale_x), std::abs(scale_y), std::abs(scale_z)});
+
+    // normals are only transformed correctly by the model matrix under a uniform, unmirrored, scale
+    const auto cone_culling = (scale_x > 0.0f) && (scale_x == scale_y) && (scale_y == scale_z);
+
+    const auto planes = frustum_side_planes(camera);
+
+    auto ranges = std::vector<IndexRange>{};
+
+    for (const auto &meshlet : meshlets)
+    {
+        const auto radius = meshlet.radius * scale;
+        const Vector3 view_centre = model_view * Vector4{meshlet.centre, 1.0f};
+        const auto depth = -view_centre.z;
+
+        if ((depth + radius < camera.near_plane()) || (depth - radius > camera.far_plane()) ||
+            std::ranges::any_of(planes, [&](const auto &plane) { return Vector3::dot(plane, view_centre) < -radius; }))
+        {
+            continue;
+        }
+
+        if (cone_culling && (meshlet.cone_cutoff < 1.0f))
+        {
+            const Vector3 centre = model * Vector4{meshlet.centre, 1.0f};
+            const auto axis = Vector3::normalise(model * Vector4{meshlet.cone_axis, 0.0f});
+            const auto to_centre = centre - camera.position();
+
+            if (Vector3::dot(to_centre, axis) >= (meshlet.cone_cutoff * to_centre.length()) + radius)
+            {
+                continue;
+            }
+        }
+
+        if (!ranges.empty() && (ranges.back().offset + ranges.back().count == meshlet.index_offset))
+        {
+            ranges.back().count += meshlet.index_count;
+        }
+        else
+        {
+            ranges.push_back({.offset = meshlet.index_offset, .count = meshlet.index_count});
+        }
+    }
+
+    return ranges;
+}
+
+}
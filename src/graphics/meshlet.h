@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "graphics/mesh_data.h"
+#include "maths/vector3.h"
+
+namespace ufps
+{
+
+class Camera;
+class Transform;
+
+inline constexpr auto meshlet_max_vertices = 64u;
+inline constexpr auto meshlet_max_triangles = 124u;
+
+/**
+ * A small cluster of triangles which can be culled independently of the rest of its mesh. Indices are relative to the
+ * first index of the mesh so meshlets remain valid when the mesh is relocated.
+ *
+ * Bounds are in model space, a meshlet can be culled as back facing if the camera is inside the cone described by the
+ * axis and cutoff. A cutoff of one means the cone is disabled.
+ */
+struct Meshlet
+{
+    std::uint32_t index_offset;
+    std::uint32_t index_count;
+    Vector3 centre;
+    float radius;
+    Vector3 cone_axis;
+    float cone_cutoff;
+};
+
+static_assert(sizeof(Meshlet) == sizeof(std::uint32_t) * 10, "meshlets are written to disk as is");
+
+/**
+ * A range of indices relative to the first index of a mesh.
+ */
+struct IndexRange
+{
+    std::uint32_t offset;
+    std::uint32_t count;
+
+    constexpr auto operator==(const IndexRange &) const -> bool = default;
+};
+
+/**
+ * Range of the packed meshlet blob belonging to a single mesh.
+ */
+struct MeshletRange
+{
+    std::uint32_t offset;
+    std::uint32_t count;
+};
+
+/**
+ * Split a mesh into meshlets without reordering its indices, each meshlet is a run of consecutive triangles so the
+ * vertex cache order is preserved. Meshes which aren't closed are treated as double sided and get no cone.
+ */
+auto build_meshlets(const MeshData &mesh) -> std::vector<Meshlet>;
+
+/**
+ * Whether a model space bounding sphere is entirely inside the camera frustum, if so frustum culling can't remove
+ * anything from the mesh it bounds.
+ */
+auto inside_frustum(const Vector3 &centre, float radius, const Transform &transform, const Camera &camera) -> bool;
+
+/**
+ * Cull meshlets against the camera frustum and their normal cones, adjacent visible meshlets are merged into a single
+ * range.
+ */
+auto cull_meshlets(std::span<const Meshlet> meshlets, const Transform &transform, const Camera &camera)
+    -> std::vector<IndexRange>;
+
+}
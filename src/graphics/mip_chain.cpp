@@ -0,0 +1,233 @@
+#include "graphics/mip_chain.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <ranges>
+#include <span>
+#include <utility>
+
+#include "graphics/texture_data.h"
+#include "utils/data_buffer.h"
+#include "utils/error.h"
+#include "utils/exception.h"
+#include "utils/formatter.h"
+
+namespace
+{
+
+constexpr auto block_size = 4u;
+constexpr auto block_bytes = 16zu;
+
+auto channel_count(ufps::TextureFormat format) -> std::size_t
+{
+    switch (format)
+    {
+        using enum ufps::TextureFormat;
+
+        case RED: return 1zu;
+        case RGB:
+        case SRGB: return 3zu;
+        case RGBA:
+        case SRGBA: return 4zu;
+        default: throw ufps::Exception("texture format does not have 8 bit channels: {}", format);
+    }
+}
+
+/**
+ * Size of a texel as it is uploaded, float formats are uploaded as 32 bit floats.
+ */
+auto texel_size(ufps::TextureFormat format) -> std::size_t
+{
+    switch (format)
+    {
+        using enum ufps::TextureFormat;
+
+        case R16F: return 2zu * sizeof(float);
+        case RGB16F: return 3zu * sizeof(float);
+        default: return channel_count(format);
+    }
+}
+
+auto is_srgb(ufps::TextureFormat format) -> bool
+{
+    return (format == ufps::TextureFormat::SRGB) || (format == ufps::TextureFormat::SRGBA);
+}
+
+auto to_float(std::byte value) -> float
+{
+    return static_cast<float>(std::to_integer<std::uint8_t>(value)) / 255.0f;
+}
+
+auto to_linear(std::byte value) -> float
+{
+    const auto c = to_float(value);
+    return c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+}
+
+auto to_srgb(float value) -> std::byte
+{
+    const auto c = value <= 0.0031308f ? value * 12.92f : (1.055f * std::pow(value, 1.0f / 2.4f)) - 0.055f;
+    return static_cast<std::byte>(std::lround(std::clamp(c, 0.0f, 1.0f) * 255.0f));
+}
+
+auto to_unorm(float value) -> std::byte
+{
+    return static_cast<std::byte>(std::lround(std::clamp(value, 0.0f, 1.0f) * 255.0f));
+}
+
+/**
+ * Halve a level with a 2x2 box filter, odd edges clamp so the last row or column is weighted twice.
+ */
+auto downsample(
+    std::span<const std::byte> src,
+    std::uint32_t src_width,
+    std::uint32_t src_height,
+    std::size_t channels,
+    bool srgb,
+    ufps::DataBuffer &dst) -> void
+{
+    const auto width = std::max(src_width / 2u, 1u);
+    const auto height = std::max(src_height / 2u, 1u);
+
+    for (auto y = 0u; y < height; ++y)
+    {
+        const auto rows = std::array{std::min(y * 2u, src_height - 1u), std::min((y * 2u) + 1u, src_height - 1u)};
+
+        for (auto x = 0u; x < width; ++x)
+        {
+            const auto columns =
+                std::array{std::min(x * 2u, src_width - 1u), std::min((x * 2u) + 1u, src_width - 1u)};
+
+            for (auto channel = 0zu; channel < channels; ++channel)
+            {
+                // only colour is gamma encoded, the fourth channel is always alpha
+                const auto linearise = srgb && (channel < 3zu);
+                auto sum = 0.0f;
+
+                for (const auto row : rows)
+                {
+                    for (const auto column : columns)
+                    {
+                        const auto texel = (static_cast<std::size_t>(row) * src_width) + column;
+                        const auto value = src[(texel * channels) + channel];
+                        sum += linearise ? to_linear(value) : to_float(value);
+                    }
+                }
+
+                dst.push_back(linearise ? to_srgb(sum / 4.0f) : to_unorm(sum / 4.0f));
+            }
+        }
+    }
+}
+
+}
+
+namespace ufps
+{
+
+auto is_block_compressed(TextureFormat format) -> bool
+{
+    return (format == TextureFormat::BC5U) || (format == TextureFormat::BC7) || (format == TextureFormat::BC7_SRGB);
+}
+
+auto mip_level_count(std::uint32_t width, std::uint32_t height) -> std::uint32_t
+{
+    return static_cast<std::uint32_t>(std::bit_width(std::max({width, height, 1u})));
+}
+
+auto mip_extent(std::uint32_t size, std::uint32_t level) -> std::uint32_t
+{
+    return std::max(size >> level, 1u);
+}
+
+auto mip_level_size(TextureFormat format, std::uint32_t width, std::uint32_t height) -> std::size_t
+{
+    if (is_block_compressed(format))
+    {
+        return static_cast<std::size_t>((width + block_size - 1u) / block_size) *
+               ((height + block_size - 1u) / block_size) * block_bytes;
+    }
+
+    return static_cast<std::size_t>(width) * height * texel_size(format);
+}
+
+auto mip_chain_size(TextureFormat format, std::uint32_t width, std::uint32_t height, std::uint32_t mip_levels)
+    -> std::size_t
+{
+    auto size = 0zu;
+
+    for (auto level = 0u; level < mip_levels; ++level)
+    {
+        size += mip_level_size(format, mip_extent(width, level), mip_extent(height, level));
+    }
+
+    return size;
+}
+
+auto mip_chain_from(const TextureData &texture, std::uint32_t first_level) -> TextureData
+{
+    ensure(texture.data.has_value(), "cannot slice a mip chain without texture data");
+    ensure(first_level < texture.mip_levels, "level {} is outside a chain of {}", first_level, texture.mip_levels);
+
+    const auto offset = mip_chain_size(texture.format, texture.width, texture.height, first_level);
+    const auto size = mip_chain_size(texture.format, texture.width, texture.height, texture.mip_levels) - offset;
+    ensure(texture.data->size() >= offset + size, "texture data is smaller than its mip chain");
+
+    return {
+        .width = mip_extent(texture.width, first_level),
+        .height = mip_extent(texture.height, first_level),
+        .mip_levels = texture.mip_levels - first_level,
+        .format = texture.format,
+        .data = texture.data->subspan(offset, size),
+        .is_compressed = texture.is_compressed,
+    };
+}
+
+auto generate_mip_chain(const TextureData &texture) -> TextureData
+{
+    ensure(texture.data.has_value(), "cannot generate mips without texture data");
+
+    const auto channels = channel_count(texture.format);
+    const auto mip_levels = mip_level_count(texture.width, texture.height);
+    const auto first_level_size = mip_level_size(texture.format, texture.width, texture.height);
+    ensure(texture.data->size() >= first_level_size, "texture data is smaller than its first level");
+
+    auto data = DataBuffer{};
+    data.reserve(mip_chain_size(texture.format, texture.width, texture.height, mip_levels));
+    data.append_range(std::span{*texture.data}.first(first_level_size));
+
+    auto src_offset = 0zu;
+
+    for (auto level = 1u; level < mip_levels; ++level)
+    {
+        const auto src_width = mip_extent(texture.width, level - 1u);
+        const auto src_height = mip_extent(texture.height, level - 1u);
+        const auto src_size = mip_level_size(texture.format, src_width, src_height);
+
+        // the whole chain was reserved up front so appending the next level never invalidates the source level
+        downsample(
+            std::span{data}.subspan(src_offset, src_size),
+            src_width,
+            src_height,
+            channels,
+            is_srgb(texture.format),
+            data);
+
+        src_offset += src_size;
+    }
+
+    return {
+        .width = texture.width,
+        .height = texture.height,
+        .mip_levels = mip_levels,
+        .format = texture.format,
+        .data = std::move(data),
+        .is_compressed = false,
+    };
+}
+
+}
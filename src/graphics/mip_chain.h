@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "graphics/texture_data.h"
+
+namespace ufps
+{
+
+/**
+ * Whether a format is stored as 4x4 blocks rather than individual texels.
+ */
+auto is_block_compressed(TextureFormat format) -> bool;
+
+/**
+ * Number of levels in a full mip chain, down to and including 1x1.
+ */
+auto mip_level_count(std::uint32_t width, std::uint32_t height) -> std::uint32_t;
+
+/**
+ * Size of a dimension at a given mip level, never less than one.
+ */
+auto mip_extent(std::uint32_t size, std::uint32_t level) -> std::uint32_t;
+
+/**
+ * Size in bytes of a single level of the given dimensions, block compressed levels are rounded up to whole blocks.
+ */
+auto mip_level_size(TextureFormat format, std::uint32_t width, std::uint32_t height) -> std::size_t;
+
+/**
+ * Size in bytes of the first mip_levels levels stored back to back, largest first.
+ */
+auto mip_chain_size(TextureFormat format, std::uint32_t width, std::uint32_t height, std::uint32_t mip_levels)
+    -> std::size_t;
+
+/**
+ * The levels of a texture from first_level to the end of its chain, the first becomes level 0. The result shares the
+ * texture's data rather than copying it.
+ */
+auto mip_chain_from(const TextureData &texture, std::uint32_t first_level) -> TextureData;
+
+/**
+ * Build a full mip chain from the first level of an uncompressed 8 bit texture with a box filter. sRGB textures are
+ * filtered in linear space, alpha is always linear.
+ */
+auto generate_mip_chain(const TextureData &texture) -> TextureData;
+
+}
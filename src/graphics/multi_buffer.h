@@ -1,8 +1,11 @@
 #pragma once
 
+#include <array>
+#include <chrono>
 #include <cstddef>
 #include <string_view>
 
+#include "graphics/fence.h"
 #include "graphics/utils.h"
 #include "utils/data_buffer.h"
 
@@ -11,16 +14,21 @@ namespace ufps
 
 /**
  * A multi buffer wrapper over a Buffer type. Will allocate size * Frames amount of data and can advance through the
- * internal frames
+ * internal frames. Each frame is guarded by a fence so advancing onto a frame the gpu is still reading blocks until it
+ * is done.
  */
-template <IsBuffer Buffer, std::size_t Frames = 3zu>
+template <IsBuffer Buffer, std::size_t Frames = 3zu, IsFence Fence = GpuFence>
 class MultiBuffer
 {
   public:
+    static constexpr auto frame_count = Frames;
+
     MultiBuffer(std::size_t size, std::string_view name)
         : buffer_{size * Frames, name}
         , size_{size}
         , frame_offset_{}
+        , fences_{}
+        , wait_time_{}
     {
     }
 
@@ -29,9 +37,17 @@ class MultiBuffer
         buffer_.write(data, offset + frame_offset_);
     }
 
+    /**
+     * Should be called once all commands reading the current frame have been submitted.
+     */
     auto advance() -> void
     {
+        fences_[frame_index()].insert();
         frame_offset_ = (frame_offset_ + size_) % (size_ * Frames);
+
+        const auto start = std::chrono::steady_clock::now();
+        fences_[frame_index()].wait();
+        wait_time_ = std::chrono::steady_clock::now() - start;
     }
 
     auto native_handle() const
@@ -54,6 +70,19 @@ class MultiBuffer
         return frame_offset_;
     }
 
+    auto frame_index() const -> std::size_t
+    {
+        return frame_offset_ / size_;
+    }
+
+    /**
+     * Time the cpu spent blocked on the gpu in the last call to advance().
+     */
+    auto wait_time() const -> std::chrono::nanoseconds
+    {
+        return wait_time_;
+    }
+
     auto name() const -> std::string_view
     {
         return buffer_.name();
@@ -63,6 +92,8 @@ class MultiBuffer
     Buffer buffer_;
     std::size_t size_;
     std::size_t frame_offset_;
+    std::array<Fence, Frames> fences_;
+    std::chrono::nanoseconds wait_time_;
 };
 
 }
@@ -0,0 +1,208 @@
+#include "graphics/null_opengl.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ranges>
+#include <unordered_map>
+#include <vector>
+
+#include "graphics/opengl.h"
+#include "utils/error.h"
+
+namespace
+{
+
+/**
+ * Buffer storage and name counters, gl is only ever called from the main thread so this needs no synchronisation.
+ */
+struct NullState
+{
+    ::GLuint next_name = 1u;
+    ::GLuint64 next_handle = 1u;
+    std::unordered_map<::GLuint, std::vector<std::byte>> buffers;
+};
+
+auto state() -> NullState &
+{
+    static auto null_state = NullState{};
+    return null_state;
+}
+
+auto storage(::GLuint buffer, ::GLintptr offset, ::GLsizeiptr size) -> std::byte *
+{
+    auto &buffers = state().buffers;
+
+    const auto data = buffers.find(buffer);
+    ufps::expect(data != std::ranges::end(buffers), "no storage for buffer {}", buffer);
+    ufps::expect(
+        static_cast<std::size_t>(offset + size) <= data->second.size(),
+        "range [{}, {}) is outside buffer {}",
+        offset,
+        offset + size,
+        buffer);
+
+    return data->second.data() + offset;
+}
+
+/**
+ * Fallback for everything without a bespoke stand in, ignores its arguments and returns a value initialised result.
+ */
+template <class T>
+struct NullFunction;
+
+template <class R, class... Args>
+struct NullFunction<R(APIENTRY *)(Args...)>
+{
+    static auto APIENTRY call(Args...) -> R
+    {
+        return R();
+    }
+};
+
+auto APIENTRY create_names(::GLsizei n, ::GLuint *names) -> void
+{
+    for (auto i = 0; i < n; ++i)
+    {
+        names[i] = state().next_name++;
+    }
+}
+
+auto APIENTRY create_textures(::GLenum, ::GLsizei n, ::GLuint *textures) -> void
+{
+    create_names(n, textures);
+}
+
+auto APIENTRY create_shader(::GLenum) -> ::GLuint
+{
+    return state().next_name++;
+}
+
+auto APIENTRY create_program() -> ::GLuint
+{
+    return state().next_name++;
+}
+
+auto APIENTRY get_status(::GLuint, ::GLenum pname, ::GLint *params) -> void
+{
+    switch (pname)
+    {
+        case GL_COMPILE_STATUS:
+        case GL_LINK_STATUS:
+        case GL_VALIDATE_STATUS: *params = GL_TRUE; break;
+        default: *params = 0; break;
+    }
+}
+
+auto APIENTRY check_frame_buffer_status(::GLuint, ::GLenum) -> ::GLenum
+{
+    return GL_FRAMEBUFFER_COMPLETE;
+}
+
+auto APIENTRY texture_sampler_handle(::GLuint, ::GLuint) -> ::GLuint64
+{
+    return state().next_handle++;
+}
+
+auto APIENTRY buffer_storage(::GLuint buffer, ::GLsizeiptr size, const void *data, ::GLbitfield) -> void
+{
+    auto &backing = state().buffers[buffer];
+    backing.assign(static_cast<std::size_t>(size), std::byte{});
+
+    if (data != nullptr)
+    {
+        std::memcpy(backing.data(), data, backing.size());
+    }
+}
+
+auto APIENTRY delete_buffers(::GLsizei n, const ::GLuint *buffers) -> void
+{
+    for (auto i = 0; i < n; ++i)
+    {
+        state().buffers.erase(buffers[i]);
+    }
+}
+
+auto APIENTRY buffer_sub_data(::GLuint buffer, ::GLintptr offset, ::GLsizeiptr size, const void *data) -> void
+{
+    std::memcpy(storage(buffer, offset, size), data, static_cast<std::size_t>(size));
+}
+
+auto APIENTRY get_buffer_sub_data(::GLuint buffer, ::GLintptr offset, ::GLsizeiptr size, void *data) -> void
+{
+    std::memcpy(data, storage(buffer, offset, size), static_cast<std::size_t>(size));
+}
+
+auto APIENTRY copy_buffer_sub_data(
+    ::GLuint read_buffer,
+    ::GLuint write_buffer,
+    ::GLintptr read_offset,
+    ::GLintptr write_offset,
+    ::GLsizeiptr size) -> void
+{
+    // reading and writing the same buffer is allowed as long as the ranges don't overlap, memmove is fine either way
+    std::memmove(
+        storage(write_buffer, write_offset, size),
+        storage(read_buffer, read_offset, size),
+        static_cast<std::size_t>(size));
+}
+
+auto APIENTRY map_buffer_range(::GLuint buffer, ::GLintptr offset, ::GLsizeiptr length, ::GLbitfield) -> void *
+{
+    return storage(buffer, offset, length);
+}
+
+auto APIENTRY unmap_buffer(::GLuint) -> ::GLboolean
+{
+    return GL_TRUE;
+}
+
+auto APIENTRY fence_sync(::GLenum, ::GLbitfield) -> ::GLsync
+{
+    // never dereferenced, it only has to be distinguishable from a failed fence
+    static auto fence = std::byte{};
+    return reinterpret_cast<::GLsync>(&fence);
+}
+
+auto APIENTRY client_wait_sync(::GLsync, ::GLbitfield, ::GLuint64) -> ::GLenum
+{
+    return GL_ALREADY_SIGNALED;
+}
+
+}
+
+namespace ufps
+{
+
+auto use_null_opengl() -> void
+{
+#define NULL_FUNCTION(TYPE, NAME) ::NAME = &NullFunction<TYPE>::call;
+
+    FOR_OPENGL_FUNCTIONS(NULL_FUNCTION)
+
+    ::glCreateBuffers = create_names;
+    ::glGenBuffers = create_names;
+    ::glCreateVertexArrays = create_names;
+    ::glGenVertexArrays = create_names;
+    ::glCreateSamplers = create_names;
+    ::glCreateFramebuffers = create_names;
+    ::glCreateRenderbuffers = create_names;
+    ::glCreateTextures = create_textures;
+    ::glCreateShader = create_shader;
+    ::glCreateProgram = create_program;
+    ::glGetShaderiv = get_status;
+    ::glGetProgramiv = get_status;
+    ::glCheckNamedFramebufferStatus = check_frame_buffer_status;
+    ::glGetTextureSamplerHandleARB = texture_sampler_handle;
+    ::glNamedBufferStorage = buffer_storage;
+    ::glDeleteBuffers = delete_buffers;
+    ::glNamedBufferSubData = buffer_sub_data;
+    ::glGetNamedBufferSubData = get_buffer_sub_data;
+    ::glCopyNamedBufferSubData = copy_buffer_sub_data;
+    ::glMapNamedBufferRange = map_buffer_range;
+    ::glUnmapNamedBuffer = unmap_buffer;
+    ::glFenceSync = fence_sync;
+    ::glClientWaitSync = client_wait_sync;
+}
+
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+namespace ufps
+{
+
+/**
+ * Point every function in FOR_OPENGL_FUNCTIONS at a cpu stand in so gpu resources can be created and used without a
+ * gl context. Objects get unique names, buffers are backed by host memory so sub data writes and mapped writes land
+ * somewhere, fences are always signalled and shaders, programs and frame buffers are always complete. Everything else
+ * does nothing.
+ *
+ * Core 1.1 functions come straight from opengl32 and are not replaced, without a current context they are no-ops.
+ */
+auto use_null_opengl() -> void;
+
+}
@@ -0,0 +1,87 @@
+#include "graphics/null_renderer.h"
+
+#include <chrono>
+#include <cstddef>
+
+#include "core/camera.h"
+#include "core/scene.h"
+#include "core/service_locator.h"
+#include "graphics/debug_group.h"
+#include "graphics/deferred_release.h"
+#include "graphics/frame_preparation.h"
+
+namespace
+{
+
+// same as the renderer, the transient buffer grows if a frame needs more
+constexpr auto transient_frame_size = 4zu * 1024zu * 1024zu;
+
+// there's no device to ask, this is the largest storage buffer offset alignment gl allows
+constexpr auto transient_alignment = 256zu;
+
+}
+
+namespace ufps
+{
+
+NullRenderer::NullRenderer()
+    : transient_buffer_{transient_frame_size, transient_alignment, "null_transient_buffer"}
+    , light_buffer_{"null_light_buffer"}
+    , render_metrics_{}
+{
+}
+
+auto NullRenderer::render(Scene &scene, const Camera &camera) -> void
+{
+    transient_buffer_.upload(camera.data_view());
+
+    execute_gbuffer_pass(scene, camera);
+    execute_light_cluster_pass(scene, camera);
+
+    render_metrics_.transient_bytes = transient_buffer_.frame_used();
+    render_metrics_.transient_high_water_mark = transient_buffer_.high_water_mark();
+
+    transient_buffer_.advance();
+    light_buffer_.advance();
+
+    render_metrics_.cpu_wait_ms =
+        std::chrono::duration<float, std::milli>(transient_buffer_.wait_time() + light_buffer_.wait_time()).count();
+
+    auto &deferred_release = service<DeferredRelease<>>();
+    deferred_release.collect();
+    render_metrics_.deferred_release_count = deferred_release.size();
+}
+
+auto NullRenderer::execute_gbuffer_pass(const Scene &scene, const Camera &camera) -> void
+{
+    const auto debug_group = DebugGroup{"gbuffer"};
+
+    // nothing is drawn, the uploads are left for the transient buffer to recycle
+    prepare_draws(scene, camera, transient_buffer_, render_metrics_);
+}
+
+auto NullRenderer::execute_light_cluster_pass(Scene &scene, const Camera &camera) -> void
+{
+    const auto debug_group = DebugGroup{"light_cluster"};
+
+    const auto upload_start = std::chrono::steady_clock::now();
+    render_metrics_.light_upload_bytes = light_buffer_.upload(scene.lights());
+    render_metrics_.light_upload_ms =
+        std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - upload_start).count();
+
+    const auto &lights = scene.lights();
+
+    const auto cluster_start = std::chrono::steady_clock::now();
+    pack_light_clusters(camera, lights.lights.data(), transient_buffer_, render_metrics_);
+    const auto cluster_end = std::chrono::steady_clock::now();
+
+    render_metrics_.light_count = lights.lights.size();
+    render_metrics_.light_cluster_ms = std::chrono::duration<float, std::milli>(cluster_end - cluster_start).count();
+}
+
+auto NullRenderer::metrics() const -> const RenderMetrics &
+{
+    return render_metrics_;
+}
+
+}
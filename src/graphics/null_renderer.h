@@ -0,0 +1,35 @@
+#pragma once
+
+#include "core/camera.h"
+#include "core/scene.h"
+#include "graphics/light_buffer.h"
+#include "graphics/render_metrics.h"
+#include "graphics/transient_buffer.h"
+
+namespace ufps
+{
+
+/**
+ * Stand in for Renderer when there is no window or gpu. Does all the cpu side preparation of a frame, building draw
+ * commands and object data, packing lights and clustering them, and writes the results into the same buffers the
+ * renderer uses but never draws anything. Its buffers still need gl, either a real context or use_null_opengl().
+ */
+class NullRenderer
+{
+  public:
+    NullRenderer();
+
+    auto render(Scene &scene, const Camera &camera) -> void;
+
+    auto metrics() const -> const RenderMetrics &;
+
+  private:
+    auto execute_gbuffer_pass(const Scene &scene, const Camera &camera) -> void;
+    auto execute_light_cluster_pass(Scene &scene, const Camera &camera) -> void;
+
+    TransientBuffer<> transient_buffer_;
+    LightBuffer light_buffer_;
+    RenderMetrics render_metrics_;
+};
+
+}
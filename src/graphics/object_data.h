@@ -10,12 +10,10 @@ namespace ufps
 struct alignas(16) ObjectData
 {
     Matrix4 model;
-    std::uint64_t albedo_texture_index;
-    std::uint64_t normal_texture_index;
-    std::uint64_t specular_texture_index;
-    std::uint64_t glossiness_texture_index;
-    std::uint64_t emissive_texture_index;
+    std::uint32_t material_index;
     float emissive_strength;
 };
 
+static_assert(sizeof(ObjectData) == sizeof(float) * 20);
+
 }
@@ -41,12 +41,14 @@
     DO(::PFNGLCREATEBUFFERSPROC, glCreateBuffers)                                                                      \
     DO(::PFNGLNAMEDBUFFERSTORAGEPROC, glNamedBufferStorage)                                                            \
     DO(::PFNGLCLEARNAMEDBUFFERDATAPROC, glClearNamedBufferData)                                                        \
+    DO(::PFNGLCLEARNAMEDBUFFERSUBDATAPROC, glClearNamedBufferSubData)                                                  \
     DO(::PFNGLCREATEVERTEXARRAYSPROC, glCreateVertexArrays)                                                            \
     DO(::PFNGLVERTEXARRAYBINDVERTEXBUFFEREXTPROC, glVertexArrayVertexBuffer)                                           \
     DO(::PFNGLENABLEVERTEXARRAYATTRIBPROC, glEnableVertexArrayAttrib)                                                  \
     DO(::PFNGLVERTEXARRAYATTRIBFORMATPROC, glVertexArrayAttribFormat)                                                  \
     DO(::PFNGLVERTEXARRAYATTRIBBINDINGPROC, glVertexArrayAttribBinding)                                                \
     DO(::PFNGLNAMEDBUFFERSUBDATAPROC, glNamedBufferSubData)                                                            \
+    DO(::PFNGLCOPYNAMEDBUFFERSUBDATAPROC, glCopyNamedBufferSubData)                                                    \
     DO(::PFNGLVERTEXARRAYELEMENTBUFFERPROC, glVertexArrayElementBuffer)                                                \
     DO(::PFNGLDRAWELEMENTSBASEVERTEXPROC, glDrawElementsBaseVertex)                                                    \
     DO(::PFNGLBINDBUFFERBASEPROC, glBindBufferBase)                                                                    \
@@ -61,6 +63,7 @@
     DO(::PFNGLTEXTURESUBIMAGE2DPROC, glTextureSubImage2D)                                                              \
     DO(::PFNGLCOMPRESSEDTEXTURESUBIMAGE2DPROC, glCompressedTextureSubImage2D)                                          \
     DO(::PFNGLTEXTURESUBIMAGE3DPROC, glTextureSubImage3D)                                                              \
+    DO(::PFNGLCOPYIMAGESUBDATAPROC, glCopyImageSubData)                                                                \
     DO(::PFNGLCREATESAMPLERSPROC, glCreateSamplers)                                                                    \
     DO(::PFNGLDELETESAMPLERSPROC, glDeleteSamplers)                                                                    \
     DO(::PFNGLBINDTEXTUREUNITPROC, glBindTextureUnit)                                                                  \
@@ -84,6 +87,8 @@
     DO(::PFNGLNAMEDFRAMEBUFFERREADBUFFERPROC, glNamedFramebufferReadBuffer)                                            \
     DO(::PFNGLNAMEDFRAMEBUFFERDRAWBUFFERPROC, glNamedFramebufferDrawBuffer)                                            \
     DO(::PFNGLOBJECTLABELPROC, glObjectLabel)                                                                          \
+    DO(::PFNGLPUSHDEBUGGROUPPROC, glPushDebugGroup)                                                                    \
+    DO(::PFNGLPOPDEBUGGROUPPROC, glPopDebugGroup)                                                                      \
     DO(::PFNGLVALIDATEPROGRAMPROC, glValidateProgram)                                                                  \
     DO(::PFNGLMULTIDRAWARRAYSINDIRECTPROC, glMultiDrawArraysIndirect)                                                  \
     DO(::PFNGLMULTIDRAWELEMENTSINDIRECTPROC, glMultiDrawElementsIndirect)                                              \
@@ -91,7 +96,10 @@
     DO(::PFNGLDISPATCHCOMPUTEPROC, glDispatchCompute)                                                                  \
     DO(::PFNGLMEMORYBARRIERPROC, glMemoryBarrier)                                                                      \
     DO(::PFNGLGETNAMEDBUFFERSUBDATAPROC, glGetNamedBufferSubData)                                                      \
-    DO(::PFNGLUNMAPNAMEDBUFFERPROC, glUnmapNamedBuffer)
+    DO(::PFNGLUNMAPNAMEDBUFFERPROC, glUnmapNamedBuffer)                                                                \
+    DO(::PFNGLFENCESYNCPROC, glFenceSync)                                                                              \
+    DO(::PFNGLCLIENTWAITSYNCPROC, glClientWaitSync)                                                                    \
+    DO(::PFNGLDELETESYNCPROC, glDeleteSync)
 
 #define DO_DEFINE(TYPE, NAME) inline TYPE NAME;
 FOR_OPENGL_FUNCTIONS(DO_DEFINE)
@@ -0,0 +1,120 @@
+#include "graphics/packed_vertex.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <stdfloat>
+
+#include "graphics/vertex_data.h"
+#include "maths/vector3.h"
+
+namespace
+{
+
+constexpr auto bitangent_sign_bit = 1u << 16u;
+
+auto sign_not_zero(float v) -> float
+{
+    return v >= 0.0f ? 1.0f : -1.0f;
+}
+
+// matches glsl packSnorm2x16
+auto pack_snorm16(float v) -> std::uint32_t
+{
+    const auto quantised = static_cast<std::int16_t>(std::round(std::clamp(v, -1.0f, 1.0f) * 32767.0f));
+    return static_cast<std::uint32_t>(std::bit_cast<std::uint16_t>(quantised));
+}
+
+// matches glsl unpackSnorm2x16
+auto unpack_snorm16(std::uint32_t v) -> float
+{
+    const auto quantised = std::bit_cast<std::int16_t>(static_cast<std::uint16_t>(v & 0xffffu));
+    return std::clamp(static_cast<float>(quantised) / 32767.0f, -1.0f, 1.0f);
+}
+
+auto pack_half2(float x, float y) -> std::uint32_t
+{
+    const auto low = std::bit_cast<std::uint16_t>(static_cast<std::float16_t>(x));
+    const auto high = std::bit_cast<std::uint16_t>(static_cast<std::float16_t>(y));
+
+    return static_cast<std::uint32_t>(low) | (static_cast<std::uint32_t>(high) << 16u);
+}
+
+auto unpack_half(std::uint32_t v) -> float
+{
+    return static_cast<float>(std::bit_cast<std::float16_t>(static_cast<std::uint16_t>(v & 0xffffu)));
+}
+
+}
+
+namespace ufps
+{
+
+auto octahedral_encode(const Vector3 &v) -> std::uint32_t
+{
+    // project onto the octahedron |x| + |y| + |z| = 1 then fold the lower hemisphere over the upper
+    const auto l1 = std::abs(v.x) + std::abs(v.y) + std::abs(v.z);
+
+    // also catches nan, which would otherwise reach the integer conversion in pack_snorm16
+    if (!(l1 > 0.0f))
+    {
+        return octahedral_encode({0.0f, 0.0f, 1.0f});
+    }
+
+    auto x = v.x / l1;
+    auto y = v.y / l1;
+
+    if (v.z < 0.0f)
+    {
+        const auto folded_x = (1.0f - std::abs(y)) * sign_not_zero(x);
+        const auto folded_y = (1.0f - std::abs(x)) * sign_not_zero(y);
+        x = folded_x;
+        y = folded_y;
+    }
+
+    return pack_snorm16(x) | (pack_snorm16(y) << 16u);
+}
+
+auto octahedral_decode(std::uint32_t encoded) -> Vector3
+{
+    const auto x = unpack_snorm16(encoded);
+    const auto y = unpack_snorm16(encoded >> 16u);
+    const auto z = 1.0f - std::abs(x) - std::abs(y);
+
+    // unfold the lower hemisphere
+    const auto t = std::max(-z, 0.0f);
+
+    return Vector3::normalise({x + (x >= 0.0f ? -t : t), y + (y >= 0.0f ? -t : t), z});
+}
+
+auto pack_vertex(const VertexData &vertex) -> PackedVertex
+{
+    const auto handedness = Vector3::dot(Vector3::cross(vertex.normal, vertex.tangent), vertex.bitangent);
+    const auto tangent = octahedral_encode(vertex.tangent) & ~bitangent_sign_bit;
+
+    return {
+        .position = vertex.position,
+        .normal = octahedral_encode(vertex.normal),
+        .tangent = handedness < 0.0f ? tangent | bitangent_sign_bit : tangent,
+        .uv = pack_half2(vertex.uv.s, vertex.uv.t),
+    };
+}
+
+auto unpack_vertex(const PackedVertex &vertex) -> VertexData
+{
+    const auto normal = octahedral_decode(vertex.normal);
+    const auto tangent = octahedral_decode(vertex.tangent);
+    const auto sign = (vertex.tangent & bitangent_sign_bit) != 0u ? -1.0f : 1.0f;
+    const auto bitangent = Vector3::cross(normal, tangent);
+
+    return {
+        .position = vertex.position,
+        .normal = normal,
+        .tangent = tangent,
+        .bitangent = {bitangent.x * sign, bitangent.y * sign, bitangent.z * sign},
+        .uv = {.s = unpack_half(vertex.uv), .t = unpack_half(vertex.uv >> 16u)},
+    };
+}
+
+}
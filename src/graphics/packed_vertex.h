@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+
+#include "graphics/vertex_data.h"
+#include "maths/vector3.h"
+
+namespace ufps
+{
+
+/**
+ * Compact gpu vertex format, must match the decode functions in the vertex shaders.
+ *
+ * - position is full float
+ * - normal is octahedral encoded as two 16 bit snorms
+ * - tangent is octahedral encoded as two 16 bit snorms, the lowest bit holds the bitangent sign (set if negative)
+ * - uv is two half floats
+ *
+ * The bitangent is rebuilt on decode as sign * cross(normal, tangent).
+ */
+struct PackedVertex
+{
+    Vector3 position;
+    std::uint32_t normal;
+    std::uint32_t tangent;
+    std::uint32_t uv;
+};
+
+static_assert(sizeof(PackedVertex) == sizeof(float) * 3 + sizeof(std::uint32_t) * 3);
+
+/**
+ * Encode a unit vector onto the octahedron, packed as two snorm16 values with x in the low half. A zero length vector,
+ * which imported meshes do contain, has no direction so encodes as +Z.
+ */
+auto octahedral_encode(const Vector3 &v) -> std::uint32_t;
+
+auto octahedral_decode(std::uint32_t encoded) -> Vector3;
+
+auto pack_vertex(const VertexData &vertex) -> PackedVertex;
+
+auto unpack_vertex(const PackedVertex &vertex) -> VertexData;
+
+}
@@ -5,6 +5,7 @@
 #include <string>
 #include <string_view>
 
+#include "graphics/gl_recorder.h"
 #include "graphics/opengl.h"
 #include "utils/auto_release.h"
 #include "utils/data_buffer.h"
@@ -30,6 +31,7 @@ auto PersistentBuffer::write(DataBufferView data, std::size_t offset) const -> v
 {
     expect(size_ >= data.size_bytes() + offset, "buffer too small");
     std::memcpy(reinterpret_cast<std::byte *>(map_) + offset, data.data(), data.size_bytes());
+    record_mapped_write(data.size_bytes());
 }
 
 auto PersistentBuffer::native_handle() const -> ::GLuint
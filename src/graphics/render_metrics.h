@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+
+namespace ufps
+{
+
+/**
+ * Statistics for the last rendered frame, timings are cpu time only.
+ */
+struct RenderMetrics
+{
+    std::size_t command_count;
+    std::size_t instance_count;
+    std::size_t triangle_count;
+    std::size_t lod0_triangle_count;
+    float command_build_ms;
+    std::size_t light_count;
+    std::size_t light_index_count;
+    float light_cluster_ms;
+    std::size_t light_upload_bytes;
+    float light_upload_ms;
+    float cpu_wait_ms;
+    std::size_t transient_bytes;
+    std::size_t transient_high_water_mark;
+    std::size_t deferred_release_count;
+};
+
+}
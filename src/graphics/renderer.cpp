@@ -1,24 +1,33 @@
 #include "graphics/renderer.h"
 
 #include <GL/gl.h>
+#include <algorithm>
 #include <chrono>
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <optional>
 #include <random>
 #include <ranges>
 #include <span>
+#include <string>
 #include <string_view>
+#include <utility>
 
 #include "core/camera.h"
 #include "core/entity.h"
 #include "core/scene.h"
 #include "core/service_locator.h"
-#include "graphics/buffer_writer.h"
 #include "graphics/command_buffer.h"
+#include "graphics/debug_group.h"
+#include "graphics/deferred_release.h"
 #include "graphics/frame_buffer.h"
+#include "graphics/frame_preparation.h"
+#include "graphics/light_buffer.h"
+#include "graphics/light_clusters.h"
+#include "graphics/material_manager.h"
 #include "graphics/mesh_manager.h"
-#include "graphics/object_data.h"
+#include "graphics/mesh_view.h"
 #include "graphics/opengl.h"
 #include "graphics/point_light.h"
 #include "graphics/program.h"
@@ -37,6 +46,20 @@ using namespace std::literals;
 namespace
 {
 
+// must match light_cluster.comp
+constexpr auto max_gpu_lights_per_cluster = 256u;
+
+// initial space for per frame uploads, the transient buffer grows if a frame needs more
+constexpr auto transient_frame_size = 4zu * 1024zu * 1024zu;
+
+auto storage_buffer_alignment() -> std::size_t
+{
+    auto alignment = ::GLint{};
+    ::glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+
+    return static_cast<std::size_t>(alignment);
+}
+
 template <class T>
 struct AutoBind
 {
@@ -67,6 +90,7 @@ auto create_render_target(
     const auto colour_attachment_texture_data = ufps::TextureData{
         .width = width,
         .height = height,
+        .mip_levels = 1u,
         .format = format,
         .data = std::nullopt,
         .is_compressed = false,
@@ -97,6 +121,7 @@ auto create_render_target(
     const auto depth_texture_data = ufps::TextureData{
         .width = width,
         .height = height,
+        .mip_levels = 1u,
         .format = ufps::TextureFormat::DEPTH24,
         .data = std::nullopt,
         .is_compressed = false,
@@ -142,12 +167,14 @@ auto create_sprite() -> ufps::Entity
     return {
         "post_process_sprite",
         {{mesh_views.front(),
-          texture_manager.texture_index("textures\\default_BaseColor.dds"),
-          texture_manager.texture_index("textures\\default_Normal.dds"),
-          texture_manager.texture_index("textures\\default_Metallic.dds"),
-          texture_manager.texture_index("textures\\default_AO.dds"),
-          texture_manager.texture_index("textures\\default_Roughness.dds"),
-          texture_manager.texture_index("textures\\default_Emissive.dds")}},
+          ufps::service<ufps::MaterialManager>().add({
+              .albedo_texture_bindless_handle = texture_manager.bindless_handle("textures\\default_BaseColor.dds"),
+              .normal_texture_bindless_handle = texture_manager.bindless_handle("textures\\default_Normal.dds"),
+              .specular_texture_bindless_handle = texture_manager.bindless_handle("textures\\default_Metallic.dds"),
+              .ao_texture_bindless_handle = texture_manager.bindless_handle("textures\\default_AO.dds"),
+              .glossiness_texture_bindless_handle = texture_manager.bindless_handle("textures\\default_Roughness.dds"),
+              .emissive_texture_bindless_handle = texture_manager.bindless_handle("textures\\default_Emissive.dds"),
+          })}},
         {}};
 }
 
@@ -174,8 +201,9 @@ auto create_ssao_noise_texture(const ufps::Sampler &sampler) -> std::uint64_t
     const auto ssao_noise_texture_data = ufps::TextureData{
         .width = 4,
         .height = 4,
+        .mip_levels = 1u,
         .format = ufps::TextureFormat::RGB,
-        .data = ssao_noise_data,
+        .data = std::move(ssao_noise_data),
         .is_compressed = false,
     };
 
@@ -198,15 +226,22 @@ Renderer::Renderer(
     ResourceLoader &resource_loader)
     : window_{window}
     , dummy_vao_{0u, [](auto e) { ::glDeleteVertexArrays(1u, &e); }}
-    , command_buffer_{"gbuffer_command_buffer"}
     , post_processing_command_buffer_{"post_processing_command_buffer"}
     , post_process_sprite_{create_sprite()}
-    , camera_buffer_{sizeof(CameraData), "camera_buffer"}
-    , light_buffer_{sizeof(LightData), "light_buffer"}
-    , object_data_buffer_{sizeof(ObjectData), "object_data_buffer"}
+    , transient_buffer_{transient_frame_size, storage_buffer_alignment(), "transient_buffer"}
+    , camera_allocation_{}
+    , light_cluster_allocation_{}
+    , light_index_allocation_{}
+    , light_buffer_{"light_buffer"}
     , luminance_histogram_buffer_{sizeof(std::uint32_t) * 256, "luminance_histogram_buffer"}
     , average_luminance_buffer_{sizeof(float), "average_luminance_buffer"}
     , ssao_samples_buffer_{sizeof(Vector4) * 64, "ssao_samples_buffer"}
+    , gpu_light_cluster_buffer_{
+          sizeof(LightClusterHeader) + sizeof(LightCluster) * LightClusterGrid::count,
+          "gpu_light_cluster_buffer"}
+    , gpu_light_index_buffer_{
+          sizeof(std::uint32_t) * LightClusterGrid::count * max_gpu_lights_per_cluster,
+          "gpu_light_index_buffer"}
     , gbuffer_program_{create_program(
           resource_loader,
           "shaders\\gbuffer.vert",
@@ -221,6 +256,11 @@ Renderer::Renderer(
           "shaders\\light_pass.frag",
           "light_pass_fragment_shader",
           "light_pass_program")}
+    , light_cluster_program_{create_program(
+          resource_loader,
+          "shaders\\light_cluster.comp",
+          "light_cluster_shader",
+          "light_cluster_program")}
     , tone_map_program_{create_program(
           resource_loader,
           "shaders\\tone_map.vert",
@@ -330,6 +370,8 @@ Renderer::Renderer(
           "bloom"),}
     ,final_fb_{}
     , enable_post_processing_{true}
+    , gpu_light_clustering_{false}
+    , render_metrics_{}
 {
     post_processing_command_buffer_.build(post_process_sprite_);
 
@@ -378,9 +420,10 @@ Renderer::Renderer(
 
 auto Renderer::render(Scene &scene, const Camera &camera) -> void
 {
-    camera_buffer_.write(camera.data_view(), 0zu);
+    camera_allocation_ = transient_buffer_.upload(camera.data_view());
 
-    execute_gbuffer_pass(scene);
+    execute_gbuffer_pass(scene, camera);
+    execute_light_cluster_pass(scene, camera);
     execute_lighting_pass(scene);
 
     if (enable_post_processing_)
@@ -398,12 +441,33 @@ auto Renderer::render(Scene &scene, const Camera &camera) -> void
         final_fb_ = &light_pass_rt_.fb;
     }
 
-    post_render(scene, camera);
+    {
+        const auto debug_group = DebugGroup{"post_render"};
+        post_render(scene, camera);
+    }
+
+    render_metrics_.transient_bytes = transient_buffer_.frame_used();
+    render_metrics_.transient_high_water_mark = transient_buffer_.high_water_mark();
 
-    command_buffer_.advance();
-    camera_buffer_.advance();
+    transient_buffer_.advance();
     light_buffer_.advance();
-    object_data_buffer_.advance();
+
+    // typically only the first of these blocks, by the time the second waits its fence has already signalled
+    render_metrics_.cpu_wait_ms =
+        std::chrono::duration<float, std::milli>(transient_buffer_.wait_time() + light_buffer_.wait_time()).count();
+
+    auto &deferred_release = service<DeferredRelease<>>();
+    deferred_release.collect();
+    render_metrics_.deferred_release_count = deferred_release.size();
+}
+
+auto Renderer::relocate_meshes(std::span<const MeshRelocation> relocations) -> void
+{
+    post_process_sprite_.relocate_meshes(relocations);
+
+    // move onto a frame the gpu has finished with before rewriting the command
+    post_processing_command_buffer_.advance();
+    post_processing_command_buffer_.build(post_process_sprite_);
 }
 
 auto Renderer::post_render(Scene &, const Camera &) -> void
@@ -451,8 +515,10 @@ auto Renderer::create_program(
     return ufps::Program{compute_shader, program_name};
 }
 
-auto Renderer::execute_gbuffer_pass(Scene &scene) -> void
+auto Renderer::execute_gbuffer_pass(Scene &scene, const Camera &camera) -> void
 {
+    const auto debug_group = DebugGroup{"gbuffer"};
+
     gbuffer_rt_.fb.bind();
     ::glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
@@ -463,75 +529,101 @@ auto Renderer::execute_gbuffer_pass(Scene &scene) -> void
     ::glBindBufferRange(
         GL_SHADER_STORAGE_BUFFER,
         1,
-        camera_buffer_.native_handle(),
-        camera_buffer_.frame_offset_bytes(),
-        sizeof(CameraData));
+        camera_allocation_.buffer,
+        camera_allocation_.offset,
+        camera_allocation_.size);
     ::glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffer_handle);
 
-    const auto command_count = command_buffer_.build(scene);
-    ::glBindBuffer(GL_DRAW_INDIRECT_BUFFER, command_buffer_.native_handle());
+    const auto [batch, commands, object_data] = prepare_draws(scene, camera, transient_buffer_, render_metrics_);
 
-    auto object_data = std::vector<ObjectData>{};
-
-    for (const auto &entity : scene.entities())
-    {
-        object_data.append_range(
-            entity.render_entities() | std::views::transform(
-                                           [&entity](const auto &e)
-                                           {
-                                               return ObjectData{
-                                                   .model = entity.transform(),
-                                                   .albedo_texture_index = e.albedo_texture_bindless_handle(),
-                                                   .normal_texture_index = e.normal_texture_bindless_handle(),
-                                                   .specular_texture_index = e.specular_texture_bindless_handle(),
-                                                   .glossiness_texture_index = e.glossiness_texture_bindless_handle(),
-                                                   .emissive_texture_index = e.emissive_texture_bindless_handle(),
-                                                   .emissive_strength = entity.emissive_strength(),
-                                               };
-                                           }));
-    }
-
-    resize_gpu_buffer(object_data, object_data_buffer_);
-    object_data_buffer_.write(std::as_bytes(std::span{object_data.data(), object_data.size()}), 0zu);
-    ::glBindBufferRange(
-        GL_SHADER_STORAGE_BUFFER,
-        2,
-        object_data_buffer_.native_handle(),
-        object_data_buffer_.frame_offset_bytes(),
-        object_data_buffer_.size());
+    ::glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commands.buffer);
+    ::glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 2, object_data.buffer, object_data.offset, object_data.size);
+    ::glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, service<MaterialManager>().native_handle());
 
     ::glMultiDrawElementsIndirect(
         GL_TRIANGLES,
         GL_UNSIGNED_INT,
-        reinterpret_cast<const void *>(command_buffer_.offset_bytes()),
-        command_count,
+        reinterpret_cast<const void *>(commands.offset),
+        batch.commands.size(),
         0);
 }
 
-auto Renderer::execute_lighting_pass(Scene &scene) -> void
+auto Renderer::execute_light_cluster_pass(Scene &scene, const Camera &camera) -> void
 {
-    light_pass_rt_.fb.bind();
-    ::glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    const auto debug_group = DebugGroup{"light_cluster"};
 
-    const auto auto_bind = AutoBind{light_pass_program_};
+    const auto upload_start = std::chrono::steady_clock::now();
+    render_metrics_.light_upload_bytes = light_buffer_.upload(scene.lights());
+    render_metrics_.light_upload_ms =
+        std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - upload_start).count();
 
-    {
-        const auto &lights = scene.lights();
+    const auto &lights = scene.lights();
 
-        const auto buffer_size_bytes =
-            sizeof(lights.ambient) + sizeof(std::uint32_t) + sizeof(PointLight) * lights.lights.size();
-        if (light_buffer_.size() < buffer_size_bytes)
-        {
-            light_buffer_ = {buffer_size_bytes, light_buffer_.name()};
-            // opengl barrier incase gpu using previous frame
-            ::glFinish();
-        }
+    const auto cluster_start = std::chrono::steady_clock::now();
 
-        auto writer = BufferWriter{light_buffer_};
-        writer.write(lights.ambient);
-        writer.write(static_cast<std::uint32_t>(lights.lights.size()));
-        writer.write(lights.lights.data());
+    if (gpu_light_clustering_)
+    {
+        const auto auto_bind = AutoBind{light_cluster_program_};
+
+        // the shader allocates from the light index count in the header so it must start at zero each frame
+        const auto zero = ::GLuint{0};
+        ::glClearNamedBufferSubData(
+            gpu_light_cluster_buffer_.native_handle(),
+            GL_R32UI,
+            offsetof(LightClusterHeader, light_index_count),
+            sizeof(std::uint32_t),
+            GL_RED_INTEGER,
+            GL_UNSIGNED_INT,
+            &zero);
+
+        ::glBindBufferRange(
+            GL_SHADER_STORAGE_BUFFER,
+            0,
+            light_buffer_.native_handle(),
+            light_buffer_.frame_offset_bytes(),
+            light_buffer_.size());
+        ::glBindBufferRange(
+            GL_SHADER_STORAGE_BUFFER,
+            1,
+            camera_allocation_.buffer,
+            camera_allocation_.offset,
+            camera_allocation_.size);
+        ::glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, gpu_light_cluster_buffer_.native_handle());
+        ::glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, gpu_light_index_buffer_.native_handle());
+
+        light_cluster_program_.set_uniforms(
+            std::tan(camera.fov() / 2.0f),
+            camera.width() / camera.height(),
+            camera.near_plane(),
+            camera.far_plane());
+
+        ::glDispatchCompute(LightClusterGrid::width, LightClusterGrid::height, LightClusterGrid::depth);
+        ::glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+        // index count stays on the gpu, reading it back would stall
+        render_metrics_.light_index_count = 0zu;
     }
+    else
+    {
+        const auto clusters = pack_light_clusters(camera, lights.lights.data(), transient_buffer_, render_metrics_);
+        light_cluster_allocation_ = clusters.clusters;
+        light_index_allocation_ = clusters.light_indices;
+    }
+
+    const auto cluster_end = std::chrono::steady_clock::now();
+
+    render_metrics_.light_count = lights.lights.size();
+    render_metrics_.light_cluster_ms = std::chrono::duration<float, std::milli>(cluster_end - cluster_start).count();
+}
+
+auto Renderer::execute_lighting_pass([[maybe_unused]] Scene &scene) -> void
+{
+    const auto debug_group = DebugGroup{"lighting"};
+
+    light_pass_rt_.fb.bind();
+    ::glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    const auto auto_bind = AutoBind{light_pass_program_};
 
     light_pass_program_.set_uniforms(
         gbuffer_rt_.colour_texture_bindless_handle_0,
@@ -551,9 +643,31 @@ auto Renderer::execute_lighting_pass(Scene &scene) -> void
     ::glBindBufferRange(
         GL_SHADER_STORAGE_BUFFER,
         2,
-        camera_buffer_.native_handle(),
-        camera_buffer_.frame_offset_bytes(),
-        sizeof(CameraData));
+        camera_allocation_.buffer,
+        camera_allocation_.offset,
+        camera_allocation_.size);
+
+    if (gpu_light_clustering_)
+    {
+        ::glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, gpu_light_cluster_buffer_.native_handle());
+        ::glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, gpu_light_index_buffer_.native_handle());
+    }
+    else
+    {
+        ::glBindBufferRange(
+            GL_SHADER_STORAGE_BUFFER,
+            3,
+            light_cluster_allocation_.buffer,
+            light_cluster_allocation_.offset,
+            light_cluster_allocation_.size);
+        ::glBindBufferRange(
+            GL_SHADER_STORAGE_BUFFER,
+            4,
+            light_index_allocation_.buffer,
+            light_index_allocation_.offset,
+            light_index_allocation_.size);
+    }
+
     ::glBindBuffer(GL_DRAW_INDIRECT_BUFFER, post_processing_command_buffer_.native_handle());
     ::glMultiDrawElementsIndirect(
         GL_TRIANGLES,
@@ -565,6 +679,8 @@ auto Renderer::execute_lighting_pass(Scene &scene) -> void
 
 auto Renderer::execute_bloom_pass([[maybe_unused]] Scene &scene) -> void
 {
+    const auto debug_group = DebugGroup{"bloom"};
+
     auto src_width = light_pass_rt_.fb.width();
     auto src_height = light_pass_rt_.fb.height();
     auto src_handle = light_pass_rt_.colour_texture_bindless_handle_0;
@@ -656,6 +772,8 @@ auto Renderer::execute_bloom_pass([[maybe_unused]] Scene &scene) -> void
 
 auto Renderer::execute_luminance_histogram_pass(Scene &scene) -> void
 {
+    const auto debug_group = DebugGroup{"luminance_histogram"};
+
     const auto auto_bind = AutoBind{luminance_histogram_program_};
 
     const auto zero = ::GLuint{0};
@@ -679,6 +797,8 @@ auto Renderer::execute_luminance_histogram_pass(Scene &scene) -> void
 
 auto Renderer::execute_average_luminance_pass(Scene &scene) -> void
 {
+    const auto debug_group = DebugGroup{"average_luminance"};
+
     static auto delta_time = 1.0f / 60.0f;
 
     const auto auto_bind = AutoBind{average_luminance_program_};
@@ -699,6 +819,8 @@ auto Renderer::execute_average_luminance_pass(Scene &scene) -> void
 
 auto Renderer::execute_ssao_pass(Scene &scene) -> void
 {
+    const auto debug_group = DebugGroup{"ssao"};
+
     if (!scene.ssao_options().enabled)
     {
         ::glClearColor(1.0f, 0.0f, 0.0f, 1.0f);
@@ -733,9 +855,9 @@ auto Renderer::execute_ssao_pass(Scene &scene) -> void
         ::glBindBufferRange(
             GL_SHADER_STORAGE_BUFFER,
             1,
-            camera_buffer_.native_handle(),
-            camera_buffer_.frame_offset_bytes(),
-            sizeof(CameraData));
+            camera_allocation_.buffer,
+            camera_allocation_.offset,
+            camera_allocation_.size);
         ::glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, ssao_samples_buffer_.native_handle());
         ::glBindBuffer(GL_DRAW_INDIRECT_BUFFER, post_processing_command_buffer_.native_handle());
         ::glMultiDrawElementsIndirect(
@@ -772,6 +894,8 @@ auto Renderer::execute_ssao_pass(Scene &scene) -> void
 
 auto Renderer::execute_tone_mapping_pass(Scene &scene) -> void
 {
+    const auto debug_group = DebugGroup{"tone_mapping"};
+
     const auto [vertex_buffer_handle, index_buffer_handle] = service<MeshManager>().native_handle();
 
     tone_map_rt_.fb.bind();
@@ -797,9 +921,9 @@ auto Renderer::execute_tone_mapping_pass(Scene &scene) -> void
     ::glBindBufferRange(
         GL_SHADER_STORAGE_BUFFER,
         2,
-        camera_buffer_.native_handle(),
-        camera_buffer_.frame_offset_bytes(),
-        sizeof(CameraData));
+        camera_allocation_.buffer,
+        camera_allocation_.offset,
+        camera_allocation_.size);
     ::glBindBuffer(GL_DRAW_INDIRECT_BUFFER, post_processing_command_buffer_.native_handle());
     ::glMultiDrawElementsIndirect(
         GL_TRIANGLES,
@@ -811,6 +935,8 @@ auto Renderer::execute_tone_mapping_pass(Scene &scene) -> void
 
 auto Renderer::execute_chromatic_aberration_pass(Scene &scene) -> void
 {
+    const auto debug_group = DebugGroup{"chromatic_aberration"};
+
     static const auto start = std::chrono::steady_clock::now();
     const auto elapsed =
         std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
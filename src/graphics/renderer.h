@@ -1,16 +1,21 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <span>
+#include <vector>
 
 #include "core/camera.h"
 #include "core/scene.h"
 #include "graphics/command_buffer.h"
 #include "graphics/frame_buffer.h"
-#include "graphics/multi_buffer.h"
+#include "graphics/light_buffer.h"
+#include "graphics/mesh_view.h"
 #include "graphics/opengl.h"
-#include "graphics/persistent_buffer.h"
 #include "graphics/program.h"
+#include "graphics/render_metrics.h"
 #include "graphics/sampler.h"
+#include "graphics/transient_buffer.h"
 #include "graphics/window.h"
 #include "resources/resource_loader.h"
 #include "utils/auto_release.h"
@@ -37,6 +42,11 @@ class Renderer
 
     auto render(Scene &scene, const Camera &camera) -> void;
 
+    /**
+     * Update any meshes the renderer owns after they have been moved by MeshManager::compact.
+     */
+    auto relocate_meshes(std::span<const MeshRelocation> relocations) -> void;
+
   protected:
     static auto create_program(
         ufps::ResourceLoader &resource_loader,
@@ -56,17 +66,21 @@ class Renderer
 
     const Window &window_;
     AutoRelease<::GLuint> dummy_vao_;
-    CommandBuffer command_buffer_;
     CommandBuffer post_processing_command_buffer_;
     Entity post_process_sprite_;
-    MultiBuffer<PersistentBuffer> camera_buffer_;
-    MultiBuffer<PersistentBuffer> light_buffer_;
-    MultiBuffer<PersistentBuffer> object_data_buffer_;
+    TransientBuffer<> transient_buffer_;
+    TransientAllocation camera_allocation_;
+    TransientAllocation light_cluster_allocation_;
+    TransientAllocation light_index_allocation_;
+    LightBuffer light_buffer_;
     Buffer luminance_histogram_buffer_;
     Buffer average_luminance_buffer_;
     Buffer ssao_samples_buffer_;
+    Buffer gpu_light_cluster_buffer_;
+    Buffer gpu_light_index_buffer_;
     Program gbuffer_program_;
     Program light_pass_program_;
+    Program light_cluster_program_;
     Program tone_map_program_;
     Program luminance_histogram_program_;
     Program average_luminance_program_;
@@ -89,9 +103,12 @@ class Renderer
     RenderTarget bloom_rt_;
     FrameBuffer *final_fb_;
     bool enable_post_processing_;
+    bool gpu_light_clustering_;
+    RenderMetrics render_metrics_;
 
   private:
-    auto execute_gbuffer_pass(Scene &scene) -> void;
+    auto execute_gbuffer_pass(Scene &scene, const Camera &camera) -> void;
+    auto execute_light_cluster_pass(Scene &scene, const Camera &camera) -> void;
     auto execute_lighting_pass(Scene &scene) -> void;
     auto execute_bloom_pass(Scene &scene) -> void;
     auto execute_luminance_histogram_pass(Scene &scene) -> void;
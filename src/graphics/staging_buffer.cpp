@@ -0,0 +1,129 @@
+#include "graphics/staging_buffer.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "graphics/fence.h"
+#include "graphics/gl_recorder.h"
+#include "graphics/opengl.h"
+#include "utils/data_buffer.h"
+#include "utils/error.h"
+
+namespace
+{
+
+/** Allocation granularity, keeps every range aligned for any texel or block format. */
+constexpr auto staging_alignment = 256zu;
+
+}
+
+namespace ufps
+{
+
+StagingBuffer::StagingBuffer(std::size_t size, std::string_view name)
+    : buffer_{0u, [](auto buffer) { ::glUnmapNamedBuffer(buffer); ::glDeleteBuffers(1, &buffer); }}
+    , map_{}
+    , size_{(size / staging_alignment) * staging_alignment}
+    , allocator_{static_cast<std::uint32_t>(size / staging_alignment)}
+    , released_{}
+    , pending_{}
+    , name_{name}
+{
+    expect(size_ != 0zu, "staging buffer {} is smaller than its alignment", name);
+
+    // readable as well as writable as asset headers are parsed in place, only a few bytes are ever read back
+    const auto flags = GL_MAP_READ_BIT | GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    ::glCreateBuffers(1, &buffer_);
+    ::glNamedBufferStorage(buffer_, size_, nullptr, flags);
+    ::glObjectLabel(GL_BUFFER, buffer_, name.length(), name.data());
+
+    map_ = reinterpret_cast<std::byte *>(::glMapNamedBufferRange(buffer_, 0, size_, flags));
+    expect(map_ != nullptr, "failed to map staging buffer {}", name);
+}
+
+auto StagingBuffer::allocate(std::size_t size) -> std::optional<StagingAllocation>
+{
+    const auto count = static_cast<std::uint32_t>((std::max(size, 1zu) + staging_alignment - 1zu) / staging_alignment);
+
+    const auto offset = allocator_.allocate(count);
+    if (!offset)
+    {
+        return std::nullopt;
+    }
+
+    // the caller writes straight into the mapping, so count it as written when it is handed out
+    record_mapped_write(size);
+
+    // the owner may be dropped on any thread so it only queues the range, collect() frees it on the render thread
+    auto owner = std::shared_ptr<const void>{
+        map_ + (*offset * staging_alignment),
+        [this, offset = *offset, count](const void *) { released_.push({offset, count}); }};
+
+    return StagingAllocation{
+        .data = std::span{map_ + (*offset * staging_alignment), size},
+        .owner = std::move(owner),
+    };
+}
+
+auto StagingBuffer::contains(DataBufferView data) const -> bool
+{
+    return std::less_equal{}(map_, data.data()) && std::less_equal{}(data.data() + data.size(), map_ + size_);
+}
+
+auto StagingBuffer::offset(DataBufferView data) const -> std::size_t
+{
+    expect(contains(data), "data is not in staging buffer {}", name_);
+    return static_cast<std::size_t>(data.data() - map_);
+}
+
+auto StagingBuffer::collect() -> void
+{
+    // anything reading a released range was submitted before it was released, so a fence inserted now is after it
+    for (auto released = released_.yield(); !released.empty(); released.pop())
+    {
+        const auto [offset, count] = released.front();
+
+        auto fence = GpuFence{};
+        fence.insert();
+        pending_.emplace_back(std::move(fence), offset, count);
+    }
+
+    std::erase_if(
+        pending_,
+        [this](const auto &pending)
+        {
+            const auto &[fence, offset, count] = pending;
+            if (!fence.signalled())
+            {
+                return false;
+            }
+
+            allocator_.free(offset, count);
+            return true;
+        });
+}
+
+auto StagingBuffer::native_handle() const -> ::GLuint
+{
+    return buffer_;
+}
+
+auto StagingBuffer::size() const -> std::size_t
+{
+    return size_;
+}
+
+auto StagingBuffer::used() const -> std::size_t
+{
+    return static_cast<std::size_t>(allocator_.used()) * staging_alignment;
+}
+
+}
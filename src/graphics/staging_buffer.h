@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+#include "concurrency/concurrent_queue.h"
+#include "graphics/fence.h"
+#include "graphics/opengl.h"
+#include "utils/auto_release.h"
+#include "utils/data_buffer.h"
+#include "utils/range_allocator.h"
+
+namespace ufps
+{
+
+/**
+ * A writable range of a StagingBuffer. The range is released when the last copy of owner is dropped, so views of it
+ * can share owner to keep it alive.
+ */
+struct StagingAllocation
+{
+    std::span<std::byte> data;
+    std::shared_ptr<const void> owner;
+};
+
+/**
+ * Persistently mapped pixel unpack buffer assets can be decompressed straight into, so their texels reach the gpu
+ * without another copy on the cpu. Ranges are allocated on the render thread but can be written from any thread.
+ * Released ranges are only reused once the gpu has finished any uploads from them, the buffer must outlive every
+ * allocation.
+ */
+class StagingBuffer
+{
+  public:
+    StagingBuffer(std::size_t size, std::string_view name);
+
+    StagingBuffer(const StagingBuffer &) = delete;
+    auto operator=(const StagingBuffer &) -> StagingBuffer & = delete;
+
+    /**
+     * Allocate a range, returns an empty optional if there is no large enough gap.
+     */
+    auto allocate(std::size_t size) -> std::optional<StagingAllocation>;
+
+    /**
+     * Whether data lies within the buffer, and so can be uploaded from it.
+     */
+    auto contains(DataBufferView data) const -> bool;
+
+    /**
+     * Offset of data within the buffer, this is what gl expects in place of a pointer when the buffer is bound.
+     */
+    auto offset(DataBufferView data) const -> std::size_t;
+
+    /**
+     * Return released ranges to the allocator once the gpu has passed all uploads submitted before their release.
+     * Should be called once per frame after the frame's uploads.
+     */
+    auto collect() -> void;
+
+    auto native_handle() const -> ::GLuint;
+
+    auto size() const -> std::size_t;
+
+    auto used() const -> std::size_t;
+
+  private:
+    AutoRelease<::GLuint> buffer_;
+    std::byte *map_;
+    std::size_t size_;
+    RangeAllocator allocator_;
+    ConcurrentQueue<std::tuple<std::uint32_t, std::uint32_t>> released_;
+    std::vector<std::tuple<GpuFence, std::uint32_t, std::uint32_t>> pending_;
+    std::string name_;
+};
+
+}
@@ -1,11 +1,16 @@
 #include "graphics/texture.h"
 
+#include <cstddef>
+#include <cstdint>
+#include <span>
 #include <string>
 
 #include <GL/gl.h>
 
+#include "graphics/mip_chain.h"
 #include "graphics/opengl.h"
 #include "graphics/sampler.h"
+#include "graphics/staging_buffer.h"
 #include "graphics/texture_data.h"
 #include "third_party/opengl/glext.h"
 #include "utils/exception.h"
@@ -45,27 +50,24 @@ Texture::Texture(const TextureData &texture, const std::string &name, const Samp
     , name_{name}
     , width_{texture.width}
     , height_{texture.height}
-
+    , mip_levels_{texture.mip_levels}
+    , format_{texture.format}
+    , is_compressed_{texture.is_compressed}
 {
     ::glCreateTextures(GL_TEXTURE_2D, 1, &handle_);
     ::glObjectLabel(GL_TEXTURE, handle_, name.length(), name.data());
-    ::glTextureStorage2D(handle_, 1, to_opengl(texture.format, true), texture.width, texture.height);
+    ::glTextureStorage2D(handle_, texture.mip_levels, to_opengl(texture.format, true), texture.width, texture.height);
     if (const auto &data = texture.data; data)
     {
-        if (texture.is_compressed)
-        {
-            const auto size = ((width_ + 3u) / 4u) * ((height_ + 3) / 4u) * 16;
-            ::glCompressedTextureSubImage2D(
-                handle_, 0, 0, 0, texture.width, texture.height, to_opengl(texture.format, false), size, data->data());
-        }
-        else
+        auto offset = 0zu;
+
+        for (auto level = 0u; level < texture.mip_levels; ++level)
         {
-            const auto type = texture.format == TextureFormat::R16F || texture.format == TextureFormat::RGB16F
-                                  ? GL_FLOAT
-                                  : GL_UNSIGNED_BYTE;
+            const auto size =
+                mip_level_size(texture.format, mip_extent(texture.width, level), mip_extent(texture.height, level));
 
-            ::glTextureSubImage2D(
-                handle_, 0, 0, 0, texture.width, texture.height, to_opengl(texture.format, false), type, data->data());
+            upload(level, std::span{*data}.subspan(offset, size));
+            offset += size;
         }
     }
 
@@ -81,6 +83,59 @@ Texture::~Texture()
     }
 }
 
+auto Texture::upload(std::uint32_t level, std::span<const std::byte> data) -> void
+{
+    upload(level, data.data(), data.size());
+}
+
+auto Texture::upload(std::uint32_t level, const StagingBuffer &staging, std::span<const std::byte> data) -> void
+{
+    ::glBindBuffer(GL_PIXEL_UNPACK_BUFFER, staging.native_handle());
+    upload(level, reinterpret_cast<const void *>(staging.offset(data)), data.size());
+    ::glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0u);
+}
+
+auto Texture::upload(std::uint32_t level, const void *pixels, std::size_t size) -> void
+{
+    const auto width = mip_extent(width_, level);
+    const auto height = mip_extent(height_, level);
+
+    if (is_compressed_)
+    {
+        ::glCompressedTextureSubImage2D(
+            handle_, level, 0, 0, width, height, to_opengl(format_, false), static_cast<::GLsizei>(size), pixels);
+    }
+    else
+    {
+        const auto type =
+            format_ == TextureFormat::R16F || format_ == TextureFormat::RGB16F ? GL_FLOAT : GL_UNSIGNED_BYTE;
+
+        // levels are tightly packed so three channel rows aren't necessarily four byte aligned, Window sets the unpack
+        // alignment to one when it creates the context rather than it being changed and restored for every upload
+        ::glTextureSubImage2D(handle_, level, 0, 0, width, height, to_opengl(format_, false), type, pixels);
+    }
+}
+
+auto Texture::copy(const Texture &source, std::uint32_t source_level, std::uint32_t level) -> void
+{
+    ::glCopyImageSubData(
+        source.handle_,
+        GL_TEXTURE_2D,
+        source_level,
+        0,
+        0,
+        0,
+        handle_,
+        GL_TEXTURE_2D,
+        level,
+        0,
+        0,
+        0,
+        mip_extent(width_, level),
+        mip_extent(height_, level),
+        1);
+}
+
 auto Texture::native_handle() const -> ::GLuint
 {
     return handle_;
@@ -106,4 +161,9 @@ auto Texture::height() const -> std::uint32_t
     return height_;
 }
 
+auto Texture::mip_levels() const -> std::uint32_t
+{
+    return mip_levels_;
+}
+
 }
@@ -1,10 +1,13 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <span>
 #include <string>
 
 #include "graphics/opengl.h"
 #include "graphics/sampler.h"
+#include "graphics/staging_buffer.h"
 #include "graphics/texture_data.h"
 #include "utils/auto_release.h"
 
@@ -20,6 +23,21 @@ class Texture
     Texture(Texture &&) = default;
     auto operator=(Texture &&) -> Texture & = default;
 
+    /**
+     * Replace the contents of a single level, contents can change after the texture is made resident, state can't.
+     */
+    auto upload(std::uint32_t level, std::span<const std::byte> data) -> void;
+
+    /**
+     * As above but data lies in a staging buffer, the gpu copies it out of the buffer so the cpu never touches it.
+     */
+    auto upload(std::uint32_t level, const StagingBuffer &staging, std::span<const std::byte> data) -> void;
+
+    /**
+     * Copy a level of another texture of the same format and level size on the gpu.
+     */
+    auto copy(const Texture &source, std::uint32_t source_level, std::uint32_t level) -> void;
+
     auto native_handle() const -> ::GLuint;
     auto bindless_handle() const -> ::GLuint64;
 
@@ -28,12 +46,22 @@ class Texture
     auto width() const -> std::uint32_t;
     auto height() const -> std::uint32_t;
 
+    auto mip_levels() const -> std::uint32_t;
+
   private:
+    /**
+     * Upload from client memory or, if a pixel unpack buffer is bound, from pixels as an offset into it.
+     */
+    auto upload(std::uint32_t level, const void *pixels, std::size_t size) -> void;
+
     AutoRelease<::GLuint> handle_;
     ::GLuint64 bindless_handle_;
     std::string name_;
     std::uint32_t width_;
     std::uint32_t height_;
+    std::uint32_t mip_levels_;
+    TextureFormat format_;
+    bool is_compressed_;
 };
 
 }
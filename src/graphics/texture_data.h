@@ -4,7 +4,7 @@
 #include <optional>
 #include <string>
 
-#include "utils/data_buffer.h"
+#include "utils/shared_buffer_view.h"
 
 namespace ufps
 {
@@ -24,12 +24,17 @@ enum class TextureFormat
     BC7_SRGB,
 };
 
+/**
+ * Mip levels are stored back to back in data, largest first. Data is usually a view into the decompressed asset or a
+ * staging buffer rather than a copy of its texels, copying a TextureData never copies texels.
+ */
 struct TextureData
 {
     std::uint32_t width;
     std::uint32_t height;
+    std::uint32_t mip_levels;
     TextureFormat format;
-    std::optional<DataBuffer> data;
+    std::optional<SharedBufferView> data;
     bool is_compressed;
 };
 
@@ -3,6 +3,7 @@
 #include <cstdint>
 #include <ranges>
 #include <span>
+#include <utility>
 #include <vector>
 
 #include "graphics/buffer.h"
@@ -51,6 +52,18 @@ auto TextureManager::add(std::vector<Texture> textures) -> std::uint32_t
     return new_index;
 }
 
+auto TextureManager::replace(std::uint32_t index, Texture texture) -> Texture
+{
+    expect(index < textures_.size(), "index {} out of range", index);
+
+    auto old_texture = std::exchange(textures_[index], std::move(texture));
+    cpu_buffer_[index] = textures_[index].bindless_handle();
+
+    gpu_buffer_.write(std::as_bytes(std::span{&cpu_buffer_[index], 1zu}), index * sizeof(::GLuint64));
+
+    return old_texture;
+}
+
 auto TextureManager::native_handle() const -> ::GLuint
 {
     return gpu_buffer_.native_handle();
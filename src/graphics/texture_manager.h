@@ -19,6 +19,11 @@ class TextureManager
     auto add(Texture texture) -> std::uint32_t;
     auto add(std::vector<Texture> textures) -> std::uint32_t;
 
+    /**
+     * Swap the texture at an index for a new one, the old texture is returned as the gpu may still be using it.
+     */
+    auto replace(std::uint32_t index, Texture texture) -> Texture;
+
     auto native_handle() const -> ::GLuint;
 
     auto texture(std::uint32_t index) const -> const Texture *;
@@ -0,0 +1,254 @@
+#include "graphics/texture_residency.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <ranges>
+#include <span>
+#include <tuple>
+#include <vector>
+
+#include "graphics/mip_chain.h"
+#include "utils/error.h"
+
+namespace ufps
+{
+
+auto desired_mip_level(std::uint32_t width, std::uint32_t height, float projected_pixels) -> std::uint32_t
+{
+    const auto coarsest = mip_level_count(width, height) - 1u;
+
+    if (!(projected_pixels > 0.0f))
+    {
+        return coarsest;
+    }
+
+    const auto texels_per_pixel = static_cast<float>(std::max(width, height)) / projected_pixels;
+    if (texels_per_pixel <= 1.0f)
+    {
+        return 0u;
+    }
+
+    // rounding down errs on the side of detail, the sampler blends towards the coarser level anyway
+    return std::min(static_cast<std::uint32_t>(std::floor(std::log2(texels_per_pixel))), coarsest);
+}
+
+TextureResidency::TextureResidency(const TextureResidencyConfig &config)
+    : config_{config}
+    , entries_{}
+    , resident_bytes_{}
+    , frame_{1u}
+{
+    expect(config_.tail_levels != 0u, "at least one level of every texture must always be resident");
+}
+
+auto TextureResidency::add(std::span<const std::size_t> level_sizes) -> std::uint32_t
+{
+    expect(!level_sizes.empty(), "texture has no levels");
+
+    const auto level_count = static_cast<std::uint32_t>(level_sizes.size());
+    const auto tail_level = level_count > config_.tail_levels ? level_count - config_.tail_levels : 0u;
+
+    entries_.push_back({
+        .level_sizes = level_sizes | std::ranges::to<std::vector>(),
+        .tail_level = tail_level,
+        .resident_level = tail_level,
+        .requested_level = tail_level,
+        .last_used = 0u,
+        .loaded = false,
+    });
+
+    resident_bytes_ += std::ranges::fold_left(level_sizes | std::views::drop(tail_level), 0zu, std::plus{});
+
+    return static_cast<std::uint32_t>(entries_.size() - 1zu);
+}
+
+auto TextureResidency::request(std::uint32_t texture, std::uint32_t level) -> void
+{
+    expect(texture < entries_.size(), "texture {} out of range", texture);
+
+    auto &entry = entries_[texture];
+    const auto clamped = std::min(level, entry.tail_level);
+
+    // the first request of a frame replaces whatever was wanted last frame
+    entry.requested_level = entry.last_used == frame_ ? std::min(entry.requested_level, clamped) : clamped;
+    entry.last_used = frame_;
+}
+
+auto TextureResidency::set_loaded(std::uint32_t texture, bool loaded) -> void
+{
+    expect(texture < entries_.size(), "texture {} out of range", texture);
+    entries_[texture].loaded = loaded;
+}
+
+auto TextureResidency::update() -> ResidencyPlan
+{
+    auto plan = ResidencyPlan{};
+    const auto previous = entries_ | std::views::transform(&Entry::resident_level) | std::ranges::to<std::vector>();
+
+    // textures drawn this frame that want more detail, the ones furthest from what they asked for first
+    auto candidates = std::views::iota(0u, static_cast<std::uint32_t>(entries_.size())) |
+                      std::views::filter(
+                          [this](auto index)
+                          {
+                              const auto &entry = entries_[index];
+                              return (entry.last_used == frame_) && (entry.requested_level < entry.resident_level);
+                          }) |
+                      std::ranges::to<std::vector>();
+    std::ranges::stable_sort(
+        candidates,
+        std::ranges::greater{},
+        [this](auto index) { return entries_[index].resident_level - entries_[index].requested_level; });
+
+    plan.loads = candidates | std::views::filter([this](auto index) { return !entries_[index].loaded; }) |
+                 std::ranges::to<std::vector>();
+    std::erase_if(candidates, [this](auto index) { return !entries_[index].loaded; });
+
+    // a level at a time per texture each pass so one large texture cannot starve the others of the upload budget
+    for (auto granted = true; granted;)
+    {
+        granted = false;
+
+        for (const auto index : candidates)
+        {
+            auto &entry = entries_[index];
+            if (entry.resident_level <= entry.requested_level)
+            {
+                continue;
+            }
+
+            const auto bytes = entry.level_sizes[entry.resident_level - 1u];
+
+            // the first upload is always allowed so levels larger than the budget still make progress
+            if ((plan.upload_bytes != 0zu) && (plan.upload_bytes + bytes > config_.upload_budget))
+            {
+                continue;
+            }
+
+            if (!make_room(entry, bytes, plan))
+            {
+                continue;
+            }
+
+            --entry.resident_level;
+            resident_bytes_ += bytes;
+            plan.upload_bytes += bytes;
+            granted = true;
+        }
+    }
+
+    // only happens if the tails alone exceed the budget, everything streamed in above was made room for
+    while (resident_bytes_ > config_.vram_budget)
+    {
+        auto evictable = entries_ | std::views::filter([](const auto &e) { return e.resident_level < e.tail_level; });
+        if (std::ranges::empty(evictable))
+        {
+            break;
+        }
+
+        evict(
+            *std::ranges::min_element(
+                evictable, {}, [](const auto &e) { return std::make_tuple(e.last_used, e.resident_level); }),
+            plan);
+    }
+
+    for (auto &&[index, entry] : std::views::enumerate(entries_))
+    {
+        if (entry.loaded && ((entry.last_used != frame_) || (entry.resident_level <= entry.requested_level)))
+        {
+            entry.loaded = false;
+            plan.unloads.push_back(static_cast<std::uint32_t>(index));
+        }
+
+        if (entry.resident_level != previous[index])
+        {
+            plan.changes.push_back({
+                .texture = static_cast<std::uint32_t>(index),
+                .resident_level = entry.resident_level,
+            });
+        }
+    }
+
+    ++frame_;
+
+    return plan;
+}
+
+auto TextureResidency::resident_level(std::uint32_t texture) const -> std::uint32_t
+{
+    expect(texture < entries_.size(), "texture {} out of range", texture);
+    return entries_[texture].resident_level;
+}
+
+auto TextureResidency::requested_level(std::uint32_t texture) const -> std::uint32_t
+{
+    expect(texture < entries_.size(), "texture {} out of range", texture);
+    return entries_[texture].requested_level;
+}
+
+auto TextureResidency::resident_bytes() const -> std::size_t
+{
+    return resident_bytes_;
+}
+
+auto TextureResidency::size() const -> std::size_t
+{
+    return entries_.size();
+}
+
+auto TextureResidency::evict(Entry &entry, ResidencyPlan &plan) -> void
+{
+    const auto bytes = entry.level_sizes[entry.resident_level];
+
+    ++entry.resident_level;
+    resident_bytes_ -= bytes;
+    plan.evicted_bytes += bytes;
+}
+
+auto TextureResidency::make_room(const Entry &candidate, std::size_t bytes, ResidencyPlan &plan) -> bool
+{
+    // textures used less recently than the candidate can drop back to their tail, ones used as recently can only drop
+    // detail they didn't ask for, otherwise two visible textures would keep evicting each other
+    const auto evictable_level = [&candidate](const Entry &entry)
+    {
+        if (&entry == &candidate)
+        {
+            return entry.resident_level;
+        }
+
+        return entry.last_used < candidate.last_used ? entry.tail_level
+                                                     : std::min(entry.requested_level, entry.tail_level);
+    };
+
+    auto available = 0zu;
+    for (const auto &entry : entries_)
+    {
+        for (auto level = entry.resident_level; level < evictable_level(entry); ++level)
+        {
+            available += entry.level_sizes[level];
+        }
+    }
+
+    // nothing is evicted unless it frees enough for the candidate
+    if (resident_bytes_ + bytes > config_.vram_budget + available)
+    {
+        return false;
+    }
+
+    while (resident_bytes_ + bytes > config_.vram_budget)
+    {
+        auto victims =
+            entries_ | std::views::filter([&](const auto &e) { return e.resident_level < evictable_level(e); });
+
+        evict(
+            *std::ranges::min_element(
+                victims, {}, [](const auto &e) { return std::make_tuple(e.last_used, e.resident_level); }),
+            plan);
+    }
+
+    return true;
+}
+
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace ufps
+{
+
+/**
+ * Limits the residency policy works within. The tail is the smallest levels of every chain, they are always resident
+ * so there is always something to sample.
+ */
+struct TextureResidencyConfig
+{
+    std::size_t vram_budget;
+    std::size_t upload_budget;
+    std::uint32_t tail_levels;
+};
+
+/**
+ * New first resident level of a texture, levels from it to the end of the chain are resident.
+ */
+struct ResidencyChange
+{
+    std::uint32_t texture;
+    std::uint32_t resident_level;
+
+    constexpr auto operator==(const ResidencyChange &) const -> bool = default;
+};
+
+/**
+ * Result of a single update. Changes are in ascending texture order, loads are textures which want more detail but
+ * whose source data has not been loaded, most wanted first. Unloads are textures whose source data is no longer needed
+ * as they have everything they asked for or weren't drawn, they are no longer considered loaded.
+ */
+struct ResidencyPlan
+{
+    std::vector<ResidencyChange> changes;
+    std::vector<std::uint32_t> loads;
+    std::vector<std::uint32_t> unloads;
+    std::size_t upload_bytes;
+    std::size_t evicted_bytes;
+};
+
+/**
+ * Mip level whose texels are closest to one per pixel when a texture is stretched over the supplied number of pixels.
+ */
+auto desired_mip_level(std::uint32_t width, std::uint32_t height, float projected_pixels) -> std::uint32_t;
+
+/**
+ * Decides which mip levels of each texture should be resident, knows nothing about gl.
+ *
+ * Every frame the renderer requests the level it would like for each texture it draws, update then streams in finer
+ * levels one at a time within the upload budget and evicts the finest levels of the least recently used textures to
+ * stay within the vram budget.
+ */
+class TextureResidency
+{
+  public:
+    TextureResidency(const TextureResidencyConfig &config);
+
+    /**
+     * Track a texture with the supplied level sizes, largest first. Only the tail starts resident.
+     */
+    auto add(std::span<const std::size_t> level_sizes) -> std::uint32_t;
+
+    /**
+     * Request a level for a texture this frame, the finest of all requests in a frame wins.
+     */
+    auto request(std::uint32_t texture, std::uint32_t level) -> void;
+
+    /**
+     * Mark whether the source data of a texture is available, levels are only streamed in for loaded textures.
+     */
+    auto set_loaded(std::uint32_t texture, bool loaded) -> void;
+
+    /**
+     * Plan the uploads and evictions for this frame, apply them and start the next frame.
+     */
+    auto update() -> ResidencyPlan;
+
+    auto resident_level(std::uint32_t texture) const -> std::uint32_t;
+
+    auto requested_level(std::uint32_t texture) const -> std::uint32_t;
+
+    auto resident_bytes() const -> std::size_t;
+
+    auto size() const -> std::size_t;
+
+  private:
+    struct Entry
+    {
+        std::vector<std::size_t> level_sizes;
+        std::uint32_t tail_level;
+        std::uint32_t resident_level;
+        std::uint32_t requested_level;
+        std::uint64_t last_used;
+        bool loaded;
+    };
+
+    auto evict(Entry &entry, ResidencyPlan &plan) -> void;
+
+    auto make_room(const Entry &candidate, std::size_t bytes, ResidencyPlan &plan) -> bool;
+
+    TextureResidencyConfig config_;
+    std::vector<Entry> entries_;
+    std::size_t resident_bytes_;
+    std::uint64_t frame_;
+};
+
+}
@@ -0,0 +1,337 @@
+#include "graphics/texture_streamer.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "concurrency/thread_pool.h"
+#include "core/service_locator.h"
+#include "graphics/deferred_release.h"
+#include "graphics/material_manager.h"
+#include "graphics/mip_chain.h"
+#include "graphics/sampler.h"
+#include "graphics/staging_buffer.h"
+#include "graphics/texture.h"
+#include "graphics/texture_data.h"
+#include "graphics/texture_manager.h"
+#include "graphics/texture_residency.h"
+#include "graphics/utils.h"
+#include "resources/asset_archive.h"
+#include "utils/auto_release.h"
+#include "utils/error.h"
+#include "utils/exception.h"
+#include "utils/formatter.h"
+#include "utils/log.h"
+#include "utils/shared_buffer_view.h"
+
+namespace
+{
+
+/**
+ * Decoding only needs to know about srgb for formats which don't record it, those that do will decode to the same
+ * format they did at startup.
+ */
+auto is_srgb(ufps::TextureFormat format) -> bool
+{
+    return (format == ufps::TextureFormat::SRGB) || (format == ufps::TextureFormat::SRGBA) ||
+           (format == ufps::TextureFormat::BC7_SRGB);
+}
+
+}
+
+namespace ufps
+{
+
+TextureStreamer::TextureStreamer(
+    const AssetArchive &archive,
+    const Sampler &sampler,
+    const TextureResidencyConfig &config,
+    std::size_t staging_size)
+    : archive_{archive}
+    , sampler_{sampler}
+    , residency_{config}
+    , staging_{staging_size, "texture_staging"}
+    , textures_{}
+    , handles_{}
+    , loaded_{}
+    , loads_in_flight_{}
+{
+}
+
+TextureStreamer::~TextureStreamer()
+{
+    // decodes still on the pool write into this object
+    for (auto count = loads_in_flight_.load(); count != 0u; count = loads_in_flight_.load())
+    {
+        loads_in_flight_.wait(count);
+    }
+}
+
+auto TextureStreamer::add(const std::vector<std::tuple<std::string, TextureData>> &textures) -> void
+{
+    const auto first_texture = static_cast<std::uint32_t>(textures_.size());
+    auto tails = std::vector<Texture>{};
+
+    for (const auto &[name, texture] : textures)
+    {
+        const auto level_sizes =
+            std::views::iota(0u, texture.mip_levels) |
+            std::views::transform(
+                [&texture](auto level)
+                {
+                    return mip_level_size(
+                        texture.format, mip_extent(texture.width, level), mip_extent(texture.height, level));
+                }) |
+            std::ranges::to<std::vector>();
+
+        const auto resident_level = residency_.resident_level(residency_.add(level_sizes));
+        auto tail = mip_chain_from(texture, resident_level);
+
+        textures_.push_back({
+            .name = name,
+            .texture_index = 0u,
+            .width = texture.width,
+            .height = texture.height,
+            .mip_levels = texture.mip_levels,
+            .format = texture.format,
+            .is_compressed = texture.is_compressed,
+            .resident_level = resident_level,
+            .loading = false,
+            .source = std::nullopt,
+            .staged_bytes = 0zu,
+            .copied_bytes = tail.data->size(),
+        });
+
+        // tails are uploaded from the startup decode, they're small enough it isn't worth staging them
+        tails.emplace_back(tail, name, sampler_);
+    }
+
+    auto &texture_manager = service<TextureManager>();
+    const auto first_index = texture_manager.add(std::move(tails));
+
+    for (auto texture = first_texture; texture < textures_.size(); ++texture)
+    {
+        auto &streamed = textures_[texture];
+        streamed.texture_index = first_index + (texture - first_texture);
+
+        handles_.emplace(texture_manager.texture(streamed.texture_index)->bindless_handle(), texture);
+    }
+
+    log::debug("added {} textures, {} KiB resident", textures.size(), residency_.resident_bytes() / 1024zu);
+}
+
+auto TextureStreamer::request(std::span<const float> material_coverage) -> void
+{
+    const auto &material_manager = service<MaterialManager>();
+
+    for (const auto &[index, pixels] : std::views::enumerate(material_coverage))
+    {
+        if (pixels <= 0.0f)
+        {
+            continue;
+        }
+
+        const auto &material = material_manager.material(static_cast<std::uint32_t>(index));
+
+        for (const auto handle :
+             {material.albedo_texture_bindless_handle,
+              material.normal_texture_bindless_handle,
+              material.specular_texture_bindless_handle,
+              material.ao_texture_bindless_handle,
+              material.glossiness_texture_bindless_handle,
+              material.emissive_texture_bindless_handle})
+        {
+            if (const auto texture = handles_.find(handle); texture != std::ranges::cend(handles_))
+            {
+                const auto &streamed = textures_[texture->second];
+                residency_.request(texture->second, desired_mip_level(streamed.width, streamed.height, pixels));
+            }
+        }
+    }
+}
+
+auto TextureStreamer::update() -> void
+{
+    for (auto loaded = loaded_.yield(); !loaded.empty(); loaded.pop())
+    {
+        auto &[texture, source] = loaded.front();
+        auto &streamed = textures_[texture];
+
+        // a failed decode has no source, it's marked unloaded so it is retried if it is still wanted
+        streamed.loading = false;
+        residency_.set_loaded(texture, source.has_value());
+        streamed.source = std::move(source);
+    }
+
+    const auto plan = residency_.update();
+
+    for (const auto &change : plan.changes)
+    {
+        apply(change);
+    }
+
+    for (const auto texture : plan.unloads)
+    {
+        textures_[texture].source.reset();
+    }
+
+    for (const auto texture : plan.loads)
+    {
+        if (!textures_[texture].loading)
+        {
+            load(texture);
+        }
+    }
+
+    // after this frame's uploads so released ranges aren't reused until the gpu has read them
+    staging_.collect();
+
+    if (!plan.changes.empty())
+    {
+        log::debug(
+            "texture streaming: uploaded {} KiB evicted {} KiB resident {} KiB staging {} KiB",
+            plan.upload_bytes / 1024zu,
+            plan.evicted_bytes / 1024zu,
+            residency_.resident_bytes() / 1024zu,
+            staging_.used() / 1024zu);
+    }
+}
+
+auto TextureStreamer::resident_bytes() const -> std::size_t
+{
+    return residency_.resident_bytes();
+}
+
+auto TextureStreamer::copied_bytes() const -> std::size_t
+{
+    return std::ranges::fold_left(textures_ | std::views::transform(&StreamedTexture::copied_bytes), 0zu, std::plus{});
+}
+
+auto TextureStreamer::load(std::uint32_t texture) -> void
+{
+    auto &streamed = textures_[texture];
+    streamed.loading = true;
+    ++loads_in_flight_;
+
+    // staging ranges can only be allocated here but the pool is free to decompress into them
+    auto staging = staging_.allocate(archive_.size(streamed.name));
+
+    service<ThreadPool>().add(
+        [this, texture, name = streamed.name, srgb = is_srgb(streamed.format), staging = std::move(staging)]
+        {
+            // the destructor waits on this so it has to be dropped however the job ends
+            const auto in_flight = AutoRelease<std::atomic<std::uint32_t> *>{
+                &loads_in_flight_,
+                [](auto *count)
+                {
+                    --*count;
+                    count->notify_all();
+                }};
+
+            // a failed texture keeps whatever levels it has, an empty result tells update() it can be retried
+            try
+            {
+                if (staging)
+                {
+                    archive_.load_into(name, staging->data);
+                    loaded_.push({texture, load_texture(SharedBufferView{staging->owner, staging->data}, srgb)});
+                }
+                else
+                {
+                    loaded_.push({texture, load_texture(archive_.load(name), srgb)});
+                }
+            }
+            catch (const Exception &e)
+            {
+                log::error("failed to stream {}: {}", name, e);
+                loaded_.push({texture, std::nullopt});
+            }
+            catch (const std::exception &e)
+            {
+                log::error("failed to stream {}: {}", name, e.what());
+                loaded_.push({texture, std::nullopt});
+            }
+            catch (...)
+            {
+                log::error("failed to stream {}: unknown error", name);
+                loaded_.push({texture, std::nullopt});
+            }
+        });
+}
+
+auto TextureStreamer::apply(const ResidencyChange &change) -> void
+{
+    auto &streamed = textures_[change.texture];
+    auto &texture_manager = service<TextureManager>();
+    const auto &old_texture = *texture_manager.texture(streamed.texture_index);
+
+    auto texture = Texture{
+        {
+            .width = mip_extent(streamed.width, change.resident_level),
+            .height = mip_extent(streamed.height, change.resident_level),
+            .mip_levels = streamed.mip_levels - change.resident_level,
+            .format = streamed.format,
+            .data = std::nullopt,
+            .is_compressed = streamed.is_compressed,
+        },
+        streamed.name,
+        sampler_};
+
+    for (auto level = change.resident_level; level < streamed.mip_levels; ++level)
+    {
+        if (level >= streamed.resident_level)
+        {
+            // already on the gpu so it doesn't need to cross the bus again
+            texture.copy(old_texture, level - streamed.resident_level, level - change.resident_level);
+            continue;
+        }
+
+        expect(streamed.source.has_value(), "streaming {} level {} without source data", streamed.name, level);
+        expect(streamed.source->mip_levels == streamed.mip_levels, "{} changed since startup", streamed.name);
+
+        const auto &source = *streamed.source;
+        const auto data = std::span{*source.data}.subspan(
+            mip_chain_size(source.format, source.width, source.height, level),
+            mip_level_size(source.format, mip_extent(source.width, level), mip_extent(source.height, level)));
+
+        if (staging_.contains(data))
+        {
+            texture.upload(level - change.resident_level, staging_, data);
+            streamed.staged_bytes += data.size();
+        }
+        else
+        {
+            texture.upload(level - change.resident_level, data);
+            streamed.copied_bytes += data.size();
+        }
+    }
+
+    const auto old_handle = old_texture.bindless_handle();
+    const auto new_handle = texture.bindless_handle();
+
+    // the old texture may still be sampled by frames in flight
+    service<DeferredRelease<>>().retire(texture_manager.replace(streamed.texture_index, std::move(texture)));
+    service<MaterialManager>().replace_texture(old_handle, new_handle);
+
+    handles_.erase(old_handle);
+    handles_.emplace(new_handle, change.texture);
+    streamed.resident_level = change.resident_level;
+
+    log::debug(
+        "{} resident from level {}, {} KiB staged {} KiB copied",
+        streamed.name,
+        streamed.resident_level,
+        streamed.staged_bytes / 1024zu,
+        streamed.copied_bytes / 1024zu);
+}
+
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "concurrency/concurrent_queue.h"
+#include "graphics/sampler.h"
+#include "graphics/staging_buffer.h"
+#include "graphics/texture_data.h"
+#include "graphics/texture_residency.h"
+#include "resources/asset_archive.h"
+
+namespace ufps
+{
+
+/**
+ * Streams mip levels of archived textures in and out of TextureManager as TextureResidency decides.
+ *
+ * Textures start with only their tail resident. When finer levels are wanted the full chain is decoded from the
+ * archive on the thread pool and levels are uploaded within the per frame budget. Bindless textures can't change
+ * their levels so a texture is recreated whenever its residency changes, levels it keeps are copied on the gpu and
+ * every material is pointed at the new handle.
+ *
+ * Where the staging buffer has room textures are decompressed straight into it and levels are uploaded from there, so
+ * their texels are never copied by the cpu. Otherwise they are decoded into memory and uploaded from it, which costs a
+ * copy in the driver, the bytes copied are counted per texture.
+ */
+class TextureStreamer
+{
+  public:
+    TextureStreamer(
+        const AssetArchive &archive,
+        const Sampler &sampler,
+        const TextureResidencyConfig &config,
+        std::size_t staging_size);
+    ~TextureStreamer();
+
+    TextureStreamer(const TextureStreamer &) = delete;
+    auto operator=(const TextureStreamer &) -> TextureStreamer & = delete;
+
+    /**
+     * Add decoded textures with full mip chains, only their tails are uploaded. Can be called with textures a batch
+     * at a time so they needn't all be decoded at once.
+     */
+    auto add(const std::vector<std::tuple<std::string, TextureData>> &textures) -> void;
+
+    /**
+     * Request levels for the textures of every material drawn this frame from their size on screen.
+     */
+    auto request(std::span<const float> material_coverage) -> void;
+
+    /**
+     * Collect finished decodes, apply this frame's residency plan and start decoding any textures it is waiting on.
+     */
+    auto update() -> void;
+
+    auto resident_bytes() const -> std::size_t;
+
+    /**
+     * Bytes the cpu has copied uploading every texture, levels uploaded from the staging buffer aren't counted.
+     */
+    auto copied_bytes() const -> std::size_t;
+
+  private:
+    struct StreamedTexture
+    {
+        std::string name;
+        std::uint32_t texture_index;
+        std::uint32_t width;
+        std::uint32_t height;
+        std::uint32_t mip_levels;
+        TextureFormat format;
+        bool is_compressed;
+        std::uint32_t resident_level;
+        bool loading;
+        std::optional<TextureData> source;
+        std::size_t staged_bytes;
+        std::size_t copied_bytes;
+    };
+
+    auto load(std::uint32_t texture) -> void;
+
+    auto apply(const ResidencyChange &change) -> void;
+
+    const AssetArchive &archive_;
+    const Sampler &sampler_;
+    TextureResidency residency_;
+    StagingBuffer staging_;
+    std::vector<StreamedTexture> textures_;
+    std::unordered_map<std::uint64_t, std::uint32_t> handles_;
+    /** Finished decodes, the data is empty if decoding failed. */
+    ConcurrentQueue<std::tuple<std::uint32_t, std::optional<TextureData>>> loaded_;
+    std::atomic<std::uint32_t> loads_in_flight_;
+};
+
+}
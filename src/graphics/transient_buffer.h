@@ -0,0 +1,199 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "graphics/deferred_release.h"
+#include "graphics/fence.h"
+#include "graphics/opengl.h"
+#include "graphics/persistent_buffer.h"
+#include "graphics/utils.h"
+#include "utils/data_buffer.h"
+#include "utils/error.h"
+#include "utils/log.h"
+
+namespace ufps
+{
+
+/**
+ * A range of a TransientBuffer, only valid until the end of the frame it was allocated in.
+ */
+struct TransientAllocation
+{
+    ::GLuint buffer;
+    std::size_t offset;
+    std::size_t size;
+};
+
+/**
+ * Ring buffer for data which is rewritten every frame. The underlying buffer is split into Frames regions, each frame
+ * linearly sub-allocates aligned ranges from its own region and advance() waits for the gpu to finish with the next
+ * region before reusing it. If a frame runs out of space the whole buffer grows, allocations already made this frame
+ * remain valid as the old buffer is kept alive until the gpu is done with it.
+ */
+template <IsBuffer Buffer = PersistentBuffer, std::size_t Frames = 3zu, IsFence Fence = GpuFence>
+class TransientBuffer
+{
+  public:
+    TransientBuffer(std::size_t frame_size, std::size_t alignment, std::string_view name)
+        : buffer_{align_up(frame_size, alignment) * Frames, name}
+        , frame_size_{align_up(frame_size, alignment)}
+        , alignment_{alignment}
+        , frame_index_{}
+        , frame_used_{}
+        , high_water_mark_{}
+        , fences_{}
+        , outgrown_{}
+        , retired_{}
+        , wait_time_{}
+        , name_{name}
+    {
+        expect(alignment_ != 0zu, "alignment must be non zero");
+    }
+
+    /**
+     * Reserve an aligned range in the current frame. The range is never empty so it can always be bound.
+     */
+    auto allocate(std::size_t size) -> TransientAllocation
+    {
+        const auto reserve_size = std::max(size, alignment_);
+        auto offset = align_up(frame_used_, alignment_);
+
+        if (offset + reserve_size > frame_size_)
+        {
+            grow(offset + reserve_size);
+            offset = 0zu;
+        }
+
+        frame_used_ = offset + reserve_size;
+        high_water_mark_ = std::max(high_water_mark_, frame_used_);
+
+        return {
+            .buffer = buffer_.native_handle(), .offset = (frame_index_ * frame_size_) + offset, .size = reserve_size};
+    }
+
+    /**
+     * Write into a range returned by the most recent allocate().
+     */
+    auto write(const TransientAllocation &allocation, DataBufferView data, std::size_t offset = 0zu) -> void
+    {
+        expect(allocation.buffer == buffer_.native_handle(), "allocation is from an old buffer");
+        expect(offset + data.size_bytes() <= allocation.size, "write outside of allocation");
+
+        buffer_.write(data, allocation.offset + offset);
+    }
+
+    auto upload(DataBufferView data) -> TransientAllocation
+    {
+        const auto allocation = allocate(data.size_bytes());
+        write(allocation, data);
+
+        return allocation;
+    }
+
+    /**
+     * Should be called once all commands reading the current frame have been submitted.
+     */
+    auto advance() -> void
+    {
+        // commands later in the frame may still use allocations from an outgrown buffer so only now can it be retired
+        for (auto &buffer : outgrown_)
+        {
+            retired_.retire(std::move(buffer));
+        }
+        outgrown_.clear();
+
+        fences_[frame_index_].insert();
+        frame_index_ = (frame_index_ + 1zu) % Frames;
+        frame_used_ = 0zu;
+
+        const auto start = std::chrono::steady_clock::now();
+        fences_[frame_index_].wait();
+        wait_time_ = std::chrono::steady_clock::now() - start;
+
+        retired_.collect();
+    }
+
+    auto native_handle() const
+    {
+        return buffer_.native_handle();
+    }
+
+    /**
+     * Bytes available to each frame.
+     */
+    auto frame_size() const -> std::size_t
+    {
+        return frame_size_;
+    }
+
+    auto frame_used() const -> std::size_t
+    {
+        return frame_used_;
+    }
+
+    /**
+     * Most bytes used by any single frame.
+     */
+    auto high_water_mark() const -> std::size_t
+    {
+        return high_water_mark_;
+    }
+
+    auto wait_time() const -> std::chrono::nanoseconds
+    {
+        return wait_time_;
+    }
+
+    auto name() const -> std::string_view
+    {
+        return name_;
+    }
+
+  private:
+    static constexpr auto align_up(std::size_t value, std::size_t alignment) -> std::size_t
+    {
+        return ((value + alignment - 1zu) / alignment) * alignment;
+    }
+
+    auto grow(std::size_t required) -> void
+    {
+        auto new_frame_size = frame_size_ * 2zu;
+        while (new_frame_size < required)
+        {
+            new_frame_size *= 2zu;
+        }
+        new_frame_size = align_up(new_frame_size, alignment_);
+
+        log::info("growing {} transient buffer {} -> {}", name_, frame_size_, new_frame_size);
+
+        outgrown_.push_back(std::move(buffer_));
+        buffer_ = Buffer{new_frame_size * Frames, name_};
+
+        // fresh storage so there is nothing for the gpu to still be reading
+        frame_size_ = new_frame_size;
+        frame_index_ = 0zu;
+        frame_used_ = 0zu;
+        fences_ = {};
+    }
+
+    Buffer buffer_;
+    std::size_t frame_size_;
+    std::size_t alignment_;
+    std::size_t frame_index_;
+    std::size_t frame_used_;
+    std::size_t high_water_mark_;
+    std::array<Fence, Frames> fences_;
+    std::vector<Buffer> outgrown_;
+    DeferredRelease<Fence> retired_;
+    std::chrono::nanoseconds wait_time_;
+    std::string name_;
+};
+
+}
@@ -26,6 +26,7 @@
 #include "assimp/vector3.h"
 #include "graphics/dds.h"
 #include "graphics/mesh_data.h"
+#include "graphics/mip_chain.h"
 #include "graphics/model_data.h"
 #include "graphics/texture_data.h"
 #include "graphics/utils.h"
@@ -33,10 +34,21 @@
 #include "utils/data_buffer.h"
 #include "utils/error.h"
 #include "utils/log.h"
+#include "utils/shared_buffer_view.h"
 
 namespace
 {
 
+constexpr std::byte dds_magic[] = {
+    static_cast<std::byte>(0x44),
+    static_cast<std::byte>(0x44),
+    static_cast<std::byte>(0x53),
+    static_cast<std::byte>(0x20),
+};
+
+constexpr auto dx10_fourcc = 0x30315844u;
+constexpr auto bc5u_fourcc = 0x55354342u;
+
 template <ufps::log::Level L>
 class SimpleAssimpLogStream : public ::Assimp::LogStream
 {
@@ -96,10 +108,29 @@ auto get_texture_filename(::aiMaterial const *material, ::aiTextureType type) ->
                : std::optional{std::format("textures\\{}.dds", path.filename().stem().native_encoded_string())};
 }
 
+auto to_dxgi_format(ufps::TextureFormat format) -> ::DXGI_FORMAT
+{
+    switch (format)
+    {
+        using enum ufps::TextureFormat;
+
+        case RED: return DXGI_FORMAT_R8_UNORM;
+        case RGBA: return DXGI_FORMAT_R8G8B8A8_UNORM;
+        case SRGBA: return DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
+        case BC5U: return DXGI_FORMAT_BC5_UNORM;
+        case BC7: return DXGI_FORMAT_BC7_UNORM;
+        case BC7_SRGB: return DXGI_FORMAT_BC7_UNORM_SRGB;
+        default: throw ufps::Exception("texture format cannot be written to dds: {}", format);
+    }
+}
+
 auto to_native_format(::DXGI_FORMAT format) -> ufps::TextureFormat
 {
     switch (format)
     {
+        case DXGI_FORMAT_R8_UNORM: return ufps::TextureFormat::RED;
+        case DXGI_FORMAT_R8G8B8A8_UNORM: return ufps::TextureFormat::RGBA;
+        case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB: return ufps::TextureFormat::SRGBA;
         case DXGI_FORMAT_BC5_UNORM: return ufps::TextureFormat::BC5U;
         case DXGI_FORMAT_BC7_UNORM: return ufps::TextureFormat::BC7;
         case DXGI_FORMAT_BC7_UNORM_SRGB: return ufps::TextureFormat::BC7_SRGB;
@@ -110,54 +141,73 @@ auto to_native_format(::DXGI_FORMAT format) -> ufps::TextureFormat
 
 namespace ufps
 {
-auto load_texture(DataBufferView image_data, bool is_srgb) -> TextureData
+auto load_texture(SharedBufferView image_data, bool is_srgb) -> TextureData
 {
     auto width = int{};
     auto height = int{};
     auto num_channels = int{};
 
-    static constexpr std::byte dds_magic[] = {
-        static_cast<std::byte>(0x44),
-        static_cast<std::byte>(0x44),
-        static_cast<std::byte>(0x53),
-        static_cast<std::byte>(0x20),
-    };
-
     if (std::ranges::equal(dds_magic, image_data | std::views::take(sizeof(dds_magic))))
     {
+        ensure(image_data.size() >= sizeof(dds_magic) + sizeof(DDS_HEADER), "dds data truncated");
+
         auto dds_header = DDS_HEADER{};
         std::memcpy(&dds_header, image_data.data() + sizeof(dds_magic), sizeof(dds_header));
 
         ensure(dds_header.dwSize == sizeof(dds_header), "invalid dds_header size: {}", dds_header.dwSize);
-        if (dds_header.ddspf.dwFourCC == 0x30315844)
+
+        auto format = TextureFormat{};
+        auto data_offset = sizeof(dds_magic) + sizeof(dds_header);
+
+        if (dds_header.ddspf.dwFourCC == dx10_fourcc)
         {
+            ensure(image_data.size() >= data_offset + sizeof(DDS_HEADER_DXT10), "dds data truncated");
+
             auto dx10_header = DDS_HEADER_DXT10{};
-            std::memcpy(&dx10_header, image_data.data() + sizeof(dds_magic) + sizeof(dds_header), sizeof(dx10_header));
-
-            return {
-                .width = static_cast<std::uint32_t>(dds_header.dwWidth),
-                .height = static_cast<std::uint32_t>(dds_header.dwHeight),
-                .format = to_native_format(dx10_header.dxgiFormat),
-                .data = image_data | std::views::drop(sizeof(dds_magic) + sizeof(dds_header) + sizeof(dx10_header)) |
-                        std::ranges::to<std::vector>(),
-                .is_compressed = true,
-            };
+            std::memcpy(&dx10_header, image_data.data() + data_offset, sizeof(dx10_header));
+
+            format = to_native_format(dx10_header.dxgiFormat);
+            data_offset += sizeof(dx10_header);
         }
-        else if (dds_header.ddspf.dwFourCC == 0x55354342)
+        else if (dds_header.ddspf.dwFourCC == bc5u_fourcc)
         {
-            return {
-                .width = static_cast<std::uint32_t>(dds_header.dwWidth),
-                .height = static_cast<std::uint32_t>(dds_header.dwHeight),
-                .format = TextureFormat::BC5U,
-                .data = image_data | std::views::drop(sizeof(dds_magic) + sizeof(dds_header)) |
-                        std::ranges::to<std::vector>(),
-                .is_compressed = true,
-            };
+            format = TextureFormat::BC5U;
         }
         else
         {
             throw ufps::Exception("unsupported dds format: {}", dds_header.ddspf.dwFourCC);
         }
+
+        const auto dds_width = static_cast<std::uint32_t>(dds_header.dwWidth);
+        const auto dds_height = static_cast<std::uint32_t>(dds_header.dwHeight);
+        const auto mip_levels = (dds_header.dwFlags & DDSD_MIPMAPCOUNT) != 0u
+                                    ? std::max(static_cast<std::uint32_t>(dds_header.dwMipMapCount), 1u)
+                                    : 1u;
+
+        // gl won't allocate more levels than the chain has, so the texture couldn't be created
+        ensure(
+            mip_levels <= mip_level_count(dds_width, dds_height),
+            "dds claims {} mip levels but a {}x{} texture has at most {}",
+            mip_levels,
+            dds_width,
+            dds_height,
+            mip_level_count(dds_width, dds_height));
+
+        const auto data_size = mip_chain_size(format, dds_width, dds_height, mip_levels);
+        ensure(
+            image_data.size() >= data_offset + data_size,
+            "dds data truncated, {} mip levels need {} bytes",
+            mip_levels,
+            data_size);
+
+        return {
+            .width = dds_width,
+            .height = dds_height,
+            .mip_levels = mip_levels,
+            .format = format,
+            .data = image_data.subspan(data_offset, data_size),
+            .is_compressed = is_block_compressed(format),
+        };
     }
     else
     {
@@ -175,17 +225,110 @@ auto load_texture(DataBufferView image_data, bool is_srgb) -> TextureData
         ensure(raw_data, "failed to parse texture data");
 
         const auto *ptr = reinterpret_cast<const std::byte *>(raw_data.get());
+        const auto size = static_cast<std::size_t>(width) * height * num_channels;
+
+        // stb's allocation is adopted rather than copied, the view frees it once the texture data is done with it
+        auto owner = std::shared_ptr<const void>{raw_data.release(), ::stbi_image_free};
 
         return {
             .width = static_cast<std::uint32_t>(width),
             .height = static_cast<std::uint32_t>(height),
+            .mip_levels = 1u,
             .format = channels_to_format(num_channels, is_srgb),
-            .data = {{ptr, ptr + width * height * num_channels}},
+            .data = SharedBufferView{std::move(owner), {ptr, size}},
             .is_compressed = false,
         };
     }
 }
 
+auto load_texture(DataBufferView image_data, bool is_srgb) -> TextureData
+{
+    return load_texture(SharedBufferView{image_data}, is_srgb);
+}
+
+auto load_texture(DataBuffer &&image_data, bool is_srgb) -> TextureData
+{
+    return load_texture(SharedBufferView{std::move(image_data)}, is_srgb);
+}
+
+auto encode_dds(const TextureData &texture) -> DataBuffer
+{
+    ensure(texture.data.has_value(), "cannot encode a texture without data");
+
+    // dds has no 24 bit dxgi format so three channel textures are widened
+    if ((texture.format == TextureFormat::RGB) || (texture.format == TextureFormat::SRGB))
+    {
+        auto rgba = DataBuffer{};
+        rgba.reserve((texture.data->size() / 3zu) * 4zu);
+
+        for (const auto &texel : *texture.data | std::views::chunk(3))
+        {
+            rgba.append_range(texel);
+            rgba.push_back(std::byte{0xff});
+        }
+
+        return encode_dds({
+            .width = texture.width,
+            .height = texture.height,
+            .mip_levels = texture.mip_levels,
+            .format = texture.format == TextureFormat::SRGB ? TextureFormat::SRGBA : TextureFormat::RGBA,
+            .data = std::move(rgba),
+            .is_compressed = false,
+        });
+    }
+
+    const auto data_size = mip_chain_size(texture.format, texture.width, texture.height, texture.mip_levels);
+    ensure(texture.data->size() >= data_size, "texture data is smaller than its {} mip levels", texture.mip_levels);
+
+    const auto compressed = is_block_compressed(texture.format);
+
+    const auto dds_header = DDS_HEADER{
+        .dwSize = sizeof(DDS_HEADER),
+        .dwFlags = DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_MIPMAPCOUNT |
+                   (compressed ? DDSD_LINEARSIZE : DDSD_PITCH),
+        .dwHeight = texture.height,
+        .dwWidth = texture.width,
+        .dwPitchOrLinearSize = static_cast<DWORD>(
+            compressed ? mip_level_size(texture.format, texture.width, texture.height)
+                       : mip_level_size(texture.format, texture.width, 1u)),
+        .dwDepth = 0u,
+        .dwMipMapCount = texture.mip_levels,
+        .dwReserved1 = {},
+        .ddspf =
+            {
+                .dwSize = sizeof(DDS_PIXELFORMAT),
+                .dwFlags = DDPF_FOURCC,
+                .dwFourCC = dx10_fourcc,
+                .dwRGBBitCount = 0u,
+                .dwRBitMask = 0u,
+                .dwGBitMask = 0u,
+                .dwBBitMask = 0u,
+                .dwABitMask = 0u,
+            },
+        .dwCaps = DDSCAPS_TEXTURE | (texture.mip_levels > 1u ? DDSCAPS_COMPLEX | DDSCAPS_MIPMAP : 0u),
+        .dwCaps2 = 0u,
+        .dwCaps3 = 0u,
+        .dwCaps4 = 0u,
+        .dwReserved2 = 0u,
+    };
+
+    const auto dx10_header = DDS_HEADER_DXT10{
+        .dxgiFormat = to_dxgi_format(texture.format),
+        .resourceDimension = D3D10_RESOURCE_DIMENSION_TEXTURE2D,
+        .miscFlag = 0u,
+        .arraySize = 1u,
+        .miscFlags2 = 0u,
+    };
+
+    auto dds = DataBuffer{};
+    dds.append_range(dds_magic);
+    dds.append_range(std::as_bytes(std::span{&dds_header, 1zu}));
+    dds.append_range(std::as_bytes(std::span{&dx10_header, 1zu}));
+    dds.append_range(std::span{*texture.data}.first(data_size));
+
+    return dds;
+}
+
 auto load_model(DataBufferView model_data) -> std::tuple<std::string, std::vector<ModelData>>
 {
     [[maybe_unused]] static auto *logger = []
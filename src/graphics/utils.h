@@ -2,10 +2,13 @@
 
 #include <cstddef>
 #include <ranges>
+#include <string>
 #include <string_view>
 #include <tuple>
 #include <vector>
 
+#include "core/service_locator.h"
+#include "graphics/deferred_release.h"
 #include "graphics/model_data.h"
 #include "graphics/opengl.h"
 #include "graphics/texture_data.h"
@@ -13,6 +16,7 @@
 #include "resources/resource_loader.h"
 #include "utils/data_buffer.h"
 #include "utils/log.h"
+#include "utils/shared_buffer_view.h"
 
 namespace ufps
 {
@@ -46,15 +50,36 @@ auto resize_gpu_buffer(const std::vector<T> &cpu_buffer, Buffer &gpu_buffer)
 
         ufps::log::info("growing {} buffer {} -> {}", gpu_buffer.name(), gpu_buffer.size(), new_size);
 
-        // opengl barrier incase gpu using previous frame
-        ::glFinish();
+        const auto name = std::string{gpu_buffer.name()};
 
-        gpu_buffer = Buffer{new_size, gpu_buffer.name()};
+        // the gpu may still be reading the old buffer so keep it alive until it's done rather than stalling
+        service<DeferredRelease<>>().retire(std::move(gpu_buffer));
+
+        gpu_buffer = Buffer{new_size, name};
     }
 }
 
+/**
+ * Decode a dds or any image stb can read. A dds is not copied, the returned data views the mip levels in image_data
+ * and shares ownership of it with the image, anything else is decoded into a buffer the returned data owns.
+ */
+auto load_texture(SharedBufferView image_data, bool is_srgb) -> TextureData;
+
+/**
+ * As above for image data owned by the caller, which must outlive the returned texture data.
+ */
 auto load_texture(DataBufferView image_data, bool is_srgb) -> TextureData;
 
+/**
+ * As above but takes ownership of the image data, the returned texture data keeps it alive.
+ */
+auto load_texture(DataBuffer &&image_data, bool is_srgb) -> TextureData;
+
+/**
+ * Write a texture and all its mip levels as a dds with a dx10 header, three channel textures are widened to four.
+ */
+auto encode_dds(const TextureData &texture) -> DataBuffer;
+
 auto load_model(DataBufferView model_data) -> std::tuple<std::string, std::vector<ModelData>>;
 
 }
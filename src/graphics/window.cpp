@@ -330,6 +330,9 @@ Window::Window(
     ::glEnable(GL_BLEND);
     ::glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
+    // every texture level is uploaded tightly packed, nothing relies on the default of four, see Texture::upload
+    ::glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
     set_mode(mode);
 
     const auto *vendor = ::glGetString(GL_VENDOR);
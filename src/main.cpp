@@ -1,18 +1,35 @@
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <filesystem>
 #include <fstream>
+#include <functional>
 #include <map>
 #include <memory>
+#include <meta>
 #include <numbers>
+#include <optional>
 #include <ranges>
 #include <span>
 #include <sstream>
+#include <string>
 #include <string_view>
+#include <system_error>
 #include <thread>
+#include <tuple>
 #include <unordered_map>
+#include <utility>
 #include <variant>
+#include <vector>
 
 #include <objbase.h>
 #include <windows.h>
 
+// needs the types from windows.h
+#include <psapi.h>
+
 #include <yaml-cpp/yaml.h>
 
 #include "config.h"
@@ -21,23 +38,35 @@
 #include "concurrency/task.h"
 #include "concurrency/thread_pool.h"
 #include "core/actor.h"
+#include "core/camera.h"
 #include "core/flycam_actor.h"
-#include "core/manifest_descriptions.h"
 #include "core/player_actor.h"
 #include "core/render_entity.h"
 #include "core/scene.h"
+#include "core/scene_snapshot.h"
 #include "core/service_locator.h"
 #include "events/input_map.h"
 #include "events/key.h"
 #include "events/key_event.h"
 #include "graphics/colour.h"
 #include "graphics/debug_renderer.h"
+#include "graphics/deferred_release.h"
+#include "graphics/gl_recorder.h"
+#include "graphics/material.h"
+#include "graphics/material_manager.h"
 #include "graphics/mesh_data.h"
+#include "graphics/mesh_lod.h"
 #include "graphics/mesh_manager.h"
+#include "graphics/meshlet.h"
+#include "graphics/null_opengl.h"
+#include "graphics/null_renderer.h"
 #include "graphics/renderer.h"
 #include "graphics/sampler.h"
 #include "graphics/texture.h"
+#include "graphics/texture_data.h"
 #include "graphics/texture_manager.h"
+#include "graphics/texture_residency.h"
+#include "graphics/texture_streamer.h"
 #include "graphics/utils.h"
 #include "graphics/vertex_data.h"
 #include "graphics/window.h"
@@ -45,12 +74,14 @@
 #include "memory/metrics.h"
 #include "physics/physics_system.h"
 #include "physics/rigid_body.h"
+#include "resources/asset_archive.h"
+#include "resources/binary_manifest.h"
 #include "resources/embedded_resource_loader.h"
 #include "resources/file_resource_loader.h"
 #include "resources/resource_loader.h"
 #include "serialisation/yaml_serialiser.h"
 #include "utils/data_buffer.h"
-#include "utils/decompress.h"
+#include "utils/error.h"
 #include "utils/formatter.h"
 #include "utils/log.h"
 #include "utils/resolve_symbols.h"
@@ -62,6 +93,62 @@ using namespace std::literals;
 namespace
 {
 
+constexpr auto mesh_compaction_moves_per_frame = 4zu;
+
+// headless runs have no window, frames are prepared as if for a 1080p one
+constexpr auto headless_width = 1920.0f;
+constexpr auto headless_height = 1080.0f;
+constexpr auto default_headless_frame_count = 1000zu;
+
+// 64x64 and smaller levels are always resident
+constexpr auto texture_streaming_config = ufps::TextureResidencyConfig{
+    .vram_budget = 512zu * 1024zu * 1024zu,
+    .upload_budget = 8zu * 1024zu * 1024zu,
+    .tail_levels = 7u,
+};
+
+// textures are decompressed straight into this and uploaded from it, large enough for a few full 4k chains in flight
+constexpr auto texture_staging_size = 128zu * 1024zu * 1024zu;
+
+/**
+ * Logs how long each stage of startup took and the running total, the last stage is the first presented frame.
+ */
+class StartupTimer
+{
+  public:
+    StartupTimer()
+        : start_{std::chrono::steady_clock::now()}
+        , last_{start_}
+    {
+    }
+
+    auto stage(std::string_view name) -> void
+    {
+        const auto now = std::chrono::steady_clock::now();
+
+        ufps::log::info(
+            "startup stage {}: {:.2f} ms (total {:.2f} ms)",
+            name,
+            std::chrono::duration<float, std::milli>(now - last_).count(),
+            std::chrono::duration<float, std::milli>(now - start_).count());
+
+        last_ = now;
+    }
+
+  private:
+    std::chrono::steady_clock::time_point start_;
+    std::chrono::steady_clock::time_point last_;
+};
+
+/**
+ * What's left of the decoded assets once the services exist, only needed until the entity cache has been built.
+ */
+struct LevelAssets
+{
+    ufps::BinaryManifest manifest;
+    ufps::DataBuffer meshlet_data;
+};
+
 auto cube() -> ufps::MeshData
 {
     const ufps::Vector3 positions[] = {
@@ -129,70 +216,129 @@ auto cube() -> ufps::MeshData
     return vs;
 }
 
-auto load_all_textures(
-    ufps::ResourceLoader &resource_loader,
-    ufps::TextureManager &texture_manager,
-    const ufps::Sampler &sampler) -> void
+/**
+ * Decode textures on the pool one per worker at a time and hand each batch to the streamer as soon as it's done, so
+ * only a batch of full mip chains is ever held in memory rather than every texture in the level.
+ */
+auto stream_textures(const ufps::BinaryManifest &manifest, const ufps::AssetArchive &archive, ufps::ThreadPool &pool)
+    -> void
 {
-    const auto texture_manifest_str = resource_loader.load_string("configs\\texture_manifest.yaml");
-    const auto texture_manifest = ufps::yaml::deserialise<ufps::TextureManifestDescription>(texture_manifest_str);
-    ensure(texture_manifest);
+    auto &texture_streamer = ufps::service<ufps::TextureStreamer>();
+    const auto batch_size = std::max<std::size_t>(pool.worker_count(), 1zu);
 
-    const auto texture_blob = ufps::decompress(resource_loader.load_data_buffer("blobs\\texture_data.bin"));
-
-    for (const auto &[name, manifest] : texture_manifest->textures)
+    for (const auto &batch : manifest.textures() | std::views::chunk(batch_size))
     {
-        const auto raw_texture_data = std::span{texture_blob.data() + manifest.offset, manifest.size};
-        const auto texture_data = ufps::load_texture(raw_texture_data, manifest.is_srgb);
-        texture_manager.add({texture_data, name, sampler});
+        auto textures = batch |
+                        std::views::transform(
+                            [&manifest](const auto &e)
+                            { return std::tuple{std::string{manifest.name(e.name)}, ufps::TextureData{}}; }) |
+                        std::ranges::to<std::vector>();
+
+        // every job writes to its own slot so they need no synchronisation beyond the wait
+        auto jobs = std::vector<ufps::Job>{};
+
+        // the texture slots were built from the batch so they are in the same order
+        for (auto &&[texture, texture_manifest] : std::views::zip(textures, batch))
+        {
+            jobs.push_back(
+                [&archive, &texture = texture, is_srgb = texture_manifest.is_srgb != 0u]
+                {
+                    auto &[name, texture_data] = texture;
+                    texture_data = ufps::load_texture(archive.load(name), is_srgb);
+                });
+        }
+
+        ufps::run_parallel(pool, std::move(jobs));
+        texture_streamer.add(textures);
     }
+
+    ufps::log::info(
+        "streaming {} textures, {} KiB resident",
+        manifest.textures().size(),
+        texture_streamer.resident_bytes() / 1024zu);
 }
 
-auto build_mesh_lookup(ufps::ResourceLoader &resource_loader) -> ufps::StringMap<std::vector<ufps::MeshView>>
+auto build_mesh_lookup(const ufps::BinaryManifest &manifest) -> ufps::StringMap<std::vector<ufps::MeshView>>
 {
-    auto mesh_lookup = ufps::StringMap<std::vector<ufps::MeshView>>{};
-
-    const auto manifest_str = resource_loader.load_string("configs\\model_manifest.yaml");
-    const auto manifest = ufps::yaml::deserialise<ufps::ModelManifestDescription>(manifest_str);
-    ensure(manifest);
+    return manifest.models() |
+           std::views::transform(
+               [&manifest](const auto &model)
+               {
+                   return std::pair{
+                       std::string{manifest.name(model.name)},
+                       manifest.sub_models(model) | std::views::transform(&ufps::BinarySubModelManifest::mesh_view) |
+                           std::ranges::to<std::vector>()};
+               }) |
+           std::ranges::to<ufps::StringMap<std::vector<ufps::MeshView>>>();
+}
 
-    return manifest->models |
+/**
+ * Every lod is a separate mesh in the arena, they're owned by their model but kept out of its sub model views.
+ */
+auto build_lod_lookup(const ufps::BinaryManifest &manifest) -> ufps::StringMap<std::vector<ufps::MeshView>>
+{
+    return manifest.models() |
            std::views::transform(
-               [](const auto &e)
+               [&manifest](const auto &model)
                {
-                   const auto &[name, manifests] = e;
                    return std::pair{
-                       name,
-                       manifests | std::views::transform([](const auto &m) { return m.mesh_view; }) |
+                       std::string{manifest.name(model.name)},
+                       manifest.sub_models(model) |
+                           std::views::transform([&manifest](const auto &m) { return manifest.lods(m); }) |
+                           std::views::join | std::views::transform(&ufps::MeshLod::mesh_view) |
                            std::ranges::to<std::vector>()};
                }) |
            std::ranges::to<ufps::StringMap<std::vector<ufps::MeshView>>>();
 }
 
-auto build_entity_cache(ufps::ResourceLoader &resource_loader) -> ufps::StringMap<ufps::Entity>
+/**
+ * The meshlet blob is taken by value as every sub model copies its meshlets out of it, so it's released once the cache
+ * is built.
+ */
+auto build_entity_cache(const ufps::BinaryManifest &manifest, ufps::DataBuffer meshlet_blob)
+    -> ufps::StringMap<ufps::Entity>
 {
     auto &texture_manager = ufps::service<ufps::TextureManager>();
+    auto &material_manager = ufps::service<ufps::MaterialManager>();
     auto entity_cache = ufps::StringMap<ufps::Entity>{};
 
-    const auto model_manifest_str = resource_loader.load_string("configs\\model_manifest.yaml");
-    const auto model_manifest = ufps::yaml::deserialise<ufps::ModelManifestDescription>(model_manifest_str);
-    ensure(model_manifest);
+    const auto meshlet_data = std::span<const ufps::Meshlet>{
+        reinterpret_cast<const ufps::Meshlet *>(meshlet_blob.data()), meshlet_blob.size() / sizeof(ufps::Meshlet)};
 
-    for (const auto &[name, manifests] : model_manifest->models)
+    for (const auto &model : manifest.models())
     {
+        const auto name = std::string{manifest.name(model.name)};
         auto render_entities = std::vector<ufps::RenderEntity>{};
 
-        for (const auto &[mesh_view, albedo, normal, specular, ao, glosiness, emissive] : manifests)
+        for (const auto &sub_model : manifest.sub_models(model))
         {
-            const auto albedo_index = texture_manager.bindless_handle(albedo);
-            const auto normal_index = texture_manager.bindless_handle(normal);
-            const auto specular_index = texture_manager.bindless_handle(specular);
-            const auto ao_index = texture_manager.bindless_handle(ao);
-            const auto glossiness_index = texture_manager.bindless_handle(glosiness);
-            const auto emissive_index = texture_manager.bindless_handle(emissive);
+            const auto &[albedo, normal, specular, ao, glosiness, emissive] = sub_model.textures;
+
+            const auto material_index = material_manager.add({
+                .albedo_texture_bindless_handle = texture_manager.bindless_handle(manifest.texture_name(albedo)),
+                .normal_texture_bindless_handle = texture_manager.bindless_handle(manifest.texture_name(normal)),
+                .specular_texture_bindless_handle = texture_manager.bindless_handle(manifest.texture_name(specular)),
+                .ao_texture_bindless_handle = texture_manager.bindless_handle(manifest.texture_name(ao)),
+                .glossiness_texture_bindless_handle = texture_manager.bindless_handle(manifest.texture_name(glosiness)),
+                .emissive_texture_bindless_handle = texture_manager.bindless_handle(manifest.texture_name(emissive)),
+            });
+
+            auto lod_chain = std::vector<ufps::MeshLod>{{.mesh_view = sub_model.mesh_view, .error = 0.0f}};
+            lod_chain.append_range(manifest.lods(sub_model));
+
+            const auto &[meshlet_offset, meshlet_count] = sub_model.meshlets;
+            ufps::ensure(
+                static_cast<std::size_t>(meshlet_offset) + meshlet_count <= meshlet_data.size(),
+                "{} meshlets [{}, {}) are outside the {} in the blob",
+                name,
+                meshlet_offset,
+                static_cast<std::size_t>(meshlet_offset) + meshlet_count,
+                meshlet_data.size());
 
             render_entities.push_back(
-                {mesh_view, albedo_index, normal_index, specular_index, ao_index, glossiness_index, emissive_index});
+                {std::move(lod_chain),
+                 meshlet_data.subspan(meshlet_offset, meshlet_count) | std::ranges::to<std::vector>(),
+                 material_index});
         }
 
         entity_cache.insert({name, ufps::Entity{name, std::move(render_entities), {}}});
@@ -254,14 +400,9 @@ auto flicker_light(ufps::PointLightHandle handle, ufps::Scene &scene) -> ufps::T
         }
     }
 }
-}
 
-int start()
+auto log_version() -> void
 {
-    // Daz_Da_Cat: First stream done.
-    // Daz_Da_Cat: You can't handle the Daz!
-    ::CoInitializeEx(nullptr, COINIT_MULTITHREADED);
-
     ufps::log::info(
         "μfps version: {}.{}.{}.{}",
         ufps::version::year,
@@ -269,46 +410,295 @@ int start()
         ufps::version::day,
         ufps::version::tweak);
     ufps::log::info("{}", ufps::system_info());
+}
 
-    auto window = ufps::Window{ufps::WindowMode::WINDOWED, 3840, 2160, 0u, 0u};
-    auto running = true;
-
-    auto input_map = ufps::InputMap{};
-
-    auto resource_loader = std::unique_ptr<ufps::ResourceLoader>();
+auto create_resource_loader() -> std::unique_ptr<ufps::ResourceLoader>
+{
     if constexpr (ufps::config::use_embedded_resouce_loader)
     {
         ufps::log::info("using embedded resource loader");
-        resource_loader = std::make_unique<ufps::EmbeddedResourceLoader>();
+        return std::make_unique<ufps::EmbeddedResourceLoader>();
     }
     else
     {
         ufps::log::info("using file resource loader");
-        resource_loader = std::make_unique<ufps::FileResourceLoader>(
+        return std::make_unique<ufps::FileResourceLoader>(
             std::vector<std::filesystem::path>{"assets", "secret-assets", "build\\build_assets"});
     }
+}
 
-    const auto sampler = ufps::Sampler{
-        ufps::FilterType::LINEAR,
+auto simple_sampler() -> ufps::Sampler
+{
+    return ufps::Sampler{
+        ufps::FilterType::LINEAR_MIPMAP,
         ufps::FilterType::LINEAR,
         ufps::WrapMode::REPEAT,
         ufps::WrapMode::REPEAT,
         "simple_sampler"};
+}
 
-    auto texture_manager = std::make_unique<ufps::TextureManager>();
-    load_all_textures(*resource_loader, *texture_manager, sampler);
+/**
+ * Decode all the assets and create every service, what's still needed for building the entity cache is returned.
+ */
+auto create_services(
+    ufps::ResourceLoader &resource_loader,
+    const ufps::AssetArchive &archive,
+    const ufps::Sampler &sampler,
+    ufps::DebugRenderMode physics_debug_render_mode,
+    StartupTimer &startup_timer) -> std::tuple<std::unique_ptr<ufps::Services>, LevelAssets>
+{
+    // buffers can grow (and retire their old storage) while loading so this service has to exist before anything else
+    auto services = std::make_unique<ufps::Services>();
+    std::get<std::unique_ptr<ufps::DeferredRelease<>>>(*services) = std::make_unique<ufps::DeferredRelease<>>();
+    ufps::set_service(services.get());
 
     auto pool = std::make_unique<ufps::ThreadPool>();
-    auto awaitable_manager = std::make_unique<ufps::AwaitableManager>(*pool);
-    auto mesh_manager = std::make_unique<ufps::MeshManager>(
-        ufps::decompress(resource_loader->load_data_buffer("blobs\\vertex_data.bin")),
-        ufps::decompress(resource_loader->load_data_buffer("blobs\\index_data.bin")),
-        build_mesh_lookup(*resource_loader));
 
-    mesh_manager->load("cube", std::vector{cube()});
+    // the manifest is used in place from the mapped file
+    const auto manifest = ufps::BinaryManifest{resource_loader.map_data_buffer("configs\\manifest.bin")};
+
+    auto meshlet_data = ufps::DataBuffer{};
+    auto mesh_manager = std::unique_ptr<ufps::MeshManager>{};
 
-    auto physics = std::make_unique<ufps::PhysicsSystem>(ufps::DebugRenderMode::ON);
-    auto &player_controller = physics->player_controller();
+    {
+        // vertices and indices are only held until they've been uploaded, the meshlets are kept for the entity cache
+        auto vertex_data = ufps::DataBuffer{};
+        auto index_data = ufps::DataBuffer{};
+
+        auto jobs = std::vector<ufps::Job>{};
+        jobs.push_back([&] { vertex_data = archive.load("vertex_data"); });
+        jobs.push_back([&] { index_data = archive.load("index_data"); });
+        jobs.push_back([&] { meshlet_data = archive.load("meshlet_data"); });
+        ufps::run_parallel(*pool, std::move(jobs));
+        startup_timer.stage("geometry decode");
+
+        mesh_manager = std::make_unique<ufps::MeshManager>(
+            vertex_data, index_data, build_mesh_lookup(manifest), build_lod_lookup(manifest));
+        mesh_manager->load("cube", std::vector{cube()});
+        startup_timer.stage("mesh upload");
+    }
+
+    // only the smallest levels are uploaded up front, the rest are streamed in once something is drawn with them
+    std::get<std::unique_ptr<ufps::TextureManager>>(*services) = std::make_unique<ufps::TextureManager>();
+    std::get<std::unique_ptr<ufps::TextureStreamer>>(*services) =
+        std::make_unique<ufps::TextureStreamer>(archive, sampler, texture_streaming_config, texture_staging_size);
+    stream_textures(manifest, archive, *pool);
+    startup_timer.stage("texture decode and upload");
+    ufps::log::info("texture upload copied {} KiB", ufps::service<ufps::TextureStreamer>().copied_bytes() / 1024zu);
+
+    std::get<std::unique_ptr<ufps::AwaitableManager>>(*services) = std::make_unique<ufps::AwaitableManager>(*pool);
+    std::get<std::unique_ptr<ufps::MaterialManager>>(*services) = std::make_unique<ufps::MaterialManager>();
+    std::get<std::unique_ptr<ufps::MeshManager>>(*services) = std::move(mesh_manager);
+    std::get<std::unique_ptr<ufps::PhysicsSystem>>(*services) =
+        std::make_unique<ufps::PhysicsSystem>(physics_debug_render_mode);
+    std::get<std::unique_ptr<ufps::ThreadPool>>(*services) = std::move(pool);
+    startup_timer.stage("physics");
+
+    return {std::move(services), LevelAssets{.manifest = manifest, .meshlet_data = std::move(meshlet_data)}};
+}
+
+/**
+ * The baked snapshot is used in place from the mapped file, the yaml is only parsed if it has been edited since.
+ */
+auto load_level(ufps::ResourceLoader &resource_loader, LevelAssets assets, StartupTimer &startup_timer) -> ufps::Scene
+{
+    const auto entity_cache = build_entity_cache(assets.manifest, std::move(assets.meshlet_data));
+
+    const auto use_snapshot =
+        std::filesystem::exists("scene.bin") &&
+        (!std::filesystem::exists("scene.yaml") ||
+         std::filesystem::last_write_time("scene.bin") >= std::filesystem::last_write_time("scene.yaml"));
+
+    if (use_snapshot)
+    {
+        auto scene_loader =
+            ufps::FileResourceLoader{std::vector<std::filesystem::path>{std::filesystem::current_path()}};
+        auto scene = ufps::load_scene(ufps::SceneSnapshot{scene_loader.map_data_buffer("scene.bin")}, entity_cache);
+        startup_timer.stage("scene (snapshot)");
+
+        return scene;
+    }
+
+    auto strm = std::stringstream{};
+    auto scene_description_yaml = std::ifstream{"scene.yaml"};
+
+    if (scene_description_yaml.is_open())
+    {
+        strm << scene_description_yaml.rdbuf();
+    }
+    else
+    {
+        if constexpr (ufps::config::use_embedded_resouce_loader)
+        {
+            auto scene_description_str = resource_loader.load_string("configs\\scene.yaml");
+            strm << scene_description_str;
+        }
+    }
+
+    auto scene_description = ufps::yaml::deserialise<ufps::Scene::Description>(strm.str());
+    ufps::ensure(scene_description);
+
+    auto scene = ufps::Scene{std::move(*scene_description), entity_cache};
+    startup_timer.stage("scene (yaml)");
+
+    return scene;
+}
+
+auto log_startup_heap() -> void
+{
+    ufps::log::info(
+        "startup heap: live {} MiB peak {} MiB",
+        ufps::metrics().live_allocated_bytes / (1024zu * 1024zu),
+        ufps::metrics().peak_live_allocated_bytes / (1024zu * 1024zu));
+
+    // the heap misses mapped archives and driver allocations, the working set is what the os sees
+    auto counters = ::PROCESS_MEMORY_COUNTERS{};
+    if (::GetProcessMemoryInfo(::GetCurrentProcess(), &counters, sizeof(counters)) == 0)
+    {
+        ufps::log::warn("could not query process memory: {}", ::GetLastError());
+        return;
+    }
+
+    ufps::log::info(
+        "startup working set: current {} MiB peak {} MiB",
+        counters.WorkingSetSize / (1024zu * 1024zu),
+        counters.PeakWorkingSetSize / (1024zu * 1024zu));
+}
+
+auto start_light_coroutines(ufps::Scene &scene) -> void
+{
+    const auto point_light_handles = scene.lights().lights.handles();
+
+    pulse_light(point_light_handles[0], scene);
+    flicker_light(point_light_handles[2], scene);
+}
+
+template <class F>
+auto time_ms(F &&func) -> float
+{
+    const auto start = std::chrono::steady_clock::now();
+    func();
+    return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * Cpu time of every stage of each headless frame, in milliseconds. The light and command stages are part of render.
+ */
+struct HeadlessTimings
+{
+    std::vector<float> physics;
+    std::vector<float> coroutines;
+    std::vector<float> render;
+    std::vector<float> command_build;
+    std::vector<float> light_upload;
+    std::vector<float> light_cluster;
+    std::vector<float> texture_streaming;
+    std::vector<float> mesh_compaction;
+    std::vector<float> frame;
+};
+
+auto log_timings(std::string_view stage, std::vector<float> samples) -> void
+{
+    std::ranges::sort(samples);
+
+    const auto mean = std::ranges::fold_left(samples, 0.0f, std::plus{}) / static_cast<float>(samples.size());
+    const auto p99 = samples[(samples.size() * 99zu) / 100zu];
+
+    ufps::log::info(
+        "headless {:<18} mean {:>8.3f} ms min {:>8.3f} ms p99 {:>8.3f} ms max {:>8.3f} ms",
+        stage,
+        mean,
+        samples.front(),
+        p99,
+        samples.back());
+}
+
+/**
+ * Add a frame's recorded gl counts to the running totals, passes are matched by name.
+ */
+auto accumulate_gl_counts(std::vector<ufps::GlPassCounts> &totals, const std::vector<ufps::GlPassCounts> &frame)
+    -> void
+{
+    for (const auto &pass : frame)
+    {
+        auto total = std::ranges::find(totals, pass.name, &ufps::GlPassCounts::name);
+        if (total == std::ranges::end(totals))
+        {
+            total = totals.insert(total, {.name = pass.name, .counts = {}});
+        }
+
+        total->counts += pass.counts;
+    }
+}
+
+auto log_gl_counts(std::string_view label, const std::vector<ufps::GlPassCounts> &passes, std::size_t frame_count)
+    -> void
+{
+    const auto per_frame = [frame_count](std::size_t count) { return static_cast<float>(count) / frame_count; };
+
+    for (const auto &[name, counts] : passes)
+    {
+        ufps::log::info(
+            "gl {} {:<20} calls {:.1f} draws {:.1f} dispatches {:.1f} state changes {:.1f} buffer binds {:.1f} sub "
+            "data {:.1f} KiB mapped writes {:.1f} KiB",
+            label,
+            name,
+            per_frame(counts.calls),
+            per_frame(counts.draw_calls),
+            per_frame(counts.dispatches),
+            per_frame(counts.state_changes),
+            per_frame(counts.buffer_binds),
+            per_frame(counts.sub_data_bytes) / 1024.0f,
+            per_frame(counts.mapped_write_bytes) / 1024.0f);
+    }
+}
+
+auto parse_frame_count(std::string_view arg) -> std::size_t
+{
+    auto frame_count = 0zu;
+    const auto [end, ec] = std::from_chars(arg.data(), arg.data() + arg.size(), frame_count);
+    ufps::ensure(
+        (ec == std::errc{}) && (end == arg.data() + arg.size()) && (frame_count != 0zu),
+        "invalid headless frame count: {}",
+        arg);
+
+    return frame_count;
+}
+}
+
+int start(bool record_gl)
+{
+    // Daz_Da_Cat: First stream done.
+    // Daz_Da_Cat: You can't handle the Daz!
+    ::CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+
+    // reset after the first frame is presented
+    auto startup_timer = std::optional<StartupTimer>{std::in_place};
+
+    log_version();
+
+    auto window = ufps::Window{ufps::WindowMode::WINDOWED, 3840, 2160, 0u, 0u};
+    auto running = true;
+    startup_timer->stage("window");
+
+    // the window has resolved the gl functions, so the recorder can wrap them
+    if (record_gl)
+    {
+        ufps::record_opengl();
+    }
+
+    auto input_map = ufps::InputMap{};
+
+    auto resource_loader = create_resource_loader();
+    const auto sampler = simple_sampler();
+
+    // the archive is mapped rather than loaded so assets are only read and inflated when asked for, decoding happens
+    // on the pool and only the gl uploads happen here
+    const auto archive = ufps::AssetArchive{resource_loader->map_data_buffer("blobs\\assets.archive")};
+
+    auto [services, level_assets] =
+        create_services(*resource_loader, archive, sampler, ufps::DebugRenderMode::ON, *startup_timer);
+    auto &player_controller = ufps::service<ufps::PhysicsSystem>().player_controller();
 
     auto player_actor = ufps::PlayerActor{
         {{0.0f, 2.0f, 0.0f},
@@ -335,42 +725,18 @@ int start()
 
     ufps::Actor *current_actor = std::addressof(player_actor);
 
-    auto strm = std::stringstream{};
-    auto scene_description_yaml = std::ifstream{"scene.yaml"};
-
-    if (scene_description_yaml.is_open())
-    {
-        strm << scene_description_yaml.rdbuf();
-    }
-    else
-    {
-        if constexpr (ufps::config::use_embedded_resouce_loader)
-        {
-            auto scene_description_str = resource_loader->load_string("configs\\scene.yaml");
-            strm << scene_description_str;
-        }
-    }
-
-    auto services = std::make_unique<ufps::Services>(
-        std::move(awaitable_manager),
-        std::move(mesh_manager),
-        std::move(physics),
-        std::move(texture_manager),
-        std::move(pool));
-    ufps::set_service(services.get());
-
     auto renderer = ufps::DebugRenderer{window, *resource_loader};
     auto debug_mode = false;
+    startup_timer->stage("renderer");
 
-    auto scene_description = ufps::yaml::deserialise<ufps::Scene::Description>(strm.str());
-    ufps::ensure(scene_description);
-
-    auto scene = ufps::Scene{std::move(*scene_description), build_entity_cache(*resource_loader)};
-
-    const auto point_light_handles = scene.lights().lights.handles();
+    auto scene = load_level(*resource_loader, std::move(level_assets), *startup_timer);
+    log_startup_heap();
+    start_light_coroutines(scene);
 
-    pulse_light(point_light_handles[0], scene);
-    flicker_light(point_light_handles[2], scene);
+    if (record_gl)
+    {
+        log_gl_counts("startup", ufps::end_recorded_frame(), 1zu);
+    }
 
     while (running)
     {
@@ -435,9 +801,30 @@ int start()
         pool.drain();
 
         renderer.render(scene, current_actor->camera());
+        ufps::service<ufps::TextureStreamer>().update();
+
+        // a few meshes a frame keeps compaction off the critical path
+        if (const auto relocations = ufps::service<ufps::MeshManager>().compact(mesh_compaction_moves_per_frame);
+            !relocations.empty())
+        {
+            scene.relocate_meshes(relocations);
+            renderer.relocate_meshes(relocations);
+        }
 
         window.swap();
 
+        // shown while drawing the next frame's debug ui
+        if (record_gl)
+        {
+            renderer.set_gl_counts(ufps::end_recorded_frame());
+        }
+
+        if (startup_timer)
+        {
+            startup_timer->stage("first frame");
+            startup_timer.reset();
+        }
+
         const auto end_frame_allocated_bytes = ufps::g_metrics.total_allocated_bytes.load(std::memory_order_relaxed);
         ufps::g_metrics.frame_allocated_bytes.store(
             end_frame_allocated_bytes - begin_frame_allocated_bytes, std::memory_order_relaxed);
@@ -479,11 +866,133 @@ int start()
     return 0;
 }
 
-int main()
+/**
+ * Run a fixed number of frames without a window or gpu and log how long each stage took. The same assets, scene and
+ * services are loaded as a normal run but gl is replaced with cpu stand ins and the renderer only prepares frames.
+ * There's no input so the camera sweeps a full turn over the run to see the whole level.
+ */
+int start_headless(std::size_t frame_count)
+{
+    ::CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+
+    auto startup_timer = StartupTimer{};
+
+    log_version();
+    ufps::log::info("running headless for {} frames", frame_count);
+
+    ufps::use_null_opengl();
+    ufps::record_opengl();
+
+    auto resource_loader = create_resource_loader();
+    const auto sampler = simple_sampler();
+    const auto archive = ufps::AssetArchive{resource_loader->map_data_buffer("blobs\\assets.archive")};
+
+    auto [services, level_assets] =
+        create_services(*resource_loader, archive, sampler, ufps::DebugRenderMode::OFF, startup_timer);
+
+    auto renderer = ufps::NullRenderer{};
+    startup_timer.stage("renderer");
+
+    auto scene = load_level(*resource_loader, std::move(level_assets), startup_timer);
+    log_startup_heap();
+    start_light_coroutines(scene);
+
+    // everything uploaded while loading is reported on its own so it doesn't skew the per frame counts
+    log_gl_counts("startup", ufps::end_recorded_frame(), 1zu);
+
+    auto camera = ufps::Camera{
+        {0.0f, 2.0f, 0.0f},
+        {0.0f, 0.0f, -1.0f},
+        {0.0f, 1.0f, 0.0f},
+        std::numbers::pi_v<float> / 4.0f,
+        headless_width,
+        headless_height,
+        0.1f,
+        1000.0f};
+    const auto yaw_step = (2.0f * std::numbers::pi_v<float>) / static_cast<float>(frame_count);
+
+    auto &awaitable = ufps::service<ufps::AwaitableManager>();
+    auto &physics = ufps::service<ufps::PhysicsSystem>();
+    auto &pool = ufps::service<ufps::ThreadPool>();
+
+    auto timings = HeadlessTimings{};
+    auto gl_counts = std::vector<ufps::GlPassCounts>{};
+
+    for (auto frame = 0zu; frame < frame_count; ++frame)
+    {
+        const auto frame_start = std::chrono::steady_clock::now();
+
+        camera.adjust_yaw(yaw_step);
+
+        timings.physics.push_back(time_ms([&] { physics.update(); }));
+        timings.coroutines.push_back(time_ms(
+            [&]
+            {
+                awaitable.pump();
+                pool.drain();
+            }));
+        timings.render.push_back(time_ms([&] { renderer.render(scene, camera); }));
+        timings.command_build.push_back(renderer.metrics().command_build_ms);
+        timings.light_upload.push_back(renderer.metrics().light_upload_ms);
+        timings.light_cluster.push_back(renderer.metrics().light_cluster_ms);
+        timings.texture_streaming.push_back(time_ms([] { ufps::service<ufps::TextureStreamer>().update(); }));
+        timings.mesh_compaction.push_back(time_ms(
+            [&]
+            {
+                if (const auto relocations =
+                        ufps::service<ufps::MeshManager>().compact(mesh_compaction_moves_per_frame);
+                    !relocations.empty())
+                {
+                    scene.relocate_meshes(relocations);
+                }
+            }));
+
+        timings.frame.push_back(
+            std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - frame_start).count());
+
+        accumulate_gl_counts(gl_counts, ufps::end_recorded_frame());
+    }
+
+    const auto &metrics = renderer.metrics();
+    ufps::log::info(
+        "headless last frame: {} commands {} instances {} triangles {} lights {} light indices",
+        metrics.command_count,
+        metrics.instance_count,
+        metrics.triangle_count,
+        metrics.light_count,
+        metrics.light_index_count);
+
+    constexpr auto ctx = std::meta::access_context::current();
+    constexpr auto stages = std::define_static_array(std::meta::nonstatic_data_members_of(^^HeadlessTimings, ctx));
+    template for (constexpr auto e : stages)
+    {
+        log_timings(std::meta::identifier_of(e), std::move(timings.[:e:]));
+    }
+
+    log_gl_counts("per frame", gl_counts, frame_count);
+
+    awaitable.pump();
+    pool.drain();
+
+    return 0;
+}
+
+int main(int argc, char **argv)
 {
     try
     {
-        return start();
+        const auto args = std::span{argv, static_cast<std::size_t>(argc)} | std::views::drop(1) |
+                          std::views::transform([](const char *arg) { return std::string_view{arg}; }) |
+                          std::ranges::to<std::vector>();
+
+        // --headless [frames] runs without a window or gpu, for measuring cpu performance on machines without either
+        if (!args.empty() && (args[0] == "--headless"))
+        {
+            return start_headless(args.size() > 1zu ? parse_frame_count(args[1]) : default_headless_frame_count);
+        }
+
+        // --record-gl counts gl calls for each pass of the real renderer and shows them in the metrics window
+        return start(std::ranges::contains(args, "--record-gl"sv));
     }
     catch (const ufps::Exception &e)
     {
@@ -12,6 +12,7 @@ struct Metrics
     std::atomic<std::size_t> live_allocation_count;
     std::atomic<std::size_t> total_allocated_bytes;
     std::atomic<std::size_t> live_allocated_bytes;
+    std::atomic<std::size_t> peak_live_allocated_bytes;
     std::atomic<std::size_t> frame_allocated_bytes;
 };
 
@@ -21,6 +22,7 @@ struct MetricsSnapshot
     std::size_t live_allocation_count;
     std::size_t total_allocated_bytes;
     std::size_t live_allocated_bytes;
+    std::size_t peak_live_allocated_bytes;
     std::size_t frame_allocated_bytes;
 };
 
@@ -33,6 +35,7 @@ inline auto metrics() -> MetricsSnapshot
         .live_allocation_count = g_metrics.live_allocation_count.load(std::memory_order_relaxed),
         .total_allocated_bytes = g_metrics.total_allocated_bytes.load(std::memory_order_relaxed),
         .live_allocated_bytes = g_metrics.live_allocated_bytes.load(std::memory_order_relaxed),
+        .peak_live_allocated_bytes = g_metrics.peak_live_allocated_bytes.load(std::memory_order_relaxed),
         .frame_allocated_bytes = g_metrics.frame_allocated_bytes.load(std::memory_order_relaxed),
     };
 }
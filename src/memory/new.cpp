@@ -42,7 +42,16 @@ auto operator new(std::size_t count) -> void *
     ufps::g_metrics.total_allocation_count.fetch_add(1, std::memory_order_relaxed);
     ufps::g_metrics.live_allocation_count.fetch_add(1, std::memory_order_relaxed);
     ufps::g_metrics.total_allocated_bytes.fetch_add(real_allocation_size, std::memory_order_relaxed);
-    ufps::g_metrics.live_allocated_bytes.fetch_add(real_allocation_size, std::memory_order_relaxed);
+    const auto live_bytes =
+        ufps::g_metrics.live_allocated_bytes.fetch_add(real_allocation_size, std::memory_order_relaxed) +
+        real_allocation_size;
+
+    auto peak_bytes = ufps::g_metrics.peak_live_allocated_bytes.load(std::memory_order_relaxed);
+    while ((live_bytes > peak_bytes) &&
+           !ufps::g_metrics.peak_live_allocated_bytes.compare_exchange_weak(
+               peak_bytes, live_bytes, std::memory_order_relaxed))
+    {
+    }
 
     return ptr;
 }
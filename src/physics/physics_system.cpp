@@ -4,7 +4,10 @@
 #include <cstdarg>
 #include <cstdio>
 #include <optional>
+#include <ranges>
+#include <span>
 #include <string_view>
+#include <vector>
 
 #include "maths/transform.h"
 #include "maths/vector3.h"
@@ -145,6 +148,64 @@ auto PhysicsSystem::create_rigid_body(const RigidBody::Description &description)
     return handle;
 }
 
+auto PhysicsSystem::create_rigid_bodies(std::span<const RigidBody::Description> descriptions)
+    -> std::vector<RigidBodyHandle>
+{
+    if (descriptions.empty())
+    {
+        return {};
+    }
+
+    // every body starts as the same unit box, so the shape can be shared until a body is scaled
+    auto box_shape_settings = ::JPH::BoxShapeSettings{to_jolt(Vector3{1.0f})};
+    box_shape_settings.SetEmbedded();
+
+    auto box_result = box_shape_settings.Create();
+    if (box_result.HasError())
+    {
+        throw Exception("box error: {}", box_result.GetError());
+    }
+
+    const auto &box = box_result.Get();
+    auto &interface = physics_system_.GetBodyInterface();
+
+    auto body_ids = std::vector<::JPH::BodyID>{};
+    body_ids.reserve(descriptions.size());
+
+    for (const auto &description : descriptions)
+    {
+        const auto body_settings = ::JPH::BodyCreationSettings{
+            box,
+            to_jolt(Transform{description.local_transform}.position),
+            ::JPH::Quat::sIdentity(),
+            to_motion(PhysicsLayer::STATIC),
+            static_cast<::JPH::ObjectLayer>(PhysicsLayer::STATIC)};
+
+        const auto *body = interface.CreateBody(body_settings);
+        ensure(body != nullptr, "out of rigid bodies after {} of {}", body_ids.size(), descriptions.size());
+
+        body_ids.push_back(body->GetID());
+    }
+
+    // adding shuffles the ids, so keep them in description order for the handles
+    auto added_ids = body_ids;
+    const auto add_state = interface.AddBodiesPrepare(added_ids.data(), static_cast<int>(added_ids.size()));
+    interface.AddBodiesFinalize(
+        added_ids.data(), static_cast<int>(added_ids.size()), add_state, to_activation(PhysicsLayer::STATIC));
+
+    auto handles = std::vector<RigidBodyHandle>{};
+    handles.reserve(descriptions.size());
+
+    for (const auto &[body_id, description] : std::views::zip(body_ids, descriptions))
+    {
+        const auto handle = rigid_bodies_.emplace(body_id, std::addressof(interface));
+        rigid_bodies_[handle]->set_local_transform(Transform{description.local_transform});
+        handles.push_back(handle);
+    }
+
+    return handles;
+}
+
 auto PhysicsSystem::remove_rigid_body(RigidBodyHandle handle) -> void
 {
     const auto &rb = rigid_body(handle);
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <optional>
+#include <span>
+#include <vector>
 
 #include "core/sparse_set.h"
 #include "maths/aabb.h"
@@ -36,6 +38,13 @@ class PhysicsSystem : public ::JPH::ContactListener
     auto create_box(const AABB &aabb, const Vector3 &position, PhysicsLayer layer) -> RigidBodyHandle;
 
     auto create_rigid_body(const RigidBody::Description &description) -> RigidBodyHandle;
+
+    /**
+     * Create many rigid bodies at once, they are added to the broad phase in a single batch rather than one at a time.
+     * Handles are returned in the same order as the descriptions.
+     */
+    auto create_rigid_bodies(std::span<const RigidBody::Description> descriptions) -> std::vector<RigidBodyHandle>;
+
     auto remove_rigid_body(RigidBodyHandle handle) -> void;
     auto duplicate_rigid_body(RigidBodyHandle handle) -> RigidBodyHandle;
 
@@ -0,0 +1,185 @@
+#include "resources/asset_archive.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "utils/compress.h"
+#include "utils/data_buffer.h"
+#include "utils/decompress.h"
+#include "utils/error.h"
+
+namespace
+{
+
+template <class T>
+auto append(ufps::DataBuffer &buffer, const T &obj) -> void
+{
+    buffer.append_range(std::as_bytes(std::span{&obj, 1zu}));
+}
+
+template <class T>
+auto read(ufps::DataBufferView data, std::size_t offset) -> T
+{
+    ufps::ensure(offset + sizeof(T) <= data.size(), "archive truncated at offset {}", offset);
+
+    // the mapped data has no alignment guarantees
+    auto obj = T{};
+    std::memcpy(&obj, data.data() + offset, sizeof(T));
+    return obj;
+}
+
+}
+
+namespace ufps
+{
+
+auto AssetArchiveWriter::add(std::string_view name, DataBufferView data) -> void
+{
+    auto frame = compress(data);
+    ensure(frame);
+
+    assets_.push_back({.name = std::string{name}, .frame = std::move(*frame), .size = data.size()});
+}
+
+auto AssetArchiveWriter::data() const -> DataBuffer
+{
+    const auto names_size = std::ranges::fold_left(
+        assets_ | std::views::transform([](const auto &asset) { return asset.name.size(); }), 0zu, std::plus{});
+
+    auto archive = DataBuffer{};
+
+    append(
+        archive,
+        AssetArchiveHeader{
+            .magic = asset_archive_magic,
+            .version = asset_archive_version,
+            .entry_count = static_cast<std::uint32_t>(assets_.size()),
+            .names_size = static_cast<std::uint32_t>(names_size),
+        });
+
+    auto name_offset = 0zu;
+    auto frame_offset = sizeof(AssetArchiveHeader) + (assets_.size() * sizeof(AssetArchiveEntry)) + names_size;
+
+    for (const auto &[name, frame, size] : assets_)
+    {
+        append(
+            archive,
+            AssetArchiveEntry{
+                .offset = frame_offset,
+                .compressed_size = frame.size(),
+                .size = size,
+                .name_offset = static_cast<std::uint32_t>(name_offset),
+                .name_size = static_cast<std::uint32_t>(name.size()),
+            });
+
+        name_offset += name.size();
+        frame_offset += frame.size();
+    }
+
+    for (const auto &asset : assets_)
+    {
+        archive.append_range(std::as_bytes(std::span{asset.name}));
+    }
+
+    for (const auto &asset : assets_)
+    {
+        archive.append_range(asset.frame);
+    }
+
+    return archive;
+}
+
+auto AssetArchiveWriter::size() const -> std::size_t
+{
+    return std::ranges::fold_left(assets_ | std::views::transform(&Asset::size), 0zu, std::plus{});
+}
+
+auto AssetArchiveWriter::compressed_size() const -> std::size_t
+{
+    return std::ranges::fold_left(
+        assets_ | std::views::transform([](const auto &asset) { return asset.frame.size(); }), 0zu, std::plus{});
+}
+
+AssetArchive::AssetArchive(DataBufferView data)
+    : data_{data}
+    , entries_{}
+{
+    const auto header = read<AssetArchiveHeader>(data_, 0zu);
+    ensure(header.magic == asset_archive_magic, "not an asset archive");
+    ensure(header.version == asset_archive_version, "unsupported asset archive version: {}", header.version);
+
+    const auto names_offset = sizeof(AssetArchiveHeader) + (header.entry_count * sizeof(AssetArchiveEntry));
+    ensure(names_offset + header.names_size <= data_.size(), "archive index truncated");
+
+    const auto names = data_.subspan(names_offset, header.names_size);
+
+    for (auto i = 0zu; i < header.entry_count; ++i)
+    {
+        const auto entry = read<AssetArchiveEntry>(data_, sizeof(AssetArchiveHeader) + (i * sizeof(AssetArchiveEntry)));
+        ensure(entry.name_offset + entry.name_size <= names.size(), "archive entry {} has an invalid name", i);
+        ensure(entry.offset + entry.compressed_size <= data_.size(), "archive entry {} is truncated", i);
+
+        const auto name_bytes = names.subspan(entry.name_offset, entry.name_size);
+        entries_.insert({
+            std::string{reinterpret_cast<const char *>(name_bytes.data()), name_bytes.size()},
+            entry,
+        });
+    }
+}
+
+auto AssetArchive::contains(std::string_view name) const -> bool
+{
+    return entries_.contains(name);
+}
+
+auto AssetArchive::names() const -> std::vector<std::string>
+{
+    return entries_ | std::views::keys | std::ranges::to<std::vector>();
+}
+
+auto AssetArchive::size(std::string_view name) const -> std::size_t
+{
+    return entry(name).size;
+}
+
+auto AssetArchive::load(std::string_view name) const -> DataBuffer
+{
+    const auto &asset = entry(name);
+
+    auto data = decompress(data_.subspan(asset.offset, asset.compressed_size));
+    ensure(data.size() == asset.size, "asset {} decompressed to {} bytes, expected {}", name, data.size(), asset.size);
+
+    return data;
+}
+
+auto AssetArchive::load_into(std::string_view name, std::span<std::byte> destination) const -> void
+{
+    const auto &asset = entry(name);
+    ensure(
+        destination.size() >= asset.size,
+        "asset {} needs {} bytes, destination has {}",
+        name,
+        asset.size,
+        destination.size());
+
+    const auto size = decompress(data_.subspan(asset.offset, asset.compressed_size), destination.first(asset.size));
+    ensure(size == asset.size, "asset {} decompressed to {} bytes, expected {}", name, size, asset.size);
+}
+
+auto AssetArchive::entry(std::string_view name) const -> const AssetArchiveEntry &
+{
+    const auto asset = entries_.find(name);
+    ensure(asset != std::ranges::cend(entries_), "cannot find {} in archive", name);
+
+    return asset->second;
+}
+
+}
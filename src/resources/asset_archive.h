@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "utils/data_buffer.h"
+#include "utils/string_map.h"
+
+namespace ufps
+{
+
+inline constexpr auto asset_archive_magic = 0x50465541u; // "UFPA"
+inline constexpr auto asset_archive_version = 1u;
+
+/**
+ * An archive is a header, an index of entries, a table of names and then one zstd frame per asset. Offsets are from
+ * the start of the archive so it can be read in place from a memory mapped file.
+ */
+struct AssetArchiveHeader
+{
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint32_t entry_count;
+    std::uint32_t names_size;
+};
+
+struct AssetArchiveEntry
+{
+    std::uint64_t offset;
+    std::uint64_t compressed_size;
+    std::uint64_t size;
+    std::uint32_t name_offset;
+    std::uint32_t name_size;
+};
+
+static_assert(sizeof(AssetArchiveHeader) == 16zu, "archive headers are written to disk as is");
+static_assert(sizeof(AssetArchiveEntry) == 32zu, "archive entries are written to disk as is");
+
+/**
+ * Builds an archive, each asset is compressed as it is added so only the compressed frames are held.
+ */
+class AssetArchiveWriter
+{
+  public:
+    auto add(std::string_view name, DataBufferView data) -> void;
+
+    auto data() const -> DataBuffer;
+
+    auto size() const -> std::size_t;
+    auto compressed_size() const -> std::size_t;
+
+  private:
+    struct Asset
+    {
+        std::string name;
+        DataBuffer frame;
+        std::size_t size;
+    };
+
+    std::vector<Asset> assets_;
+};
+
+/**
+ * Read only view of an archive, the data must outlive the archive. Assets are decompressed on demand and loading is
+ * const so independent assets can be loaded from multiple threads.
+ */
+class AssetArchive
+{
+  public:
+    AssetArchive(DataBufferView data);
+
+    auto contains(std::string_view name) const -> bool;
+    auto names() const -> std::vector<std::string>;
+
+    auto size(std::string_view name) const -> std::size_t;
+    auto load(std::string_view name) const -> DataBuffer;
+
+    /**
+     * Decompress an asset straight into memory owned by the caller, which must hold at least size(name) bytes.
+     */
+    auto load_into(std::string_view name, std::span<std::byte> destination) const -> void;
+
+  private:
+    auto entry(std::string_view name) const -> const AssetArchiveEntry &;
+
+    DataBufferView data_;
+    StringMap<AssetArchiveEntry> entries_;
+};
+
+}
@@ -0,0 +1,203 @@
+#include "resources/binary_manifest.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "core/manifest_descriptions.h"
+#include "graphics/mesh_lod.h"
+#include "utils/data_buffer.h"
+#include "utils/error.h"
+#include "utils/flat_records.h"
+#include "utils/string_map.h"
+
+namespace
+{
+
+constexpr auto format_name = std::string_view{"manifest"};
+
+}
+
+namespace ufps
+{
+
+auto encode_binary_manifest(const ModelManifestDescription &models, const TextureManifestDescription &textures)
+    -> DataBuffer
+{
+    auto texture_names = textures.textures | std::views::keys | std::ranges::to<std::vector>();
+    std::ranges::sort(texture_names);
+
+    auto model_names = models.models | std::views::keys | std::ranges::to<std::vector>();
+    std::ranges::sort(model_names);
+
+    auto names = std::string{};
+    const auto add_name = [&names](std::string_view name)
+    {
+        const auto offset = static_cast<std::uint32_t>(names.size());
+        names.append(name);
+
+        return BinaryManifestName{.offset = offset, .size = static_cast<std::uint32_t>(name.size())};
+    };
+
+    auto texture_records = std::vector<BinaryTextureManifest>{};
+    auto texture_indices = StringMap<std::uint32_t>{};
+
+    for (const auto &[index, name] : std::views::enumerate(texture_names))
+    {
+        texture_records.push_back({
+            .name = add_name(name),
+            .is_srgb = textures.textures.find(name)->second.is_srgb ? 1u : 0u,
+        });
+        texture_indices.insert({name, static_cast<std::uint32_t>(index)});
+    }
+
+    const auto texture_index = [&texture_indices](const std::string &name)
+    {
+        const auto index = texture_indices.find(name);
+        ensure(index != std::ranges::cend(texture_indices), "texture {} is not in the texture manifest", name);
+
+        return index->second;
+    };
+
+    auto model_records = std::vector<BinaryModelManifest>{};
+    auto sub_model_records = std::vector<BinarySubModelManifest>{};
+    auto lods = std::vector<MeshLod>{};
+
+    for (const auto &name : model_names)
+    {
+        const auto &sub_models = models.models.find(name)->second;
+
+        model_records.push_back({
+            .name = add_name(name),
+            .first_sub_model = static_cast<std::uint32_t>(sub_model_records.size()),
+            .sub_model_count = static_cast<std::uint32_t>(sub_models.size()),
+        });
+
+        for (const auto &sub_model : sub_models)
+        {
+            sub_model_records.push_back({
+                .mesh_view = sub_model.mesh_view,
+                .meshlets = sub_model.meshlets,
+                .first_lod = static_cast<std::uint32_t>(lods.size()),
+                .lod_count = static_cast<std::uint32_t>(sub_model.lods.size()),
+                .textures = {
+                    texture_index(sub_model.albedo_texture),
+                    texture_index(sub_model.normal_texture),
+                    texture_index(sub_model.specular_texture),
+                    texture_index(sub_model.ao_texture),
+                    texture_index(sub_model.glossiness_texture),
+                    texture_index(sub_model.emissive_texture),
+                },
+            });
+
+            lods.append_range(sub_model.lods);
+        }
+    }
+
+    const auto header = BinaryManifestHeader{
+        .magic = binary_manifest_magic,
+        .version = binary_manifest_version,
+        .texture_count = static_cast<std::uint32_t>(texture_records.size()),
+        .model_count = static_cast<std::uint32_t>(model_records.size()),
+        .sub_model_count = static_cast<std::uint32_t>(sub_model_records.size()),
+        .lod_count = static_cast<std::uint32_t>(lods.size()),
+        .names_size = static_cast<std::uint32_t>(names.size()),
+        .schema = binary_manifest_schema,
+    };
+
+    auto manifest = DataBuffer{};
+    flat_records::append(manifest, std::span{&header, 1zu});
+    flat_records::append(manifest, std::span<const BinaryTextureManifest>{texture_records});
+    flat_records::append(manifest, std::span<const BinaryModelManifest>{model_records});
+    flat_records::append(manifest, std::span<const BinarySubModelManifest>{sub_model_records});
+    flat_records::append(manifest, std::span<const MeshLod>{lods});
+    flat_records::append(manifest, std::span<const char>{names});
+
+    return manifest;
+}
+
+BinaryManifest::BinaryManifest(DataBufferView data)
+    : textures_{}
+    , models_{}
+    , sub_models_{}
+    , lods_{}
+    , names_{}
+{
+    // every record is made of 32 bit fields, mapped files and embedded resources are aligned for this
+    ensure(
+        reinterpret_cast<std::uintptr_t>(data.data()) % alignof(BinaryManifestHeader) == 0zu,
+        "manifest data is not aligned");
+
+    auto offset = 0zu;
+    const auto header = flat_records::section<BinaryManifestHeader>(format_name, data, offset, 1zu).front();
+    ensure(header.magic == binary_manifest_magic, "not a binary manifest");
+    ensure(header.version == binary_manifest_version, "unsupported binary manifest version: {}", header.version);
+    ensure(header.schema == binary_manifest_schema, "binary manifest was written with a different schema");
+
+    textures_ = flat_records::section<BinaryTextureManifest>(format_name, data, offset, header.texture_count);
+    models_ = flat_records::section<BinaryModelManifest>(format_name, data, offset, header.model_count);
+    sub_models_ = flat_records::section<BinarySubModelManifest>(format_name, data, offset, header.sub_model_count);
+    lods_ = flat_records::section<MeshLod>(format_name, data, offset, header.lod_count);
+
+    const auto names = flat_records::section<char>(format_name, data, offset, header.names_size);
+    names_ = std::string_view{names.data(), names.size()};
+
+    for (const auto &texture : textures_)
+    {
+        flat_records::check_range(format_name, texture.name.offset, texture.name.size, names_.size(), "name");
+    }
+
+    for (const auto &model : models_)
+    {
+        flat_records::check_range(format_name, model.name.offset, model.name.size, names_.size(), "name");
+        flat_records::check_range(
+            format_name, model.first_sub_model, model.sub_model_count, sub_models_.size(), "sub model");
+    }
+
+    for (const auto &sub_model : sub_models_)
+    {
+        flat_records::check_range(format_name, sub_model.first_lod, sub_model.lod_count, lods_.size(), "lod");
+
+        for (const auto texture : sub_model.textures)
+        {
+            flat_records::check_range(format_name, texture, 1u, textures_.size(), "texture");
+        }
+    }
+}
+
+auto BinaryManifest::textures() const -> std::span<const BinaryTextureManifest>
+{
+    return textures_;
+}
+
+auto BinaryManifest::models() const -> std::span<const BinaryModelManifest>
+{
+    return models_;
+}
+
+auto BinaryManifest::sub_models(const BinaryModelManifest &model) const -> std::span<const BinarySubModelManifest>
+{
+    return sub_models_.subspan(model.first_sub_model, model.sub_model_count);
+}
+
+auto BinaryManifest::lods(const BinarySubModelManifest &sub_model) const -> std::span<const MeshLod>
+{
+    return lods_.subspan(sub_model.first_lod, sub_model.lod_count);
+}
+
+auto BinaryManifest::name(const BinaryManifestName &name) const -> std::string_view
+{
+    return names_.substr(name.offset, name.size);
+}
+
+auto BinaryManifest::texture_name(std::uint32_t index) const -> std::string_view
+{
+    return name(textures_[index].name);
+}
+
+}
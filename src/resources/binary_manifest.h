@@ -0,0 +1,133 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+#include "core/manifest_descriptions.h"
+#include "graphics/mesh_lod.h"
+#include "graphics/mesh_view.h"
+#include "graphics/meshlet.h"
+#include "serialisation/binary_serialiser.h"
+#include "utils/data_buffer.h"
+
+namespace ufps
+{
+
+inline constexpr auto binary_manifest_magic = 0x4d504655u; // "UFPM"
+inline constexpr auto binary_manifest_version = 2u;
+
+/**
+ * A manifest is a header, arrays of fixed size texture, model, sub model and lod records and then a table of names.
+ * Records refer to each other and to names by index so it can be used in place from a memory mapped file, which is
+ * why it isn't written with binary::serialise: that reads into owning containers. Records are binary::FixedLayout
+ * types, laid out with the shared flat record helpers, and the header carries their binary schema.
+ */
+struct BinaryManifestHeader
+{
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint32_t texture_count;
+    std::uint32_t model_count;
+    std::uint32_t sub_model_count;
+    std::uint32_t lod_count;
+    std::uint32_t names_size;
+    std::uint32_t schema;
+};
+
+struct BinaryManifestName
+{
+    std::uint32_t offset;
+    std::uint32_t size;
+};
+
+struct BinaryTextureManifest
+{
+    BinaryManifestName name;
+    std::uint32_t is_srgb;
+};
+
+struct BinaryModelManifest
+{
+    BinaryManifestName name;
+    std::uint32_t first_sub_model;
+    std::uint32_t sub_model_count;
+};
+
+/**
+ * Textures are indices of texture records, in the order albedo, normal, specular, ao, glossiness and emissive. Lods
+ * are the simplified meshes only, as in ModelManifest.
+ */
+struct BinarySubModelManifest
+{
+    MeshView mesh_view;
+    MeshletRange meshlets;
+    std::uint32_t first_lod;
+    std::uint32_t lod_count;
+    std::array<std::uint32_t, 6zu> textures;
+};
+
+static_assert(binary::FixedLayout<BinaryManifestHeader>, "manifest headers are written to disk as is");
+static_assert(binary::FixedLayout<BinaryTextureManifest>, "manifest records are written to disk as is");
+static_assert(binary::FixedLayout<BinaryModelManifest>, "manifest records are written to disk as is");
+static_assert(binary::FixedLayout<BinarySubModelManifest>, "manifest records are written to disk as is");
+static_assert(binary::FixedLayout<MeshLod>, "manifest records are written to disk as is");
+static_assert(sizeof(BinaryManifestHeader) == 32zu);
+static_assert(sizeof(BinaryTextureManifest) == 12zu);
+static_assert(sizeof(BinaryModelManifest) == 16zu);
+static_assert(sizeof(BinarySubModelManifest) == 56zu);
+static_assert(sizeof(MeshLod) == 20zu);
+
+/**
+ * Every record type in a manifest, only used to hash their layout the same way the binary serialiser does.
+ */
+struct BinaryManifestRecords
+{
+    BinaryTextureManifest texture;
+    BinaryModelManifest model;
+    BinarySubModelManifest sub_model;
+    MeshLod lod;
+};
+
+/**
+ * Changes whenever a record type changes, folded to 32 bits so the header keeps its size and alignment.
+ */
+inline constexpr auto binary_manifest_schema = static_cast<std::uint32_t>(
+    binary::schema<BinaryManifestRecords>() ^ (binary::schema<BinaryManifestRecords>() >> 32u));
+
+/**
+ * Flatten the model and texture manifests into a single binary manifest. Textures and models are sorted by name and
+ * every texture a model uses must be in the texture manifest.
+ */
+auto encode_binary_manifest(const ModelManifestDescription &models, const TextureManifestDescription &textures)
+    -> DataBuffer;
+
+/**
+ * Read only view of a binary manifest, the data must outlive the manifest. Every record is bounds checked on
+ * construction so accessing them afterwards is just pointer arithmetic.
+ */
+class BinaryManifest
+{
+  public:
+    BinaryManifest(DataBufferView data);
+
+    auto textures() const -> std::span<const BinaryTextureManifest>;
+    auto models() const -> std::span<const BinaryModelManifest>;
+
+    auto sub_models(const BinaryModelManifest &model) const -> std::span<const BinarySubModelManifest>;
+    auto lods(const BinarySubModelManifest &sub_model) const -> std::span<const MeshLod>;
+
+    auto name(const BinaryManifestName &name) const -> std::string_view;
+    auto texture_name(std::uint32_t index) const -> std::string_view;
+
+  private:
+    std::span<const BinaryTextureManifest> textures_;
+    std::span<const BinaryModelManifest> models_;
+    std::span<const BinarySubModelManifest> sub_models_;
+    std::span<const MeshLod> lods_;
+    std::string_view names_;
+};
+
+}
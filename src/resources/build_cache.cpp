@@ -0,0 +1,175 @@
+#include "resources/build_cache.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <system_error>
+#include <thread>
+
+#include "utils/compress.h"
+#include "utils/data_buffer.h"
+#include "utils/decompress.h"
+#include "utils/error.h"
+#include "utils/exception.h"
+#include "utils/formatter.h"
+#include "utils/log.h"
+
+namespace
+{
+
+constexpr auto build_cache_magic = 0x43424655u; // "UFBC"
+
+/**
+ * Written before the compressed frame, so entries from a different key or a truncated write are detected.
+ */
+struct BuildCacheHeader
+{
+    std::uint32_t magic;
+    std::uint32_t reserved;
+    std::uint64_t key;
+    std::uint64_t compressed_size;
+};
+
+static_assert(sizeof(BuildCacheHeader) == 24zu, "build cache headers are written to disk as is");
+
+constexpr auto mix(std::uint64_t value) -> std::uint64_t
+{
+    value ^= value >> 32u;
+    value *= 0xd6e8feb86659fd93ull;
+    value ^= value >> 32u;
+    value *= 0xd6e8feb86659fd93ull;
+    value ^= value >> 32u;
+
+    return value;
+}
+
+}
+
+namespace ufps
+{
+
+auto content_hash(DataBufferView data, std::uint64_t seed) -> std::uint64_t
+{
+    auto hash = mix(seed ^ (data.size() * 0x9e3779b97f4a7c15ull));
+
+    // eight bytes at a time as sources can be hundreds of megabytes, the tail is zero padded
+    for (auto offset = 0zu; offset < data.size(); offset += sizeof(std::uint64_t))
+    {
+        auto word = std::uint64_t{};
+        std::memcpy(&word, data.data() + offset, std::min(sizeof(word), data.size() - offset));
+
+        hash = mix(hash ^ mix(word));
+    }
+
+    return hash;
+}
+
+auto build_cache_key(DataBufferView source, std::string_view settings) -> std::uint64_t
+{
+    return content_hash(source, content_hash(std::as_bytes(std::span{settings})));
+}
+
+BuildCache::BuildCache(const std::filesystem::path &directory)
+    : directory_{directory}
+    , hits_{}
+    , misses_{}
+{
+    std::filesystem::create_directories(directory_);
+}
+
+auto BuildCache::load(std::uint64_t key) -> std::optional<DataBuffer>
+{
+    const auto entry_path = path(key);
+
+    auto file = std::ifstream{entry_path, std::ios::binary};
+    if (!file)
+    {
+        ++misses_;
+        return std::nullopt;
+    }
+
+    auto header = BuildCacheHeader{};
+    file.read(reinterpret_cast<char *>(&header), sizeof(header));
+
+    // the size comes from disk, a corrupt one must not be trusted with an allocation
+    auto size_error = std::error_code{};
+    const auto file_size = std::filesystem::file_size(entry_path, size_error);
+    const auto size_valid =
+        file && !size_error && (file_size >= sizeof(header)) && (header.compressed_size == file_size - sizeof(header));
+
+    auto frame = DataBuffer(size_valid ? header.compressed_size : 0zu);
+    file.read(reinterpret_cast<char *>(frame.data()), frame.size());
+
+    if (!file || (header.magic != build_cache_magic) || (header.key != key) || frame.empty())
+    {
+        log::warn("ignoring invalid build cache entry {}", entry_path.string());
+        ++misses_;
+        return std::nullopt;
+    }
+
+    try
+    {
+        auto data = decompress(frame);
+        ++hits_;
+
+        return data;
+    }
+    catch (const Exception &e)
+    {
+        log::warn("ignoring invalid build cache entry {}: {}", entry_path.string(), e);
+        ++misses_;
+        return std::nullopt;
+    }
+}
+
+auto BuildCache::store(std::uint64_t key, DataBufferView data) -> void
+{
+    auto frame = compress(data);
+    ensure(frame);
+
+    const auto header = BuildCacheHeader{
+        .magic = build_cache_magic,
+        .reserved = 0u,
+        .key = key,
+        .compressed_size = frame->size(),
+    };
+
+    // identical sources share a key so may be stored by two threads at once, each needs its own temporary
+    const auto entry_path = path(key);
+    auto temp_path = entry_path;
+    temp_path += std::format(".{}.tmp", std::hash<std::thread::id>{}(std::this_thread::get_id()));
+
+    {
+        auto file = std::ofstream{temp_path, std::ios::binary | std::ios::trunc};
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char *>(frame->data()), frame->size());
+        ensure(static_cast<bool>(file), "failed to write build cache entry {}", temp_path.string());
+    }
+
+    std::filesystem::rename(temp_path, entry_path);
+}
+
+auto BuildCache::hits() const -> std::uint32_t
+{
+    return hits_.load();
+}
+
+auto BuildCache::misses() const -> std::uint32_t
+{
+    return misses_.load();
+}
+
+auto BuildCache::path(std::uint64_t key) const -> std::filesystem::path
+{
+    return directory_ / std::format("{:016x}", key);
+}
+
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string_view>
+
+#include "utils/data_buffer.h"
+
+namespace ufps
+{
+
+/**
+ * Hash of some bytes which is stable across runs so it can key an on disk cache, it is not cryptographic.
+ */
+auto content_hash(DataBufferView data, std::uint64_t seed = 0u) -> std::uint64_t;
+
+/**
+ * Key for the output of building a source asset, settings should describe everything other than the source which
+ * changes the output. Including a version which is bumped whenever the build code changes invalidates old entries.
+ */
+auto build_cache_key(DataBufferView source, std::string_view settings) -> std::uint64_t;
+
+/**
+ * Directory of intermediate build outputs keyed by build_cache_key, entries are zstd compressed. Independent keys can
+ * be loaded and stored from multiple threads. Entries are written to a temporary file and renamed into place so an
+ * interrupted build never leaves a partial entry, entries which can't be read are treated as missing.
+ */
+class BuildCache
+{
+  public:
+    BuildCache(const std::filesystem::path &directory);
+
+    auto load(std::uint64_t key) -> std::optional<DataBuffer>;
+
+    auto store(std::uint64_t key, DataBufferView data) -> void;
+
+    auto hits() const -> std::uint32_t;
+    auto misses() const -> std::uint32_t;
+
+  private:
+    auto path(std::uint64_t key) const -> std::filesystem::path;
+
+    std::filesystem::path directory_;
+    std::atomic<std::uint32_t> hits_;
+    std::atomic<std::uint32_t> misses_;
+};
+
+}
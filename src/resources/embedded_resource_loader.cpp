@@ -12,24 +12,13 @@
 namespace
 {
 
-constexpr const std::uint8_t vertex_data_bin[] = {
-#embed "../../build/build_assets/blobs/vertex_data.bin"
+constexpr const std::uint8_t assets_archive[] = {
+#embed "../../build/build_assets/blobs/assets.archive"
 };
 
-constexpr const std::uint8_t index_data_bin[] = {
-#embed "../../build/build_assets/blobs/index_data.bin"
-};
-
-constexpr const std::uint8_t model_manifest_yaml[] = {
-#embed "../../build/build_assets/configs/model_manifest.yaml"
-};
-
-constexpr const std::uint8_t texture_data_bin[] = {
-#embed "../../build/build_assets/blobs/texture_data.bin"
-};
-
-constexpr const std::uint8_t texture_manifest_yaml[] = {
-#embed "../../build/build_assets/configs/texture_manifest.yaml"
+// the manifest is used in place so has to be aligned for its records
+alignas(std::uint32_t) constexpr const std::uint8_t manifest_bin[] = {
+#embed "../../build/build_assets/configs/manifest.bin"
 };
 
 constexpr const std::uint8_t average_luminance_comp[] = {
@@ -52,6 +41,10 @@ constexpr const std::uint8_t gbuffer_vert[] = {
 #embed "../../assets/shaders/gbuffer.vert"
 };
 
+constexpr const std::uint8_t light_cluster_comp[] = {
+#embed "../../assets/shaders/light_cluster.comp"
+};
+
 constexpr const std::uint8_t light_pass_frag[] = {
 #embed "../../assets/shaders/light_pass.frag"
 };
@@ -120,17 +113,15 @@ namespace ufps
 EmbeddedResourceLoader::EmbeddedResourceLoader()
 {
     lookup_ = {
-        {"blobs\\index_data.bin", std::span{index_data_bin, sizeof(index_data_bin)}},
-        {"blobs\\texture_data.bin", std::span{texture_data_bin, sizeof(texture_data_bin)}},
-        {"blobs\\vertex_data.bin", std::span{vertex_data_bin, sizeof(vertex_data_bin)}},
-        {"configs\\model_manifest.yaml", std::span{model_manifest_yaml, sizeof(model_manifest_yaml)}},
+        {"blobs\\assets.archive", std::span{assets_archive, sizeof(assets_archive)}},
+        {"configs\\manifest.bin", std::span{manifest_bin, sizeof(manifest_bin)}},
         {"configs\\scene.yaml", std::span{scene_config, sizeof(scene_config)}},
-        {"configs\\texture_manifest.yaml", std::span{texture_manifest_yaml, sizeof(texture_manifest_yaml)}},
         {"shaders\\average_luminance.comp", std::span{average_luminance_comp, sizeof(average_luminance_comp)}},
         {"shaders\\debug_light.frag", std::span{debug_light_frag, sizeof(debug_light_frag)}},
         {"shaders\\debug_light.vert", std::span{debug_light_vert, sizeof(debug_light_vert)}},
         {"shaders\\gbuffer.frag", std::span{gbuffer_frag, sizeof(gbuffer_frag)}},
         {"shaders\\gbuffer.vert", std::span{gbuffer_vert, sizeof(gbuffer_vert)}},
+        {"shaders\\light_cluster.comp", std::span{light_cluster_comp, sizeof(light_cluster_comp)}},
         {"shaders\\light_pass.frag", std::span{light_pass_frag, sizeof(light_pass_frag)}},
         {"shaders\\light_pass.vert", std::span{light_pass_vert, sizeof(light_pass_vert)}},
         {"shaders\\line.frag", std::span{line_frag, sizeof(line_frag)}},
@@ -161,4 +152,12 @@ auto EmbeddedResourceLoader::load_data_buffer(std::string_view name) -> DataBuff
 
     return to_container<DataBuffer>(resource->second);
 }
+
+auto EmbeddedResourceLoader::map_data_buffer(std::string_view name) -> DataBufferView
+{
+    const auto resource = lookup_.find(name);
+    expect(resource != std::ranges::cend(lookup_), "resource {} does not exist", name);
+
+    return std::as_bytes(resource->second);
+}
 }
@@ -2,6 +2,8 @@
 
 #include <cstddef>
 #include <filesystem>
+#include <memory>
+#include <string>
 #include <ranges>
 #include <vector>
 
@@ -46,13 +48,28 @@ auto init(const std::filesystem::path &path)
     return std::make_tuple(std::move(handle), std::move(mapping), std::move(map_view));
 }
 
+/**
+ * GetFileSize only returns the low 32 bits without a second out parameter, so archives over 4 GiB need the 64 bit size.
+ */
+auto file_size(HANDLE handle, const std::filesystem::path &path) -> std::size_t
+{
+    auto size = ::LARGE_INTEGER{};
+    ufps::ensure(
+        ::GetFileSizeEx(handle, &size) != 0,
+        "failed to get file size: {} error: {}",
+        path.native_encoded_string(),
+        ::GetLastError());
+
+    return static_cast<std::size_t>(size.QuadPart);
+}
+
 template <class T>
 auto load(const std::filesystem::path &path)
 {
     static_assert(sizeof(typename T::value_type) == 1);
 
     const auto &[handle, mapping, map_view] = init(path);
-    const auto size = ::GetFileSize(handle, nullptr);
+    const auto size = file_size(handle, path);
     const auto *ptr = reinterpret_cast<T::value_type *>(map_view.get());
 
     return T{ptr, ptr + size};
@@ -63,6 +80,7 @@ namespace ufps
 {
 FileResourceLoader::FileResourceLoader(const std::vector<std::filesystem::path> &roots)
     : roots_{roots}
+    , mapped_files_{}
 {
     for (const auto &root : roots_)
     {
@@ -101,6 +119,35 @@ auto FileResourceLoader::load_data_buffer(std::string_view name) -> DataBuffer
     throw Exception("cannot find {}", name);
 }
 
+auto FileResourceLoader::map_data_buffer(std::string_view name) -> DataBufferView
+{
+    if (const auto mapped_file = mapped_files_.find(name); mapped_file != std::ranges::cend(mapped_files_))
+    {
+        return mapped_file->second.data;
+    }
+
+    for (const auto &root : roots_)
+    {
+        const auto path = root / name;
+        if (std::filesystem::exists(path))
+        {
+            // the view keeps the file mapped after the file and mapping handles are closed
+            auto [handle, mapping, map_view] = init(path);
+            const auto size = file_size(handle, path);
+            const auto data = DataBufferView{reinterpret_cast<const std::byte *>(map_view.get()), size};
+
+            mapped_files_.insert({
+                std::string{name},
+                {.view = {map_view.release(), [](void *view) { ::UnmapViewOfFile(view); }}, .data = data},
+            });
+
+            return data;
+        }
+    }
+
+    throw Exception("cannot find {}", name);
+}
+
 auto FileResourceLoader::resources(std::string_view type) -> std::vector<std::string>
 {
     return roots_ |
@@ -1,12 +1,14 @@
 #pragma once
 
 #include <filesystem>
+#include <memory>
 #include <string>
 #include <string_view>
 #include <vector>
 
 #include "resources/resource_loader.h"
 #include "utils/data_buffer.h"
+#include "utils/string_map.h"
 
 namespace ufps
 {
@@ -19,10 +21,18 @@ class FileResourceLoader : public ResourceLoader
 
     auto load_string(std::string_view name) -> std::string override;
     auto load_data_buffer(std::string_view name) -> DataBuffer override;
+    auto map_data_buffer(std::string_view name) -> DataBufferView override;
     auto resources(std::string_view type) -> std::vector<std::string> override;
 
   private:
+    struct MappedFile
+    {
+        std::unique_ptr<void, void (*)(void *)> view;
+        DataBufferView data;
+    };
+
     std::vector<std::filesystem::path> roots_;
+    StringMap<MappedFile> mapped_files_;
 };
 
 }
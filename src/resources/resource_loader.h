@@ -2,6 +2,7 @@
 
 #include <string>
 #include <string_view>
+#include <vector>
 
 #include "utils/data_buffer.h"
 
@@ -15,6 +16,12 @@ class ResourceLoader
 
     virtual auto load_string(std::string_view name) -> std::string = 0;
     virtual auto load_data_buffer(std::string_view name) -> DataBuffer = 0;
+
+    /**
+     * Get a view of a resource without copying it, the view remains valid for the lifetime of the loader.
+     */
+    virtual auto map_data_buffer(std::string_view name) -> DataBufferView = 0;
+
     virtual auto resources(std::string_view type) -> std::vector<std::string> = 0;
 };
 
@@ -0,0 +1,526 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <expected>
+#include <format>
+#include <meta>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "maths/bounded_number.h"
+#include "maths/matrix4.h"
+#include "serialisation/concepts.h"
+#include "utils/data_buffer.h"
+#include "utils/error.h"
+#include "utils/exception.h"
+
+namespace ufps::binary
+{
+
+inline constexpr auto format_magic = 0x42504655u; // "UFPB"
+inline constexpr auto format_version = 1u;
+
+/**
+ * Every serialised object starts with this. The schema is a hash of the names and types of everything reachable from
+ * the serialised type so data written by an older build is rejected rather than misread. A type can declare a static
+ * schema_version to force this when only the meaning of its members changes.
+ */
+struct Header
+{
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint64_t schema;
+};
+
+static_assert(std::endian::native == std::endian::little, "binary data is little endian and read in place");
+
+namespace impl
+{
+
+using serialisation::Array;
+using serialisation::Bounded;
+using serialisation::Class;
+using serialisation::Enum;
+using serialisation::Map;
+using serialisation::Sparse;
+
+template <class T>
+consteval auto is_fixed_layout() -> bool
+{
+    if constexpr (std::is_arithmetic_v<T>)
+    {
+        // any byte is a valid value for every other arithmetic type
+        return !std::same_as<T, bool>;
+    }
+    else if constexpr (std::same_as<T, std::byte>)
+    {
+        return true;
+    }
+    else if constexpr (std::is_bounded_array_v<T>)
+    {
+        return is_fixed_layout<std::remove_extent_t<T>>();
+    }
+    else if constexpr (std::is_class_v<T> && std::is_trivially_copyable_v<T>)
+    {
+        auto fixed = true;
+        auto size = 0zu;
+
+        // only public members are visible so a class hiding state, such as a bounded number, never matches the size
+        constexpr auto ctx = std::meta::access_context::current();
+        template for (constexpr auto e : std::define_static_array(std::meta::nonstatic_data_members_of(^^T, ctx)))
+        {
+            using MemberType = typename[:std::meta::type_of(e):];
+            fixed = fixed && is_fixed_layout<MemberType>();
+            size += sizeof(MemberType);
+        }
+
+        return fixed && size == sizeof(T);
+    }
+    else
+    {
+        return false;
+    }
+}
+
+}
+
+/**
+ * A type whose bytes are its serialised form: scalars (other than bool), bytes and classes of them with no padding
+ * and no non-public members. These, and contiguous ranges of them, are copied in bulk.
+ */
+template <class T>
+concept FixedLayout = impl::is_fixed_layout<T>();
+
+namespace impl
+{
+
+consteval auto hash(std::uint64_t seed, std::string_view str) -> std::uint64_t
+{
+    // fnv-1a
+    for (const auto c : str)
+    {
+        seed ^= static_cast<std::uint8_t>(c);
+        seed *= 0x100000001b3ull;
+    }
+
+    return seed;
+}
+
+consteval auto hash(std::uint64_t seed, std::uint64_t value) -> std::uint64_t
+{
+    for (auto i = 0u; i < 8u; ++i)
+    {
+        seed ^= (value >> (i * 8u)) & 0xffu;
+        seed *= 0x100000001b3ull;
+    }
+
+    return seed;
+}
+
+template <class T>
+consteval auto schema_hash(std::uint64_t seed = 0xcbf29ce484222325ull) -> std::uint64_t
+{
+    if constexpr (std::is_arithmetic_v<T>)
+    {
+        return hash(
+            hash(seed, "scalar"),
+            (sizeof(T) << 2u) | (std::floating_point<T> ? 2u : 0u) | (std::is_signed_v<T> ? 1u : 0u));
+    }
+    else if constexpr (std::same_as<T, std::string>)
+    {
+        return hash(seed, "string");
+    }
+    else if constexpr (Bounded<T>)
+    {
+        return schema_hash<typename T::type>(hash(seed, "bounded"));
+    }
+    else if constexpr (Enum<T>)
+    {
+        seed = schema_hash<std::underlying_type_t<T>>(hash(seed, std::meta::identifier_of(^^T)));
+
+        template for (constexpr auto e : std::define_static_array(std::meta::enumerators_of(^^T)))
+        {
+            seed = hash(hash(seed, std::meta::identifier_of(e)), static_cast<std::uint64_t>(std::to_underlying([:e:])));
+        }
+
+        return seed;
+    }
+    else if constexpr (Map<T>)
+    {
+        return schema_hash<typename T::mapped_type>(schema_hash<typename T::key_type>(hash(seed, "map")));
+    }
+    else if constexpr (Sparse<T>)
+    {
+        return schema_hash<typename T::value_type>(hash(seed, "sparse"));
+    }
+    else if constexpr (Array<T>)
+    {
+        return schema_hash<std::ranges::range_value_t<T>>(hash(seed, "array"));
+    }
+    else if constexpr (std::same_as<T, Matrix4>)
+    {
+        return hash(seed, "Matrix4");
+    }
+    else if constexpr (Class<T>)
+    {
+        seed = hash(seed, std::meta::identifier_of(^^T));
+        if constexpr (requires { T::schema_version; })
+        {
+            seed = hash(seed, static_cast<std::uint64_t>(T::schema_version));
+        }
+
+        constexpr auto ctx = std::meta::access_context::current();
+        template for (constexpr auto e : std::define_static_array(std::meta::nonstatic_data_members_of(^^T, ctx)))
+        {
+            seed = schema_hash<typename[:std::meta::type_of(e):]>(hash(seed, std::meta::identifier_of(e)));
+        }
+
+        return seed;
+    }
+    else
+    {
+        static_assert(false, "type cannot be serialised");
+    }
+}
+
+inline auto write_bytes(DataBuffer &buffer, const void *data, std::size_t size) -> void
+{
+    buffer.append_range(std::span{static_cast<const std::byte *>(data), size});
+}
+
+/**
+ * Sequential reads from serialised data, running off the end throws.
+ */
+class Reader
+{
+  public:
+    Reader(DataBufferView data)
+        : data_{data}
+    {
+    }
+
+    auto read_bytes(void *destination, std::size_t size) -> void
+    {
+        ensure(size <= data_.size(), "binary data truncated, {} bytes needed with {} remaining", size, data_.size());
+
+        std::memcpy(destination, data_.data(), size);
+        data_ = data_.subspan(size);
+    }
+
+    auto remaining() const -> std::size_t
+    {
+        return data_.size();
+    }
+
+  private:
+    DataBufferView data_;
+};
+
+template <class T>
+auto write(DataBuffer &buffer, const T &obj) -> void;
+
+template <class T>
+auto read(Reader &reader) -> T;
+
+template <class R>
+auto write_range(DataBuffer &buffer, const R &range) -> void
+{
+    using ValueType = std::ranges::range_value_t<R>;
+
+    write(buffer, static_cast<std::uint64_t>(std::ranges::size(range)));
+
+    if constexpr (std::ranges::contiguous_range<R> && FixedLayout<ValueType>)
+    {
+        write_bytes(buffer, std::ranges::data(range), std::ranges::size(range) * sizeof(ValueType));
+    }
+    else
+    {
+        for (const auto &e : range)
+        {
+            write(buffer, e);
+        }
+    }
+}
+
+template <class T>
+auto write(DataBuffer &buffer, const T &obj) -> void
+{
+    if constexpr (FixedLayout<T>)
+    {
+        write_bytes(buffer, &obj, sizeof(T));
+    }
+    else if constexpr (std::same_as<T, bool>)
+    {
+        write(buffer, static_cast<std::uint8_t>(obj));
+    }
+    else if constexpr (Enum<T>)
+    {
+        write(buffer, std::to_underlying(obj));
+    }
+    else if constexpr (Bounded<T>)
+    {
+        write(buffer, *obj);
+    }
+    else if constexpr (std::same_as<T, std::string>)
+    {
+        write(buffer, static_cast<std::uint64_t>(obj.size()));
+        write_bytes(buffer, obj.data(), obj.size());
+    }
+    else if constexpr (std::same_as<T, Matrix4>)
+    {
+        write_bytes(buffer, obj.data().data(), obj.data().size_bytes());
+    }
+    else if constexpr (Map<T>)
+    {
+        write(buffer, static_cast<std::uint64_t>(std::ranges::size(obj)));
+
+        for (const auto &[k, v] : obj)
+        {
+            write(buffer, k);
+            write(buffer, v);
+        }
+    }
+    else if constexpr (Sparse<T>)
+    {
+        write_range(buffer, obj.data());
+    }
+    else if constexpr (Array<T>)
+    {
+        write_range(buffer, obj);
+    }
+    else if constexpr (Class<T>)
+    {
+        constexpr auto ctx = std::meta::access_context::current();
+        template for (constexpr auto e : std::define_static_array(std::meta::nonstatic_data_members_of(^^T, ctx)))
+        {
+            write(buffer, obj.[:e:]);
+        }
+    }
+    else
+    {
+        static_assert(false, "type cannot be serialised");
+    }
+}
+
+/**
+ * Read an element count, elements take at least a byte each unless they are empty so anything larger than the
+ * remaining data is corrupt and must not be used to reserve memory.
+ */
+template <class T>
+auto read_count(Reader &reader) -> std::size_t
+{
+    const auto count = read<std::uint64_t>(reader);
+
+    if constexpr (!std::is_empty_v<T>)
+    {
+        ensure(
+            count <= reader.remaining(),
+            "binary data has {} elements with {} bytes remaining",
+            count,
+            reader.remaining());
+    }
+
+    return static_cast<std::size_t>(count);
+}
+
+template <class T>
+auto read(Reader &reader) -> T
+{
+    if constexpr (FixedLayout<T>)
+    {
+        auto obj = T{};
+        reader.read_bytes(&obj, sizeof(T));
+        return obj;
+    }
+    else if constexpr (std::same_as<T, bool>)
+    {
+        const auto value = read<std::uint8_t>(reader);
+        ensure(value <= 1u, "invalid bool value: {}", value);
+        return value == 1u;
+    }
+    else if constexpr (Enum<T>)
+    {
+        const auto value = read<std::underlying_type_t<T>>(reader);
+
+        template for (constexpr auto e : std::define_static_array(std::meta::enumerators_of(^^T)))
+        {
+            if (value == std::to_underlying([:e:]))
+            {
+                return [:e:];
+            }
+        }
+
+        throw Exception("unknown enum value {} for {}", value, std::meta::identifier_of(^^T));
+    }
+    else if constexpr (Bounded<T>)
+    {
+        // construction checks the bounds
+        return T{read<typename T::type>(reader)};
+    }
+    else if constexpr (std::same_as<T, std::string>)
+    {
+        auto obj = std::string(read_count<char>(reader), '\0');
+        reader.read_bytes(obj.data(), obj.size());
+        return obj;
+    }
+    else if constexpr (std::same_as<T, Matrix4>)
+    {
+        auto values = std::array<float, 16u>{};
+        reader.read_bytes(values.data(), sizeof(values));
+        return Matrix4{values};
+    }
+    else if constexpr (Map<T>)
+    {
+        auto obj = T{};
+
+        const auto count = read_count<typename T::value_type>(reader);
+        for (auto i = 0zu; i < count; ++i)
+        {
+            auto key = read<typename T::key_type>(reader);
+            obj[std::move(key)] = read<typename T::mapped_type>(reader);
+        }
+
+        return obj;
+    }
+    else if constexpr (Sparse<T>)
+    {
+        auto obj = T{};
+
+        const auto count = read_count<typename T::value_type>(reader);
+        for (auto i = 0zu; i < count; ++i)
+        {
+            obj.emplace(read<typename T::value_type>(reader));
+        }
+
+        return obj;
+    }
+    else if constexpr (Array<T>)
+    {
+        using ValueType = std::ranges::range_value_t<T>;
+
+        auto obj = T{};
+        const auto count = read_count<ValueType>(reader);
+
+        if constexpr (requires { std::tuple_size<T>::value; })
+        {
+            ensure(
+                count == std::tuple_size_v<T>,
+                "binary data has {} elements for an array of {}",
+                count,
+                std::tuple_size_v<T>);
+
+            for (auto &e : obj)
+            {
+                e = read<ValueType>(reader);
+            }
+        }
+        else if constexpr (std::ranges::contiguous_range<T> && FixedLayout<ValueType>)
+        {
+            ensure(count * sizeof(ValueType) <= reader.remaining(), "binary data truncated");
+
+            obj.resize(count);
+            reader.read_bytes(std::ranges::data(obj), count * sizeof(ValueType));
+        }
+        else
+        {
+            obj.reserve(count);
+            for (auto i = 0zu; i < count; ++i)
+            {
+                obj.push_back(read<ValueType>(reader));
+            }
+        }
+
+        return obj;
+    }
+    else if constexpr (Class<T>)
+    {
+        auto obj = T{};
+
+        constexpr auto ctx = std::meta::access_context::current();
+        template for (constexpr auto e : std::define_static_array(std::meta::nonstatic_data_members_of(^^T, ctx)))
+        {
+            obj.[:e:] = read<typename[:std::meta::type_of(e):]>(reader);
+        }
+
+        return obj;
+    }
+    else
+    {
+        static_assert(false, "type cannot be serialised");
+    }
+}
+
+}
+
+/**
+ * Hash of the layout of a type, stored in the header of everything serialised from it.
+ */
+template <impl::Class T>
+consteval auto schema() -> std::uint64_t
+{
+    return impl::schema_hash<T>();
+}
+
+/**
+ * Serialise an object to a compact little endian form, the binary equivalent of yaml::serialise. Much faster to read
+ * and write but only readable by a build with the same schema for the type.
+ */
+template <impl::Class T>
+auto serialise(const T &obj) -> std::expected<DataBuffer, std::string>
+{
+    try
+    {
+        auto buffer = DataBuffer{};
+        impl::write(buffer, Header{.magic = format_magic, .version = format_version, .schema = schema<T>()});
+        impl::write(buffer, obj);
+
+        return buffer;
+    }
+    catch (const std::exception &e)
+    {
+        return std::unexpected(std::format("{}", e.what()));
+    }
+    catch (...)
+    {
+        return std::unexpected<std::string>("unknown exception");
+    }
+}
+
+template <impl::Class T>
+auto deserialise(DataBufferView data) -> std::expected<T, std::string>
+{
+    try
+    {
+        auto reader = impl::Reader{data};
+
+        const auto header = impl::read<Header>(reader);
+        ensure(header.magic == format_magic, "not binary serialised data");
+        ensure(header.version == format_version, "unsupported binary format version: {}", header.version);
+        ensure(header.schema == schema<T>(), "binary data was written with a different schema");
+
+        auto obj = impl::read<T>(reader);
+        ensure(reader.remaining() == 0zu, "{} bytes of binary data left over", reader.remaining());
+
+        return obj;
+    }
+    catch (const std::exception &e)
+    {
+        return std::unexpected(std::format("{}", e.what()));
+    }
+    catch (...)
+    {
+        return std::unexpected<std::string>("unknown exception");
+    }
+}
+
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <concepts>
+#include <ranges>
+#include <string>
+#include <type_traits>
+
+namespace ufps::serialisation
+{
+
+template <class T>
+concept Bounded = requires {
+    typename T::type;
+    T::min;
+    T::max;
+};
+
+/**
+ * Anything which isn't a container or a bounded number is walked member by member with reflection.
+ */
+template <class T>
+concept Class = !std::ranges::range<T> && std::is_class_v<T> && !(requires { typename T::handle_type; }) && !Bounded<T>;
+
+template <class T>
+concept BaseType = std::integral<T> || std::floating_point<T> || std::same_as<T, std::string>;
+
+template <class T>
+concept Map = std::ranges::range<T> && requires {
+    typename T::key_type;
+    typename T::mapped_type;
+};
+
+template <class T>
+concept Array = std::ranges::range<T> && !Map<T> && !std::same_as<T, std::string>;
+
+template <class T>
+concept Sparse = requires { typename T::handle_type; };
+
+template <class T>
+concept Enum = std::is_enum_v<T>;
+
+}
@@ -0,0 +1,180 @@
+#include "serialisation/yaml_events.h"
+
+#include <cstdint>
+#include <spanstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <yaml-cpp/eventhandler.h>
+#include <yaml-cpp/yaml.h>
+
+#include "utils/error.h"
+
+namespace
+{
+
+/**
+ * Appends events to the tape as the parser emits them, container starts are patched with their end once it is seen.
+ */
+class Recorder : public ::YAML::EventHandler
+{
+  public:
+    Recorder(std::vector<ufps::yaml::Event> &events, std::string &values, bool &has_aliases)
+        : events_(events)
+        , values_(values)
+        , has_aliases_(has_aliases)
+        , open_{}
+    {
+    }
+
+    auto OnDocumentStart(const ::YAML::Mark &) -> void override
+    {
+    }
+
+    auto OnDocumentEnd() -> void override
+    {
+    }
+
+    auto OnNull(const ::YAML::Mark &, ::YAML::anchor_t) -> void override
+    {
+        push(ufps::yaml::EventType::NULL_VALUE);
+    }
+
+    auto OnAlias(const ::YAML::Mark &, ::YAML::anchor_t) -> void override
+    {
+        // record something so the structure stays intact, the caller is expected to fall back to a node tree
+        has_aliases_ = true;
+        push(ufps::yaml::EventType::NULL_VALUE);
+    }
+
+    auto OnScalar(const ::YAML::Mark &, const std::string &, ::YAML::anchor_t, const std::string &value)
+        -> void override
+    {
+        const auto offset = static_cast<std::uint32_t>(values_.size());
+        values_.append(value);
+
+        push(ufps::yaml::EventType::SCALAR);
+        events_.back().offset = offset;
+        events_.back().size = static_cast<std::uint32_t>(value.size());
+    }
+
+    auto OnSequenceStart(const ::YAML::Mark &, const std::string &, ::YAML::anchor_t, ::YAML::EmitterStyle::value)
+        -> void override
+    {
+        open_.push_back(static_cast<std::uint32_t>(events_.size()));
+        push(ufps::yaml::EventType::SEQUENCE_START);
+    }
+
+    auto OnSequenceEnd() -> void override
+    {
+        close(ufps::yaml::EventType::SEQUENCE_END);
+    }
+
+    auto OnMapStart(const ::YAML::Mark &, const std::string &, ::YAML::anchor_t, ::YAML::EmitterStyle::value)
+        -> void override
+    {
+        open_.push_back(static_cast<std::uint32_t>(events_.size()));
+        push(ufps::yaml::EventType::MAP_START);
+    }
+
+    auto OnMapEnd() -> void override
+    {
+        close(ufps::yaml::EventType::MAP_END);
+    }
+
+  private:
+    auto push(ufps::yaml::EventType type) -> void
+    {
+        const auto index = static_cast<std::uint32_t>(events_.size());
+        events_.push_back({.type = type, .next = index + 1u, .offset = 0u, .size = 0u});
+    }
+
+    auto close(ufps::yaml::EventType type) -> void
+    {
+        ufps::expect(!open_.empty(), "unbalanced yaml events");
+
+        push(type);
+        events_[open_.back()].next = static_cast<std::uint32_t>(events_.size());
+        open_.pop_back();
+    }
+
+    std::vector<ufps::yaml::Event> &events_;
+    std::string &values_;
+    bool &has_aliases_;
+    std::vector<std::uint32_t> open_;
+};
+
+}
+
+namespace ufps::yaml
+{
+
+EventTape::EventTape(std::string_view yaml)
+    : events_{}
+    , values_{}
+    , has_aliases_{false}
+{
+    auto strm = std::ispanstream{yaml};
+    auto parser = ::YAML::Parser{strm};
+    auto recorder = Recorder{events_, values_, has_aliases_};
+
+    parser.HandleNextDocument(recorder);
+}
+
+auto EventTape::root() const -> std::uint32_t
+{
+    return events_.empty() ? npos : 0u;
+}
+
+auto EventTape::type(std::uint32_t index) const -> EventType
+{
+    return index == npos ? EventType::MISSING : events_[index].type;
+}
+
+auto EventTape::value(std::uint32_t index) const -> std::string_view
+{
+    const auto &event = events_[index];
+    return std::string_view{values_}.substr(event.offset, event.size);
+}
+
+auto EventTape::next(std::uint32_t index) const -> std::uint32_t
+{
+    return events_[index].next;
+}
+
+auto EventTape::find(std::uint32_t index, std::string_view key) const -> std::uint32_t
+{
+    if (type(index) != EventType::MAP_START)
+    {
+        return npos;
+    }
+
+    for (auto entry = index + 1u; events_[entry].type != EventType::MAP_END;)
+    {
+        const auto value_index = events_[entry].next;
+
+        const auto matches = (events_[entry].type == EventType::SCALAR && value(entry) == key) ||
+                             (events_[entry].type == EventType::NULL_VALUE && key == "null");
+        if (matches)
+        {
+            return value_index;
+        }
+
+        entry = events_[value_index].next;
+    }
+
+    return npos;
+}
+
+auto EventTape::has_aliases() const -> bool
+{
+    return has_aliases_;
+}
+
+auto EventTape::size() const -> std::uint32_t
+{
+    return static_cast<std::uint32_t>(events_.size());
+}
+
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ufps::yaml
+{
+
+enum class EventType : std::uint8_t
+{
+    MISSING,
+    SCALAR,
+    NULL_VALUE,
+    SEQUENCE_START,
+    SEQUENCE_END,
+    MAP_START,
+    MAP_END,
+};
+
+/**
+ * For scalars offset and size locate the value in the tape, for all events next is the index of the event after it
+ * and any children.
+ */
+struct Event
+{
+    EventType type;
+    std::uint32_t next;
+    std::uint32_t offset;
+    std::uint32_t size;
+};
+
+/**
+ * Flat record of the parser events for the first document in some yaml, a much cheaper alternative to building a
+ * YAML::Node tree. Values are walked by index with subtrees skipped in constant time. Aliases are not resolved, so
+ * callers should fall back to a node tree if has_aliases() is true. Throws YAML::Exception for invalid yaml.
+ */
+class EventTape
+{
+  public:
+    static constexpr auto npos = std::numeric_limits<std::uint32_t>::max();
+
+    EventTape(std::string_view yaml);
+
+    /**
+     * Index of the document's root value, or npos for an empty document.
+     */
+    auto root() const -> std::uint32_t;
+
+    /**
+     * Type of the event at index, npos is MISSING.
+     */
+    auto type(std::uint32_t index) const -> EventType;
+
+    auto value(std::uint32_t index) const -> std::string_view;
+
+    auto next(std::uint32_t index) const -> std::uint32_t;
+
+    /**
+     * Index of the value for the first matching key in the map at index, or npos if index is not a map or the key is
+     * not in it. Keys are matched as YAML::Node does, so a null key is "null".
+     */
+    auto find(std::uint32_t index, std::string_view key) const -> std::uint32_t;
+
+    auto has_aliases() const -> bool;
+
+    auto size() const -> std::uint32_t;
+
+  private:
+    std::vector<Event> events_;
+    std::string values_;
+    bool has_aliases_;
+};
+
+}
@@ -1,7 +1,10 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <charconv>
 #include <concepts>
+#include <cstdint>
 #include <exception>
 #include <expected>
 #include <meta>
@@ -9,12 +12,15 @@
 #include <sstream>
 #include <string>
 #include <string_view>
+#include <system_error>
 #include <type_traits>
 
 #include <yaml-cpp/yaml.h>
 
 #include "maths/bounded_number.h"
 #include "maths/matrix4.h"
+#include "serialisation/concepts.h"
+#include "serialisation/yaml_events.h"
 #include "utils/exception.h"
 #include "utils/formatter.h"
 
@@ -24,39 +30,21 @@ namespace ufps::yaml
 namespace impl
 {
 
-template <class T>
-concept Bounded = requires {
-    typename T::type;
-    T::min;
-    T::max;
-};
-
-template <class T>
-concept Class = !std::ranges::range<T> && std::is_class_v<T> && !(requires { typename T::handle_type; }) && !Bounded<T>;
-
-template <class T>
-concept BaseType = std::integral<T> || std::floating_point<T> || std::same_as<T, std::string>;
-
-template <class T>
-concept Map = std::ranges::range<T> && requires {
-    typename T::key_type;
-    typename T::mapped_type;
-};
-
-template <class T>
-concept Array = std::ranges::range<T> && !Map<T> && !std::same_as<T, std::string>;
-
-template <class T>
-concept Sparse = requires { typename T::handle_type; };
-
-template <class T>
-concept Enum = std::is_enum_v<T>;
+using serialisation::Array;
+using serialisation::BaseType;
+using serialisation::Bounded;
+using serialisation::Class;
+using serialisation::Enum;
+using serialisation::Map;
+using serialisation::Sparse;
 
 template <Class T>
 auto do_serialise(const T &obj) -> std::expected<::YAML::Node, std::string>;
 auto do_serialise(const Map auto &obj) -> std::expected<::YAML::Node, std::string>;
 template <Class T>
 auto do_deserialise(const ::YAML::Node &node) -> std::expected<T, std::string>;
+template <Class T>
+auto do_stream_deserialise(const EventTape &tape, std::uint32_t index) -> std::expected<T, std::string>;
 
 auto do_serialise(const BaseType auto &obj) -> std::expected<::YAML::Node, std::string>
 {
@@ -311,6 +299,290 @@ auto do_deserialise(const ::YAML::Node &node) -> std::expected<T, std::string>
     return obj;
 }
 
+/**
+ * Plain decimal integers without a leading zero, which yaml-cpp would read as octal, are all from_chars handles
+ * identically to yaml-cpp's stream based conversion.
+ */
+inline auto is_plain_integer(std::string_view value) -> bool
+{
+    if (value.starts_with('-'))
+    {
+        value.remove_prefix(1zu);
+    }
+
+    return !value.empty() && (value == "0" || value.front() != '0') &&
+           std::ranges::all_of(value, [](auto c) { return c >= '0' && c <= '9'; });
+}
+
+inline auto is_plain_float(std::string_view value) -> bool
+{
+    return !value.empty() && value.find_first_not_of("0123456789+-.eE") == std::string_view::npos;
+}
+
+/**
+ * Convert a scalar exactly as YAML::Node::as would. Common cases are parsed in place, anything else (hex, octal,
+ * infinities, yes/no booleans etc) goes through a temporary node so the results never differ.
+ */
+template <class T>
+auto convert_scalar(std::string_view value) -> T
+{
+    if constexpr (std::same_as<T, std::string>)
+    {
+        return std::string{value};
+    }
+    else if constexpr (std::same_as<T, bool>)
+    {
+        if (value == "true" || value == "false")
+        {
+            return value == "true";
+        }
+    }
+    else if constexpr ((std::integral<T> && sizeof(T) > 1zu) || std::floating_point<T>)
+    {
+        const auto is_plain = std::integral<T> ? is_plain_integer(value) : is_plain_float(value);
+        if (is_plain)
+        {
+            auto result = T{};
+            const auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), result);
+            if (ec == std::errc{} && ptr == value.data() + value.size())
+            {
+                return result;
+            }
+        }
+    }
+
+    return ::YAML::Node{std::string{value}}.as<T>();
+}
+
+template <class T>
+auto stream_scalar(const EventTape &tape, std::uint32_t index) -> std::expected<T, std::string>
+{
+    switch (tape.type(index))
+    {
+        using enum EventType;
+        case SCALAR: return convert_scalar<T>(tape.value(index));
+        case NULL_VALUE: return ::YAML::Node{::YAML::NodeType::Null}.as<T>();
+        case MISSING: return std::unexpected<std::string>("missing value");
+        default: return std::unexpected(std::format("expected a scalar at event {}", index));
+    }
+}
+
+/**
+ * Missing, null and scalar values are treated as empty containers, as iterating such a YAML::Node yields nothing.
+ */
+inline auto stream_container(const EventTape &tape, std::uint32_t index, EventType expected)
+    -> std::expected<bool, std::string>
+{
+    const auto type = tape.type(index);
+    if (type == expected)
+    {
+        return true;
+    }
+
+    if (type == EventType::SEQUENCE_START || type == EventType::MAP_START)
+    {
+        return std::unexpected(std::format("unexpected container at event {}", index));
+    }
+
+    return false;
+}
+
+template <BaseType T>
+auto do_stream_deserialise(const EventTape &tape, std::uint32_t index) -> std::expected<T, std::string>
+{
+    return stream_scalar<T>(tape, index);
+}
+
+template <Bounded T>
+auto do_stream_deserialise(const EventTape &tape, std::uint32_t index) -> std::expected<typename T::type, std::string>
+{
+    return stream_scalar<typename T::type>(tape, index);
+}
+
+template <Enum T>
+auto do_stream_deserialise(const EventTape &tape, std::uint32_t index) -> std::expected<T, std::string>
+{
+    const auto enum_value = stream_scalar<std::string>(tape, index);
+    if (!enum_value)
+    {
+        return std::unexpected(enum_value.error());
+    }
+
+    template for (constexpr auto e : std::define_static_array(std::meta::enumerators_of(^^T)))
+    {
+        if (std::meta::identifier_of(e) == *enum_value)
+        {
+            return [:e:];
+        }
+    }
+
+    return std::unexpected(std::format("unknown enum value {} for {}", *enum_value, std::meta::identifier_of(^^T)));
+}
+
+template <Array T>
+auto do_stream_deserialise(const EventTape &tape, std::uint32_t index) -> std::expected<T, std::string>
+{
+    auto obj = T{};
+
+    const auto has_elements = stream_container(tape, index, EventType::SEQUENCE_START);
+    if (!has_elements)
+    {
+        return std::unexpected(has_elements.error());
+    }
+
+    if (!*has_elements)
+    {
+        return obj;
+    }
+
+    for (auto element = index + 1u; tape.type(element) != EventType::SEQUENCE_END; element = tape.next(element))
+    {
+        auto inner_element = do_stream_deserialise<std::ranges::range_value_t<T>>(tape, element);
+        if (!inner_element)
+        {
+            return std::unexpected(inner_element.error());
+        }
+
+        obj.push_back(std::move(*inner_element));
+    }
+
+    return obj;
+}
+
+template <Map T>
+auto do_stream_deserialise(const EventTape &tape, std::uint32_t index) -> std::expected<T, std::string>
+{
+    auto obj = T{};
+
+    const auto has_elements = stream_container(tape, index, EventType::MAP_START);
+    if (!has_elements)
+    {
+        return std::unexpected(has_elements.error());
+    }
+
+    if (!*has_elements)
+    {
+        return obj;
+    }
+
+    for (auto key = index + 1u; tape.type(key) != EventType::MAP_END;)
+    {
+        const auto value = tape.next(key);
+
+        auto deserialised_key = do_stream_deserialise<typename T::key_type>(tape, key);
+        if (!deserialised_key)
+        {
+            return std::unexpected(deserialised_key.error());
+        }
+
+        auto deserialised_value = do_stream_deserialise<typename T::mapped_type>(tape, value);
+        if (!deserialised_value)
+        {
+            return std::unexpected(deserialised_value.error());
+        }
+
+        obj[std::move(*deserialised_key)] = std::move(*deserialised_value);
+        key = tape.next(value);
+    }
+
+    return obj;
+}
+
+template <Sparse T>
+auto do_stream_deserialise(const EventTape &tape, std::uint32_t index) -> std::expected<T, std::string>
+{
+    auto obj = T{};
+
+    const auto has_elements = stream_container(tape, index, EventType::SEQUENCE_START);
+    if (!has_elements)
+    {
+        return std::unexpected(has_elements.error());
+    }
+
+    if (!*has_elements)
+    {
+        return obj;
+    }
+
+    for (auto element = index + 1u; tape.type(element) != EventType::SEQUENCE_END; element = tape.next(element))
+    {
+        auto inner_element = do_stream_deserialise<typename T::value_type>(tape, element);
+        if (!inner_element)
+        {
+            return std::unexpected(inner_element.error());
+        }
+
+        obj.emplace(std::move(*inner_element));
+    }
+
+    return obj;
+}
+
+template <>
+inline auto do_stream_deserialise(const EventTape &tape, std::uint32_t index) -> std::expected<Matrix4, std::string>
+{
+    auto values = std::array<float, 16u>{};
+    auto *iter = std::begin(values);
+
+    const auto has_elements = stream_container(tape, index, EventType::SEQUENCE_START);
+    if (!has_elements)
+    {
+        return std::unexpected(has_elements.error());
+    }
+
+    for (auto element = index + 1u; *has_elements && tape.type(element) != EventType::SEQUENCE_END;
+         element = tape.next(element))
+    {
+        if (iter == std::ranges::end(values))
+        {
+            return std::unexpected{"too many values in matrix"};
+        }
+
+        const auto value = stream_scalar<float>(tape, element);
+        if (!value)
+        {
+            return std::unexpected(value.error());
+        }
+
+        *iter = *value;
+        ++iter;
+    }
+
+    if (iter != std::ranges::end(values))
+    {
+        return std::unexpected{"too few values in matrix"};
+    }
+
+    return Matrix4{values};
+}
+
+/**
+ * Members are looked up by name like the node tree so they can be in any order and unknown keys are ignored.
+ */
+template <Class T>
+auto do_stream_deserialise(const EventTape &tape, std::uint32_t index) -> std::expected<T, std::string>
+{
+    auto obj = T{};
+
+    const auto inner_index = tape.find(index, std::meta::identifier_of(^^T));
+
+    constexpr auto ctx = std::meta::access_context::current();
+    template for (constexpr auto e : std::define_static_array(std::meta::nonstatic_data_members_of(^^T, ctx)))
+    {
+        using ElementType = typename[:std::meta::type_of(e):];
+        auto inner_element =
+            do_stream_deserialise<ElementType>(tape, tape.find(inner_index, std::meta::identifier_of(e)));
+        if (!inner_element)
+        {
+            return std::unexpected(inner_element.error());
+        }
+
+        obj.[:e:] = std::move(*inner_element);
+    }
+
+    return obj;
+}
+
 }
 
 auto serialise(const impl::Class auto &obj) -> std::expected<std::string, std::string>
@@ -339,8 +611,12 @@ auto serialise(const impl::Class auto &obj) -> std::expected<std::string, std::s
     }
 }
 
+/**
+ * Deserialise by building a YAML::Node tree, this handles everything yaml-cpp does but is slow and memory hungry for
+ * large documents.
+ */
 template <impl::Class T>
-auto deserialise(const std::string &yaml) -> std::expected<T, std::string>
+auto deserialise_tree(const std::string &yaml) -> std::expected<T, std::string>
 {
     try
     {
@@ -361,4 +637,35 @@ auto deserialise(const std::string &yaml) -> std::expected<T, std::string>
     }
 }
 
+/**
+ * Deserialise from a flat tape of parser events, giving the same result as deserialise_tree without building a node
+ * for every value. Documents with aliases fall back to the node tree.
+ */
+template <impl::Class T>
+auto deserialise(const std::string &yaml) -> std::expected<T, std::string>
+{
+    try
+    {
+        const auto tape = EventTape{yaml};
+        if (tape.has_aliases())
+        {
+            return deserialise_tree<T>(yaml);
+        }
+
+        return impl::do_stream_deserialise<T>(tape, tape.root());
+    }
+    catch (const ::YAML::Exception &e)
+    {
+        return std::unexpected(std::format("{} [{} {} {}]", e.msg, e.mark.pos, e.mark.line, e.mark.column));
+    }
+    catch (const std::exception &e)
+    {
+        return std::unexpected(std::format("{}", e.what()));
+    }
+    catch (...)
+    {
+        return std::unexpected<std::string>("unknown exception");
+    }
+}
+
 }
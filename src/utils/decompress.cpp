@@ -1,5 +1,8 @@
 #include "utils/decompress.h"
 
+#include <cstddef>
+#include <span>
+
 #include <zstd.h>
 
 #include "utils/data_buffer.h"
@@ -16,16 +19,22 @@ auto decompress(DataBufferView data) -> DataBuffer
     expect(decompressed_buffer_size != ZSTD_CONTENTSIZE_UNKNOWN, "cannot get original size");
 
     auto decompressed_buffer = DataBuffer(decompressed_buffer_size);
+    decompress(data, decompressed_buffer);
+
+    return decompressed_buffer;
+}
 
+auto decompress(DataBufferView data, std::span<std::byte> destination) -> std::size_t
+{
     const auto decompressed_size =
-        ::ZSTD_decompress(decompressed_buffer.data(), decompressed_buffer.size(), data.data(), data.size_bytes());
+        ::ZSTD_decompress(destination.data(), destination.size(), data.data(), data.size_bytes());
 
     if (::ZSTD_isError(decompressed_size) == 1)
     {
         throw Exception("failed to compress data: {}", ::ZSTD_getErrorName(decompressed_size));
     }
 
-    return decompressed_buffer;
+    return decompressed_size;
 }
 
 }
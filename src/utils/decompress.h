@@ -1,5 +1,8 @@
 #pragma once
 
+#include <cstddef>
+#include <span>
+
 #include "utils/data_buffer.h"
 
 namespace ufps
@@ -7,4 +10,9 @@ namespace ufps
 
 auto decompress(DataBufferView data) -> DataBuffer;
 
+/**
+ * Decompress into memory owned by the caller, such as a mapped buffer, returns the number of bytes written.
+ */
+auto decompress(DataBufferView data, std::span<std::byte> destination) -> std::size_t;
+
 }
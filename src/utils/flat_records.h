@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+#include "utils/data_buffer.h"
+#include "utils/error.h"
+
+/**
+ * Helpers for formats made of a header followed by arrays of fixed size records which are read in place, such as the
+ * binary manifest and scene snapshots. Format is the name of the format used in errors.
+ */
+namespace ufps::flat_records
+{
+
+template <class T>
+auto append(DataBuffer &buffer, std::span<const T> objs) -> void
+{
+    buffer.append_range(std::as_bytes(objs));
+}
+
+/**
+ * View a section of the data as records, checking it is in bounds. Sections follow one another so the offset is
+ * advanced past this one.
+ */
+template <class T>
+auto section(std::string_view format, DataBufferView data, std::size_t &offset, std::size_t count) -> std::span<const T>
+{
+    ensure(offset + (count * sizeof(T)) <= data.size(), "{} truncated at offset {}", format, offset);
+
+    const auto records = std::span<const T>{reinterpret_cast<const T *>(data.data() + offset), count};
+    offset += count * sizeof(T);
+
+    return records;
+}
+
+/**
+ * Check a range one record refers to, by index, is inside another section.
+ */
+inline auto check_range(
+    std::string_view format,
+    std::uint32_t first,
+    std::uint32_t count,
+    std::size_t size,
+    std::string_view what) -> void
+{
+    ensure(
+        static_cast<std::size_t>(first) + count <= size,
+        "{} {} range [{}, {}) is outside {} records",
+        format,
+        what,
+        first,
+        static_cast<std::size_t>(first) + count,
+        size);
+}
+
+}
@@ -0,0 +1,130 @@
+#include "utils/range_allocator.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <ranges>
+
+#include "utils/error.h"
+
+namespace ufps
+{
+
+RangeAllocator::RangeAllocator(std::uint32_t capacity)
+    : free_{}
+    , capacity_{capacity}
+    , used_{}
+{
+    if (capacity_ != 0u)
+    {
+        free_.emplace(0u, capacity_);
+    }
+}
+
+auto RangeAllocator::allocate(std::uint32_t count) -> std::optional<std::uint32_t>
+{
+    expect(count != 0u, "cannot allocate an empty range");
+
+    const auto iter = std::ranges::find_if(free_, [count](const auto &range) { return range.second >= count; });
+    if (iter == std::ranges::end(free_))
+    {
+        return std::nullopt;
+    }
+
+    const auto [offset, free_count] = *iter;
+    free_.erase(iter);
+
+    if (free_count > count)
+    {
+        free_.emplace(offset + count, free_count - count);
+    }
+
+    used_ += count;
+
+    return offset;
+}
+
+auto RangeAllocator::free(std::uint32_t offset, std::uint32_t count) -> void
+{
+    expect(count != 0u, "cannot free an empty range");
+    expect(offset + count <= capacity_, "range outside of allocator");
+
+    auto next = free_.lower_bound(offset);
+    expect((next == std::ranges::end(free_)) || (offset + count <= next->first), "range overlaps a free range");
+
+    auto start = offset;
+    auto end = offset + count;
+
+    if (next != std::ranges::begin(free_))
+    {
+        const auto previous = std::ranges::prev(next);
+        expect(previous->first + previous->second <= offset, "range overlaps a free range");
+
+        if (previous->first + previous->second == offset)
+        {
+            start = previous->first;
+            free_.erase(previous);
+        }
+    }
+
+    if ((next != std::ranges::end(free_)) && (next->first == end))
+    {
+        end += next->second;
+        free_.erase(next);
+    }
+
+    free_.emplace(start, end - start);
+    used_ -= count;
+}
+
+auto RangeAllocator::grow(std::uint32_t capacity) -> void
+{
+    expect(capacity >= capacity_, "allocator cannot shrink");
+
+    if (capacity == capacity_)
+    {
+        return;
+    }
+
+    const auto old_capacity = capacity_;
+    capacity_ = capacity;
+
+    // reuse free so the new space merges with any trailing gap
+    used_ += capacity - old_capacity;
+    free(old_capacity, capacity - old_capacity);
+}
+
+auto RangeAllocator::capacity() const -> std::uint32_t
+{
+    return capacity_;
+}
+
+auto RangeAllocator::used() const -> std::uint32_t
+{
+    return used_;
+}
+
+auto RangeAllocator::largest_free() const -> std::uint32_t
+{
+    return std::ranges::fold_left(
+        free_ | std::views::values, 0u, [](auto largest, auto count) { return std::max(largest, count); });
+}
+
+auto RangeAllocator::free_range_count() const -> std::size_t
+{
+    return free_.size();
+}
+
+auto RangeAllocator::is_packed() const -> bool
+{
+    if (free_.empty())
+    {
+        return true;
+    }
+
+    const auto &[offset, count] = *std::ranges::begin(free_);
+    return (free_.size() == 1zu) && (offset + count == capacity_);
+}
+
+}
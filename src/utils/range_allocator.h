@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <optional>
+
+namespace ufps
+{
+
+/**
+ * Offset allocator over an abstract range of [0, capacity) elements. Allocation is first fit so live ranges are packed
+ * towards the start, freed ranges are merged with their neighbours.
+ */
+class RangeAllocator
+{
+  public:
+    RangeAllocator(std::uint32_t capacity);
+
+    /**
+     * Allocate count contiguous elements, returns the offset or an empty optional if there is no large enough gap.
+     */
+    auto allocate(std::uint32_t count) -> std::optional<std::uint32_t>;
+
+    auto free(std::uint32_t offset, std::uint32_t count) -> void;
+
+    /**
+     * Extend the range, existing allocations are unaffected.
+     */
+    auto grow(std::uint32_t capacity) -> void;
+
+    auto capacity() const -> std::uint32_t;
+
+    auto used() const -> std::uint32_t;
+
+    auto largest_free() const -> std::uint32_t;
+
+    /**
+     * Number of separate free gaps, one (or zero if full) means there is no fragmentation.
+     */
+    auto free_range_count() const -> std::size_t;
+
+    /**
+     * True if nothing is allocated after a free gap, i.e. compacting has nothing to move.
+     */
+    auto is_packed() const -> bool;
+
+  private:
+    /** Free ranges as offset -> count. */
+    std::map<std::uint32_t, std::uint32_t> free_;
+    std::uint32_t capacity_;
+    std::uint32_t used_;
+};
+
+}
@@ -0,0 +1,87 @@
+#include "utils/shared_buffer_view.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+#include "utils/data_buffer.h"
+#include "utils/error.h"
+
+namespace ufps
+{
+
+SharedBufferView::SharedBufferView(DataBuffer &&data)
+    : owner_{}
+    , view_{}
+{
+    auto owner = std::make_shared<const DataBuffer>(std::move(data));
+    view_ = *owner;
+    owner_ = std::move(owner);
+}
+
+SharedBufferView::SharedBufferView(DataBufferView data)
+    : owner_{}
+    , view_{data}
+{
+}
+
+SharedBufferView::SharedBufferView(std::shared_ptr<const void> owner, DataBufferView data)
+    : owner_{std::move(owner)}
+    , view_{data}
+{
+}
+
+auto SharedBufferView::subspan(std::size_t offset, std::size_t size) const -> SharedBufferView
+{
+    ensure(
+        offset + size <= view_.size(),
+        "sub view [{}, {}) is outside a view of {} bytes",
+        offset,
+        offset + size,
+        view_.size());
+
+    return {owner_, view_.subspan(offset, size)};
+}
+
+auto SharedBufferView::view() const -> DataBufferView
+{
+    return view_;
+}
+
+auto SharedBufferView::data() const -> const std::byte *
+{
+    return view_.data();
+}
+
+auto SharedBufferView::size() const -> std::size_t
+{
+    return view_.size();
+}
+
+auto SharedBufferView::empty() const -> bool
+{
+    return view_.empty();
+}
+
+auto SharedBufferView::begin() const -> const std::byte *
+{
+    return view_.data();
+}
+
+auto SharedBufferView::end() const -> const std::byte *
+{
+    return view_.data() + view_.size();
+}
+
+auto SharedBufferView::operator[](std::size_t index) const -> const std::byte &
+{
+    return view_[index];
+}
+
+auto SharedBufferView::operator==(const SharedBufferView &other) const -> bool
+{
+    return std::ranges::equal(view_, other.view_);
+}
+
+}
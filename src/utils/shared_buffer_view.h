@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+#include "utils/data_buffer.h"
+
+namespace ufps
+{
+
+/**
+ * A view of bytes which can share ownership of the memory it views, so data can be handed around without being copied
+ * and without the view outliving what it points into. Views made from a DataBufferView own nothing and the caller
+ * must keep the memory alive, copies and sub views share the same memory.
+ */
+class SharedBufferView
+{
+  public:
+    /**
+     * Take ownership of a buffer and view all of it, the buffer is moved not copied.
+     */
+    SharedBufferView(DataBuffer &&data);
+
+    /**
+     * View memory owned by the caller.
+     */
+    SharedBufferView(DataBufferView data);
+
+    /**
+     * View memory kept alive by owner, which is released when the last view of it is destroyed.
+     */
+    SharedBufferView(std::shared_ptr<const void> owner, DataBufferView data);
+
+    auto subspan(std::size_t offset, std::size_t size) const -> SharedBufferView;
+
+    auto view() const -> DataBufferView;
+
+    auto data() const -> const std::byte *;
+    auto size() const -> std::size_t;
+    auto empty() const -> bool;
+
+    auto begin() const -> const std::byte *;
+    auto end() const -> const std::byte *;
+
+    auto operator[](std::size_t index) const -> const std::byte &;
+
+    /**
+     * Views are equal if they view equal bytes, wherever they are.
+     */
+    auto operator==(const SharedBufferView &other) const -> bool;
+
+  private:
+    std::shared_ptr<const void> owner_;
+    DataBufferView view_;
+};
+
+}
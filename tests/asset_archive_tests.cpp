@@ -0,0 +1,97 @@
+#include <algorithm>
+#include <cstddef>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "resources/asset_archive.h"
+#include "utils/data_buffer.h"
+#include "utils/error.h"
+
+namespace
+{
+
+auto bytes(std::string_view str) -> ufps::DataBuffer
+{
+    return std::as_bytes(std::span{str}) | std::ranges::to<ufps::DataBuffer>();
+}
+
+}
+
+TEST(asset_archive, round_trip)
+{
+    const auto repeated = ufps::DataBuffer(4096zu, std::byte{0x2a});
+
+    auto writer = ufps::AssetArchiveWriter{};
+    writer.add("textures\\a.dds", bytes("hello"));
+    writer.add("textures\\b.dds", repeated);
+    writer.add("empty", {});
+
+    ASSERT_EQ(writer.size(), repeated.size() + 5zu);
+    ASSERT_LT(writer.compressed_size(), writer.size());
+
+    const auto data = writer.data();
+    const auto archive = ufps::AssetArchive{data};
+
+    auto names = archive.names();
+    std::ranges::sort(names);
+    ASSERT_EQ(names, (std::vector<std::string>{"empty", "textures\\a.dds", "textures\\b.dds"}));
+
+    ASSERT_EQ(archive.size("textures\\b.dds"), repeated.size());
+    ASSERT_EQ(archive.load("textures\\a.dds"), bytes("hello"));
+    ASSERT_EQ(archive.load("textures\\b.dds"), repeated);
+    ASSERT_TRUE(archive.load("empty").empty());
+}
+
+TEST(asset_archive, missing_asset)
+{
+    auto writer = ufps::AssetArchiveWriter{};
+    writer.add("a", bytes("hello"));
+
+    const auto data = writer.data();
+    const auto archive = ufps::AssetArchive{data};
+
+    ASSERT_TRUE(archive.contains("a"));
+    ASSERT_FALSE(archive.contains("b"));
+    ASSERT_THROW(archive.load("b"), ufps::Exception);
+}
+
+TEST(asset_archive, invalid_archive)
+{
+    ASSERT_THROW(ufps::AssetArchive{bytes("not an archive")}, ufps::Exception);
+    ASSERT_THROW(ufps::AssetArchive{ufps::DataBuffer{}}, ufps::Exception);
+
+    auto writer = ufps::AssetArchiveWriter{};
+    writer.add("a", bytes("hello"));
+
+    auto data = writer.data();
+    data.resize(data.size() - 1zu);
+
+    ASSERT_THROW(ufps::AssetArchive{data}, ufps::Exception);
+}
+
+TEST(asset_archive, load_into)
+{
+    const auto repeated = ufps::DataBuffer(4096zu, std::byte{0x2a});
+
+    auto writer = ufps::AssetArchiveWriter{};
+    writer.add("a", repeated);
+
+    const auto data = writer.data();
+    const auto archive = ufps::AssetArchive{data};
+
+    // only the asset's bytes are written, the rest of the destination is untouched
+    auto destination = ufps::DataBuffer(repeated.size() + 16zu, std::byte{0x01});
+    archive.load_into("a", destination);
+
+    ASSERT_TRUE(std::ranges::equal(std::span{destination}.first(repeated.size()), repeated));
+    ASSERT_TRUE(std::ranges::all_of(
+        std::span{destination}.subspan(repeated.size()), [](auto b) { return b == std::byte{0x01}; }));
+
+    auto too_small = ufps::DataBuffer(repeated.size() - 1zu);
+    ASSERT_THROW(archive.load_into("a", too_small), ufps::Exception);
+}
@@ -0,0 +1,156 @@
+#include <cstddef>
+#include <cstdint>
+#include <ranges>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "core/manifest_descriptions.h"
+#include "graphics/mesh_lod.h"
+#include "graphics/mesh_view.h"
+#include "resources/binary_manifest.h"
+#include "utils/data_buffer.h"
+#include "utils/error.h"
+
+namespace
+{
+
+auto sub_model(std::uint32_t offset, std::vector<ufps::MeshLod> lods, std::string albedo) -> ufps::ModelManifest
+{
+    return {
+        .mesh_view = {.index_offset = offset, .index_count = 3u, .vertex_offset = offset, .vertex_count = 3u},
+        .lods = std::move(lods),
+        .meshlets = {.offset = offset, .count = 1u},
+        .albedo_texture = std::move(albedo),
+        .normal_texture = "normal",
+        .specular_texture = "specular",
+        .ao_texture = "ao",
+        .glossiness_texture = "glossiness",
+        .emissive_texture = "emissive",
+    };
+}
+
+auto texture_manifest() -> ufps::TextureManifestDescription
+{
+    auto manifest = ufps::TextureManifestDescription{};
+
+    for (const auto *name : {"normal", "specular", "ao", "glossiness", "emissive"})
+    {
+        manifest.textures[name] = {.is_srgb = false};
+    }
+
+    manifest.textures["crate_BaseColor"] = {.is_srgb = true};
+    manifest.textures["barrel_BaseColor"] = {.is_srgb = true};
+
+    return manifest;
+}
+
+auto model_manifest() -> ufps::ModelManifestDescription
+{
+    const auto lod = ufps::MeshLod{
+        .mesh_view = {.index_offset = 9u, .index_count = 3u, .vertex_offset = 9u, .vertex_count = 3u},
+        .error = 0.5f,
+    };
+
+    auto manifest = ufps::ModelManifestDescription{};
+    manifest.models["crate"] = {sub_model(0u, {lod}, "crate_BaseColor"), sub_model(3u, {}, "crate_BaseColor")};
+    manifest.models["barrel"] = {sub_model(6u, {}, "barrel_BaseColor")};
+
+    return manifest;
+}
+
+}
+
+TEST(binary_manifest, round_trip)
+{
+    const auto models = model_manifest();
+    const auto textures = texture_manifest();
+
+    const auto data = ufps::encode_binary_manifest(models, textures);
+    const auto manifest = ufps::BinaryManifest{data};
+
+    ASSERT_EQ(manifest.textures().size(), textures.textures.size());
+    for (const auto &texture : manifest.textures())
+    {
+        const auto name = std::string{manifest.name(texture.name)};
+        ASSERT_TRUE(textures.textures.contains(name));
+        ASSERT_EQ(texture.is_srgb != 0u, textures.textures.find(name)->second.is_srgb);
+    }
+
+    // models are sorted by name
+    ASSERT_EQ(manifest.models().size(), 2zu);
+    ASSERT_EQ(manifest.name(manifest.models()[0].name), "barrel");
+    ASSERT_EQ(manifest.name(manifest.models()[1].name), "crate");
+
+    for (const auto &model : manifest.models())
+    {
+        const auto &expected = models.models.find(manifest.name(model.name))->second;
+        const auto sub_models = manifest.sub_models(model);
+        ASSERT_EQ(sub_models.size(), expected.size());
+
+        for (const auto &[actual, expected_sub_model] : std::views::zip(sub_models, expected))
+        {
+            ASSERT_EQ(actual.mesh_view, expected_sub_model.mesh_view);
+            ASSERT_EQ(actual.meshlets.offset, expected_sub_model.meshlets.offset);
+            ASSERT_EQ(actual.meshlets.count, expected_sub_model.meshlets.count);
+            ASSERT_EQ(manifest.lods(actual) | std::ranges::to<std::vector>(), expected_sub_model.lods);
+            ASSERT_EQ(manifest.texture_name(actual.textures[0]), expected_sub_model.albedo_texture);
+            ASSERT_EQ(manifest.texture_name(actual.textures[1]), expected_sub_model.normal_texture);
+            ASSERT_EQ(manifest.texture_name(actual.textures[5]), expected_sub_model.emissive_texture);
+        }
+    }
+}
+
+TEST(binary_manifest, empty)
+{
+    const auto data = ufps::encode_binary_manifest({}, {});
+    const auto manifest = ufps::BinaryManifest{data};
+
+    ASSERT_TRUE(manifest.textures().empty());
+    ASSERT_TRUE(manifest.models().empty());
+}
+
+TEST(binary_manifest, missing_texture)
+{
+    auto textures = texture_manifest();
+    textures.textures.erase("crate_BaseColor");
+
+    ASSERT_THROW(ufps::encode_binary_manifest(model_manifest(), textures), ufps::Exception);
+}
+
+TEST(binary_manifest, invalid_manifest)
+{
+    ASSERT_THROW(ufps::BinaryManifest{ufps::DataBuffer{}}, ufps::Exception);
+    ASSERT_THROW(ufps::BinaryManifest{ufps::DataBuffer(64zu, std::byte{0x2a})}, ufps::Exception);
+
+    auto data = ufps::encode_binary_manifest(model_manifest(), texture_manifest());
+    data.resize(data.size() - 1zu);
+
+    ASSERT_THROW(ufps::BinaryManifest{data}, ufps::Exception);
+}
+
+TEST(binary_manifest, different_schema)
+{
+    auto data = ufps::encode_binary_manifest(model_manifest(), texture_manifest());
+    ASSERT_EQ(reinterpret_cast<const ufps::BinaryManifestHeader *>(data.data())->schema, ufps::binary_manifest_schema);
+
+    // as if written by a build whose records had a different layout
+    reinterpret_cast<ufps::BinaryManifestHeader *>(data.data())->schema ^= 1u;
+
+    ASSERT_THROW(ufps::BinaryManifest{data}, ufps::Exception);
+}
+
+TEST(binary_manifest, invalid_record)
+{
+    auto data = ufps::encode_binary_manifest(model_manifest(), texture_manifest());
+
+    // point the first model's sub models past the end of the sub model records
+    auto *model = reinterpret_cast<ufps::BinaryModelManifest *>(
+        data.data() + sizeof(ufps::BinaryManifestHeader) +
+        (texture_manifest().textures.size() * sizeof(ufps::BinaryTextureManifest)));
+    model->first_sub_model = 100u;
+
+    ASSERT_THROW(ufps::BinaryManifest{data}, ufps::Exception);
+}
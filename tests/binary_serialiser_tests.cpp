@@ -0,0 +1,231 @@
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ranges>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "core/sparse_set.h"
+#include "maths/bounded_number.h"
+#include "maths/matrix4.h"
+#include "maths/vector3.h"
+#include "serialisation/binary_serialiser.h"
+#include "utils/data_buffer.h"
+
+namespace
+{
+
+struct Simple
+{
+    int a;
+
+    auto operator==(const Simple &) const -> bool = default;
+};
+
+struct Renamed
+{
+    int b;
+};
+
+struct MultiMember
+{
+    int a;
+    float b;
+    std::string c;
+    bool d;
+
+    auto operator==(const MultiMember &) const -> bool = default;
+};
+
+struct Containers
+{
+    std::vector<int> a;
+    std::vector<MultiMember> b;
+    std::unordered_map<std::string, Simple> c;
+
+    auto operator==(const Containers &) const -> bool = default;
+};
+
+struct Blobs
+{
+    ufps::DataBuffer data;
+    std::array<std::string, 2zu> names;
+
+    auto operator==(const Blobs &) const -> bool = default;
+};
+
+enum class Fruit : std::uint8_t
+{
+    APPLE,
+    PEAR,
+};
+
+struct Everything
+{
+    Fruit fruit;
+    ufps::BoundedFloat<0.0f, 1.0f> bounded;
+    ufps::Vector3 position;
+    ufps::Matrix4 transform;
+    ufps::SparseSet<Simple> sparse;
+};
+
+struct Padded
+{
+    std::uint8_t a;
+    std::uint32_t b;
+};
+
+struct Versioned
+{
+    static constexpr auto schema_version = 2u;
+
+    int a;
+};
+
+static_assert(ufps::binary::FixedLayout<Simple>);
+static_assert(ufps::binary::FixedLayout<ufps::Vector3>);
+static_assert(ufps::binary::FixedLayout<std::byte>);
+static_assert(!ufps::binary::FixedLayout<MultiMember>);
+static_assert(!ufps::binary::FixedLayout<Padded>);
+static_assert(!ufps::binary::FixedLayout<ufps::BoundedFloat<0.0f, 1.0f>>);
+
+static_assert(ufps::binary::schema<Simple>() != ufps::binary::schema<Renamed>());
+static_assert(ufps::binary::schema<Simple>() != ufps::binary::schema<Versioned>());
+
+}
+
+TEST(binary_serialisation, simple_struct)
+{
+    const auto data = ufps::binary::serialise(Simple{.a = 12});
+    ASSERT_TRUE(data);
+    ASSERT_EQ(data->size(), sizeof(ufps::binary::Header) + sizeof(int));
+
+    ASSERT_EQ(ufps::binary::deserialise<Simple>(*data), Simple{.a = 12});
+}
+
+TEST(binary_serialisation, multi_member_struct)
+{
+    const auto expected = MultiMember{.a = 12, .b = 3.1f, .c = "hello world", .d = true};
+
+    const auto data = ufps::binary::serialise(expected);
+    ASSERT_TRUE(data);
+
+    ASSERT_EQ(ufps::binary::deserialise<MultiMember>(*data), expected);
+}
+
+TEST(binary_serialisation, containers)
+{
+    const auto expected = Containers{
+        .a = {1, 2, 3, 4, 5, 7},
+        .b = {{.a = 1, .b = 2.0f, .c = "three", .d = false}, {.a = 4, .b = 5.0f, .c = "", .d = true}},
+        .c = {{"1", {.a = 1}}, {"2", {.a = 2}}},
+    };
+
+    const auto data = ufps::binary::serialise(expected);
+    ASSERT_TRUE(data);
+
+    ASSERT_EQ(ufps::binary::deserialise<Containers>(*data), expected);
+}
+
+TEST(binary_serialisation, blobs)
+{
+    const auto expected = Blobs{.data = {std::byte{0x00}, std::byte{0x2a}, std::byte{0xff}}, .names = {"one", "two"}};
+
+    const auto data = ufps::binary::serialise(expected);
+    ASSERT_TRUE(data);
+
+    ASSERT_EQ(ufps::binary::deserialise<Blobs>(*data), expected);
+}
+
+TEST(binary_serialisation, everything)
+{
+    auto expected = Everything{
+        .fruit = Fruit::PEAR,
+        .bounded = 0.25f,
+        .position = {1.0f, 2.0f, 3.0f},
+        .transform = ufps::Matrix4{ufps::Vector3{4.0f, 5.0f, 6.0f}},
+        .sparse = {},
+    };
+    expected.sparse.emplace(Simple{.a = 1});
+    expected.sparse.emplace(Simple{.a = 2});
+
+    const auto data = ufps::binary::serialise(expected);
+    ASSERT_TRUE(data);
+
+    const auto result = ufps::binary::deserialise<Everything>(*data);
+    ASSERT_TRUE(result);
+    ASSERT_EQ(result->fruit, expected.fruit);
+    ASSERT_EQ(result->bounded, expected.bounded);
+    ASSERT_EQ(result->position, expected.position);
+    ASSERT_EQ(result->transform, expected.transform);
+    ASSERT_TRUE(std::ranges::equal(result->sparse.data(), expected.sparse.data()));
+}
+
+TEST(binary_deserialisation, schema_mismatch)
+{
+    const auto data = ufps::binary::serialise(Simple{.a = 12});
+    ASSERT_TRUE(data);
+
+    ASSERT_FALSE(ufps::binary::deserialise<Renamed>(*data));
+    ASSERT_FALSE(ufps::binary::deserialise<Versioned>(*data));
+}
+
+TEST(binary_deserialisation, invalid_data)
+{
+    ASSERT_FALSE(ufps::binary::deserialise<Simple>(ufps::DataBuffer{}));
+    ASSERT_FALSE(ufps::binary::deserialise<Simple>(ufps::DataBuffer(32zu, std::byte{0x2a})));
+
+    auto data = ufps::binary::serialise(MultiMember{.a = 12, .b = 3.1f, .c = "hello world", .d = true});
+    ASSERT_TRUE(data);
+
+    auto truncated = *data;
+    truncated.pop_back();
+    ASSERT_FALSE(ufps::binary::deserialise<MultiMember>(truncated));
+
+    auto trailing = *data;
+    trailing.push_back(std::byte{0x00});
+    ASSERT_FALSE(ufps::binary::deserialise<MultiMember>(trailing));
+
+    // the bool is the last byte
+    auto invalid_bool = *data;
+    invalid_bool.back() = std::byte{0x02};
+    ASSERT_FALSE(ufps::binary::deserialise<MultiMember>(invalid_bool));
+}
+
+TEST(binary_deserialisation, invalid_enum)
+{
+    auto data = ufps::binary::serialise(
+        Everything{
+            .fruit = Fruit::APPLE,
+            .bounded = 0.5f,
+            .position = {},
+            .transform = {},
+            .sparse = {},
+        });
+    ASSERT_TRUE(data);
+
+    (*data)[sizeof(ufps::binary::Header)] = std::byte{0x07};
+    ASSERT_FALSE(ufps::binary::deserialise<Everything>(*data));
+}
+
+TEST(binary_deserialisation, out_of_bounds)
+{
+    auto data = ufps::binary::serialise(
+        Everything{
+            .fruit = Fruit::APPLE,
+            .bounded = 0.5f,
+            .position = {},
+            .transform = {},
+            .sparse = {},
+        });
+    ASSERT_TRUE(data);
+
+    const auto out_of_bounds = 2.0f;
+    std::memcpy(data->data() + sizeof(ufps::binary::Header) + sizeof(Fruit), &out_of_bounds, sizeof(float));
+    ASSERT_FALSE(ufps::binary::deserialise<Everything>(*data));
+}
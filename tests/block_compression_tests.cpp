@@ -0,0 +1,128 @@
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "graphics/block_compression.h"
+#include "graphics/mip_chain.h"
+#include "graphics/texture_data.h"
+#include "utils/data_buffer.h"
+#include "utils/error.h"
+
+namespace
+{
+
+auto texture(std::uint32_t width, std::uint32_t height, ufps::TextureFormat format, std::vector<std::uint8_t> texels)
+    -> ufps::TextureData
+{
+    auto data = ufps::DataBuffer{};
+    for (const auto texel : texels)
+    {
+        data.push_back(static_cast<std::byte>(texel));
+    }
+
+    return {
+        .width = width,
+        .height = height,
+        .mip_levels = 1u,
+        .format = format,
+        .data = std::move(data),
+        .is_compressed = false,
+    };
+}
+
+/**
+ * Smooth two axis gradient with a mip chain, typical of what the encoder sees.
+ */
+auto gradient(std::uint32_t size) -> ufps::TextureData
+{
+    auto texels = std::vector<std::uint8_t>{};
+
+    for (auto y = 0u; y < size; ++y)
+    {
+        for (auto x = 0u; x < size; ++x)
+        {
+            texels.push_back(static_cast<std::uint8_t>(x * 255u / (size - 1u)));
+            texels.push_back(static_cast<std::uint8_t>(y * 255u / (size - 1u)));
+            texels.push_back(128u);
+        }
+    }
+
+    return ufps::generate_mip_chain(texture(size, size, ufps::TextureFormat::RGB, std::move(texels)));
+}
+
+}
+
+TEST(block_compression, bc7_solid_colour_is_exact)
+{
+    auto texels = std::vector<std::uint8_t>{};
+    for (auto i = 0u; i < 16u; ++i)
+    {
+        texels.append_range(std::vector<std::uint8_t>{37u, 201u, 91u, 255u});
+    }
+
+    const auto source = texture(4u, 4u, ufps::TextureFormat::RGBA, std::move(texels));
+    const auto compressed = ufps::compress_texture(source, ufps::TextureFormat::BC7);
+
+    ASSERT_EQ(compressed.format, ufps::TextureFormat::BC7);
+    ASSERT_TRUE(compressed.is_compressed);
+    ASSERT_EQ(compressed.data->size(), 16zu);
+    ASSERT_TRUE(std::isinf(ufps::compression_psnr(source, compressed)));
+}
+
+TEST(block_compression, bc7_gradient_quality)
+{
+    const auto source = gradient(64u);
+    const auto compressed = ufps::compress_texture(source, ufps::TextureFormat::BC7_SRGB);
+
+    ASSERT_EQ(compressed.mip_levels, source.mip_levels);
+    ASSERT_EQ(
+        compressed.data->size(), ufps::mip_chain_size(ufps::TextureFormat::BC7, 64u, 64u, compressed.mip_levels));
+    ASSERT_GT(ufps::compression_psnr(source, compressed), 30.0f);
+}
+
+TEST(block_compression, odd_sizes_pad_partial_blocks)
+{
+    const auto source =
+        ufps::generate_mip_chain(texture(6u, 5u, ufps::TextureFormat::RED, std::vector<std::uint8_t>(30zu, 200u)));
+    const auto compressed = ufps::compress_texture(source, ufps::TextureFormat::BC7);
+
+    ASSERT_EQ(compressed.data->size(), ufps::mip_chain_size(ufps::TextureFormat::BC7, 6u, 5u, source.mip_levels));
+    ASSERT_GT(ufps::compression_psnr(source, compressed), 40.0f);
+}
+
+TEST(block_compression, bc5_only_keeps_two_channels)
+{
+    auto texels = std::vector<std::uint8_t>{};
+    for (auto i = 0u; i < 16u; ++i)
+    {
+        texels.append_range(std::vector<std::uint8_t>{128u, 64u, static_cast<std::uint8_t>(i * 16u)});
+    }
+
+    const auto source = texture(4u, 4u, ufps::TextureFormat::RGB, std::move(texels));
+    const auto compressed = ufps::compress_texture(source, ufps::TextureFormat::BC5U);
+
+    ASSERT_EQ(compressed.data->size(), 16zu);
+    ASSERT_TRUE(std::isinf(ufps::compression_psnr(source, compressed)));
+}
+
+TEST(block_compression, bc5_gradient_quality)
+{
+    const auto source = gradient(64u);
+    const auto compressed = ufps::compress_texture(source, ufps::TextureFormat::BC5U);
+
+    ASSERT_GT(ufps::compression_psnr(source, compressed), 40.0f);
+}
+
+TEST(block_compression, rejects_invalid_requests)
+{
+    const auto source = texture(4u, 4u, ufps::TextureFormat::RED, std::vector<std::uint8_t>(16zu));
+    ASSERT_THROW(ufps::compress_texture(source, ufps::TextureFormat::RGBA), ufps::Exception);
+
+    auto compressed = source;
+    compressed.is_compressed = true;
+    ASSERT_THROW(ufps::compress_texture(compressed, ufps::TextureFormat::BC7), ufps::Exception);
+}
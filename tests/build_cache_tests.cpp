@@ -0,0 +1,131 @@
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <string_view>
+
+#include <gtest/gtest.h>
+
+#include "resources/build_cache.h"
+#include "utils/data_buffer.h"
+
+namespace
+{
+
+auto bytes(std::string_view str) -> ufps::DataBuffer
+{
+    return std::as_bytes(std::span{str}) | std::ranges::to<ufps::DataBuffer>();
+}
+
+/**
+ * Fresh cache directory for a single test, removed when the test ends.
+ */
+class BuildCacheDirectory
+{
+  public:
+    BuildCacheDirectory(std::string_view name)
+        : path_{std::filesystem::temp_directory_path() / "ufps_build_cache_tests" / name}
+    {
+        std::filesystem::remove_all(path_);
+    }
+
+    ~BuildCacheDirectory()
+    {
+        std::filesystem::remove_all(path_);
+    }
+
+    auto path() const -> const std::filesystem::path &
+    {
+        return path_;
+    }
+
+  private:
+    std::filesystem::path path_;
+};
+
+}
+
+TEST(build_cache, content_hash)
+{
+    const auto data = bytes("the quick brown fox jumps over the lazy dog");
+
+    ASSERT_EQ(ufps::content_hash(data), ufps::content_hash(bytes("the quick brown fox jumps over the lazy dog")));
+    ASSERT_NE(ufps::content_hash(data), ufps::content_hash(bytes("the quick brown fox jumps over the lazy cog")));
+    ASSERT_NE(ufps::content_hash(data), ufps::content_hash(data, 1u));
+
+    // the zero padded tail must not collide with explicit zeros
+    auto padded = bytes("abc");
+    padded.push_back(std::byte{0});
+    ASSERT_NE(ufps::content_hash(bytes("abc")), ufps::content_hash(padded));
+}
+
+TEST(build_cache, key_depends_on_settings)
+{
+    const auto source = bytes("source");
+
+    ASSERT_EQ(ufps::build_cache_key(source, "texture v1 BC7"), ufps::build_cache_key(source, "texture v1 BC7"));
+    ASSERT_NE(ufps::build_cache_key(source, "texture v1 BC7"), ufps::build_cache_key(source, "texture v1 BC5U"));
+    ASSERT_NE(ufps::build_cache_key(source, "texture v1 BC7"), ufps::build_cache_key(source, "texture v2 BC7"));
+}
+
+TEST(build_cache, round_trip)
+{
+    const auto directory = BuildCacheDirectory{"round_trip"};
+    const auto data = ufps::DataBuffer(4096zu, std::byte{0x2a});
+
+    {
+        auto cache = ufps::BuildCache{directory.path()};
+
+        ASSERT_EQ(cache.load(1u), std::nullopt);
+        cache.store(1u, data);
+        ASSERT_EQ(cache.load(1u), data);
+
+        ASSERT_EQ(cache.hits(), 1u);
+        ASSERT_EQ(cache.misses(), 1u);
+    }
+
+    // entries persist between runs
+    auto cache = ufps::BuildCache{directory.path()};
+    ASSERT_EQ(cache.load(1u), data);
+    ASSERT_EQ(cache.load(2u), std::nullopt);
+}
+
+TEST(build_cache, invalid_entry_is_a_miss)
+{
+    const auto directory = BuildCacheDirectory{"invalid_entry"};
+
+    auto cache = ufps::BuildCache{directory.path()};
+    cache.store(1u, bytes("hello"));
+
+    // truncate every entry as an interrupted write might
+    for (const auto &entry : std::filesystem::directory_iterator{directory.path()})
+    {
+        std::filesystem::resize_file(entry.path(), 8u);
+    }
+
+    ASSERT_EQ(cache.load(1u), std::nullopt);
+    ASSERT_EQ(cache.misses(), 1u);
+}
+
+TEST(build_cache, corrupt_size_is_a_miss)
+{
+    const auto directory = BuildCacheDirectory{"corrupt_size"};
+
+    auto cache = ufps::BuildCache{directory.path()};
+    cache.store(1u, bytes("hello"));
+
+    // the compressed size follows the magic, reserved word and key, claim far more than the file holds
+    for (const auto &entry : std::filesystem::directory_iterator{directory.path()})
+    {
+        auto file = std::fstream{entry.path(), std::ios::binary | std::ios::in | std::ios::out};
+        const auto size = std::uint64_t{1ull << 62u};
+        file.seekp(16);
+        file.write(reinterpret_cast<const char *>(&size), sizeof(size));
+    }
+
+    ASSERT_EQ(cache.load(1u), std::nullopt);
+    ASSERT_EQ(cache.misses(), 1u);
+}
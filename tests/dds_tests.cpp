@@ -0,0 +1,101 @@
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include <gtest/gtest.h>
+
+#include "graphics/mip_chain.h"
+#include "graphics/texture_data.h"
+#include "graphics/utils.h"
+#include "utils/data_buffer.h"
+#include "utils/error.h"
+
+namespace
+{
+
+auto texture(std::uint32_t width, std::uint32_t height, std::uint32_t mip_levels, ufps::TextureFormat format)
+    -> ufps::TextureData
+{
+    auto data = ufps::DataBuffer(ufps::mip_chain_size(format, width, height, mip_levels));
+    for (auto i = 0zu; i < data.size(); ++i)
+    {
+        data[i] = static_cast<std::byte>(i);
+    }
+
+    return {
+        .width = width,
+        .height = height,
+        .mip_levels = mip_levels,
+        .format = format,
+        .data = std::move(data),
+        .is_compressed = ufps::is_block_compressed(format),
+    };
+}
+
+}
+
+TEST(dds, round_trip_block_compressed_mips)
+{
+    const auto source = texture(16u, 8u, ufps::mip_level_count(16u, 8u), ufps::TextureFormat::BC7_SRGB);
+
+    const auto loaded = ufps::load_texture(ufps::encode_dds(source), false);
+
+    ASSERT_EQ(loaded.width, 16u);
+    ASSERT_EQ(loaded.height, 8u);
+    ASSERT_EQ(loaded.mip_levels, 5u);
+    ASSERT_EQ(loaded.format, ufps::TextureFormat::BC7_SRGB);
+    ASSERT_TRUE(loaded.is_compressed);
+    ASSERT_EQ(loaded.data, source.data);
+}
+
+TEST(dds, round_trip_uncompressed_mips)
+{
+    const auto source = texture(5u, 3u, 3u, ufps::TextureFormat::SRGBA);
+
+    const auto loaded = ufps::load_texture(ufps::encode_dds(source), true);
+
+    ASSERT_EQ(loaded.mip_levels, 3u);
+    ASSERT_EQ(loaded.format, ufps::TextureFormat::SRGBA);
+    ASSERT_FALSE(loaded.is_compressed);
+    ASSERT_EQ(loaded.data, source.data);
+}
+
+TEST(dds, rgb_widened_to_rgba)
+{
+    const auto source = texture(2u, 1u, 2u, ufps::TextureFormat::RGB);
+
+    const auto loaded = ufps::load_texture(ufps::encode_dds(source), false);
+
+    ASSERT_EQ(loaded.format, ufps::TextureFormat::RGBA);
+    ASSERT_EQ(loaded.data->size(), 12zu);
+    ASSERT_EQ((*loaded.data)[3], std::byte{0xff});
+    ASSERT_EQ((*loaded.data)[4], (*source.data)[3]);
+}
+
+TEST(dds, truncated_mip_chain)
+{
+    auto dds = ufps::encode_dds(texture(8u, 8u, 4u, ufps::TextureFormat::BC5U));
+    dds.resize(dds.size() - 1zu);
+
+    ASSERT_THROW(ufps::load_texture(dds, false), ufps::Exception);
+}
+
+TEST(dds, too_many_mip_levels)
+{
+    // an 8x8 chain only has four levels, the fifth is padded with enough data that only the count is wrong
+    const auto dds = ufps::encode_dds(texture(8u, 8u, 5u, ufps::TextureFormat::BC5U));
+
+    ASSERT_THROW(ufps::load_texture(dds, false), ufps::Exception);
+}
+
+TEST(dds, load_views_image_data)
+{
+    const auto source = texture(8u, 8u, 4u, ufps::TextureFormat::BC7);
+    const auto encoded = ufps::encode_dds(source);
+
+    const auto loaded = ufps::load_texture(ufps::DataBufferView{encoded}, false);
+
+    // the levels are a view into the image rather than a copy, the payload follows the headers
+    ASSERT_EQ(loaded.data->data() + loaded.data->size(), encoded.data() + encoded.size());
+    ASSERT_EQ(loaded.data, source.data);
+}
@@ -0,0 +1,70 @@
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include "fake_fence.h"
+#include "graphics/deferred_release.h"
+
+namespace
+{
+
+struct Tracked
+{
+    Tracked(std::shared_ptr<int> counter)
+        : counter{std::move(counter)}
+    {
+    }
+
+    std::shared_ptr<int> counter;
+};
+
+}
+
+TEST(deferred_release, empty_collect)
+{
+    FakeGpu::reset();
+
+    auto release = ufps::DeferredRelease<FakeFence>{};
+    release.collect();
+
+    ASSERT_EQ(release.size(), 0zu);
+}
+
+TEST(deferred_release, kept_alive_until_signalled)
+{
+    FakeGpu::reset();
+
+    auto counter = std::make_shared<int>();
+    auto release = ufps::DeferredRelease<FakeFence>{};
+
+    release.retire(Tracked{counter});
+    release.collect();
+
+    ASSERT_EQ(release.size(), 1zu);
+    ASSERT_EQ(counter.use_count(), 2);
+
+    FakeGpu::completed = 1zu;
+    release.collect();
+
+    ASSERT_EQ(release.size(), 0zu);
+    ASSERT_EQ(counter.use_count(), 1);
+}
+
+TEST(deferred_release, released_in_fence_order)
+{
+    FakeGpu::reset();
+
+    auto first = std::make_shared<int>();
+    auto second = std::make_shared<int>();
+    auto release = ufps::DeferredRelease<FakeFence>{};
+
+    release.retire(Tracked{first});
+    release.retire(Tracked{second});
+
+    FakeGpu::completed = 1zu;
+    release.collect();
+
+    ASSERT_EQ(release.size(), 1zu);
+    ASSERT_EQ(first.use_count(), 1);
+    ASSERT_EQ(second.use_count(), 2);
+}
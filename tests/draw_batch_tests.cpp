@@ -0,0 +1,199 @@
+#include <array>
+#include <cstdint>
+#include <numbers>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "core/camera.h"
+#include "graphics/draw_batch.h"
+#include "graphics/indirect_command.h"
+#include "graphics/mesh_view.h"
+#include "graphics/meshlet.h"
+#include "graphics/object_data.h"
+#include "maths/aabb.h"
+#include "maths/matrix4.h"
+#include "maths/transform.h"
+#include "maths/vector3.h"
+
+namespace
+{
+
+constexpr auto mesh_a =
+    ufps::MeshView{.index_offset = 0u, .index_count = 36u, .vertex_offset = 0u, .vertex_count = 24u};
+constexpr auto mesh_b =
+    ufps::MeshView{.index_offset = 36u, .index_count = 6u, .vertex_offset = 24u, .vertex_count = 4u};
+
+auto draw(ufps::MeshView mesh_view, std::uint32_t material_index, float x) -> ufps::DrawInstance
+{
+    return {
+        .mesh_view = mesh_view,
+        .object_data = {
+            .model = ufps::Matrix4{ufps::Vector3{x, 0.0f, 0.0f}},
+            .material_index = material_index,
+            .emissive_strength = 1.0f,
+        }};
+}
+
+/**
+ * Meshlets for mesh_a as a unit cube, one per face in the order +x -x +y -y +z -z. Faces are flat so a cutoff of zero
+ * culls them once the camera is behind them.
+ */
+auto cube_meshlets() -> std::array<ufps::Meshlet, 6zu>
+{
+    const auto normals = std::array<ufps::Vector3, 6zu>{{
+        {1.0f, 0.0f, 0.0f},
+        {-1.0f, 0.0f, 0.0f},
+        {0.0f, 1.0f, 0.0f},
+        {0.0f, -1.0f, 0.0f},
+        {0.0f, 0.0f, 1.0f},
+        {0.0f, 0.0f, -1.0f},
+    }};
+
+    auto meshlets = std::array<ufps::Meshlet, 6zu>{};
+
+    for (auto i = 0u; i < meshlets.size(); ++i)
+    {
+        meshlets[i] = {
+            .index_offset = i * 6u,
+            .index_count = 6u,
+            .centre = normals[i] * 0.5f,
+            .radius = std::numbers::sqrt2_v<float> / 2.0f,
+            .cone_axis = normals[i],
+            .cone_cutoff = 0.0f,
+        };
+    }
+
+    return meshlets;
+}
+
+}
+
+TEST(draw_batch, empty)
+{
+    const auto batch = ufps::batch_draws(std::vector<ufps::DrawInstance>{});
+
+    ASSERT_TRUE(batch.commands.empty());
+    ASSERT_TRUE(batch.instances.empty());
+}
+
+TEST(draw_batch, single_draw)
+{
+    const auto draws = std::vector{draw(mesh_a, 1u, 0.0f)};
+    const auto batch = ufps::batch_draws(draws);
+
+    const auto expected = std::vector<ufps::IndirectCommand>{
+        {.count = 36u, .instance_count = 1u, .first = 0u, .base_vertex = 0, .base_instance = 0u}};
+
+    ASSERT_EQ(batch.commands, expected);
+    ASSERT_EQ(batch.instances.size(), 1zu);
+}
+
+TEST(draw_batch, identical_draws_merged)
+{
+    const auto draws = std::vector{draw(mesh_a, 1u, 0.0f), draw(mesh_a, 1u, 1.0f), draw(mesh_a, 1u, 2.0f)};
+    const auto batch = ufps::batch_draws(draws);
+
+    const auto expected = std::vector<ufps::IndirectCommand>{
+        {.count = 36u, .instance_count = 3u, .first = 0u, .base_vertex = 0, .base_instance = 0u}};
+
+    ASSERT_EQ(batch.commands, expected);
+    ASSERT_EQ(batch.instances.size(), 3zu);
+
+    // instance order within a command is stable
+    ASSERT_EQ(batch.instances[0].model[12], 0.0f);
+    ASSERT_EQ(batch.instances[1].model[12], 1.0f);
+    ASSERT_EQ(batch.instances[2].model[12], 2.0f);
+}
+
+TEST(draw_batch, interleaved_meshes_grouped)
+{
+    const auto draws = std::vector{
+        draw(mesh_b, 1u, 0.0f), draw(mesh_a, 1u, 1.0f), draw(mesh_b, 1u, 2.0f), draw(mesh_a, 1u, 3.0f)};
+    const auto batch = ufps::batch_draws(draws);
+
+    const auto expected = std::vector<ufps::IndirectCommand>{
+        {.count = 36u, .instance_count = 2u, .first = 0u, .base_vertex = 0, .base_instance = 0u},
+        {.count = 6u, .instance_count = 2u, .first = 36u, .base_vertex = 24, .base_instance = 2u},
+    };
+
+    ASSERT_EQ(batch.commands, expected);
+    ASSERT_EQ(batch.instances.size(), 4zu);
+
+    ASSERT_EQ(batch.instances[0].model[12], 1.0f);
+    ASSERT_EQ(batch.instances[1].model[12], 3.0f);
+    ASSERT_EQ(batch.instances[2].model[12], 0.0f);
+    ASSERT_EQ(batch.instances[3].model[12], 2.0f);
+}
+
+TEST(draw_batch, different_material_not_merged)
+{
+    const auto draws = std::vector{draw(mesh_a, 1u, 0.0f), draw(mesh_a, 2u, 1.0f), draw(mesh_a, 1u, 2.0f)};
+    const auto batch = ufps::batch_draws(draws);
+
+    const auto expected = std::vector<ufps::IndirectCommand>{
+        {.count = 36u, .instance_count = 2u, .first = 0u, .base_vertex = 0, .base_instance = 0u},
+        {.count = 36u, .instance_count = 1u, .first = 0u, .base_vertex = 0, .base_instance = 2u},
+    };
+
+    ASSERT_EQ(batch.commands, expected);
+    ASSERT_EQ(batch.instances[2].material_index, 2u);
+}
+
+TEST(draw_batch, partly_culled_copies_share_command)
+{
+    const auto camera = ufps::Camera{
+        {0.0f, 0.0f, 0.0f},
+        {0.0f, 0.0f, -1.0f},
+        {0.0f, 1.0f, 0.0f},
+        std::numbers::pi_v<float> / 4.0f,
+        1920.0f,
+        1080.0f,
+        0.1f,
+        1000.0f};
+    const auto meshlets = cube_meshlets();
+    const auto aabb = ufps::AABB{.min = {-0.5f}, .max = {0.5f}};
+
+    // either side of the view, overlapping the frustum's side planes, so each has different faces turned away
+    const auto left = ufps::Transform{{-6.8f, 0.0f, -10.0f}, {1.0f}, {}};
+    const auto right = ufps::Transform{{6.8f, 0.0f, -10.0f}, {1.0f}, {}};
+
+    ASSERT_FALSE(ufps::inside_frustum({}, 0.87f, left, camera));
+    ASSERT_FALSE(ufps::inside_frustum({}, 0.87f, right, camera));
+
+    // drawn as culled ranges these would be three commands, two for the left copy and one for the right
+    ASSERT_EQ(ufps::cull_meshlets(meshlets, left, camera).size(), 2zu);
+    ASSERT_EQ(ufps::cull_meshlets(meshlets, right, camera).size(), 1zu);
+
+    const auto left_views = ufps::cull_mesh(mesh_a, meshlets, aabb, left, camera);
+    const auto right_views = ufps::cull_mesh(mesh_a, meshlets, aabb, right, camera);
+
+    ASSERT_EQ(left_views, std::vector{mesh_a});
+    ASSERT_EQ(right_views, std::vector{mesh_a});
+
+    const auto draws = std::vector{draw(left_views[0], 1u, -6.8f), draw(right_views[0], 1u, 6.8f)};
+    const auto batch = ufps::batch_draws(draws);
+
+    const auto expected = std::vector<ufps::IndirectCommand>{
+        {.count = 36u, .instance_count = 2u, .first = 0u, .base_vertex = 0, .base_instance = 0u}};
+
+    ASSERT_EQ(batch.commands, expected);
+}
+
+TEST(draw_batch, cull_mesh_outside_frustum)
+{
+    const auto camera = ufps::Camera{
+        {0.0f, 0.0f, 0.0f},
+        {0.0f, 0.0f, -1.0f},
+        {0.0f, 1.0f, 0.0f},
+        std::numbers::pi_v<float> / 4.0f,
+        1920.0f,
+        1080.0f,
+        0.1f,
+        1000.0f};
+    const auto meshlets = cube_meshlets();
+    const auto aabb = ufps::AABB{.min = {-0.5f}, .max = {0.5f}};
+
+    ASSERT_TRUE(ufps::cull_mesh(mesh_a, meshlets, aabb, {{0.0f, 0.0f, 10.0f}, {1.0f}, {}}, camera).empty());
+    ASSERT_EQ(ufps::cull_mesh(mesh_a, meshlets, aabb, {{0.0f, 0.0f, -10.0f}, {1.0f}, {}}, camera), std::vector{mesh_a});
+}
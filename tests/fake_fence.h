@@ -0,0 +1,49 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+/**
+ * Stands in for the gpu, fences are numbered in insertion order and complete in that order.
+ */
+struct FakeGpu
+{
+    static auto reset() -> void
+    {
+        next_fence = 0zu;
+        completed = 0zu;
+        waits.clear();
+    }
+
+    static inline std::size_t next_fence{};
+    static inline std::size_t completed{};
+    static inline std::vector<std::size_t> waits{};
+};
+
+class FakeFence
+{
+  public:
+    auto insert() -> void
+    {
+        id_ = FakeGpu::next_fence++;
+    }
+
+    auto wait() const -> void
+    {
+        if (id_)
+        {
+            FakeGpu::waits.push_back(*id_);
+            FakeGpu::completed = std::max(FakeGpu::completed, *id_ + 1zu);
+        }
+    }
+
+    auto signalled() const -> bool
+    {
+        return !id_ || (*id_ < FakeGpu::completed);
+    }
+
+  private:
+    std::optional<std::size_t> id_;
+};
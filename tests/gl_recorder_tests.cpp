@@ -0,0 +1,191 @@
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ranges>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "graphics/buffer.h"
+#include "graphics/debug_group.h"
+#include "graphics/gl_recorder.h"
+#include "graphics/index_encoding.h"
+#include "graphics/mesh_data.h"
+#include "graphics/mesh_manager.h"
+#include "graphics/mesh_view.h"
+#include "graphics/null_opengl.h"
+#include "graphics/opengl.h"
+#include "graphics/packed_vertex.h"
+#include "graphics/persistent_buffer.h"
+#include "graphics/vertex_data.h"
+#include "utils/data_buffer.h"
+#include "utils/string_map.h"
+
+using namespace std::literals;
+
+namespace
+{
+
+/**
+ * Recording can only be started once per process, every test starts from an empty frame.
+ */
+auto start_recording() -> void
+{
+    static const auto started = []
+    {
+        ufps::use_null_opengl();
+        ufps::record_opengl();
+        return true;
+    }();
+    static_cast<void>(started);
+
+    ufps::end_recorded_frame();
+}
+
+auto find_pass(const std::vector<ufps::GlPassCounts> &passes, std::string_view name) -> ufps::GlCounts
+{
+    const auto pass = std::ranges::find(passes, name, &ufps::GlPassCounts::name);
+    return pass == std::ranges::end(passes) ? ufps::GlCounts{} : pass->counts;
+}
+
+auto triangle() -> std::vector<ufps::VertexData>
+{
+    return std::vector<ufps::VertexData>(3zu);
+}
+
+}
+
+TEST(gl_recorder, counts_per_pass)
+{
+    start_recording();
+
+    ::glUseProgram(1u);
+    {
+        const auto debug_group = ufps::DebugGroup{"gbuffer"};
+        ::glUseProgram(2u);
+        ::glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0u, 3u);
+        ::glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1u, 4u);
+        ::glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, 10, 0);
+
+        {
+            const auto inner = ufps::DebugGroup{"ssao"};
+            ::glDispatchCompute(1u, 1u, 1u);
+        }
+    }
+
+    const auto passes = ufps::end_recorded_frame();
+
+    ASSERT_EQ(passes.size(), 3zu);
+    ASSERT_EQ(passes[0].name, "frame"sv);
+    ASSERT_EQ(passes[1].name, "gbuffer"sv);
+    ASSERT_EQ(passes[2].name, "ssao"sv);
+
+    const auto frame = find_pass(passes, "frame");
+    ASSERT_EQ(frame.calls, 1zu);
+    ASSERT_EQ(frame.state_changes, 1zu);
+
+    // pushing and popping debug groups only names passes, they aren't counted
+    const auto gbuffer = find_pass(passes, "gbuffer");
+    ASSERT_EQ(gbuffer.calls, 4zu);
+    ASSERT_EQ(gbuffer.draw_calls, 1zu);
+    ASSERT_EQ(gbuffer.state_changes, 1zu);
+    ASSERT_EQ(gbuffer.buffer_binds, 2zu);
+    ASSERT_EQ(gbuffer.dispatches, 0zu);
+
+    const auto ssao = find_pass(passes, "ssao");
+    ASSERT_EQ(ssao.calls, 1zu);
+    ASSERT_EQ(ssao.dispatches, 1zu);
+    ASSERT_EQ(ssao.draw_calls, 0zu);
+
+    ASSERT_TRUE(ufps::end_recorded_frame().empty());
+}
+
+TEST(gl_recorder, sub_data_bytes)
+{
+    start_recording();
+
+    const auto buffer = ufps::Buffer{1024zu, "buffer"};
+    ufps::end_recorded_frame();
+
+    const auto data = std::array<std::byte, 100zu>{};
+    buffer.write(data, 0zu);
+    buffer.write(data, 200zu);
+
+    const auto counts = find_pass(ufps::end_recorded_frame(), "frame");
+    ASSERT_EQ(counts.sub_data_bytes, 200zu);
+    ASSERT_EQ(counts.mapped_write_bytes, 0zu);
+}
+
+TEST(gl_recorder, mapped_write_bytes)
+{
+    start_recording();
+
+    const auto buffer = ufps::PersistentBuffer{1024zu, "buffer"};
+    ufps::end_recorded_frame();
+
+    const auto data = std::array<std::byte, 64zu>{};
+    buffer.write(data, 0zu);
+    buffer.write(data, 512zu);
+
+    const auto counts = find_pass(ufps::end_recorded_frame(), "frame");
+    ASSERT_EQ(counts.mapped_write_bytes, 128zu);
+    ASSERT_EQ(counts.sub_data_bytes, 0zu);
+}
+
+TEST(gl_recorder, mesh_load_only_uploads_new_mesh)
+{
+    start_recording();
+
+    auto vertices = triangle();
+    vertices.append_range(triangle());
+
+    auto mesh_manager = ufps::MeshManager{
+        vertices,
+        {0u, 1u, 2u, 0u, 1u, 2u},
+        ufps::StringMap<std::vector<ufps::MeshView>>{
+            {"a", {{.index_offset = 0u, .index_count = 3u, .vertex_offset = 0u, .vertex_count = 3u}}},
+            {"b", {{.index_offset = 3u, .index_count = 3u, .vertex_offset = 3u, .vertex_count = 3u}}},
+        }};
+
+    const auto initial = find_pass(ufps::end_recorded_frame(), "frame");
+    ASSERT_EQ(initial.sub_data_bytes, (6zu * sizeof(ufps::PackedVertex)) + (6zu * sizeof(std::uint32_t)));
+
+    // reuses the range freed by a, so nothing else should be written
+    mesh_manager.unload("a");
+    const auto meshes = std::array{ufps::MeshData{.vertices = triangle(), .indices = {0u, 1u, 2u}}};
+    mesh_manager.load("c", meshes);
+
+    const auto counts = find_pass(ufps::end_recorded_frame(), "frame");
+    ASSERT_EQ(counts.sub_data_bytes, (3zu * sizeof(ufps::PackedVertex)) + (3zu * sizeof(std::uint32_t)));
+    ASSERT_EQ(counts.sub_data_bytes, mesh_manager.uploaded_bytes() - initial.sub_data_bytes);
+}
+
+TEST(gl_recorder, blob_mesh_lods_are_uploaded_but_not_sub_models)
+{
+    start_recording();
+
+    const auto vertices = std::vector<ufps::PackedVertex>(6zu, ufps::pack_vertex(ufps::VertexData{}));
+    const auto indices = std::array{0u, 1u, 2u};
+    auto index_data = ufps::DataBuffer{};
+    ufps::encode_indices(index_data, indices, 3u);
+    ufps::encode_indices(index_data, indices, 3u);
+
+    const auto sub_model =
+        ufps::MeshView{.index_offset = 0u, .index_count = 3u, .vertex_offset = 0u, .vertex_count = 3u};
+    const auto lod = ufps::MeshView{.index_offset = 3u, .index_count = 3u, .vertex_offset = 3u, .vertex_count = 3u};
+
+    auto mesh_manager = ufps::MeshManager{
+        std::as_bytes(std::span{vertices}),
+        index_data,
+        ufps::StringMap<std::vector<ufps::MeshView>>{{"a", {sub_model}}},
+        ufps::StringMap<std::vector<ufps::MeshView>>{{"a", {lod}}}};
+
+    const auto counts = find_pass(ufps::end_recorded_frame(), "frame");
+    ASSERT_EQ(counts.sub_data_bytes, (6zu * sizeof(ufps::PackedVertex)) + (6zu * sizeof(std::uint32_t)));
+
+    ASSERT_TRUE(std::ranges::equal(mesh_manager.mesh("a"), std::array{sub_model}));
+    ASSERT_TRUE(std::ranges::equal(mesh_manager.index_data(lod), indices));
+}
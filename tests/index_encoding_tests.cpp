@@ -0,0 +1,44 @@
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "graphics/index_encoding.h"
+#include "graphics/mesh_view.h"
+#include "utils/data_buffer.h"
+
+TEST(index_encoding, packed_index_size)
+{
+    ASSERT_EQ(ufps::packed_index_size(3u), sizeof(std::uint16_t));
+    ASSERT_EQ(ufps::packed_index_size(65536u), sizeof(std::uint16_t));
+    ASSERT_EQ(ufps::packed_index_size(65537u), sizeof(std::uint32_t));
+}
+
+TEST(index_encoding, round_trip_mixed_sizes)
+{
+    const auto small = std::vector<std::uint32_t>{0u, 1u, 2u, 2u, 1u, 3u};
+    const auto large = std::vector<std::uint32_t>{0u, 70000u, 69999u};
+
+    auto blob = ufps::DataBuffer{};
+    ufps::encode_indices(blob, small, 4u);
+    ufps::encode_indices(blob, large, 70001u);
+
+    ASSERT_EQ(blob.size(), (small.size() * sizeof(std::uint16_t)) + (large.size() * sizeof(std::uint32_t)));
+
+    // views deliberately out of order and with a duplicate
+    const auto views = std::vector<ufps::MeshView>{
+        {.index_offset = 6u, .index_count = 3u, .vertex_offset = 4u, .vertex_count = 70001u},
+        {.index_offset = 0u, .index_count = 6u, .vertex_offset = 0u, .vertex_count = 4u},
+        {.index_offset = 0u, .index_count = 6u, .vertex_offset = 0u, .vertex_count = 4u},
+    };
+
+    auto expected = small;
+    expected.append_range(large);
+
+    ASSERT_EQ(ufps::decode_indices(blob, views), expected);
+}
+
+TEST(index_encoding, empty)
+{
+    ASSERT_TRUE(ufps::decode_indices({}, {}).empty());
+}
@@ -0,0 +1,239 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numbers>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "concurrency/thread_pool.h"
+#include "core/camera.h"
+#include "graphics/colour.h"
+#include "graphics/light_clusters.h"
+#include "graphics/point_light.h"
+#include "maths/vector3.h"
+#include "maths/vector4.h"
+
+namespace
+{
+
+auto test_camera() -> ufps::Camera
+{
+    return {
+        {1.0f, 2.0f, 3.0f},
+        {0.0f, 0.0f, -1.0f},
+        {0.0f, 1.0f, 0.0f},
+        std::numbers::pi_v<float> / 4.0f,
+        1920.0f,
+        1080.0f,
+        0.1f,
+        1000.0f};
+}
+
+auto random_lights(std::uint32_t count) -> std::vector<ufps::PointLight>
+{
+    auto generator = std::mt19937{42u};
+    auto position = std::uniform_real_distribution<float>{-60.0f, 60.0f};
+    auto unit = std::uniform_real_distribution<float>{0.0f, 1.0f};
+
+    auto lights = std::vector<ufps::PointLight>{};
+
+    for (auto i = 0u; i < count; ++i)
+    {
+        lights.push_back({
+            .position = {position(generator), position(generator) * 0.2f, position(generator)},
+            .colour = {.r = unit(generator), .g = unit(generator), .b = unit(generator)},
+            .constant_attenuation = 1.0f,
+            .linear_attenuation = 0.7f,
+            .quadratic_attenuation = 1.8f,
+            .intensity = unit(generator) * 5.0f,
+        });
+    }
+
+    return lights;
+}
+
+// test every light against every cluster
+auto brute_force(const ufps::Camera &camera, const std::vector<ufps::PointLight> &lights)
+    -> std::vector<std::vector<std::uint32_t>>
+{
+    auto clusters = std::vector<std::vector<std::uint32_t>>(ufps::LightClusterGrid::count);
+
+    for (auto z = 0u; z < ufps::LightClusterGrid::depth; ++z)
+    {
+        for (auto y = 0u; y < ufps::LightClusterGrid::height; ++y)
+        {
+            for (auto x = 0u; x < ufps::LightClusterGrid::width; ++x)
+            {
+                const auto bounds = ufps::cluster_bounds(camera, x, y, z);
+                const auto index =
+                    (z * ufps::LightClusterGrid::height + y) * ufps::LightClusterGrid::width + x;
+
+                for (auto i = 0u; i < lights.size(); ++i)
+                {
+                    const auto centre = camera.data().view * ufps::Vector4{lights[i].position, 1.0f};
+                    const auto radius = ufps::light_radius(lights[i]);
+
+                    const auto distance = [](float v, float min, float max)
+                    { return std::max({min - v, v - max, 0.0f}); };
+                    const auto dx = distance(centre.x, bounds.min.x, bounds.max.x);
+                    const auto dy = distance(centre.y, bounds.min.y, bounds.max.y);
+                    const auto dz = distance(centre.z, bounds.min.z, bounds.max.z);
+
+                    if ((radius > 0.0f) && ((dx * dx) + (dy * dy) + (dz * dz) <= radius * radius))
+                    {
+                        clusters[index].push_back(i);
+                    }
+                }
+            }
+        }
+    }
+
+    return clusters;
+}
+
+auto expand(const ufps::LightClusters &light_clusters) -> std::vector<std::vector<std::uint32_t>>
+{
+    auto clusters = std::vector<std::vector<std::uint32_t>>{};
+
+    for (const auto &[offset, count] : light_clusters.clusters)
+    {
+        clusters.emplace_back(
+            std::ranges::begin(light_clusters.light_indices) + offset,
+            std::ranges::begin(light_clusters.light_indices) + offset + count);
+    }
+
+    return clusters;
+}
+
+}
+
+TEST(light_clusters, radius_zero_intensity)
+{
+    const auto light = ufps::PointLight{
+        .position = {},
+        .colour = ufps::colours::white,
+        .constant_attenuation = 1.0f,
+        .linear_attenuation = 0.1f,
+        .quadratic_attenuation = 0.01f,
+        .intensity = 0.0f};
+
+    ASSERT_EQ(ufps::light_radius(light), 0.0f);
+}
+
+TEST(light_clusters, radius_no_attenuation)
+{
+    const auto light = ufps::PointLight{
+        .position = {},
+        .colour = ufps::colours::white,
+        .constant_attenuation = 1.0f,
+        .linear_attenuation = 0.0f,
+        .quadratic_attenuation = 0.0f,
+        .intensity = 1.0f};
+
+    ASSERT_EQ(ufps::light_radius(light), std::numeric_limits<float>::infinity());
+}
+
+TEST(light_clusters, radius_is_cutoff_distance)
+{
+    const auto light = ufps::PointLight{
+        .position = {},
+        .colour = ufps::colours::white,
+        .constant_attenuation = 1.0f,
+        .linear_attenuation = 0.7f,
+        .quadratic_attenuation = 1.8f,
+        .intensity = 2.0f};
+
+    const auto radius = ufps::light_radius(light);
+    const auto attenuation = light.constant_attenuation + (light.linear_attenuation * radius) +
+                             (light.quadratic_attenuation * radius * radius);
+
+    ASSERT_GT(radius, 0.0f);
+    ASSERT_NEAR(light.intensity / attenuation, 0.01f, 1e-4f);
+}
+
+TEST(light_clusters, cluster_bounds_cover_frustum)
+{
+    const auto camera = test_camera();
+
+    const auto first = ufps::cluster_bounds(camera, 0u, 0u, 0u);
+    const auto last = ufps::cluster_bounds(
+        camera,
+        ufps::LightClusterGrid::width - 1u,
+        ufps::LightClusterGrid::height - 1u,
+        ufps::LightClusterGrid::depth - 1u);
+
+    ASSERT_NEAR(first.max.z, -camera.near_plane(), 1e-4f);
+    ASSERT_NEAR(last.min.z, -camera.far_plane(), 1e-1f);
+    ASSERT_LT(first.min.x, 0.0f);
+    ASSERT_LT(first.min.y, 0.0f);
+    ASSERT_GT(last.max.x, 0.0f);
+    ASSERT_GT(last.max.y, 0.0f);
+}
+
+TEST(light_clusters, neighbouring_slices_overlap)
+{
+    const auto camera = test_camera();
+
+    for (auto z = 1u; z < ufps::LightClusterGrid::depth; ++z)
+    {
+        const auto nearer = ufps::cluster_bounds(camera, 0u, 0u, z - 1u);
+        const auto further = ufps::cluster_bounds(camera, 0u, 0u, z);
+
+        ASSERT_LT(nearer.min.z, further.max.z);
+    }
+}
+
+TEST(light_clusters, no_lights)
+{
+    const auto result = ufps::cluster_lights(test_camera(), {});
+
+    ASSERT_EQ(result.clusters.size(), ufps::LightClusterGrid::count);
+    ASSERT_TRUE(result.light_indices.empty());
+    ASSERT_TRUE(std::ranges::all_of(result.clusters, [](const auto &c) { return c.count == 0u; }));
+}
+
+TEST(light_clusters, light_behind_camera_culled)
+{
+    const auto camera = test_camera();
+    const auto lights = std::vector<ufps::PointLight>{{
+        .position = camera.position() + ufps::Vector3{0.0f, 0.0f, 50.0f},
+        .colour = ufps::colours::white,
+        .constant_attenuation = 1.0f,
+        .linear_attenuation = 0.7f,
+        .quadratic_attenuation = 1.8f,
+        .intensity = 1.0f,
+    }};
+
+    const auto result = ufps::cluster_lights(camera, lights);
+
+    ASSERT_TRUE(result.light_indices.empty());
+}
+
+TEST(light_clusters, matches_brute_force)
+{
+    const auto camera = test_camera();
+    const auto lights = random_lights(1000u);
+
+    const auto result = ufps::cluster_lights(camera, lights);
+
+    ASSERT_EQ(result.clusters.size(), ufps::LightClusterGrid::count);
+    ASSERT_FALSE(result.light_indices.empty());
+    ASSERT_EQ(expand(result), brute_force(camera, lights));
+}
+
+TEST(light_clusters, parallel_matches_serial)
+{
+    const auto camera = test_camera();
+    const auto lights = random_lights(1000u);
+
+    auto pool = ufps::ThreadPool{4u};
+
+    const auto serial = ufps::cluster_lights(camera, lights);
+    const auto parallel = ufps::cluster_lights(camera, lights, pool);
+
+    ASSERT_EQ(serial.clusters, parallel.clusters);
+    ASSERT_EQ(serial.light_indices, parallel.light_indices);
+}
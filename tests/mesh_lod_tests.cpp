@@ -0,0 +1,75 @@
+#include <cmath>
+#include <numbers>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "core/camera.h"
+#include "graphics/mesh_lod.h"
+#include "graphics/mesh_view.h"
+
+namespace
+{
+
+auto test_lods() -> std::vector<ufps::MeshLod>
+{
+    return {
+        {.mesh_view = {.index_offset = 0u, .index_count = 3000u, .vertex_offset = 0u, .vertex_count = 1000u},
+         .error = 0.0f},
+        {.mesh_view = {.index_offset = 3000u, .index_count = 1500u, .vertex_offset = 1000u, .vertex_count = 500u},
+         .error = 0.01f},
+        {.mesh_view = {.index_offset = 4500u, .index_count = 750u, .vertex_offset = 1500u, .vertex_count = 250u},
+         .error = 0.1f},
+    };
+}
+
+}
+
+TEST(mesh_lod, projection_scale)
+{
+    const auto camera = ufps::Camera{
+        {0.0f, 0.0f, 0.0f},
+        {0.0f, 0.0f, -1.0f},
+        {0.0f, 1.0f, 0.0f},
+        std::numbers::pi_v<float> / 2.0f,
+        1920.0f,
+        1080.0f,
+        0.1f,
+        1000.0f};
+
+    // with a 90 degree fov a unit at a distance of one unit spans half the screen height
+    ASSERT_NEAR(ufps::lod_projection_scale(camera), 540.0f, 1e-2f);
+}
+
+TEST(mesh_lod, single_lod)
+{
+    const auto lods = std::vector<ufps::MeshLod>{{.mesh_view = {}, .error = 0.0f}};
+
+    ASSERT_EQ(ufps::select_lod(lods, 1000.0f, 1.0f, 540.0f), 0zu);
+}
+
+TEST(mesh_lod, inside_mesh_uses_full_detail)
+{
+    ASSERT_EQ(ufps::select_lod(test_lods(), 0.0f, 1.0f, 540.0f), 0zu);
+    ASSERT_EQ(ufps::select_lod(test_lods(), -1.0f, 1.0f, 540.0f), 0zu);
+}
+
+TEST(mesh_lod, coarser_with_distance)
+{
+    const auto lods = test_lods();
+
+    // error of 0.01 is one pixel at 5.4 units, error of 0.1 is one pixel at 54 units
+    ASSERT_EQ(ufps::select_lod(lods, 1.0f, 1.0f, 540.0f), 0zu);
+    ASSERT_EQ(ufps::select_lod(lods, 6.0f, 1.0f, 540.0f), 1zu);
+    ASSERT_EQ(ufps::select_lod(lods, 50.0f, 1.0f, 540.0f), 1zu);
+    ASSERT_EQ(ufps::select_lod(lods, 60.0f, 1.0f, 540.0f), 2zu);
+}
+
+TEST(mesh_lod, scale_and_threshold)
+{
+    const auto lods = test_lods();
+
+    ASSERT_EQ(ufps::select_lod(lods, 60.0f, 1.0f, 540.0f), 2zu);
+    ASSERT_EQ(ufps::select_lod(lods, 60.0f, 2.0f, 540.0f), 1zu);
+    ASSERT_EQ(ufps::select_lod(lods, 60.0f, 1.0f, 540.0f, 0.5f), 1zu);
+}
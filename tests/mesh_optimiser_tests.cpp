@@ -0,0 +1,302 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <ranges>
+#include <set>
+#include <tuple>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "graphics/mesh_data.h"
+#include "graphics/mesh_optimiser.h"
+#include "graphics/vertex_data.h"
+
+namespace
+{
+
+// a flat grid of quads, with every triangle given its own vertices when unwelded
+auto grid(std::uint32_t size, bool welded) -> ufps::MeshData
+{
+    auto mesh = ufps::MeshData{};
+
+    const auto vertex = [](std::uint32_t x, std::uint32_t y)
+    {
+        return ufps::VertexData{
+            .position = {static_cast<float>(x), static_cast<float>(y), 0.0f},
+            .normal = {0.0f, 0.0f, 1.0f},
+            .tangent = {1.0f, 0.0f, 0.0f},
+            .bitangent = {0.0f, 1.0f, 0.0f},
+            .uv = {.s = static_cast<float>(x), .t = static_cast<float>(y)},
+        };
+    };
+
+    if (welded)
+    {
+        for (auto y = 0u; y <= size; ++y)
+        {
+            for (auto x = 0u; x <= size; ++x)
+            {
+                mesh.vertices.push_back(vertex(x, y));
+            }
+        }
+    }
+
+    const auto index = [&](std::uint32_t x, std::uint32_t y)
+    {
+        if (welded)
+        {
+            return y * (size + 1u) + x;
+        }
+
+        mesh.vertices.push_back(vertex(x, y));
+        return static_cast<std::uint32_t>(mesh.vertices.size() - 1u);
+    };
+
+    for (auto y = 0u; y < size; ++y)
+    {
+        for (auto x = 0u; x < size; ++x)
+        {
+            mesh.indices.append_range(std::vector{index(x, y), index(x + 1u, y), index(x + 1u, y + 1u)});
+            mesh.indices.append_range(std::vector{index(x, y), index(x + 1u, y + 1u), index(x, y + 1u)});
+        }
+    }
+
+    return mesh;
+}
+
+auto shuffle_triangles(std::vector<std::uint32_t> indices) -> std::vector<std::uint32_t>
+{
+    auto triangles = indices | std::views::chunk(3) |
+                     std::views::transform([](auto t) { return std::tuple{t[0], t[1], t[2]}; }) |
+                     std::ranges::to<std::vector>();
+
+    std::ranges::shuffle(triangles, std::mt19937{42u});
+
+    auto shuffled = std::vector<std::uint32_t>{};
+    for (const auto &[a, b, c] : triangles)
+    {
+        shuffled.append_range(std::vector{a, b, c});
+    }
+
+    return shuffled;
+}
+
+// grid displaced by a gentle wave so simplification has some error to measure
+auto wavy_grid(std::uint32_t size) -> ufps::MeshData
+{
+    auto mesh = grid(size, true);
+
+    for (auto &vertex : mesh.vertices)
+    {
+        vertex.position.z = std::sin(vertex.position.x * 0.4f) * std::cos(vertex.position.y * 0.3f);
+    }
+
+    return mesh;
+}
+
+auto border_positions(const ufps::MeshData &mesh, float size) -> std::set<std::tuple<float, float>>
+{
+    return mesh.vertices | std::views::transform(&ufps::VertexData::position) |
+           std::views::filter([size](const auto &p)
+                              { return (p.x == 0.0f) || (p.y == 0.0f) || (p.x == size) || (p.y == size); }) |
+           std::views::transform([](const auto &p) { return std::tuple{p.x, p.y}; }) |
+           std::ranges::to<std::set>();
+}
+
+// triangles as sets of positions, independent of vertex and triangle order
+auto triangle_set(const ufps::MeshData &mesh) -> std::multiset<std::vector<float>>
+{
+    auto triangles = std::multiset<std::vector<float>>{};
+
+    for (const auto &triangle : mesh.indices | std::views::chunk(3))
+    {
+        auto positions = std::vector<float>{};
+        for (const auto index : triangle)
+        {
+            const auto &position = mesh.vertices[index].position;
+            positions.append_range(std::vector{position.x, position.y, position.z});
+        }
+
+        triangles.insert(positions);
+    }
+
+    return triangles;
+}
+
+}
+
+TEST(mesh_optimiser, analyse_worst_case)
+{
+    // no vertex is shared so every index misses
+    const auto mesh = grid(4u, false);
+    const auto stats = ufps::analyse_vertex_cache(mesh.indices, static_cast<std::uint32_t>(mesh.vertices.size()));
+
+    ASSERT_FLOAT_EQ(stats.acmr, 3.0f);
+    ASSERT_FLOAT_EQ(stats.atvr, 1.0f);
+}
+
+TEST(mesh_optimiser, analyse_single_triangle_reuse)
+{
+    const auto indices = std::vector<std::uint32_t>{0u, 1u, 2u, 2u, 1u, 3u};
+    const auto stats = ufps::analyse_vertex_cache(indices, 4u);
+
+    ASSERT_FLOAT_EQ(stats.acmr, 2.0f);
+    ASSERT_FLOAT_EQ(stats.atvr, 1.0f);
+}
+
+TEST(mesh_optimiser, deduplicate_merges_identical_vertices)
+{
+    const auto unwelded = grid(4u, false);
+    const auto welded = grid(4u, true);
+
+    const auto result = ufps::deduplicate_vertices(unwelded);
+
+    ASSERT_EQ(result.vertices.size(), welded.vertices.size());
+    ASSERT_EQ(result.indices.size(), unwelded.indices.size());
+    ASSERT_EQ(triangle_set(result), triangle_set(unwelded));
+}
+
+TEST(mesh_optimiser, vertex_cache_keeps_triangles)
+{
+    auto mesh = grid(16u, true);
+    mesh.indices = shuffle_triangles(mesh.indices);
+
+    const auto original = triangle_set(mesh);
+    mesh.indices = ufps::optimise_vertex_cache(mesh.indices, static_cast<std::uint32_t>(mesh.vertices.size()));
+
+    ASSERT_EQ(triangle_set(mesh), original);
+}
+
+TEST(mesh_optimiser, vertex_cache_improves_acmr)
+{
+    const auto vertex_count = static_cast<std::uint32_t>(grid(32u, true).vertices.size());
+    const auto shuffled = shuffle_triangles(grid(32u, true).indices);
+
+    const auto before = ufps::analyse_vertex_cache(shuffled, vertex_count);
+    const auto after = ufps::analyse_vertex_cache(ufps::optimise_vertex_cache(shuffled, vertex_count), vertex_count);
+
+    // a regular grid can approach 0.5, forsyth typically gets within ~0.8 with a 16 entry fifo
+    ASSERT_GT(before.acmr, 2.0f);
+    ASSERT_LT(after.acmr, 0.9f);
+    ASSERT_LT(after.atvr, before.atvr);
+}
+
+TEST(mesh_optimiser, overdraw_keeps_triangles_and_cache_efficiency)
+{
+    auto mesh = grid(32u, true);
+    const auto vertex_count = static_cast<std::uint32_t>(mesh.vertices.size());
+    mesh.indices = ufps::optimise_vertex_cache(shuffle_triangles(mesh.indices), vertex_count);
+
+    const auto original = triangle_set(mesh);
+    const auto before = ufps::analyse_vertex_cache(mesh.indices, vertex_count);
+
+    mesh.indices = ufps::optimise_overdraw(mesh.indices, mesh.vertices);
+    const auto after = ufps::analyse_vertex_cache(mesh.indices, vertex_count);
+
+    ASSERT_EQ(triangle_set(mesh), original);
+    ASSERT_LE(after.acmr, before.acmr * 1.05f);
+}
+
+TEST(mesh_optimiser, vertex_fetch_orders_by_first_use)
+{
+    auto mesh = grid(4u, true);
+    mesh.indices = shuffle_triangles(mesh.indices);
+
+    const auto result = ufps::optimise_vertex_fetch(mesh);
+
+    ASSERT_EQ(triangle_set(result), triangle_set(mesh));
+
+    auto next = 0u;
+    for (const auto index : result.indices)
+    {
+        ASSERT_LE(index, next);
+        next = std::max(next, index + 1u);
+    }
+}
+
+TEST(mesh_optimiser, vertex_fetch_drops_unreferenced)
+{
+    auto mesh = grid(2u, true);
+    mesh.vertices.push_back(mesh.vertices.front());
+
+    const auto result = ufps::optimise_vertex_fetch(mesh);
+
+    ASSERT_EQ(result.vertices.size(), mesh.vertices.size() - 1u);
+}
+
+TEST(mesh_optimiser, optimise_mesh)
+{
+    auto mesh = grid(32u, false);
+    mesh.indices = shuffle_triangles(mesh.indices);
+
+    const auto before = ufps::analyse_vertex_cache(mesh.indices, static_cast<std::uint32_t>(mesh.vertices.size()));
+
+    const auto [result, stages] = ufps::optimise_mesh(mesh);
+    const auto after = ufps::analyse_vertex_cache(result.indices, static_cast<std::uint32_t>(result.vertices.size()));
+
+    ASSERT_EQ(triangle_set(result), triangle_set(mesh));
+    ASSERT_EQ(result.vertices.size(), 33zu * 33zu);
+    ASSERT_LT(after.acmr, before.acmr);
+    ASSERT_LT(after.acmr, 0.9f);
+
+    ASSERT_EQ(stages.size(), 4zu);
+    ASSERT_EQ(stages.front().name, "deduplicate");
+    ASSERT_EQ(stages.back().name, "vertex fetch");
+    ASSERT_EQ(stages.back().vertex_count, result.vertices.size());
+    ASSERT_EQ(stages.back().statistics.acmr, after.acmr);
+
+    // reordering triangles for the cache is where the miss ratio drops
+    ASSERT_LT(stages[1].statistics.acmr, stages[0].statistics.acmr);
+}
+
+TEST(mesh_optimiser, simplify_flat_grid)
+{
+    const auto mesh = grid(16u, true);
+
+    const auto result = ufps::simplify_mesh(mesh, 0zu, 0.01f);
+
+    // only the border vertices are locked, everything inside a flat grid can be collapsed for free
+    ASSERT_LT(result.mesh.indices.size(), mesh.indices.size() / 4zu);
+    ASSERT_NEAR(result.error, 0.0f, 1e-4f);
+    ASSERT_EQ(border_positions(result.mesh, 16.0f), border_positions(mesh, 16.0f));
+}
+
+TEST(mesh_optimiser, simplify_stops_at_target)
+{
+    const auto mesh = grid(16u, true);
+
+    const auto result = ufps::simplify_mesh(mesh, mesh.indices.size() / 2zu, 0.01f);
+
+    ASSERT_LE(result.mesh.indices.size(), mesh.indices.size() / 2zu);
+    ASSERT_GT(result.mesh.indices.size(), mesh.indices.size() / 4zu);
+}
+
+TEST(mesh_optimiser, simplify_respects_max_error)
+{
+    const auto mesh = wavy_grid(32u);
+
+    const auto result = ufps::simplify_mesh(mesh, 0zu, 0.05f);
+
+    ASSERT_LT(result.mesh.indices.size(), mesh.indices.size());
+    ASSERT_GT(result.error, 0.0f);
+    ASSERT_LE(result.error, 0.05f);
+}
+
+TEST(mesh_optimiser, generate_lods)
+{
+    const auto mesh = wavy_grid(32u);
+
+    const auto lods = ufps::generate_lods(mesh);
+
+    ASSERT_FALSE(lods.empty());
+
+    auto previous = ufps::SimplifiedMesh{.mesh = mesh, .error = 0.0f};
+    for (const auto &lod : lods)
+    {
+        ASSERT_LT(lod.mesh.indices.size(), previous.mesh.indices.size());
+        ASSERT_GE(lod.error, previous.error);
+        previous = lod;
+    }
+}
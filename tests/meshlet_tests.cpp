@@ -0,0 +1,175 @@
+#include <algorithm>
+#include <cstdint>
+#include <numbers>
+#include <set>
+#include <tuple>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "core/camera.h"
+#include "graphics/mesh_data.h"
+#include "graphics/meshlet.h"
+#include "graphics/vertex_data.h"
+#include "maths/quaternion.h"
+#include "maths/transform.h"
+#include "maths/vector3.h"
+
+namespace
+{
+
+// 7x7 quads per face gives each face exactly 64 vertices and 98 triangles, so one meshlet
+constexpr auto face_quads = 7u;
+constexpr auto face_index_count = face_quads * face_quads * 6u;
+
+/**
+ * Axis aligned unit cube from -1 to 1, faces don't share vertices but do share edge positions so the mesh is closed.
+ * The face facing -z is last.
+ */
+auto cube() -> ufps::MeshData
+{
+    auto mesh = ufps::MeshData{};
+
+    // origin, u and v of each face, u x v points outwards
+    const auto faces = std::vector<std::tuple<ufps::Vector3, ufps::Vector3, ufps::Vector3>>{
+        {{-1.0f, -1.0f, 1.0f}, {2.0f, 0.0f, 0.0f}, {0.0f, 2.0f, 0.0f}},
+        {{1.0f, -1.0f, 1.0f}, {0.0f, 0.0f, -2.0f}, {0.0f, 2.0f, 0.0f}},
+        {{-1.0f, -1.0f, -1.0f}, {0.0f, 0.0f, 2.0f}, {0.0f, 2.0f, 0.0f}},
+        {{-1.0f, 1.0f, 1.0f}, {2.0f, 0.0f, 0.0f}, {0.0f, 0.0f, -2.0f}},
+        {{-1.0f, -1.0f, -1.0f}, {2.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 2.0f}},
+        {{1.0f, -1.0f, -1.0f}, {-2.0f, 0.0f, 0.0f}, {0.0f, 2.0f, 0.0f}},
+    };
+
+    for (const auto &[origin, u, v] : faces)
+    {
+        const auto first = static_cast<std::uint32_t>(mesh.vertices.size());
+
+        for (auto y = 0u; y <= face_quads; ++y)
+        {
+            for (auto x = 0u; x <= face_quads; ++x)
+            {
+                const auto s = static_cast<float>(x);
+                const auto t = static_cast<float>(y);
+                const auto n = static_cast<float>(face_quads);
+
+                // exact integer arithmetic until the final divide so faces agree on their shared edges
+                mesh.vertices.push_back({
+                    .position = ((origin * n) + (u * s) + (v * t)) / n,
+                    .normal = ufps::Vector3::normalise(ufps::Vector3::cross(u, v)),
+                    .tangent = ufps::Vector3::normalise(u),
+                    .bitangent = ufps::Vector3::normalise(v),
+                    .uv = {.s = s / n, .t = t / n},
+                });
+            }
+        }
+
+        for (auto y = 0u; y < face_quads; ++y)
+        {
+            for (auto x = 0u; x < face_quads; ++x)
+            {
+                const auto a = first + (y * (face_quads + 1u)) + x;
+                const auto b = a + face_quads + 1u;
+                mesh.indices.append_range(std::vector{a, a + 1u, b + 1u, a, b + 1u, b});
+            }
+        }
+    }
+
+    return mesh;
+}
+
+auto camera_at(const ufps::Vector3 &position, const ufps::Vector3 &look_at) -> ufps::Camera
+{
+    return {
+        position,
+        look_at,
+        {0.0f, 1.0f, 0.0f},
+        std::numbers::pi_v<float> / 4.0f,
+        1920.0f,
+        1080.0f,
+        0.1f,
+        1000.0f};
+}
+
+}
+
+TEST(meshlet, respects_limits_and_covers_mesh)
+{
+    const auto mesh = cube();
+    const auto meshlets = ufps::build_meshlets(mesh);
+
+    auto next = 0u;
+    for (const auto &meshlet : meshlets)
+    {
+        ASSERT_EQ(meshlet.index_offset, next);
+        ASSERT_LE(meshlet.index_count, ufps::meshlet_max_triangles * 3u);
+
+        const auto first = mesh.indices.begin() + meshlet.index_offset;
+        const auto vertices = std::set<std::uint32_t>(first, first + meshlet.index_count);
+        ASSERT_LE(vertices.size(), ufps::meshlet_max_vertices);
+
+        next += meshlet.index_count;
+    }
+
+    ASSERT_EQ(next, mesh.indices.size());
+}
+
+TEST(meshlet, closed_mesh_has_cones)
+{
+    const auto meshlets = ufps::build_meshlets(cube());
+
+    ASSERT_EQ(meshlets.size(), 6zu);
+
+    for (const auto &meshlet : meshlets)
+    {
+        ASSERT_EQ(meshlet.index_count, face_index_count);
+        ASSERT_NEAR(meshlet.radius, std::numbers::sqrt2_v<float>, 1e-5f);
+        ASSERT_NEAR(meshlet.cone_cutoff, 0.0f, 1e-5f);
+    }
+
+    ASSERT_NEAR(meshlets.back().cone_axis.z, -1.0f, 1e-5f);
+}
+
+TEST(meshlet, open_mesh_has_no_cones)
+{
+    auto mesh = cube();
+    mesh.indices.resize(mesh.indices.size() - face_index_count);
+
+    const auto meshlets = ufps::build_meshlets(mesh);
+
+    ASSERT_EQ(meshlets.size(), 5zu);
+    ASSERT_TRUE(std::ranges::all_of(meshlets, [](const auto &m) { return m.cone_cutoff == 1.0f; }));
+}
+
+TEST(meshlet, cull_back_facing)
+{
+    const auto meshlets = ufps::build_meshlets(cube());
+    const auto camera = camera_at({0.0f, 0.0f, 5.0f}, {0.0f, 0.0f, -1.0f});
+
+    const auto ranges = ufps::cull_meshlets(meshlets, {}, camera);
+
+    // only the face pointing away is culled, the rest are adjacent so merge into one range
+    ASSERT_EQ(ranges, (std::vector<ufps::IndexRange>{{.offset = 0u, .count = face_index_count * 5u}}));
+}
+
+TEST(meshlet, cull_outside_frustum)
+{
+    const auto meshlets = ufps::build_meshlets(cube());
+    const auto camera = camera_at({0.0f, 0.0f, 5.0f}, {0.0f, 0.0f, -1.0f});
+
+    const auto behind = ufps::Transform{{0.0f, 0.0f, 20.0f}, {1.0f}, {}};
+    const auto beside = ufps::Transform{{100.0f, 0.0f, 0.0f}, {1.0f}, {}};
+
+    ASSERT_TRUE(ufps::cull_meshlets(meshlets, behind, camera).empty());
+    ASSERT_TRUE(ufps::cull_meshlets(meshlets, beside, camera).empty());
+}
+
+TEST(meshlet, non_uniform_scale_disables_cones)
+{
+    const auto meshlets = ufps::build_meshlets(cube());
+    const auto camera = camera_at({0.0f, 0.0f, 5.0f}, {0.0f, 0.0f, -1.0f});
+
+    const auto stretched = ufps::Transform{{}, {1.0f, 2.0f, 1.0f}, {}};
+    const auto ranges = ufps::cull_meshlets(meshlets, stretched, camera);
+
+    ASSERT_EQ(ranges, (std::vector<ufps::IndexRange>{{.offset = 0u, .count = face_index_count * 6u}}));
+}
@@ -0,0 +1,149 @@
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "graphics/mip_chain.h"
+#include "graphics/texture_data.h"
+#include "utils/data_buffer.h"
+#include "utils/error.h"
+
+namespace
+{
+
+auto texture(std::uint32_t width, std::uint32_t height, ufps::TextureFormat format, std::vector<std::uint8_t> texels)
+    -> ufps::TextureData
+{
+    auto data = ufps::DataBuffer{};
+    for (const auto texel : texels)
+    {
+        data.push_back(static_cast<std::byte>(texel));
+    }
+
+    return {
+        .width = width,
+        .height = height,
+        .mip_levels = 1u,
+        .format = format,
+        .data = std::move(data),
+        .is_compressed = false,
+    };
+}
+
+auto texel(const ufps::TextureData &texture, std::size_t offset) -> std::uint8_t
+{
+    return std::to_integer<std::uint8_t>((*texture.data)[offset]);
+}
+
+}
+
+TEST(mip_chain, level_count)
+{
+    ASSERT_EQ(ufps::mip_level_count(1u, 1u), 1u);
+    ASSERT_EQ(ufps::mip_level_count(2u, 2u), 2u);
+    ASSERT_EQ(ufps::mip_level_count(1024u, 1024u), 11u);
+    ASSERT_EQ(ufps::mip_level_count(1024u, 16u), 11u);
+    ASSERT_EQ(ufps::mip_level_count(5u, 3u), 3u);
+}
+
+TEST(mip_chain, extent_clamps_to_one)
+{
+    ASSERT_EQ(ufps::mip_extent(1024u, 3u), 128u);
+    ASSERT_EQ(ufps::mip_extent(16u, 10u), 1u);
+    ASSERT_EQ(ufps::mip_extent(5u, 1u), 2u);
+}
+
+TEST(mip_chain, block_compressed_sizes)
+{
+    ASSERT_EQ(ufps::mip_level_size(ufps::TextureFormat::BC7, 256u, 256u), 64zu * 64zu * 16zu);
+
+    // levels smaller than a block still take a whole block
+    ASSERT_EQ(ufps::mip_level_size(ufps::TextureFormat::BC5U, 2u, 1u), 16zu);
+    ASSERT_EQ(ufps::mip_level_size(ufps::TextureFormat::BC7, 6u, 5u), 4zu * 16zu);
+
+    // 8x8 + 4x4 + 2x2 + 1x1 is 4 + 1 + 1 + 1 blocks
+    ASSERT_EQ(ufps::mip_chain_size(ufps::TextureFormat::BC7, 8u, 8u, 4u), 7zu * 16zu);
+}
+
+TEST(mip_chain, uncompressed_sizes)
+{
+    ASSERT_EQ(ufps::mip_level_size(ufps::TextureFormat::RGBA, 3u, 5u), 60zu);
+    ASSERT_EQ(ufps::mip_level_size(ufps::TextureFormat::RGB, 3u, 5u), 45zu);
+    ASSERT_EQ(ufps::mip_chain_size(ufps::TextureFormat::RED, 4u, 4u, 3u), 16zu + 4zu + 1zu);
+}
+
+TEST(mip_chain, generate_box_filter)
+{
+    // clang-format off
+    const auto source = texture(4u, 4u, ufps::TextureFormat::RED, {
+          0u,   0u, 100u, 200u,
+          0u,   0u,  50u, 250u,
+         40u,  40u,  10u,  10u,
+         40u,  40u,  20u,  20u,
+    });
+    // clang-format on
+
+    const auto mips = ufps::generate_mip_chain(source);
+
+    ASSERT_EQ(mips.mip_levels, 3u);
+    ASSERT_EQ(mips.data->size(), 16zu + 4zu + 1zu);
+
+    ASSERT_EQ(texel(mips, 16zu), 0u);
+    ASSERT_EQ(texel(mips, 17zu), 150u);
+    ASSERT_EQ(texel(mips, 18zu), 40u);
+    ASSERT_EQ(texel(mips, 19zu), 15u);
+    ASSERT_EQ(texel(mips, 20zu), 51u);
+}
+
+TEST(mip_chain, generate_odd_dimensions)
+{
+    const auto source = texture(3u, 1u, ufps::TextureFormat::RGBA, std::vector<std::uint8_t>(12zu, 255u));
+
+    const auto mips = ufps::generate_mip_chain(source);
+
+    ASSERT_EQ(mips.mip_levels, 2u);
+    ASSERT_EQ(mips.data->size(), 12zu + 4zu);
+    ASSERT_EQ(texel(mips, 12zu), 255u);
+}
+
+TEST(mip_chain, generate_srgb_filters_in_linear_space)
+{
+    const auto source = texture(2u, 1u, ufps::TextureFormat::SRGBA, {0u, 0u, 0u, 0u, 255u, 255u, 255u, 255u});
+
+    const auto mips = ufps::generate_mip_chain(source);
+
+    // half of full intensity in linear space is much brighter than 128 once encoded, alpha is never gamma encoded
+    ASSERT_EQ(texel(mips, 8zu), 188u);
+    ASSERT_EQ(texel(mips, 11zu), 128u);
+}
+
+TEST(mip_chain, chain_from_level)
+{
+    const auto source = texture(4u, 2u, ufps::TextureFormat::RED, {0u, 0u, 40u, 40u, 0u, 0u, 40u, 40u});
+    const auto mips = ufps::generate_mip_chain(source);
+
+    const auto tail = ufps::mip_chain_from(mips, 1u);
+
+    ASSERT_EQ(tail.width, 2u);
+    ASSERT_EQ(tail.height, 1u);
+    ASSERT_EQ(tail.mip_levels, 2u);
+    ASSERT_EQ(tail.data->size(), 2zu + 1zu);
+    ASSERT_EQ(texel(tail, 0zu), 0u);
+    ASSERT_EQ(texel(tail, 1zu), 40u);
+    ASSERT_EQ(texel(tail, 2zu), 20u);
+
+    // the tail is a view of the chain, not a copy of it
+    ASSERT_EQ(tail.data->data(), mips.data->data() + 8zu);
+
+    ASSERT_THROW(ufps::mip_chain_from(mips, 3u), ufps::Exception);
+}
+
+TEST(mip_chain, generate_rejects_compressed)
+{
+    auto source = texture(4u, 4u, ufps::TextureFormat::BC7, std::vector<std::uint8_t>(16zu));
+    source.is_compressed = true;
+
+    ASSERT_THROW(ufps::generate_mip_chain(source), ufps::Exception);
+}
@@ -6,6 +6,7 @@
 
 #include <gtest/gtest.h>
 
+#include "fake_fence.h"
 #include "graphics/multi_buffer.h"
 #include "utils/data_buffer.h"
 
@@ -45,7 +46,7 @@ TEST(multi_frame, single_write)
     auto data = ufps::DataBuffer{std::byte{0x0}, std::byte{0x1}, std::byte{0x2}};
     auto data_view = ufps::DataBufferView{data};
 
-    auto mb = ufps::MultiBuffer<FakeBuffer, 3zu>{data_view.size_bytes(), "test_buffer"sv};
+    auto mb = ufps::MultiBuffer<FakeBuffer, 3zu, FakeFence>{data_view.size_bytes(), "test_buffer"sv};
     mb.write(data_view, 0);
 
     const auto &buffer = mb.buffer();
@@ -62,7 +63,7 @@ TEST(multi_frame, triple_write)
     auto data = ufps::DataBuffer{std::byte{0x0}, std::byte{0x1}, std::byte{0x2}};
     auto data_view = ufps::DataBufferView{data};
 
-    auto mb = ufps::MultiBuffer<FakeBuffer, 3zu>{data_view.size_bytes(), "test_buffer"};
+    auto mb = ufps::MultiBuffer<FakeBuffer, 3zu, FakeFence>{data_view.size_bytes(), "test_buffer"};
     mb.write(data_view, 0);
     mb.advance();
     mb.write(data_view, 0);
@@ -86,7 +87,7 @@ TEST(multi_frame, quad_write)
     auto data = ufps::DataBuffer{std::byte{0x0}, std::byte{0x1}, std::byte{0x2}};
     auto data_view = ufps::DataBufferView{data};
 
-    auto mb = ufps::MultiBuffer<FakeBuffer, 3zu>{data_view.size_bytes(), "test_buffer"};
+    auto mb = ufps::MultiBuffer<FakeBuffer, 3zu, FakeFence>{data_view.size_bytes(), "test_buffer"};
     mb.write(data_view, 0);
     ASSERT_EQ(mb.frame_offset_bytes(), 0zu);
     mb.advance();
@@ -117,7 +118,7 @@ TEST(multi_frame, multi_write_offset)
     auto data = ufps::DataBuffer{std::byte{0x0}, std::byte{0x1}, std::byte{0x2}, std::byte{0x3}, std::byte{0x4}};
     auto data_view = ufps::DataBufferView{data};
 
-    auto mb = ufps::MultiBuffer<FakeBuffer, 3zu>{data_view.size_bytes(), "test_buffer"};
+    auto mb = ufps::MultiBuffer<FakeBuffer, 3zu, FakeFence>{data_view.size_bytes(), "test_buffer"};
     mb.write(data_view, 1);
     mb.advance();
     mb.write(data_view, 2);
@@ -138,3 +139,37 @@ TEST(multi_frame, multi_write_offset)
     ASSERT_EQ(buffer.size(), data_view.size_bytes() * 3zu);
     ASSERT_EQ(buffer.write_calls, expected);
 }
+
+TEST(multi_frame, advance_waits_for_oldest_frame)
+{
+    FakeGpu::reset();
+
+    auto mb = ufps::MultiBuffer<FakeBuffer, 3zu, FakeFence>{8zu, "test_buffer"};
+
+    // first lap, no frame has been submitted before so nothing to wait on
+    mb.advance();
+    mb.advance();
+    ASSERT_TRUE(FakeGpu::waits.empty());
+
+    // back to the first frame, must wait for the fence inserted after it was used
+    mb.advance();
+    ASSERT_EQ(FakeGpu::waits, std::vector{0zu});
+
+    mb.advance();
+    ASSERT_EQ(FakeGpu::waits, (std::vector{0zu, 1zu}));
+}
+
+TEST(multi_frame, frame_index)
+{
+    FakeGpu::reset();
+
+    auto mb = ufps::MultiBuffer<FakeBuffer, 3zu, FakeFence>{8zu, "test_buffer"};
+
+    ASSERT_EQ(mb.frame_index(), 0zu);
+    mb.advance();
+    ASSERT_EQ(mb.frame_index(), 1zu);
+    mb.advance();
+    ASSERT_EQ(mb.frame_index(), 2zu);
+    mb.advance();
+    ASSERT_EQ(mb.frame_index(), 0zu);
+}
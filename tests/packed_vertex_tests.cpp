@@ -0,0 +1,128 @@
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include "graphics/packed_vertex.h"
+#include "graphics/vertex_data.h"
+#include "maths/vector3.h"
+
+namespace
+{
+
+// distance between a unit vector and its octahedral snorm16 round trip, i.e. roughly the angle in radians (~0.006
+// degrees), the measured worst case is ~6.5e-5
+constexpr auto max_direction_error = 1e-4f;
+
+auto random_unit(std::mt19937 &generator) -> ufps::Vector3
+{
+    auto dist = std::uniform_real_distribution<float>{-1.0f, 1.0f};
+
+    for (;;)
+    {
+        const auto v = ufps::Vector3{dist(generator), dist(generator), dist(generator)};
+        if (const auto length = v.length(); (length > 0.1f) && (length <= 1.0f))
+        {
+            return ufps::Vector3::normalise(v);
+        }
+    }
+}
+
+auto random_vertex(std::mt19937 &generator) -> ufps::VertexData
+{
+    auto position = std::uniform_real_distribution<float>{-100.0f, 100.0f};
+    auto uv = std::uniform_real_distribution<float>{0.0f, 1.0f};
+    auto flip = std::bernoulli_distribution{0.5};
+
+    const auto normal = random_unit(generator);
+    const auto tangent = ufps::Vector3::normalise(ufps::Vector3::cross(normal, random_unit(generator)));
+    const auto bitangent = ufps::Vector3::cross(normal, tangent);
+
+    return {
+        .position = {position(generator), position(generator), position(generator)},
+        .normal = normal,
+        .tangent = tangent,
+        .bitangent = flip(generator) ? -bitangent : bitangent,
+        .uv = {.s = uv(generator), .t = uv(generator)},
+    };
+}
+
+}
+
+TEST(packed_vertex, octahedral_axes_exact)
+{
+    for (const auto &axis : {ufps::Vector3{1.0f, 0.0f, 0.0f},
+                             ufps::Vector3{-1.0f, 0.0f, 0.0f},
+                             ufps::Vector3{0.0f, 1.0f, 0.0f},
+                             ufps::Vector3{0.0f, -1.0f, 0.0f},
+                             ufps::Vector3{0.0f, 0.0f, 1.0f},
+                             ufps::Vector3{0.0f, 0.0f, -1.0f}})
+    {
+        const auto decoded = ufps::octahedral_decode(ufps::octahedral_encode(axis));
+
+        ASSERT_NEAR(decoded.x, axis.x, 1e-6f);
+        ASSERT_NEAR(decoded.y, axis.y, 1e-6f);
+        ASSERT_NEAR(decoded.z, axis.z, 1e-6f);
+    }
+}
+
+TEST(packed_vertex, octahedral_zero_length_is_up)
+{
+    const auto up = ufps::octahedral_encode({0.0f, 0.0f, 1.0f});
+    ASSERT_EQ(ufps::octahedral_encode({0.0f, 0.0f, 0.0f}), up);
+    ASSERT_EQ(ufps::octahedral_encode({-0.0f, 0.0f, -0.0f}), up);
+
+    const auto decoded = ufps::octahedral_decode(up);
+    ASSERT_NEAR(decoded.z, 1.0f, 1e-6f);
+}
+
+TEST(packed_vertex, octahedral_error_bounded)
+{
+    auto generator = std::mt19937{42u};
+
+    for (auto i = 0u; i < 100000u; ++i)
+    {
+        const auto v = random_unit(generator);
+        const auto decoded = ufps::octahedral_decode(ufps::octahedral_encode(v));
+
+        ASSERT_NEAR(decoded.length(), 1.0f, 1e-5f);
+        ASSERT_LT((v - decoded).length(), max_direction_error);
+    }
+}
+
+TEST(packed_vertex, round_trip_error_bounded)
+{
+    auto generator = std::mt19937{42u};
+
+    for (auto i = 0u; i < 10000u; ++i)
+    {
+        const auto vertex = random_vertex(generator);
+        const auto decoded = ufps::unpack_vertex(ufps::pack_vertex(vertex));
+
+        ASSERT_EQ(decoded.position, vertex.position);
+        ASSERT_LT((vertex.normal - decoded.normal).length(), max_direction_error);
+
+        // the tangent gives up a bit of precision to store the bitangent sign and the bitangent is rebuilt from the
+        // other two, so both can be off by roughly twice as much
+        ASSERT_LT((vertex.tangent - decoded.tangent).length(), max_direction_error * 2.0f);
+        ASSERT_LT((vertex.bitangent - decoded.bitangent).length(), max_direction_error * 2.0f);
+
+        // half floats have 11 bits of precision, i.e. an error of at most 2^-11 relative to values in [0.5, 1)
+        ASSERT_NEAR(decoded.uv.s, vertex.uv.s, 1.0f / 2048.0f);
+        ASSERT_NEAR(decoded.uv.t, vertex.uv.t, 1.0f / 2048.0f);
+    }
+}
+
+TEST(packed_vertex, bitangent_sign_preserved)
+{
+    const auto vertex = ufps::VertexData{
+        .position = {},
+        .normal = {0.0f, 0.0f, 1.0f},
+        .tangent = {1.0f, 0.0f, 0.0f},
+        .bitangent = {0.0f, -1.0f, 0.0f},
+        .uv = {.s = 0.0f, .t = 0.0f},
+    };
+
+    const auto decoded = ufps::unpack_vertex(ufps::pack_vertex(vertex));
+
+    ASSERT_NEAR(decoded.bitangent.y, -1.0f, 1e-4f);
+}
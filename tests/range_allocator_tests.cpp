@@ -0,0 +1,111 @@
+#include <cstdint>
+#include <optional>
+
+#include <gtest/gtest.h>
+
+#include "utils/range_allocator.h"
+
+TEST(range_allocator, ctor)
+{
+    const auto allocator = ufps::RangeAllocator{100u};
+
+    ASSERT_EQ(allocator.capacity(), 100u);
+    ASSERT_EQ(allocator.used(), 0u);
+    ASSERT_EQ(allocator.largest_free(), 100u);
+    ASSERT_EQ(allocator.free_range_count(), 1zu);
+}
+
+TEST(range_allocator, allocate_sequential)
+{
+    auto allocator = ufps::RangeAllocator{100u};
+
+    ASSERT_EQ(allocator.allocate(10u), std::optional{0u});
+    ASSERT_EQ(allocator.allocate(20u), std::optional{10u});
+    ASSERT_EQ(allocator.used(), 30u);
+    ASSERT_EQ(allocator.largest_free(), 70u);
+}
+
+TEST(range_allocator, allocate_too_large)
+{
+    auto allocator = ufps::RangeAllocator{100u};
+
+    ASSERT_EQ(allocator.allocate(101u), std::nullopt);
+    ASSERT_EQ(allocator.allocate(100u), std::optional{0u});
+    ASSERT_EQ(allocator.allocate(1u), std::nullopt);
+    ASSERT_EQ(allocator.free_range_count(), 0zu);
+}
+
+TEST(range_allocator, free_reuses_gap)
+{
+    auto allocator = ufps::RangeAllocator{100u};
+
+    allocator.allocate(10u);
+    const auto middle = allocator.allocate(10u);
+    allocator.allocate(10u);
+
+    allocator.free(*middle, 10u);
+
+    ASSERT_EQ(allocator.free_range_count(), 2zu);
+    ASSERT_EQ(allocator.allocate(5u), std::optional{10u});
+    ASSERT_EQ(allocator.allocate(10u), std::optional{30u});
+}
+
+TEST(range_allocator, free_coalesces_neighbours)
+{
+    auto allocator = ufps::RangeAllocator{30u};
+
+    const auto first = allocator.allocate(10u);
+    const auto second = allocator.allocate(10u);
+    const auto third = allocator.allocate(10u);
+
+    allocator.free(*first, 10u);
+    allocator.free(*third, 10u);
+    ASSERT_EQ(allocator.free_range_count(), 2zu);
+
+    allocator.free(*second, 10u);
+    ASSERT_EQ(allocator.free_range_count(), 1zu);
+    ASSERT_EQ(allocator.largest_free(), 30u);
+    ASSERT_EQ(allocator.used(), 0u);
+}
+
+TEST(range_allocator, grow_merges_trailing_gap)
+{
+    auto allocator = ufps::RangeAllocator{30u};
+
+    allocator.allocate(20u);
+    allocator.grow(60u);
+
+    ASSERT_EQ(allocator.capacity(), 60u);
+    ASSERT_EQ(allocator.used(), 20u);
+    ASSERT_EQ(allocator.free_range_count(), 1zu);
+    ASSERT_EQ(allocator.allocate(40u), std::optional{20u});
+}
+
+TEST(range_allocator, grow_when_full)
+{
+    auto allocator = ufps::RangeAllocator{10u};
+
+    allocator.allocate(10u);
+    allocator.grow(20u);
+
+    ASSERT_EQ(allocator.allocate(10u), std::optional{10u});
+}
+
+TEST(range_allocator, is_packed)
+{
+    auto allocator = ufps::RangeAllocator{100u};
+    ASSERT_TRUE(allocator.is_packed());
+
+    ASSERT_EQ(allocator.allocate(10u), std::optional{0u});
+    ASSERT_EQ(allocator.allocate(20u), std::optional{10u});
+    ASSERT_TRUE(allocator.is_packed());
+
+    allocator.free(0u, 10u);
+    ASSERT_FALSE(allocator.is_packed());
+
+    allocator.free(10u, 20u);
+    ASSERT_TRUE(allocator.is_packed());
+
+    ASSERT_EQ(allocator.allocate(100u), std::optional{0u});
+    ASSERT_TRUE(allocator.is_packed());
+}
@@ -0,0 +1,127 @@
+#include <cstddef>
+#include <cstdint>
+#include <ranges>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "core/entity.h"
+#include "core/scene.h"
+#include "core/scene_snapshot.h"
+#include "graphics/point_light.h"
+#include "maths/matrix4.h"
+#include "maths/vector3.h"
+#include "utils/data_buffer.h"
+#include "utils/error.h"
+
+namespace
+{
+
+auto entity(const char *name, float x, std::size_t rigid_body_count) -> ufps::Entity::Description
+{
+    return {
+        .name = name,
+        .emissive_strength = x / 10.0f,
+        .transform = {{x, 0.0f, 0.0f}, {1.0f}, {}},
+        .aabb = {},
+        .rigid_bodies = std::views::repeat(
+                            ufps::RigidBody::Description{
+                                .local_transform = ufps::Matrix4{ufps::Vector3{0.0f, x, 0.0f}},
+                                .applied_scale = {1.0f},
+                            },
+                            rigid_body_count) |
+                        std::ranges::to<std::vector>(),
+    };
+}
+
+auto scene_description() -> ufps::Scene::Description
+{
+    auto description = ufps::Scene::Description{};
+    description.fog_options.density = 0.1f;
+    description.lights.ambient = {.r = 0.1f, .g = 0.2f, .b = 0.3f};
+    description.lights.lights.emplace(
+        ufps::PointLight{
+            .position = {1.0f, 2.0f, 3.0f},
+            .colour = {.r = 1.0f, .g = 0.5f, .b = 0.25f},
+            .constant_attenuation = 1.0f,
+            .linear_attenuation = 0.35f,
+            .quadratic_attenuation = 0.44f,
+            .intensity = 2.0f,
+        });
+    description.entities = {entity("crate", 1.0f, 1zu), entity("barrel", 2.0f, 0zu), entity("crate", 3.0f, 2zu)};
+
+    return description;
+}
+
+}
+
+TEST(scene_snapshot, round_trip)
+{
+    const auto description = scene_description();
+
+    const auto data = ufps::encode_scene_snapshot(description);
+    const auto snapshot = ufps::SceneSnapshot{data};
+
+    // each prefab name is only stored once
+    ASSERT_EQ(snapshot.prefabs().size(), 2zu);
+    ASSERT_EQ(snapshot.entities().size(), description.entities.size());
+    ASSERT_EQ(snapshot.rigid_bodies().size(), 3zu);
+
+    for (const auto &[actual, expected] : std::views::zip(snapshot.entities(), description.entities))
+    {
+        ASSERT_EQ(snapshot.prefab_name(snapshot.prefabs()[actual.prefab]), expected.name);
+        ASSERT_EQ(actual.transform.position, expected.transform.position);
+        ASSERT_EQ(actual.emissive_strength, expected.emissive_strength);
+        ASSERT_EQ(actual.rigid_body_count, expected.rigid_bodies.size());
+
+        for (const auto &[rigid_body, expected_rigid_body] : std::views::zip(
+                 snapshot.rigid_bodies().subspan(actual.first_rigid_body, actual.rigid_body_count),
+                 expected.rigid_bodies))
+        {
+            ASSERT_EQ(ufps::Matrix4{rigid_body.local_transform}, expected_rigid_body.local_transform);
+        }
+    }
+
+    ASSERT_EQ(snapshot.lights().size(), 1zu);
+    ASSERT_EQ(snapshot.lights()[0].position, description.lights.lights.data()[0].position);
+    ASSERT_EQ(snapshot.lights()[0].intensity, description.lights.lights.data()[0].intensity);
+
+    const auto settings = snapshot.settings();
+    ASSERT_EQ(settings.fog_options.density, description.fog_options.density);
+    ASSERT_EQ(settings.lights.ambient.b, description.lights.ambient.b);
+    ASSERT_TRUE(settings.lights.lights.empty());
+    ASSERT_TRUE(settings.entities.empty());
+}
+
+TEST(scene_snapshot, empty)
+{
+    const auto data = ufps::encode_scene_snapshot({});
+    const auto snapshot = ufps::SceneSnapshot{data};
+
+    ASSERT_TRUE(snapshot.lights().empty());
+    ASSERT_TRUE(snapshot.entities().empty());
+    ASSERT_TRUE(snapshot.prefabs().empty());
+}
+
+TEST(scene_snapshot, invalid_snapshot)
+{
+    ASSERT_THROW(ufps::SceneSnapshot{ufps::DataBuffer{}}, ufps::Exception);
+    ASSERT_THROW(ufps::SceneSnapshot{ufps::DataBuffer(64zu, std::byte{0x2a})}, ufps::Exception);
+
+    auto data = ufps::encode_scene_snapshot(scene_description());
+    data.resize(data.size() - 1zu);
+
+    ASSERT_THROW(ufps::SceneSnapshot{data}, ufps::Exception);
+}
+
+TEST(scene_snapshot, invalid_record)
+{
+    auto data = ufps::encode_scene_snapshot(scene_description());
+
+    // point the first entity at a prefab which doesn't exist
+    auto *entity = reinterpret_cast<ufps::SceneSnapshotEntity *>(
+        data.data() + sizeof(ufps::SceneSnapshotHeader) + sizeof(ufps::PointLight));
+    entity->prefab = 100u;
+
+    ASSERT_THROW(ufps::SceneSnapshot{data}, ufps::Exception);
+}
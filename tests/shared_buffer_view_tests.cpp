@@ -0,0 +1,62 @@
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <utility>
+
+#include <gtest/gtest.h>
+
+#include "utils/data_buffer.h"
+#include "utils/error.h"
+#include "utils/shared_buffer_view.h"
+
+TEST(shared_buffer_view, takes_ownership_without_copying)
+{
+    auto buffer = ufps::DataBuffer{std::byte{1}, std::byte{2}, std::byte{3}};
+    const auto *data = buffer.data();
+
+    const auto view = ufps::SharedBufferView{std::move(buffer)};
+
+    ASSERT_EQ(view.data(), data);
+    ASSERT_EQ(view.size(), 3zu);
+    ASSERT_EQ(view[2], std::byte{3});
+}
+
+TEST(shared_buffer_view, views_caller_memory)
+{
+    const auto buffer = ufps::DataBuffer{std::byte{1}, std::byte{2}, std::byte{3}};
+
+    const auto view = ufps::SharedBufferView{ufps::DataBufferView{buffer}};
+
+    ASSERT_EQ(view.data(), buffer.data());
+    ASSERT_EQ(view, (ufps::SharedBufferView{ufps::DataBuffer{std::byte{1}, std::byte{2}, std::byte{3}}}));
+}
+
+TEST(shared_buffer_view, sub_views_keep_owner_alive)
+{
+    auto owner = std::make_shared<ufps::DataBuffer>(ufps::DataBuffer{std::byte{1}, std::byte{2}, std::byte{3}});
+    const auto weak = std::weak_ptr{owner};
+
+    auto sub_view = std::optional<ufps::SharedBufferView>{};
+
+    {
+        const auto view = ufps::SharedBufferView{owner, *owner};
+        owner.reset();
+
+        sub_view = view.subspan(1zu, 2zu);
+    }
+
+    ASSERT_FALSE(weak.expired());
+    ASSERT_EQ(sub_view->size(), 2zu);
+    ASSERT_EQ((*sub_view)[0], std::byte{2});
+
+    sub_view.reset();
+    ASSERT_TRUE(weak.expired());
+}
+
+TEST(shared_buffer_view, sub_view_out_of_range)
+{
+    const auto view = ufps::SharedBufferView{ufps::DataBuffer(4zu)};
+
+    ASSERT_EQ(view.subspan(4zu, 0zu).size(), 0zu);
+    ASSERT_THROW(view.subspan(2zu, 3zu), ufps::Exception);
+}
@@ -1,3 +1,7 @@
+#include <cstddef>
+#include <utility>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 #include "core/sparse_set.h"
@@ -282,3 +286,65 @@ TEST(sparse_set, reuse_handle)
     ASSERT_TRUE(!!s[h2]);
     ASSERT_EQ(*s[h2], 2000);
 }
+
+TEST(sparse_set, emplace_marks_dirty)
+{
+    auto s = ufps::SparseSet<int>{};
+    s.emplace(2);
+    s.emplace(20);
+
+    ASSERT_EQ(s.dirty_indices(), (std::vector<std::size_t>{0zu, 1zu}));
+
+    s.clear_dirty();
+
+    ASSERT_TRUE(s.dirty_indices().empty());
+}
+
+TEST(sparse_set, mutable_access_marks_dirty)
+{
+    auto s = ufps::SparseSet<int>{};
+    s.emplace(2);
+    const auto h = s.emplace(20);
+    s.emplace(200);
+    s.clear_dirty();
+
+    *s[h] = 30;
+
+    ASSERT_EQ(s.dirty_indices(), (std::vector<std::size_t>{1zu}));
+}
+
+TEST(sparse_set, const_access_does_not_mark_dirty)
+{
+    auto s = ufps::SparseSet<int>{};
+    const auto h = s.emplace(2);
+    s.clear_dirty();
+
+    ASSERT_EQ(*std::as_const(s)[h], 2);
+    ASSERT_TRUE(s.dirty_indices().empty());
+}
+
+TEST(sparse_set, remove_marks_moved_element_dirty)
+{
+    auto s = ufps::SparseSet<int>{};
+    const auto h = s.emplace(2);
+    s.emplace(20);
+    s.emplace(200);
+    s.clear_dirty();
+
+    s.remove(h);
+
+    ASSERT_EQ(s.dirty_indices(), (std::vector<std::size_t>{0zu}));
+    ASSERT_EQ(s.data()[0], 200);
+}
+
+TEST(sparse_set, remove_last_is_not_dirty)
+{
+    auto s = ufps::SparseSet<int>{};
+    s.emplace(2);
+    const auto h = s.emplace(20);
+    s.clear_dirty();
+
+    s.remove(h);
+
+    ASSERT_TRUE(s.dirty_indices().empty());
+}
@@ -0,0 +1,148 @@
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "graphics/texture_residency.h"
+
+namespace
+{
+
+// 8x8 rgba texture, the last two levels are the tail
+const auto level_sizes = std::vector{64zu, 16zu, 4zu, 1zu};
+
+auto residency(std::size_t vram_budget, std::size_t upload_budget) -> ufps::TextureResidency
+{
+    return ufps::TextureResidency{{.vram_budget = vram_budget, .upload_budget = upload_budget, .tail_levels = 2u}};
+}
+
+// source data arriving just before the request, as it would from the streamer
+auto request_loaded(ufps::TextureResidency &residency, std::uint32_t texture, std::uint32_t level) -> void
+{
+    residency.set_loaded(texture, true);
+    residency.request(texture, level);
+}
+
+}
+
+TEST(texture_residency, desired_mip_level)
+{
+    ASSERT_EQ(ufps::desired_mip_level(1024u, 1024u, 1024.0f), 0u);
+    ASSERT_EQ(ufps::desired_mip_level(1024u, 1024u, 4096.0f), 0u);
+    ASSERT_EQ(ufps::desired_mip_level(1024u, 1024u, 512.0f), 1u);
+    ASSERT_EQ(ufps::desired_mip_level(1024u, 512u, 100.0f), 3u);
+    ASSERT_EQ(ufps::desired_mip_level(1024u, 1024u, 0.01f), 10u);
+    ASSERT_EQ(ufps::desired_mip_level(1024u, 1024u, 0.0f), 10u);
+    ASSERT_EQ(ufps::desired_mip_level(1024u, 1024u, std::numeric_limits<float>::infinity()), 0u);
+}
+
+TEST(texture_residency, only_tail_starts_resident)
+{
+    auto res = residency(1024zu, 1024zu);
+
+    const auto texture = res.add(level_sizes);
+    const auto single_level = res.add(std::vector{16zu});
+
+    ASSERT_EQ(res.resident_level(texture), 2u);
+    ASSERT_EQ(res.resident_level(single_level), 0u);
+    ASSERT_EQ(res.resident_bytes(), 4zu + 1zu + 16zu);
+}
+
+TEST(texture_residency, streams_requested_levels_once_loaded)
+{
+    auto res = residency(1024zu, 1024zu);
+    const auto texture = res.add(level_sizes);
+
+    res.request(texture, 0u);
+    const auto unloaded = res.update();
+
+    ASSERT_EQ(unloaded.loads, std::vector{texture});
+    ASSERT_TRUE(unloaded.changes.empty());
+
+    res.set_loaded(texture, true);
+    res.request(texture, 0u);
+    const auto loaded = res.update();
+
+    ASSERT_TRUE(loaded.loads.empty());
+    ASSERT_EQ(loaded.changes, (std::vector<ufps::ResidencyChange>{{.texture = texture, .resident_level = 0u}}));
+    ASSERT_EQ(loaded.unloads, std::vector{texture});
+    ASSERT_EQ(loaded.upload_bytes, 64zu + 16zu);
+    ASSERT_EQ(res.resident_bytes(), 64zu + 16zu + 4zu + 1zu);
+}
+
+TEST(texture_residency, upload_budget_spreads_levels_over_frames)
+{
+    auto res = residency(1024zu, 20zu);
+    const auto texture = res.add(level_sizes);
+
+    request_loaded(res, texture, 0u);
+    ASSERT_EQ(res.update().upload_bytes, 16zu);
+    ASSERT_EQ(res.resident_level(texture), 1u);
+
+    // a level larger than the whole budget still gets uploaded on its own
+    request_loaded(res, texture, 0u);
+    ASSERT_EQ(res.update().upload_bytes, 64zu);
+    ASSERT_EQ(res.resident_level(texture), 0u);
+}
+
+TEST(texture_residency, least_recently_used_evicted_for_visible)
+{
+    auto res = residency(100zu, 1024zu);
+    const auto old_texture = res.add(level_sizes);
+    const auto new_texture = res.add(level_sizes);
+
+    request_loaded(res, old_texture, 0u);
+    res.update();
+    ASSERT_EQ(res.resident_bytes(), 90zu);
+
+    request_loaded(res, new_texture, 0u);
+    const auto plan = res.update();
+
+    ASSERT_EQ(res.resident_level(old_texture), 2u);
+    ASSERT_EQ(res.resident_level(new_texture), 0u);
+    ASSERT_EQ(plan.evicted_bytes, 64zu + 16zu);
+    ASSERT_EQ(res.resident_bytes(), 90zu);
+}
+
+TEST(texture_residency, visible_textures_do_not_evict_each_other)
+{
+    auto res = residency(100zu, 1024zu);
+    const auto first = res.add(level_sizes);
+    const auto second = res.add(level_sizes);
+
+    request_loaded(res, first, 0u);
+    request_loaded(res, second, 0u);
+    res.update();
+
+    // the finest level of either would go over budget and neither is allowed to evict the other to make room
+    ASSERT_EQ(res.resident_level(first), 1u);
+    ASSERT_EQ(res.resident_level(second), 1u);
+
+    request_loaded(res, first, 0u);
+    request_loaded(res, second, 0u);
+    const auto plan = res.update();
+
+    ASSERT_TRUE(plan.changes.empty());
+    ASSERT_EQ(plan.evicted_bytes, 0zu);
+}
+
+TEST(texture_residency, visible_textures_give_up_detail_they_no_longer_want)
+{
+    auto res = residency(100zu, 1024zu);
+    const auto first = res.add(level_sizes);
+    const auto second = res.add(level_sizes);
+
+    request_loaded(res, first, 0u);
+    res.update();
+
+    // second can only fit its next level if first drops the level it stopped asking for
+    request_loaded(res, first, 1u);
+    request_loaded(res, second, 0u);
+    const auto plan = res.update();
+
+    ASSERT_EQ(res.resident_level(first), 1u);
+    ASSERT_EQ(res.resident_level(second), 1u);
+    ASSERT_EQ(plan.evicted_bytes, 64zu);
+}
@@ -1,14 +1,17 @@
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <cstdint>
 #include <ranges>
 #include <thread>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include <gtest/gtest.h>
 
 #include "concurrency/thread_pool.h"
+#include "utils/error.h"
 
 using namespace std::literals;
 
@@ -42,3 +45,36 @@ TEST(thread_pool, simple)
     ASSERT_EQ(thread_ids.size(), thread_ids_set.size());
     ASSERT_FALSE(std::ranges::any_of(thread_ids_set, [](const auto &e) { return e == std::this_thread::get_id(); }));
 }
+
+TEST(thread_pool, run_parallel)
+{
+    auto pool = ufps::ThreadPool{4u};
+    auto results = std::vector<std::uint32_t>(16u);
+
+    auto jobs = std::vector<ufps::Job>{};
+    for (auto i = 0u; i < results.size(); ++i)
+    {
+        jobs.push_back([i, &results] { results[i] = i * 2u; });
+    }
+
+    ufps::run_parallel(pool, std::move(jobs));
+
+    for (auto i = 0u; i < results.size(); ++i)
+    {
+        ASSERT_EQ(results[i], i * 2u);
+    }
+}
+
+TEST(thread_pool, run_parallel_rethrows)
+{
+    auto pool = ufps::ThreadPool{4u};
+    auto ran = std::atomic<std::uint32_t>{};
+
+    auto jobs = std::vector<ufps::Job>{};
+    jobs.push_back([&ran] { ++ran; });
+    jobs.push_back([] { throw ufps::Exception("job failed"); });
+    jobs.push_back([&ran] { ++ran; });
+
+    ASSERT_THROW(ufps::run_parallel(pool, std::move(jobs)), ufps::Exception);
+    ASSERT_EQ(ran.load(), 2u);
+}
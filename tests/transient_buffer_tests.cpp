@@ -0,0 +1,148 @@
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "fake_fence.h"
+#include "graphics/opengl.h"
+#include "graphics/transient_buffer.h"
+#include "utils/data_buffer.h"
+
+using namespace std::literals;
+
+namespace
+{
+
+class FakeBuffer
+{
+  public:
+    FakeBuffer(std::size_t size, std::string_view name)
+        : handle_{next_handle++}
+        , size_{size}
+        , name_{name}
+    {
+    }
+
+    auto write(ufps::DataBufferView data, std::size_t offset) -> void
+    {
+        write_calls.push_back({data.size_bytes(), offset});
+    }
+
+    auto native_handle() const -> ::GLuint
+    {
+        return handle_;
+    }
+
+    auto size() const -> std::size_t
+    {
+        return size_;
+    }
+
+    auto name() const -> std::string_view
+    {
+        return name_;
+    }
+
+    static inline ::GLuint next_handle = 1u;
+
+    std::vector<std::tuple<std::size_t, std::size_t>> write_calls;
+    ::GLuint handle_;
+    std::size_t size_;
+    std::string name_;
+};
+
+using TestBuffer = ufps::TransientBuffer<FakeBuffer, 3zu, FakeFence>;
+
+}
+
+TEST(transient_buffer, allocations_are_aligned)
+{
+    FakeGpu::reset();
+
+    auto buffer = TestBuffer{1024zu, 256zu, "test_buffer"sv};
+
+    const auto first = buffer.allocate(10zu);
+    const auto second = buffer.allocate(300zu);
+    const auto third = buffer.allocate(4zu);
+
+    ASSERT_EQ(first.offset, 0zu);
+    ASSERT_EQ(second.offset, 256zu);
+    ASSERT_EQ(third.offset, 768zu);
+    ASSERT_EQ(buffer.frame_used(), 1024zu);
+}
+
+TEST(transient_buffer, empty_allocation_is_bindable)
+{
+    FakeGpu::reset();
+
+    auto buffer = TestBuffer{1024zu, 16zu, "test_buffer"sv};
+
+    const auto allocation = buffer.allocate(0zu);
+
+    ASSERT_EQ(allocation.size, 16zu);
+}
+
+TEST(transient_buffer, frames_use_separate_regions)
+{
+    FakeGpu::reset();
+
+    auto buffer = TestBuffer{1024zu, 16zu, "test_buffer"sv};
+
+    ASSERT_EQ(buffer.allocate(16zu).offset, 0zu);
+    buffer.advance();
+    ASSERT_EQ(buffer.frame_used(), 0zu);
+    ASSERT_EQ(buffer.allocate(16zu).offset, 1024zu);
+    buffer.advance();
+    ASSERT_EQ(buffer.allocate(16zu).offset, 2048zu);
+    buffer.advance();
+    ASSERT_EQ(buffer.allocate(16zu).offset, 0zu);
+
+    ASSERT_EQ(FakeGpu::waits, std::vector{0zu});
+}
+
+TEST(transient_buffer, upload_writes_at_allocation)
+{
+    FakeGpu::reset();
+
+    auto data = ufps::DataBuffer(20zu);
+    auto buffer = TestBuffer{1024zu, 16zu, "test_buffer"sv};
+
+    buffer.advance();
+    buffer.upload(data);
+    const auto allocation = buffer.upload(data);
+
+    ASSERT_EQ(allocation.offset, 1024zu + 32zu);
+    ASSERT_EQ(allocation.size, 20zu);
+}
+
+TEST(transient_buffer, grows_when_frame_is_full)
+{
+    FakeGpu::reset();
+
+    auto buffer = TestBuffer{64zu, 16zu, "test_buffer"sv};
+
+    const auto first = buffer.allocate(48zu);
+    const auto second = buffer.allocate(48zu);
+
+    ASSERT_NE(first.buffer, second.buffer);
+    ASSERT_EQ(second.buffer, buffer.native_handle());
+    ASSERT_EQ(second.offset, 0zu);
+    ASSERT_EQ(buffer.frame_size(), 128zu);
+}
+
+TEST(transient_buffer, high_water_mark)
+{
+    FakeGpu::reset();
+
+    auto buffer = TestBuffer{1024zu, 16zu, "test_buffer"sv};
+
+    buffer.allocate(512zu);
+    buffer.advance();
+    buffer.allocate(16zu);
+
+    ASSERT_EQ(buffer.frame_used(), 16zu);
+    ASSERT_EQ(buffer.high_water_mark(), 512zu);
+}
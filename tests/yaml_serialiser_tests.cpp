@@ -63,6 +63,17 @@ struct FruitStruct
     auto operator==(const FruitStruct &) const -> bool = default;
 };
 
+struct Mixed
+{
+    int a;
+    std::string b;
+    std::vector<int> c;
+    std::unordered_map<std::string, Simple> d;
+    FruitStruct e;
+
+    auto operator==(const Mixed &) const -> bool = default;
+};
+
 TEST(yaml_serialisation, simple_struct)
 {
     const auto result = ufps::yaml::serialise(Simple{.a = 12});
@@ -319,3 +330,80 @@ TEST(yaml_deserialisation, invalid_yaml)
     const auto result = ufps::yaml::deserialise<FruitStruct>(yaml);
     ASSERT_FALSE(!!result);
 }
+
+TEST(yaml_deserialisation, matches_tree)
+{
+    // members out of order, unknown keys and a missing container
+    const auto yaml =
+        R"(Other: 1
+Mixed:
+  unknown: [1, 2, {x: y}]
+  e:
+    FruitStruct:
+      f: APPLE
+  d:
+    one:
+      Simple:
+        a: 1
+    two: {Simple: {a: 0x10}}
+  b: hello world
+  a: 12
+  a: 13)";
+    const auto result = ufps::yaml::deserialise<Mixed>(yaml);
+    const auto expected = Mixed{
+        .a = 12,
+        .b = "hello world",
+        .c = {},
+        .d = {{"one", {.a = 1}}, {"two", {.a = 16}}},
+        .e = {.f = Fruit::APPLE},
+    };
+
+    ASSERT_EQ(result, expected);
+    ASSERT_EQ(result, ufps::yaml::deserialise_tree<Mixed>(yaml));
+}
+
+TEST(yaml_deserialisation, null_values)
+{
+    const auto yaml =
+        R"(MultiMember:
+  a: 1
+  b: 2.5
+  c: ~
+  d: yes)";
+    const auto result = ufps::yaml::deserialise<MultiMember>(yaml);
+    const auto expected = MultiMember{.a = 1, .b = 2.5f, .c = "null", .d = true};
+
+    ASSERT_EQ(result, expected);
+    ASSERT_EQ(result, ufps::yaml::deserialise_tree<MultiMember>(yaml));
+
+    ASSERT_FALSE(ufps::yaml::deserialise<Simple>("Simple:\n  a: ~"));
+    ASSERT_FALSE(ufps::yaml::deserialise_tree<Simple>("Simple:\n  a: ~"));
+}
+
+TEST(yaml_deserialisation, missing_member)
+{
+    const auto yaml =
+        R"(MultiMember:
+  a: 1
+  b: 2.5
+  d: true)";
+
+    ASSERT_FALSE(ufps::yaml::deserialise<MultiMember>(yaml));
+    ASSERT_FALSE(ufps::yaml::deserialise_tree<MultiMember>(yaml));
+    ASSERT_FALSE(ufps::yaml::deserialise<MultiMember>(""));
+}
+
+TEST(yaml_deserialisation, aliases)
+{
+    const auto yaml =
+        R"(ArrayOfStruct:
+  v:
+    - &simple
+      Simple:
+        a: 3
+    - *simple)";
+    const auto result = ufps::yaml::deserialise<ArrayOfStruct>(yaml);
+    const auto expected = ArrayOfStruct{.v = {{.a = 3}, {.a = 3}}};
+
+    ASSERT_EQ(result, expected);
+}
@@ -55,6 +55,14 @@ auto EmbeddedResourceLoader::load_data_buffer(std::string_view name) -> DataBuff
 
     return to_container<DataBuffer>(resource->second);
 }}
+
+auto EmbeddedResourceLoader::map_data_buffer(std::string_view name) -> DataBufferView
+{{
+    const auto resource = lookup_.find(name);
+    expect(resource != std::ranges::cend(lookup_), "resource {{}} does not exist", name);
+
+    return std::as_bytes(resource->second);
+}}
 }}
 """
 
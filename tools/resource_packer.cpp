@@ -1,18 +1,239 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <filesystem>
+#include <format>
 #include <fstream>
+#include <functional>
+#include <limits>
 #include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include <yaml-cpp/yaml.h>
 
+#include "concurrency/thread_pool.h"
 #include "core/manifest_descriptions.h"
+#include "graphics/block_compression.h"
+#include "graphics/index_encoding.h"
+#include "graphics/mesh_data.h"
+#include "graphics/mesh_lod.h"
+#include "graphics/mesh_optimiser.h"
+#include "graphics/mesh_view.h"
+#include "graphics/meshlet.h"
+#include "graphics/mip_chain.h"
+#include "graphics/packed_vertex.h"
 #include "graphics/utils.h"
+#include "resources/asset_archive.h"
+#include "resources/binary_manifest.h"
+#include "resources/build_cache.h"
 #include "resources/file_resource_loader.h"
+#include "serialisation/binary_serialiser.h"
 #include "serialisation/yaml_serialiser.h"
-#include "utils/compress.h"
+#include "utils/data_buffer.h"
 #include "utils/error.h"
+#include "utils/formatter.h"
 #include "utils/log.h"
 
+namespace
+{
+
+// bump these whenever importing or compressing changes its output so stale cache entries are rebuilt, model entries
+// are also keyed by the schema of PackedModel so changing its layout needs no bump
+constexpr auto model_build_version = 1u;
+constexpr auto texture_build_version = 1u;
+
+/**
+ * A mesh with its vertices packed and indices encoded, ready to be appended to the archive blobs.
+ */
+struct PackedMesh
+{
+    ufps::DataBuffer vertices;
+    ufps::DataBuffer indices;
+    std::uint32_t vertex_count;
+    std::uint32_t index_count;
+};
+
+struct PackedLod
+{
+    PackedMesh mesh;
+    float error;
+};
+
+/**
+ * Everything built from a single sub model. Meshlets are relative to their mesh so linking only has to place meshes.
+ * Textures are albedo, normal, specular, ao, glossiness and emissive.
+ */
+struct PackedSubModel
+{
+    PackedMesh mesh;
+    std::vector<PackedLod> lods;
+    std::vector<ufps::Meshlet> meshlets;
+    std::array<std::string, 6zu> textures;
+};
+
+/**
+ * The intermediate output of importing one model file, this is what the build cache holds for models.
+ */
+struct PackedModel
+{
+    std::string name;
+    std::vector<PackedSubModel> sub_models;
+};
+
+/**
+ * A texture as stored in the archive along with how it was built, for reporting.
+ */
+struct PackedTexture
+{
+    ufps::DataBuffer data;
+    std::size_t texels;
+    float seconds;
+    float psnr;
+    bool cached;
+};
+
+auto pack_mesh(const ufps::MeshData &mesh_data) -> PackedMesh
+{
+    const auto vertex_count = static_cast<std::uint32_t>(mesh_data.vertices.size());
+    const auto vertices =
+        mesh_data.vertices | std::views::transform(ufps::pack_vertex) | std::ranges::to<std::vector>();
+
+    auto indices = ufps::DataBuffer{};
+    ufps::encode_indices(indices, mesh_data.indices, vertex_count);
+
+    return {
+        .vertices = std::as_bytes(std::span{vertices}) | std::ranges::to<ufps::DataBuffer>(),
+        .indices = std::move(indices),
+        .vertex_count = vertex_count,
+        .index_count = static_cast<std::uint32_t>(mesh_data.indices.size()),
+    };
+}
+
+/**
+ * Import a model file and optimise, simplify and cluster every sub model. This is the slow part of packing.
+ */
+auto import_model(ufps::DataBufferView model_data) -> PackedModel
+{
+    const auto &[name, sub_models] = ufps::load_model(model_data);
+
+    return {
+        .name = name,
+        .sub_models =
+            sub_models |
+            std::views::transform(
+                [](const auto &model)
+                {
+                    const auto before = ufps::analyse_vertex_cache(
+                        model.mesh_data.indices, static_cast<std::uint32_t>(model.mesh_data.vertices.size()));
+
+                    ufps::log::info(
+                        "optimising mesh: vertices {} acmr {:.3f} atvr {:.3f}",
+                        model.mesh_data.vertices.size(),
+                        before.acmr,
+                        before.atvr);
+
+                    const auto [mesh_data, stages] = ufps::optimise_mesh(model.mesh_data);
+
+                    for (const auto &[stage, vertex_count, statistics] : stages)
+                    {
+                        ufps::log::info(
+                            "after {:<12} vertices {} acmr {:.3f} atvr {:.3f}",
+                            stage,
+                            vertex_count,
+                            statistics.acmr,
+                            statistics.atvr);
+                    }
+
+                    const auto lods = ufps::generate_lods(mesh_data);
+
+                    ufps::log::info(
+                        "generated {} lods: triangles {} -> {}",
+                        lods.size(),
+                        mesh_data.indices.size() / 3zu,
+                        lods | std::views::transform([](const auto &lod) { return lod.mesh.indices.size() / 3zu; }));
+
+                    auto meshlets = ufps::build_meshlets(mesh_data);
+
+                    ufps::log::info(
+                        "built {} meshlets, {} with a normal cone",
+                        meshlets.size(),
+                        std::ranges::count_if(meshlets, [](const auto &m) { return m.cone_cutoff < 1.0f; }));
+
+                    return PackedSubModel{
+                        .mesh = pack_mesh(mesh_data),
+                        .lods = lods |
+                                std::views::transform(
+                                    [](const auto &lod)
+                                    {
+                                        return PackedLod{
+                                            .mesh = pack_mesh(ufps::optimise_mesh(lod.mesh).mesh),
+                                            .error = lod.error,
+                                        };
+                                    }) |
+                                std::ranges::to<std::vector>(),
+                        .meshlets = std::move(meshlets),
+                        .textures = {
+                            model.albedo.value_or("textures\\default_BaseColor.dds"),
+                            model.normal.value_or("textures\\default_Normal.dds"),
+                            model.specular.value_or("textures\\default_Metallic.dds"),
+                            model.ao.value_or("textures\\default_AO.dds"),
+                            model.glossiness.value_or("textures\\default_Roughness.dds"),
+                            model.emissive.value_or("textures\\default_Emissive.dds"),
+                        },
+                    };
+                }) |
+            std::ranges::to<std::vector>(),
+    };
+}
+
+/**
+ * Mip and block compress an uncompressed texture, normals only need two channels as the gbuffer pass rebuilds z.
+ */
+auto compress_source(std::string_view name, const ufps::TextureData &texture, ufps::TextureFormat format)
+    -> PackedTexture
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    const auto mipped = ufps::generate_mip_chain(texture);
+    const auto compressed = ufps::compress_texture(mipped, format);
+
+    const auto seconds = std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+    const auto texels =
+        ufps::mip_chain_size(ufps::TextureFormat::RED, mipped.width, mipped.height, mipped.mip_levels);
+    const auto psnr = ufps::compression_psnr(mipped, compressed);
+
+    ufps::log::info(
+        "compressed {} with {} mip levels to {} in {:.2f}s, {:.2f} Mtexel/s, psnr: {:.2f} dB",
+        name,
+        mipped.mip_levels,
+        format,
+        seconds,
+        static_cast<float>(texels) / seconds / 1'000'000.0f,
+        psnr);
+
+    return {
+        .data = ufps::encode_dds(compressed),
+        .texels = texels,
+        .seconds = seconds,
+        .psnr = psnr,
+        .cached = false,
+    };
+}
+
+auto seconds_since(std::chrono::steady_clock::time_point start) -> float
+{
+    return std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+}
+
+}
+
 auto main(int argc, char **argv) -> int
 {
     try
@@ -32,16 +253,75 @@ auto main(int argc, char **argv) -> int
         const auto output_configs_dir = output_asset_dir / "configs";
         std::filesystem::create_directories(output_configs_dir);
 
+        // intermediate outputs of every asset keyed by its content, only assets which changed are rebuilt
+        auto cache = ufps::BuildCache{std::filesystem::path{argv[1]} / "build_cache"};
+        auto pool = ufps::ThreadPool{};
+
         ufps::log::info("packing resources fbx files");
 
         auto resource_loader = ufps::FileResourceLoader{resource_dirs};
-        auto models =
-            resource_loader.resources("models") | std::views::filter([](const auto &e) { return e.ends_with(".fbx"); });
+        const auto models = resource_loader.resources("models") |
+                            std::views::filter([](const auto &e) { return e.ends_with(".fbx"); }) |
+                            std::ranges::to<std::vector>();
+
+        const auto models_start = std::chrono::steady_clock::now();
+        auto packed_models = std::vector<PackedModel>(models.size());
+
+        {
+            auto jobs = std::vector<ufps::Job>{};
+
+            // every job writes to its own slot so they need no synchronisation beyond the wait
+            for (const auto &[model, packed] : std::views::zip(models, packed_models))
+            {
+                jobs.push_back(
+                    [&, &model = model, &packed = packed]
+                    {
+                        ufps::log::debug("found model resource: {}", model);
+
+                        const auto source = resource_loader.load_data_buffer(model);
+                        const auto key = ufps::build_cache_key(
+                            source,
+                            std::format(
+                                "model v{} schema {:x}",
+                                model_build_version,
+                                ufps::binary::schema<PackedModel>()));
+
+                        if (const auto cached = cache.load(key); cached)
+                        {
+                            auto decoded = ufps::binary::deserialise<PackedModel>(*cached);
+                            if (decoded)
+                            {
+                                packed = std::move(*decoded);
+                                return;
+                            }
+
+                            ufps::log::warn("rebuilding invalid build cache entry for {}: {}", model, decoded.error());
+                        }
+
+                        packed = import_model(source);
+
+                        const auto encoded = ufps::binary::serialise(packed);
+                        ufps::ensure(encoded);
+                        cache.store(key, *encoded);
+                    });
+            }
+
+            ufps::run_parallel(pool, std::move(jobs));
+        }
 
+        ufps::log::info(
+            "imported {} models in {:.2f}s, {} from the build cache",
+            models.size(),
+            seconds_since(models_start),
+            cache.hits());
+
+        // linking places every mesh in the shared blobs, lods get their own vertices rather than sharing their
+        // parent's so each is an independent arena allocation
         auto vertex_offset = 0zu;
         auto index_offset = 0zu;
-        auto vertex_data = std::vector<ufps::VertexData>{};
-        auto index_data = std::vector<std::uint32_t>{};
+        auto vertex_blob = ufps::DataBuffer{};
+        auto index_blob = ufps::DataBuffer{};
+        auto meshlet_data = std::vector<ufps::Meshlet>{};
 
         auto texture_names = std::unordered_set<std::string>{
             "textures\\default_BaseColor.dds",
@@ -51,156 +331,252 @@ auto main(int argc, char **argv) -> int
             "textures\\default_Roughness.dds",
             "textures\\default_Emissive.dds",
         };
+        auto normal_texture_names = std::unordered_set<std::string>{"textures\\default_Normal.dds"};
 
+        const auto append_mesh = [&](const PackedMesh &mesh)
         {
-            auto manifest = ufps::ModelManifestDescription{};
+            const auto mesh_view = ufps::MeshView{
+                .index_offset = static_cast<std::uint32_t>(index_offset),
+                .index_count = mesh.index_count,
+                .vertex_offset = static_cast<std::uint32_t>(vertex_offset),
+                .vertex_count = mesh.vertex_count,
+            };
 
-            for (const auto &m : models)
-            {
-                ufps::log::debug("found model resource: {}", m);
-                const auto &[name, sub_models] = ufps::load_model(resource_loader.load_data_buffer(m));
+            vertex_blob.append_range(mesh.vertices);
+            index_blob.append_range(mesh.indices);
 
+            vertex_offset += mesh.vertex_count;
+            index_offset += mesh.index_count;
+
+            return mesh_view;
+        };
+
+        // the yaml manifests are only written for debugging, the game reads the binary manifest built from both
+        auto model_manifest = ufps::ModelManifestDescription{};
+        auto texture_manifest = ufps::TextureManifestDescription{};
+
+        {
+            for (const auto &[name, sub_models] : packed_models)
+            {
                 if (sub_models.empty())
                 {
                     ufps::log::warn("model {} has no submodels, skipping", name);
                     continue;
                 }
 
-                manifest.models[name] =
+                model_manifest.models[name] =
                     sub_models |
                     std::views::transform(
-                        [&](const auto &model)
+                        [&](const auto &sub_model)
                         {
-                            const auto &mesh_data = model.mesh_data;
-                            const auto vertex_count = mesh_data.vertices.size();
-                            const auto index_count = mesh_data.indices.size();
-
-                            const auto albedo_name = model.albedo ? *model.albedo : "textures\\default_BaseColor.dds";
-                            const auto normal_name = model.normal ? *model.normal : "textures\\default_Normal.dds";
-                            const auto specular_name =
-                                model.specular ? *model.specular : "textures\\default_Metallic.dds";
-                            const auto ao_name = model.ao ? *model.ao : "textures\\default_AO.dds";
-                            const auto glossiness_name =
-                                model.glossiness ? *model.glossiness : "textures\\default_Roughness.dds";
-                            const auto emissive_name =
-                                model.emissive ? *model.emissive : "textures\\default_Emissive.dds";
-
-                            texture_names.insert(albedo_name);
-                            texture_names.insert(normal_name);
-                            texture_names.insert(specular_name);
-                            texture_names.insert(ao_name);
-                            texture_names.insert(glossiness_name);
-                            texture_names.insert(emissive_name);
-
-                            const auto res = ufps::ModelManifest{
-                                .mesh_view =
-                                    {
-                                        .index_offset = static_cast<std::uint32_t>(index_offset),
-                                        .index_count = static_cast<std::uint32_t>(mesh_data.indices.size()),
-                                        .vertex_offset = static_cast<std::uint32_t>(vertex_offset),
-                                        .vertex_count = static_cast<std::uint32_t>(mesh_data.vertices.size()),
-                                    },
-                                .albedo_texture = albedo_name,
-                                .normal_texture = normal_name,
-                                .specular_texture = specular_name,
-                                .ao_texture = ao_name,
-                                .glossiness_texture = glossiness_name,
-                                .emissive_texture = emissive_name,
-                            };
+                            const auto &[albedo, normal, specular, ao, glossiness, emissive] = sub_model.textures;
 
-                            vertex_data.append_range(mesh_data.vertices);
-                            index_data.append_range(mesh_data.indices);
+                            texture_names.insert_range(sub_model.textures);
+                            normal_texture_names.insert(normal);
 
-                            vertex_offset += vertex_count;
-                            index_offset += index_count;
-
-                            return res;
+                            const auto meshlet_range = ufps::MeshletRange{
+                                .offset = static_cast<std::uint32_t>(meshlet_data.size()),
+                                .count = static_cast<std::uint32_t>(sub_model.meshlets.size()),
+                            };
+                            meshlet_data.append_range(sub_model.meshlets);
+
+                            // braced initialisers are evaluated in order so the full detail mesh is appended first
+                            return ufps::ModelManifest{
+                                .mesh_view = append_mesh(sub_model.mesh),
+                                .lods = sub_model.lods |
+                                        std::views::transform(
+                                            [&](const auto &lod)
+                                            {
+                                                return ufps::MeshLod{
+                                                    .mesh_view = append_mesh(lod.mesh),
+                                                    .error = lod.error,
+                                                };
+                                            }) |
+                                        std::ranges::to<std::vector>(),
+                                .meshlets = meshlet_range,
+                                .albedo_texture = albedo,
+                                .normal_texture = normal,
+                                .specular_texture = specular,
+                                .ao_texture = ao,
+                                .glossiness_texture = glossiness,
+                                .emissive_texture = emissive,
+                            };
                         }) |
                     std::ranges::to<std::vector>();
             }
 
             const auto manifest_path = output_configs_dir / "model_manifest.yaml";
             auto manifest_file = std::ofstream{manifest_path};
-            manifest_file << *ufps::yaml::serialise(manifest);
+            manifest_file << *ufps::yaml::serialise(model_manifest);
         }
 
         ufps::log::info("finished packing models, packing textures");
-        auto texture_blob = ufps::DataBuffer{};
+        auto archive = ufps::AssetArchiveWriter{};
 
         {
-            auto manifest = ufps::TextureManifestDescription{};
+            auto sorted_texture_names = texture_names | std::ranges::to<std::vector>();
+            std::ranges::sort(sorted_texture_names);
 
-            auto offset = 0zu;
+            const auto textures_start = std::chrono::steady_clock::now();
+            const auto model_cache_hits = cache.hits();
+            auto packed_textures = std::vector<PackedTexture>(sorted_texture_names.size());
 
-            for (const auto &t : texture_names)
             {
-                ufps::log::debug("packing texture: {}", t);
+                auto jobs = std::vector<ufps::Job>{};
+
+                for (const auto &[t, packed] : std::views::zip(sorted_texture_names, packed_textures))
+                {
+                    jobs.push_back(
+                        [&, &t = t, &packed = packed]
+                        {
+                            ufps::log::debug("packing texture: {}", t);
+
+                            const auto is_srgb = t.contains("BaseColor");
+                            auto source = resource_loader.load_data_buffer(t);
+                            const auto texture = ufps::load_texture(source, is_srgb);
+
+                            if (texture.is_compressed)
+                            {
+                                // block compressed sources are stored as is, they can't be filtered without decoding
+                                if (texture.mip_levels < ufps::mip_level_count(texture.width, texture.height))
+                                {
+                                    ufps::log::warn("texture {} has {} of a full mip chain", t, texture.mip_levels);
+                                }
+
+                                packed = {
+                                    .data = std::move(source),
+                                    .texels = 0zu,
+                                    .seconds = 0.0f,
+                                    .psnr = std::numeric_limits<float>::infinity(),
+                                    .cached = false,
+                                };
+                                return;
+                            }
+
+                            const auto format = normal_texture_names.contains(t)
+                                                    ? ufps::TextureFormat::BC5U
+                                                    : (is_srgb ? ufps::TextureFormat::BC7_SRGB
+                                                               : ufps::TextureFormat::BC7);
+                            const auto key = ufps::build_cache_key(
+                                source, std::format("texture v{} {}", texture_build_version, format));
+
+                            if (auto cached = cache.load(key); cached)
+                            {
+                                packed = {
+                                    .data = std::move(*cached),
+                                    .texels = 0zu,
+                                    .seconds = 0.0f,
+                                    .psnr = std::numeric_limits<float>::infinity(),
+                                    .cached = true,
+                                };
+                                return;
+                            }
+
+                            // textures are compressed in parallel with each other so each is encoded on one thread
+                            packed = compress_source(t, texture, format);
+                            cache.store(key, packed.data);
+                        });
+                }
+
+                ufps::run_parallel(pool, std::move(jobs));
+            }
 
-                const auto texture_data = resource_loader.load_data_buffer(t);
-                const auto size = texture_data.size();
+            for (const auto &[t, packed] : std::views::zip(sorted_texture_names, packed_textures))
+            {
+                archive.add(t, packed.data);
+                texture_manifest.textures[t] = {.is_srgb = t.contains("BaseColor")};
+            }
 
-                texture_blob.append_range(std::as_bytes(std::span{texture_data.data(), size}));
+            const auto compressed_texels = std::ranges::fold_left(
+                packed_textures | std::views::transform(&PackedTexture::texels), 0zu, std::plus{});
+            const auto worst_psnr = std::ranges::fold_left(
+                packed_textures | std::views::transform(&PackedTexture::psnr),
+                std::numeric_limits<float>::infinity(),
+                [](auto a, auto b) { return std::min(a, b); });
 
-                manifest.textures[t] = {
-                    .offset = static_cast<std::uint32_t>(offset),
-                    .size = static_cast<std::uint32_t>(size),
-                    .is_srgb = t.contains("BaseColor"),
-                };
+            ufps::log::info(
+                "packed {} textures in {:.2f}s, {} from the build cache",
+                packed_textures.size(),
+                seconds_since(textures_start),
+                cache.hits() - model_cache_hits);
 
-                offset += size;
+            if (compressed_texels != 0zu)
+            {
+                const auto compression_seconds = std::ranges::fold_left(
+                    packed_textures | std::views::transform(&PackedTexture::seconds), 0.0f, std::plus{});
+
+                ufps::log::info(
+                    "block compressed {} Mtexels in {:.2f}s cpu time, {:.2f} Mtexel/s per job, worst psnr: {:.2f} dB",
+                    compressed_texels / 1'000'000zu,
+                    compression_seconds,
+                    static_cast<float>(compressed_texels) / compression_seconds / 1'000'000.0f,
+                    worst_psnr);
             }
 
             const auto manifest_path = output_configs_dir / "texture_manifest.yaml";
             auto manifest_file = std::ofstream{manifest_path};
 
-            manifest_file << *ufps::yaml::serialise(manifest);
+            manifest_file << *ufps::yaml::serialise(texture_manifest);
+        }
+
+        {
+            const auto manifest = ufps::encode_binary_manifest(model_manifest, texture_manifest);
+
+            const auto manifest_path = output_configs_dir / "manifest.bin";
+            auto manifest_file = std::ofstream{manifest_path, std::ios::binary};
+            manifest_file.write(reinterpret_cast<const char *>(manifest.data()), manifest.size());
+
+            ufps::log::info("wrote binary manifest: {} bytes", manifest.size());
         }
 
         ufps::log::info("finished packing textures, writing to disk");
 
-        const auto compressed_vertex_data =
-            ufps::compress(std::as_bytes(std::span{vertex_data.data(), vertex_data.size()}));
-        ufps::ensure(compressed_vertex_data);
+        const auto texture_size = archive.size();
+        const auto compressed_texture_size = archive.compressed_size();
+
+        ufps::log::info(
+            "packed {} textures, {} bytes, compression ratio: {:.2f}%",
+            texture_names.size(),
+            compressed_texture_size,
+            100.0f * compressed_texture_size / texture_size);
 
-        const auto vertex_data_path = output_blobs_dir / "vertex_data.bin";
-        auto vertex_data_file = std::ofstream{vertex_data_path, std::ios::binary};
-        vertex_data_file.write(
-            reinterpret_cast<const char *>(compressed_vertex_data->data()), compressed_vertex_data->size());
+        archive.add("vertex_data", vertex_blob);
 
         ufps::log::info(
-            "wrote vertex data: {} vertices, {} bytes, compression ratio: {:.2f}%",
-            compressed_vertex_data->size(),
-            compressed_vertex_data->size() * sizeof(ufps::VertexData),
-            100.0f * compressed_vertex_data->size() / (vertex_data.size() * sizeof(ufps::VertexData)));
+            "packed vertex data: {} vertices, {} bytes packed ({} unpacked), compression ratio: {:.2f}%",
+            vertex_offset,
+            vertex_blob.size(),
+            vertex_offset * sizeof(ufps::VertexData),
+            100.0f * (archive.compressed_size() - compressed_texture_size) / vertex_blob.size());
+
+        const auto compressed_vertex_size = archive.compressed_size();
+        archive.add("index_data", index_blob);
 
-        const auto compressed_index_data =
-            ufps::compress(std::as_bytes(std::span{index_data.data(), index_data.size()}));
-        ufps::ensure(compressed_index_data);
+        ufps::log::info(
+            "packed index data: {} indices, {} bytes packed ({} as 32 bit), compression ratio: {:.2f}%",
+            index_offset,
+            index_blob.size(),
+            index_offset * sizeof(std::uint32_t),
+            100.0f * (archive.compressed_size() - compressed_vertex_size) / index_blob.size());
 
-        const auto index_data_path = output_blobs_dir / "index_data.bin";
-        auto index_data_file = std::ofstream{index_data_path, std::ios::binary};
-        index_data_file.write(
-            reinterpret_cast<const char *>(compressed_index_data->data()), compressed_index_data->size());
+        const auto compressed_index_size = archive.compressed_size();
+        archive.add("meshlet_data", std::as_bytes(std::span{meshlet_data.data(), meshlet_data.size()}));
 
         ufps::log::info(
-            "wrote index data: {} indices, {} bytes, compression ratio: {:.2f}%",
-            compressed_index_data->size(),
-            compressed_index_data->size() * sizeof(std::uint32_t),
-            100.0f * compressed_index_data->size() / (index_data.size() * sizeof(std::uint32_t)));
+            "packed meshlet data: {} meshlets, {} bytes",
+            meshlet_data.size(),
+            archive.compressed_size() - compressed_index_size);
 
-        const auto compressed_texture_blob = ufps::compress(texture_blob);
-        ufps::ensure(compressed_texture_blob);
+        const auto archive_data = archive.data();
 
-        const auto texture_blob_path = output_blobs_dir / "texture_data.bin";
-        auto texture_blob_file = std::ofstream{texture_blob_path, std::ios::binary};
-        texture_blob_file.write(
-            reinterpret_cast<const char *>(compressed_texture_blob->data()), compressed_texture_blob->size());
+        const auto archive_path = output_blobs_dir / "assets.archive";
+        auto archive_file = std::ofstream{archive_path, std::ios::binary};
+        archive_file.write(reinterpret_cast<const char *>(archive_data.data()), archive_data.size());
 
         ufps::log::info(
-            "wrote texture blob: {} textures, {} bytes, compression ratio: {:.2f}%",
-            texture_names.size(),
-            compressed_texture_blob->size(),
-            100.0f * compressed_texture_blob->size() / texture_blob.size());
+            "wrote asset archive: {} bytes, compression ratio: {:.2f}%",
+            archive_data.size(),
+            100.0f * archive_data.size() / archive.size());
     }
     catch (const ufps::Exception &e)
     {